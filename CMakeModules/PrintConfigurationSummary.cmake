@@ -28,6 +28,11 @@ tarm_io_config_summary_vars_set(TARM_IO_BUILD_TESTS
                                 "YES"
                                 "NO")
 
+tarm_io_config_summary_vars_set(TARM_IO_BUILD_BENCHMARKS
+                                TARM_IO_CONFIG_SUMMARY_BUILD_BENCHMARKS
+                                "YES"
+                                "NO")
+
 tarm_io_config_summary_vars_set(TARM_IO_OPENSSL_FOUND
                                 TARM_IO_CONFIG_SUMMARY_OPENSSL
                                 "YES"
@@ -49,6 +54,7 @@ message("Build tests...............${TARM_IO_CONFIG_SUMMARY_BUILD_TESTS}")
 if (TARM_IO_BUILD_TESTS)
     message("Bundled GTest.............${TARM_IO_CONFIG_SUMMARY_BUNDLED_GTEST}")
 endif()
+message("Build benchmarks..........${TARM_IO_CONFIG_SUMMARY_BUILD_BENCHMARKS}")
 
 if(TARM_IO_PLATFORM_MACOSX)
     message("OSX deployment target.....${CMAKE_OSX_DEPLOYMENT_TARGET}")
@@ -0,0 +1,134 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "BenchmarkCommon.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#if defined(TARM_IO_PLATFORM_LINUX) || defined(TARM_IO_PLATFORM_MACOSX)
+    #include <sys/resource.h>
+    #include <unistd.h>
+#else
+    #include <ctime>
+#endif
+
+namespace {
+
+std::atomic<std::size_t> g_allocations_counter(0);
+
+std::chrono::microseconds process_cpu_time() {
+#if defined(TARM_IO_PLATFORM_LINUX) || defined(TARM_IO_PLATFORM_MACOSX)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+#else
+    return std::chrono::microseconds(std::clock() * 1000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+} // namespace
+
+// Replacing global allocation functions to count allocations made by the library and benchmarks.
+void* operator new(std::size_t size) {
+    ++g_allocations_counter;
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace tarm {
+namespace io {
+namespace benchmark {
+
+Stopwatch::Stopwatch() {
+    reset();
+}
+
+void Stopwatch::reset() {
+    m_wall_start = std::chrono::steady_clock::now();
+    m_cpu_start = process_cpu_time();
+}
+
+std::chrono::microseconds Stopwatch::wall_time() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_wall_start);
+}
+
+std::chrono::microseconds Stopwatch::cpu_time() const {
+    return process_cpu_time() - m_cpu_start;
+}
+
+double Stopwatch::cpu_usage() const {
+    const auto wall = wall_time().count();
+    return wall ? double(cpu_time().count()) / double(wall) : 0.0;
+}
+
+std::size_t allocations_count() {
+    return g_allocations_counter;
+}
+
+std::size_t resident_memory_size() {
+#if defined(TARM_IO_PLATFORM_LINUX)
+    std::ifstream statm("/proc/self/statm");
+    std::size_t total_pages = 0;
+    std::size_t resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+
+    return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+std::size_t env_or_default(const char* name, std::size_t default_value) {
+    const char* value = std::getenv(name);
+    if (value == nullptr) {
+        return default_value;
+    }
+
+    return static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+}
+
+void print_header(const std::string& benchmark_name) {
+    std::cout << "==== " << benchmark_name << " ====" << std::endl;
+}
+
+void print_result(const std::string& name, double value, const std::string& units) {
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(16)
+              << std::fixed << std::setprecision(2) << value << " " << units << std::endl;
+}
+
+} // namespace benchmark
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,49 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tarm {
+namespace io {
+namespace benchmark {
+
+// Measures wall clock and CPU time of the whole process since construction or last reset.
+class Stopwatch {
+public:
+    Stopwatch();
+
+    void reset();
+
+    std::chrono::microseconds wall_time() const;
+    std::chrono::microseconds cpu_time() const;
+
+    // CPU time divided by wall time, 1.0 means that one core was fully busy
+    double cpu_usage() const;
+
+private:
+    std::chrono::steady_clock::time_point m_wall_start;
+    std::chrono::microseconds m_cpu_start;
+};
+
+// Total number of operator new calls in the process since start (all threads)
+std::size_t allocations_count();
+
+// Resident set size of the process in bytes or 0 if it is not supported on the platform
+std::size_t resident_memory_size();
+
+// Reads value of the environment variable as unsigned number or returns default value
+std::size_t env_or_default(const char* name, std::size_t default_value);
+
+void print_header(const std::string& benchmark_name);
+void print_result(const std::string& name, double value, const std::string& units);
+
+} // namespace benchmark
+} // namespace io
+} // namespace tarm
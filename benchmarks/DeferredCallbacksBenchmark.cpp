@@ -0,0 +1,115 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Measures CPU usage of the loop and latency added by EventLoop::schedule_callback
+// under a steady trickle of deferred calls. Calls are scheduled from timer callbacks
+// (executed before I/O polling) and from callbacks posted by another thread (executed during polling).
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "Timer.h"
+
+#include <uv.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+struct LatencyStats {
+    std::vector<std::uint64_t> samples_ns;
+
+    void print(const std::string& prefix) {
+        if (samples_ns.empty()) {
+            return;
+        }
+
+        std::sort(samples_ns.begin(), samples_ns.end());
+        std::uint64_t sum = 0;
+        for (auto v : samples_ns) {
+            sum += v;
+        }
+
+        io::benchmark::print_result(prefix + " latency avg", double(sum) / samples_ns.size() / 1000.0, "us");
+        io::benchmark::print_result(prefix + " latency p99", samples_ns[samples_ns.size() * 99 / 100] / 1000.0, "us");
+        io::benchmark::print_result(prefix + " latency max", samples_ns.back() / 1000.0, "us");
+    }
+};
+
+void run_timer_trickle(std::size_t ticks, std::uint64_t period_ms) {
+    io::EventLoop loop;
+    LatencyStats stats;
+
+    auto timer = new io::Timer(loop);
+    timer->start(period_ms, period_ms, [&](io::Timer& timer) {
+        const auto scheduled_at = uv_hrtime();
+        loop.schedule_callback([&, scheduled_at](io::EventLoop&) {
+            stats.samples_ns.push_back(uv_hrtime() - scheduled_at);
+        });
+
+        if (timer.callback_call_counter() + 1 >= ticks) {
+            timer.schedule_removal();
+        }
+    });
+
+    io::benchmark::Stopwatch stopwatch;
+    const auto allocations_before = io::benchmark::allocations_count();
+    loop.run();
+    const auto allocations = io::benchmark::allocations_count() - allocations_before;
+
+    io::benchmark::print_result("timer source: CPU usage", stopwatch.cpu_usage() * 100.0, "%");
+    io::benchmark::print_result("timer source: allocations per call", double(allocations) / ticks, "");
+    stats.print("timer source:");
+}
+
+void run_cross_thread_trickle(std::size_t ticks, std::uint64_t period_ms) {
+    io::EventLoop loop;
+    LatencyStats stats;
+
+    loop.start_block_loop_from_exit();
+
+    std::thread producer([&]() {
+        for (std::size_t i = 0; i < ticks; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(period_ms));
+            loop.execute_on_loop_thread([&](io::EventLoop& loop) {
+                const auto scheduled_at = uv_hrtime();
+                loop.schedule_callback([&, scheduled_at](io::EventLoop&) {
+                    stats.samples_ns.push_back(uv_hrtime() - scheduled_at);
+                });
+            });
+        }
+
+        loop.execute_on_loop_thread([](io::EventLoop& loop) {
+            loop.stop_block_loop_from_exit();
+        });
+    });
+
+    io::benchmark::Stopwatch stopwatch;
+    loop.run();
+    producer.join();
+
+    io::benchmark::print_result("I/O source: CPU usage", stopwatch.cpu_usage() * 100.0, "%");
+    stats.print("I/O source:");
+}
+
+} // namespace
+
+int main() {
+    const std::size_t ticks = io::benchmark::env_or_default("TARM_IO_BENCH_TICKS", 2000);
+    const std::uint64_t period_ms = io::benchmark::env_or_default("TARM_IO_BENCH_PERIOD_MS", 1);
+
+    io::benchmark::print_header("Deferred callbacks trickle (" + std::to_string(ticks) + " calls, period " +
+                                std::to_string(period_ms) + " ms)");
+
+    run_timer_trickle(ticks, period_ms);
+    run_cross_thread_trickle(ticks, period_ms);
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Multiple producers throughput of EventLoop::execute_on_loop_thread.
+// Reference implementation is a mutex protected deque with uv_async_send on each call,
+// which is how EventLoop implemented this before switching to the lock-free queue.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+
+#include <uv.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+class MutexQueueExecutor {
+public:
+    MutexQueueExecutor(io::EventLoop& loop) :
+        m_loop(&loop) {
+        uv_async_init(reinterpret_cast<uv_loop_t*>(loop.raw_loop()), &m_async, on_async);
+        m_async.data = this;
+    }
+
+    void execute_on_loop_thread(const io::EventLoop::WorkCallback& callback) {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_queue.push_back(callback);
+        }
+
+        uv_async_send(&m_async);
+    }
+
+    void close() {
+        uv_close(reinterpret_cast<uv_handle_t*>(&m_async), nullptr);
+    }
+
+private:
+    static void on_async(uv_async_t* handle) {
+        auto& this_ = *reinterpret_cast<MutexQueueExecutor*>(handle->data);
+
+        std::deque<io::EventLoop::WorkCallback> queue_copy;
+        {
+            std::lock_guard<std::mutex> guard(this_.m_mutex);
+            this_.m_queue.swap(queue_copy);
+        }
+
+        for (auto& callback : queue_copy) {
+            callback(*this_.m_loop);
+        }
+    }
+
+    io::EventLoop* m_loop;
+    uv_async_t m_async;
+    std::mutex m_mutex;
+    std::deque<io::EventLoop::WorkCallback> m_queue;
+};
+
+enum class Mode {
+    MUTEX_QUEUE,
+    LOCK_FREE_QUEUE,
+    LOCK_FREE_QUEUE_BULK
+};
+
+void run(Mode mode, const std::string& name, std::size_t producers_count, std::size_t callbacks_per_producer) {
+    io::EventLoop loop;
+    MutexQueueExecutor mutex_executor(loop);
+
+    const std::size_t total_callbacks = producers_count * callbacks_per_producer;
+    const std::size_t BULK_SIZE = 64;
+    std::size_t executed_counter = 0;
+
+    // Async handle of the reference executor keeps loop running in all modes until all callbacks are executed
+    io::EventLoop::WorkCallback callback = [&](io::EventLoop&) {
+        if (++executed_counter == total_callbacks) {
+            mutex_executor.close();
+        }
+    };
+
+    std::vector<std::thread> producers;
+    std::atomic<bool> start(false);
+
+    for (std::size_t i = 0; i < producers_count; ++i) {
+        producers.emplace_back([&]() {
+            while (!start) {
+                std::this_thread::yield();
+            }
+
+            if (mode == Mode::LOCK_FREE_QUEUE_BULK) {
+                std::vector<io::EventLoop::WorkCallback> bulk;
+                for (std::size_t j = 0; j < callbacks_per_producer; ++j) {
+                    bulk.push_back(callback);
+                    if (bulk.size() == BULK_SIZE || j + 1 == callbacks_per_producer) {
+                        loop.execute_on_loop_thread(std::move(bulk));
+                        bulk.clear();
+                    }
+                }
+                return;
+            }
+
+            for (std::size_t j = 0; j < callbacks_per_producer; ++j) {
+                if (mode == Mode::MUTEX_QUEUE) {
+                    mutex_executor.execute_on_loop_thread(callback);
+                } else {
+                    loop.execute_on_loop_thread(callback);
+                }
+            }
+        });
+    }
+
+    io::benchmark::Stopwatch stopwatch;
+    start = true;
+    loop.run();
+    const auto wall_time = stopwatch.wall_time();
+
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    io::benchmark::print_result(name + ": callbacks/s",
+                                double(total_callbacks) / (double(wall_time.count()) / 1000000.0), "");
+    io::benchmark::print_result(name + ": CPU time per callback",
+                                double(stopwatch.cpu_time().count()) * 1000.0 / total_callbacks, "ns");
+}
+
+} // namespace
+
+int main() {
+    const std::size_t producers_count = io::benchmark::env_or_default("TARM_IO_BENCH_PRODUCERS", 4);
+    const std::size_t callbacks_per_producer = io::benchmark::env_or_default("TARM_IO_BENCH_CALLBACKS", 250000);
+
+    io::benchmark::print_header("execute_on_loop_thread with " + std::to_string(producers_count) + " producers");
+
+    run(Mode::MUTEX_QUEUE, "mutex + deque (reference)", producers_count, callbacks_per_producer);
+    run(Mode::LOCK_FREE_QUEUE, "lock-free queue", producers_count, callbacks_per_producer);
+    run(Mode::LOCK_FREE_QUEUE_BULK, "lock-free queue, bulk of 64", producers_count, callbacks_per_producer);
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Stress test of Removable objects teardown. Removes a lot of Timer objects at once and
+// closes a lot of TCP connections at once (disconnect storm), reporting time and allocations.
+// Note: number of TCP connections is limited by the open files limit (each connection requires 2 sockets).
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "Timer.h"
+#include "net/TcpClient.h"
+#include "net/TcpServer.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+void report_teardown(const std::string& prefix,
+                     std::size_t objects_count,
+                     const io::benchmark::Stopwatch& stopwatch,
+                     std::size_t allocations) {
+    io::benchmark::print_result(prefix + " objects", double(objects_count), "");
+    io::benchmark::print_result(prefix + " teardown time", stopwatch.wall_time().count() / 1000.0, "ms");
+    io::benchmark::print_result(prefix + " teardown time per object",
+                                double(stopwatch.wall_time().count()) * 1000.0 / objects_count, "ns");
+    io::benchmark::print_result(prefix + " allocations per object", double(allocations) / objects_count, "");
+}
+
+void run_timers_teardown(std::size_t timers_count) {
+    io::EventLoop loop;
+
+    std::vector<io::Timer*> timers;
+    timers.reserve(timers_count);
+    for (std::size_t i = 0; i < timers_count; ++i) {
+        timers.push_back(new io::Timer(loop));
+    }
+
+    io::benchmark::Stopwatch stopwatch;
+    const auto allocations_before = io::benchmark::allocations_count();
+
+    for (auto& timer : timers) {
+        timer->schedule_removal();
+    }
+
+    loop.run();
+
+    report_teardown("Timer:", timers_count, stopwatch, io::benchmark::allocations_count() - allocations_before);
+}
+
+void run_tcp_teardown(std::size_t connections_count, std::uint16_t port) {
+    io::EventLoop loop;
+
+    std::vector<io::net::TcpClient*> clients;
+    clients.reserve(connections_count);
+
+    io::benchmark::Stopwatch stopwatch;
+    std::size_t allocations_before = 0;
+    std::size_t connect_errors = 0;
+
+    auto server = new io::net::TcpServer(loop);
+
+    auto start_teardown = [&]() {
+        std::cout << "All " << server->connected_clients_count() << " connections are established" << std::endl;
+
+        stopwatch.reset();
+        allocations_before = io::benchmark::allocations_count();
+
+        server->close([&](io::net::TcpServer& server, const io::Error&) {
+            server.schedule_removal();
+        });
+    };
+
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            if (!error && server->connected_clients_count() + connect_errors == connections_count) {
+                loop.schedule_callback([&](io::EventLoop&) {
+                    start_teardown();
+                });
+            }
+        },
+        nullptr,
+        nullptr,
+        1024
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        server->schedule_removal();
+        return;
+    }
+
+    for (std::size_t i = 0; i < connections_count; ++i) {
+        auto client = new io::net::TcpClient(loop);
+        clients.push_back(client);
+        client->connect({"127.0.0.1", port},
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                if (error) {
+                    ++connect_errors;
+                    client.schedule_removal();
+                }
+            },
+            nullptr,
+            [](io::net::TcpClient& client, const io::Error&) {
+                client.schedule_removal();
+            }
+        );
+    }
+
+    loop.run();
+
+    if (connect_errors) {
+        std::cout << "Connection errors: " << connect_errors << std::endl;
+    }
+
+    // Both server and client sides objects are removed during teardown
+    report_teardown("TCP:", (connections_count - connect_errors) * 2, stopwatch,
+                    io::benchmark::allocations_count() - allocations_before);
+}
+
+} // namespace
+
+int main() {
+    const std::size_t timers_count = io::benchmark::env_or_default("TARM_IO_BENCH_TIMERS", 100000);
+    const std::size_t connections_count = io::benchmark::env_or_default("TARM_IO_BENCH_CONNECTIONS", 5000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31540));
+
+    io::benchmark::print_header("Removable objects teardown");
+
+    run_timers_teardown(timers_count);
+    run_tcp_teardown(connections_count, port);
+
+    return 0;
+}
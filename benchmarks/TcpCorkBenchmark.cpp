@@ -0,0 +1,148 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Chatty TCP server which replies to each request with many small messages, measured with corked send off and on.
+// Each request is a single byte, reply consists of separate send_data calls of small messages. Client sends next
+// request when the whole reply is received. Clients are executed in a separate loop of the same process.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "Timer.h"
+#include "net/TcpClient.h"
+#include "net/TcpServer.h"
+
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace tarm;
+
+namespace {
+
+struct ClientsState {
+    bool stop = false;
+    std::size_t received_bytes = 0;
+    std::size_t errors = 0;
+};
+
+void start_connection(io::EventLoop& loop, ClientsState& state, std::uint16_t port, std::size_t reply_size) {
+    auto received_bytes = std::make_shared<std::size_t>(0);
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({"127.0.0.1", port},
+        [&state](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+                client.schedule_removal();
+                return;
+            }
+
+            client.send_data("?", 1);
+        },
+        [&state, reply_size, received_bytes](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            *received_bytes += data.size;
+            state.received_bytes += data.size;
+            if (*received_bytes < reply_size) {
+                return;
+            }
+
+            *received_bytes -= reply_size;
+
+            if (state.stop) {
+                client.schedule_removal();
+            } else {
+                client.send_data("?", 1);
+            }
+        }
+    );
+}
+
+void run(bool cork,
+         std::size_t connections_count,
+         std::size_t messages_per_reply,
+         std::size_t message_size,
+         std::size_t duration_ms,
+         std::uint16_t port) {
+    io::EventLoop server_loop;
+
+    std::shared_ptr<char> message(new char[message_size], std::default_delete<char[]>());
+    std::fill(message.get(), message.get() + message_size, 'a');
+
+    auto server = new io::net::TcpServer(server_loop);
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        [cork](io::net::TcpConnectedClient& client, const io::Error& error) {
+            if (!error) {
+                client.delay_send(false);
+                client.cork_send(cork);
+            }
+        },
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            if (error) {
+                return;
+            }
+
+            for (std::size_t i = 0; i < data.size * messages_per_reply; ++i) {
+                client.send_data(message, static_cast<std::uint32_t>(message_size));
+            }
+        },
+        nullptr
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        return;
+    }
+
+    std::thread server_thread([&server_loop]() {
+        server_loop.run();
+    });
+
+    io::EventLoop client_loop;
+    ClientsState state;
+    for (std::size_t i = 0; i < connections_count; ++i) {
+        start_connection(client_loop, state, port, messages_per_reply * message_size);
+    }
+
+    auto timer = new io::Timer(client_loop);
+    timer->start(duration_ms, [&state](io::Timer& timer) {
+        state.stop = true;
+        timer.schedule_removal();
+    });
+
+    io::benchmark::Stopwatch stopwatch;
+    client_loop.run();
+    const auto wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+    const auto cpu_usage = stopwatch.cpu_usage();
+
+    server_loop.execute_on_loop_thread([server](io::EventLoop&) {
+        server->schedule_removal();
+    });
+    server_thread.join();
+
+    const std::string prefix = std::string("cork ") + (cork ? "on" : "off") + ": ";
+    io::benchmark::print_result(prefix + "messages/s", state.received_bytes / message_size / wall_time_s, "");
+    io::benchmark::print_result(prefix + "process CPU usage", cpu_usage * 100.0, "%");
+    if (state.errors) {
+        io::benchmark::print_result(prefix + "errors", double(state.errors), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t connections = io::benchmark::env_or_default("TARM_IO_BENCH_CONNECTIONS", 16);
+    const std::size_t messages_per_reply = io::benchmark::env_or_default("TARM_IO_BENCH_MESSAGES_PER_REPLY", 64);
+    const std::size_t message_size = io::benchmark::env_or_default("TARM_IO_BENCH_MESSAGE_SIZE", 64);
+    const std::size_t duration_ms = io::benchmark::env_or_default("TARM_IO_BENCH_DURATION_MS", 1000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31541));
+
+    io::benchmark::print_header("TCP chatty replies (" + std::to_string(connections) + " connections, " +
+                                std::to_string(messages_per_reply) + " messages of " +
+                                std::to_string(message_size) + " bytes per reply)");
+    run(false, connections, messages_per_reply, message_size, duration_ms, port);
+    run(true, connections, messages_per_reply, message_size, duration_ms, port);
+
+    return 0;
+}
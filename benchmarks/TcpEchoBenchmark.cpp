@@ -0,0 +1,214 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// TCP echo server based on TcpServerGroup, measured with different number of loops.
+// Reports connections per second (connect, echo of a small message, close) and echo throughput
+// of persistent connections. Clients are executed in a separate EventLoopGroup of the same process,
+// so results scale only while there are enough CPU cores for both sides.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoopGroup.h"
+#include "Timer.h"
+#include "net/TcpClient.h"
+#include "net/TcpServerGroup.h"
+
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+struct ClientsState {
+    bool stop = false;
+    std::size_t completed_connections = 0;
+    std::size_t echoed_bytes = 0;
+    std::size_t errors = 0;
+};
+
+void start_short_connection(io::EventLoop& loop, ClientsState& state, std::uint16_t port, const std::string& message) {
+    auto received_bytes = std::make_shared<std::size_t>(0);
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({"127.0.0.1", port},
+        [&state, message](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+                client.schedule_removal();
+                return;
+            }
+
+            client.send_data(message);
+        },
+        [&loop, &state, port, message, received_bytes](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            *received_bytes += data.size;
+            if (*received_bytes < message.size()) {
+                return;
+            }
+
+            ++state.completed_connections;
+            client.schedule_removal();
+
+            if (!state.stop) {
+                start_short_connection(loop, state, port, message);
+            }
+        },
+        [&loop, &state, port, message](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+                if (!state.stop) {
+                    start_short_connection(loop, state, port, message);
+                }
+            }
+        }
+    );
+}
+
+void start_persistent_connection(io::EventLoop& loop, ClientsState& state, std::uint16_t port, std::shared_ptr<const char> message, std::uint32_t size) {
+    auto received_bytes = std::make_shared<std::size_t>(0);
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({"127.0.0.1", port},
+        [&state, message, size](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+                client.schedule_removal();
+                return;
+            }
+
+            client.send_data(message, size);
+        },
+        [&state, message, size, received_bytes](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            *received_bytes += data.size;
+            if (*received_bytes < size) {
+                return;
+            }
+
+            *received_bytes = 0;
+            state.echoed_bytes += size;
+
+            if (state.stop) {
+                client.schedule_removal();
+            } else {
+                client.send_data(message, size);
+            }
+        }
+    );
+}
+
+enum class Mode {
+    CONNECTIONS,
+    THROUGHPUT
+};
+
+void run(Mode mode,
+         std::size_t server_loops_count,
+         std::size_t client_loops_count,
+         std::size_t connections_per_loop,
+         std::size_t message_size,
+         std::size_t duration_ms,
+         std::uint16_t port) {
+    io::EventLoopGroup server_loops(server_loops_count);
+    io::net::TcpServerGroup server(server_loops);
+    const auto listen_error = server.listen({"127.0.0.1", port},
+        nullptr,
+        [](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            if (!error) {
+                client.copy_and_send_data(data.buf.get(), static_cast<std::uint32_t>(data.size));
+            }
+        },
+        nullptr
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        return;
+    }
+
+    std::thread server_thread([&server_loops]() {
+        server_loops.run();
+    });
+
+    io::EventLoopGroup client_loops(client_loops_count);
+    std::vector<ClientsState> states(client_loops_count);
+
+    std::shared_ptr<char> message_buf(new char[message_size], std::default_delete<char[]>());
+    std::fill(message_buf.get(), message_buf.get() + message_size, 'a');
+    const std::string short_message(message_size, 'a');
+
+    for (std::size_t i = 0; i < client_loops_count; ++i) {
+        auto& loop = client_loops.loop(i);
+        auto& state = states[i];
+
+        for (std::size_t j = 0; j < connections_per_loop; ++j) {
+            if (mode == Mode::CONNECTIONS) {
+                start_short_connection(loop, state, port, short_message);
+            } else {
+                start_persistent_connection(loop, state, port, message_buf, static_cast<std::uint32_t>(message_size));
+            }
+        }
+
+        auto timer = new io::Timer(loop);
+        timer->start(duration_ms, [&state](io::Timer& timer) {
+            state.stop = true;
+            timer.schedule_removal();
+        });
+    }
+
+    io::benchmark::Stopwatch stopwatch;
+    client_loops.run();
+    const auto wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+    const auto cpu_usage = stopwatch.cpu_usage();
+
+    server.schedule_removal();
+    server_thread.join();
+
+    ClientsState total;
+    for (auto& state : states) {
+        total.completed_connections += state.completed_connections;
+        total.echoed_bytes += state.echoed_bytes;
+        total.errors += state.errors;
+    }
+
+    const std::string prefix = std::to_string(server_loops_count) + " server loop(s): ";
+    if (mode == Mode::CONNECTIONS) {
+        io::benchmark::print_result(prefix + "connections/s", total.completed_connections / wall_time_s, "");
+    } else {
+        io::benchmark::print_result(prefix + "echo throughput", total.echoed_bytes / wall_time_s / (1024.0 * 1024.0), "MB/s");
+    }
+    io::benchmark::print_result(prefix + "process CPU usage", cpu_usage * 100.0, "%");
+    if (total.errors) {
+        io::benchmark::print_result(prefix + "errors", double(total.errors), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t cores_count = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    const std::size_t max_loops = io::benchmark::env_or_default("TARM_IO_BENCH_MAX_LOOPS", cores_count);
+    const std::size_t client_loops = io::benchmark::env_or_default("TARM_IO_BENCH_CLIENT_LOOPS", max_loops);
+    const std::size_t connections = io::benchmark::env_or_default("TARM_IO_BENCH_CONNECTIONS", 16);
+    const std::size_t message_size = io::benchmark::env_or_default("TARM_IO_BENCH_MESSAGE_SIZE", 16 * 1024);
+    const std::size_t duration_ms = io::benchmark::env_or_default("TARM_IO_BENCH_DURATION_MS", 1000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31541));
+
+    io::benchmark::print_header("TCP echo, connections per second (" + std::to_string(client_loops) + " client loops, " +
+                                std::to_string(connections) + " concurrent connections per loop)");
+    for (std::size_t loops = 1; loops <= max_loops; loops *= 2) {
+        run(Mode::CONNECTIONS, loops, client_loops, connections, 64, duration_ms, port);
+    }
+
+    io::benchmark::print_header("TCP echo, throughput (" + std::to_string(client_loops) + " client loops, " +
+                                std::to_string(connections) + " connections per loop, " +
+                                std::to_string(message_size) + " bytes messages)");
+    for (std::size_t loops = 1; loops <= max_loops; loops *= 2) {
+        run(Mode::THROUGHPUT, loops, client_loops, connections, message_size, duration_ms, port);
+    }
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// TCP proxy over loopback: source -> proxy -> sink. Proxy either relays received chunks by send_data with
+// pause_read_on_backpressure or forwards data by pipe_connections (splice on Linux).
+// Proxy has its own loop and thread, its CPU time is measured by thread CPU clock and divided by forwarded GBs.
+// Source and sink are executed in another thread.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "net/Tcp.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(TARM_IO_PLATFORM_LINUX) || defined(TARM_IO_PLATFORM_MACOSX)
+    #include <time.h>
+#endif
+
+using namespace tarm;
+
+namespace {
+
+const std::size_t RELAY_HIGH_WATERMARK = 4 * 1024 * 1024;
+const std::size_t RELAY_LOW_WATERMARK = 1024 * 1024;
+
+std::chrono::microseconds thread_cpu_time() {
+#if defined(TARM_IO_PLATFORM_LINUX) || defined(TARM_IO_PLATFORM_MACOSX)
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::microseconds(std::int64_t(time.tv_sec) * 1000000 + time.tv_nsec / 1000);
+#else
+    return std::chrono::microseconds(0);
+#endif
+}
+
+void run_proxy(bool use_pipe, std::uint16_t port, std::uint16_t sink_port, std::chrono::microseconds& cpu_time) {
+    io::EventLoop loop;
+
+    io::net::TcpClient* upstream = nullptr;
+
+    auto server = new io::net::TcpServer(loop);
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Proxy accept error: " << error << std::endl;
+                return;
+            }
+
+            // Nothing is read until upstream connection is established
+            client.pause_read();
+
+            upstream = new io::net::TcpClient(loop);
+            io::net::TcpConnectedClient* client_ptr = &client;
+            upstream->connect({"127.0.0.1", sink_port},
+                [use_pipe, client_ptr, server](io::net::TcpClient& upstream, const io::Error& error) {
+                    if (error) {
+                        std::cerr << "Upstream connect error: " << error << std::endl;
+                        return;
+                    }
+
+                    if (use_pipe) {
+                        const auto pipe_error = io::net::pipe_connections(*client_ptr, upstream,
+                            [client_ptr, &upstream, server](const io::Error& error) {
+                                if (error) {
+                                    std::cerr << "Pipe error: " << error << std::endl;
+                                }
+                                client_ptr->close();
+                                upstream.schedule_removal();
+                                server->schedule_removal();
+                            }
+                        );
+                        if (pipe_error) {
+                            std::cerr << "Pipe start error: " << pipe_error << std::endl;
+                        }
+                        return;
+                    }
+
+                    io::net::pause_read_on_backpressure(*client_ptr, upstream, RELAY_HIGH_WATERMARK, RELAY_LOW_WATERMARK);
+                    io::net::pause_read_on_backpressure(upstream, *client_ptr, RELAY_HIGH_WATERMARK, RELAY_LOW_WATERMARK);
+                    client_ptr->resume_read();
+                },
+                [client_ptr](io::net::TcpClient& upstream, const io::DataChunk& data, const io::Error& error) {
+                    client_ptr->send_data(data.buf, static_cast<std::uint32_t>(data.size));
+                },
+                [use_pipe, server](io::net::TcpClient& upstream, const io::Error& error) {
+                    if (!use_pipe) {
+                        server->schedule_removal();
+                        upstream.schedule_removal();
+                    }
+                }
+            );
+        },
+        [&upstream](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            upstream->send_data(data.buf, static_cast<std::uint32_t>(data.size));
+        },
+        [use_pipe, &upstream](io::net::TcpConnectedClient& client, const io::Error& error) {
+            // Source finished sending, FIN is passed on after queued data
+            if (!use_pipe && upstream && upstream->is_open()) {
+                upstream->shutdown();
+            }
+        }
+    );
+    if (listen_error) {
+        std::cerr << "Proxy listen error: " << listen_error << std::endl;
+        server->schedule_removal();
+    }
+
+    const auto cpu_start = thread_cpu_time();
+    loop.run();
+    cpu_time = thread_cpu_time() - cpu_start;
+}
+
+struct SourceState {
+    std::size_t buffer_size = 0;
+    std::size_t total_size = 0;
+    std::size_t sent_size = 0;
+    std::size_t completed_size = 0;
+};
+
+void send_next(io::net::TcpClient& client, SourceState& state, const std::shared_ptr<const char>& buffer) {
+    if (state.sent_size >= state.total_size) {
+        return;
+    }
+
+    state.sent_size += state.buffer_size;
+    client.send_data(buffer, static_cast<std::uint32_t>(state.buffer_size),
+        [&state, buffer](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Send error: " << error << std::endl;
+            }
+
+            state.completed_size += state.buffer_size;
+            if (state.completed_size >= state.total_size) {
+                client.shutdown();
+                return;
+            }
+
+            send_next(client, state, buffer);
+        }
+    );
+}
+
+void run(bool use_pipe, std::uint16_t port, std::size_t buffer_size, std::size_t total_size) {
+    io::EventLoop loop;
+
+    std::size_t received_size = 0;
+    io::benchmark::Stopwatch stopwatch;
+    std::chrono::microseconds wall_time(0);
+
+    auto sink = new io::net::TcpServer(loop);
+    const auto listen_error = sink->listen({"127.0.0.1", static_cast<std::uint16_t>(port + 1)},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            received_size += data.size;
+            if (received_size == total_size) {
+                wall_time = stopwatch.wall_time();
+            }
+        },
+        [sink](io::net::TcpConnectedClient& client, const io::Error& error) {
+            sink->schedule_removal();
+        }
+    );
+    if (listen_error) {
+        std::cerr << "Sink listen error: " << listen_error << std::endl;
+        return;
+    }
+
+    std::chrono::microseconds proxy_cpu_time(0);
+    std::thread proxy_thread([&]() {
+        run_proxy(use_pipe, port, static_cast<std::uint16_t>(port + 1), proxy_cpu_time);
+    });
+
+    // Buffers are reused after their sends are completed
+    const std::size_t BUFFERS_IN_FLIGHT = 4;
+    std::vector<std::shared_ptr<const char>> buffers;
+    for (std::size_t i = 0; i < BUFFERS_IN_FLIGHT; ++i) {
+        std::shared_ptr<char> buffer(new char[buffer_size], std::default_delete<char[]>());
+        std::memset(buffer.get(), 'a' + int(i), buffer_size);
+        buffers.push_back(buffer);
+    }
+
+    SourceState state;
+    state.buffer_size = buffer_size;
+    state.total_size = total_size;
+
+    // Proxy is given time to start listening
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto source = new io::net::TcpClient(loop);
+    source->connect({"127.0.0.1", port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Source connect error: " << error << std::endl;
+                return;
+            }
+
+            stopwatch.reset();
+            for (const auto& buffer : buffers) {
+                send_next(client, state, buffer);
+            }
+        },
+        nullptr,
+        [](io::net::TcpClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    loop.run();
+    proxy_thread.join();
+
+    const double gigabytes = received_size / 1024.0 / 1024.0 / 1024.0;
+    const std::string prefix = use_pipe ? "pipe_connections: " : "send_data relay: ";
+    io::benchmark::print_result(prefix + "throughput", gigabytes * 1024.0 / (wall_time.count() / 1000000.0), "MB/s");
+    io::benchmark::print_result(prefix + "proxy CPU time per GB", proxy_cpu_time.count() / 1000000.0 / gigabytes, "s");
+    if (received_size != total_size) {
+        io::benchmark::print_result(prefix + "missing bytes", double(total_size - received_size), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t buffer_size = io::benchmark::env_or_default("TARM_IO_BENCH_BUFFER_SIZE", 1024 * 1024);
+    const std::size_t total_size_mb = io::benchmark::env_or_default("TARM_IO_BENCH_TOTAL_SIZE_MB", 2048);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31545));
+
+    // Whole number of buffers
+    const std::size_t total_size = total_size_mb * 1024 * 1024 / buffer_size * buffer_size;
+
+    io::benchmark::print_header("TCP proxy over loopback (" + std::to_string(total_size_mb) + " MB)");
+    run(false, port, buffer_size, total_size);
+    run(true, port, buffer_size, total_size);
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Small request/response traffic over TCP with end send callbacks on both sides.
+// Clients and server share one loop, so allocations of both sides are counted. Allocations are measured
+// after warmup period, when caches of requests and buffers are already filled.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "Timer.h"
+#include "net/TcpClient.h"
+#include "net/TcpServer.h"
+
+#include <iostream>
+#include <memory>
+
+using namespace tarm;
+
+namespace {
+
+struct State {
+    bool measuring = false;
+    bool stop = false;
+    std::size_t requests = 0;
+    std::size_t end_sends = 0;
+    std::size_t errors = 0;
+    std::size_t allocations_at_start = 0;
+    std::size_t allocations_at_end = 0;
+    double wall_time_s = 0;
+};
+
+void start_connection(io::EventLoop& loop,
+                      State& state,
+                      std::uint16_t port,
+                      const std::shared_ptr<const char>& request,
+                      std::size_t message_size) {
+    const auto size = static_cast<std::uint32_t>(message_size);
+    auto received_bytes = std::make_shared<std::size_t>(0);
+
+    auto on_end_send = [&state](io::net::TcpClient&, const io::Error& error) {
+        if (error) {
+            ++state.errors;
+        }
+        ++state.end_sends;
+    };
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({"127.0.0.1", port},
+        [&state, request, size, on_end_send](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+                client.schedule_removal();
+                return;
+            }
+
+            client.delay_send(false);
+            client.send_data(request, size, on_end_send);
+        },
+        [&state, request, size, on_end_send, received_bytes](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            *received_bytes += data.size;
+            if (*received_bytes < size) {
+                return;
+            }
+
+            *received_bytes -= size;
+            if (state.measuring) {
+                ++state.requests;
+            }
+
+            if (state.stop) {
+                client.schedule_removal();
+            } else {
+                client.send_data(request, size, on_end_send);
+            }
+        }
+    );
+}
+
+void run(std::size_t connections_count, std::size_t message_size, std::size_t warmup_ms, std::size_t duration_ms, std::uint16_t port) {
+    io::EventLoop loop;
+    State state;
+
+    std::shared_ptr<const char> message(new char[message_size](), std::default_delete<const char[]>());
+
+    auto server = new io::net::TcpServer(loop);
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        [](io::net::TcpConnectedClient& client, const io::Error& error) {
+            if (!error) {
+                client.delay_send(false);
+            }
+        },
+        [&state, message, message_size](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            if (error) {
+                return;
+            }
+
+            // Each request is replied with a message of the same size, partial reads are replied partially
+            client.send_data(message, static_cast<std::uint32_t>(data.size),
+                [&state](io::net::TcpConnectedClient&, const io::Error& error) {
+                    if (error) {
+                        ++state.errors;
+                    }
+                    ++state.end_sends;
+                }
+            );
+        },
+        nullptr
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        return;
+    }
+
+    for (std::size_t i = 0; i < connections_count; ++i) {
+        start_connection(loop, state, port, message, message_size);
+    }
+
+    io::benchmark::Stopwatch stopwatch;
+
+    auto timer = new io::Timer(loop);
+    timer->start(warmup_ms, [&](io::Timer& timer) {
+        state.measuring = true;
+        state.allocations_at_start = io::benchmark::allocations_count();
+        stopwatch.reset();
+
+        timer.start(duration_ms, [&](io::Timer& timer) {
+            state.measuring = false;
+            state.stop = true;
+            state.allocations_at_end = io::benchmark::allocations_count();
+            state.wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+            timer.schedule_removal();
+            server->schedule_removal();
+        });
+    });
+
+    loop.run();
+
+    const double requests = static_cast<double>(state.requests ? state.requests : 1);
+    io::benchmark::print_result("requests/s", state.requests / state.wall_time_s, "");
+    io::benchmark::print_result("allocations per request",
+                                (state.allocations_at_end - state.allocations_at_start) / requests, "");
+    if (state.errors) {
+        io::benchmark::print_result("errors", double(state.errors), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t connections = io::benchmark::env_or_default("TARM_IO_BENCH_CONNECTIONS", 16);
+    const std::size_t message_size = io::benchmark::env_or_default("TARM_IO_BENCH_MESSAGE_SIZE", 32);
+    const std::size_t warmup_ms = io::benchmark::env_or_default("TARM_IO_BENCH_WARMUP_MS", 200);
+    const std::size_t duration_ms = io::benchmark::env_or_default("TARM_IO_BENCH_DURATION_MS", 1000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31542));
+
+    io::benchmark::print_header("TCP request/response (" + std::to_string(connections) + " connections, " +
+                                std::to_string(message_size) + " bytes messages)");
+    run(connections, message_size, warmup_ms, duration_ms, port);
+
+    return 0;
+}
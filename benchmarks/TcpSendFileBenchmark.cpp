@@ -0,0 +1,167 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Serving of a large file over loopback TCP, File::read with send_data of each chunk versus send_file.
+// Server is executed in a separate thread, client receives the file and drops data. File is created
+// before measurements and is read once to warm up page cache, so disk is not involved.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "fs/File.h"
+#include "net/TcpClient.h"
+#include "net/TcpServer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+bool create_file(const std::string& path, std::size_t size) {
+    std::ofstream ofile(path, std::ios::binary);
+    if (ofile.fail()) {
+        return false;
+    }
+
+    std::vector<char> block(1024 * 1024);
+    for (std::size_t i = 0; i < block.size(); ++i) {
+        block[i] = static_cast<char>(i % 251);
+    }
+
+    for (std::size_t written = 0; written < size; written += block.size()) {
+        ofile.write(block.data(), static_cast<std::streamsize>(std::min(block.size(), size - written)));
+    }
+
+    return !ofile.fail();
+}
+
+void warm_up_page_cache(const std::string& path) {
+    std::ifstream ifile(path, std::ios::binary);
+    std::vector<char> block(1024 * 1024);
+    while (ifile.read(block.data(), static_cast<std::streamsize>(block.size()))) {
+    }
+}
+
+void serve_file(io::net::TcpConnectedClient& client, io::fs::File& file, bool use_send_file, std::size_t file_size) {
+    if (use_send_file) {
+        client.send_file(file, 0, file_size, [](io::net::TcpConnectedClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Send file error: " << error << std::endl;
+            }
+        });
+        return;
+    }
+
+    // Next chunk is read when one of read buffers of the file is released after send
+    file.read([&client](io::fs::File& file, const io::DataChunk& data, const io::Error& error) {
+        if (error) {
+            std::cerr << "Read error: " << error << std::endl;
+            return;
+        }
+
+        client.send_data(data.buf, static_cast<std::uint32_t>(data.size));
+    });
+}
+
+void run(bool use_send_file, const std::string& path, std::size_t file_size, std::uint16_t port) {
+    io::EventLoop server_loop;
+
+    auto server = new io::net::TcpServer(server_loop);
+    auto file = new io::fs::File(server_loop);
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            if (error) {
+                return;
+            }
+
+            file->open(path, [&client, use_send_file, file_size](io::fs::File& file, const io::Error& error) {
+                if (error) {
+                    std::cerr << "Open error: " << error << std::endl;
+                    return;
+                }
+
+                serve_file(client, file, use_send_file, file_size);
+            });
+        },
+        nullptr,
+        nullptr
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        return;
+    }
+
+    std::thread server_thread([&server_loop]() {
+        server_loop.run();
+    });
+
+    io::EventLoop client_loop;
+    std::size_t received_bytes = 0;
+
+    io::benchmark::Stopwatch stopwatch;
+
+    auto client = new io::net::TcpClient(client_loop);
+    client->connect({"127.0.0.1", port},
+        [](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Connect error: " << error << std::endl;
+                client.schedule_removal();
+            }
+        },
+        [&received_bytes, file_size](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            received_bytes += data.size;
+            if (received_bytes >= file_size) {
+                client.schedule_removal();
+            }
+        }
+    );
+
+    client_loop.run();
+    const auto wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+    const auto cpu_usage = stopwatch.cpu_usage();
+
+    server_loop.execute_on_loop_thread([server, file](io::EventLoop&) {
+        server->schedule_removal();
+        file->schedule_removal();
+    });
+    server_thread.join();
+
+    const std::string prefix = use_send_file ? "send_file: " : "read + send_data: ";
+    io::benchmark::print_result(prefix + "throughput", received_bytes / wall_time_s / 1024.0 / 1024.0, "MB/s");
+    io::benchmark::print_result(prefix + "process CPU usage", cpu_usage * 100.0, "%");
+    if (received_bytes != file_size) {
+        io::benchmark::print_result(prefix + "missing bytes", double(file_size - received_bytes), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t file_size_mb = io::benchmark::env_or_default("TARM_IO_BENCH_FILE_SIZE_MB", 1024);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31543));
+
+    const std::size_t file_size = file_size_mb * 1024 * 1024;
+    const std::string path = "tarm_io_send_file_benchmark.bin";
+    if (!create_file(path, file_size)) {
+        std::cerr << "Failed to create file " << path << std::endl;
+        return 1;
+    }
+    warm_up_page_cache(path);
+
+    io::benchmark::print_header("TCP file serving (" + std::to_string(file_size_mb) + " MB file)");
+    run(false, path, file_size, port);
+    run(true, path, file_size, port);
+
+    std::remove(path.c_str());
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Bulk TCP transfer of large buffers with regular and zero-copy (MSG_ZEROCOPY) sends, CPU time per sent GB.
+// Sender keeps a fixed number of buffers in flight, buffer is reused after its EndSendCallback.
+// Usage:
+//   tcp_zero_copy_benchmark                    - sender and receiver in one process over loopback
+//   tcp_zero_copy_benchmark receiver           - only receiver, listens on all interfaces
+//   tcp_zero_copy_benchmark sender <address>   - only sender, for example to the other end of veth pair
+// Note: on loopback kernel copies data of zero-copy sends anyway, so there is no gain there.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "net/TcpClient.h"
+#include "net/TcpServer.h"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+struct SenderState {
+    std::size_t buffer_size = 0;
+    std::size_t total_size = 0;
+    std::size_t sent_size = 0;
+    std::size_t completed_size = 0;
+    std::size_t errors = 0;
+};
+
+void send_next(io::net::TcpClient& client, SenderState& state, const std::shared_ptr<const char>& buffer) {
+    if (state.sent_size >= state.total_size) {
+        return;
+    }
+
+    state.sent_size += state.buffer_size;
+    client.send_data(buffer, static_cast<std::uint32_t>(state.buffer_size),
+        [&state, buffer](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+            }
+
+            state.completed_size += state.buffer_size;
+            if (state.completed_size >= state.total_size) {
+                client.schedule_removal();
+                return;
+            }
+
+            send_next(client, state, buffer);
+        }
+    );
+}
+
+void run_sender(bool zero_copy,
+                const std::string& address,
+                std::uint16_t port,
+                std::size_t buffer_size,
+                std::size_t buffers_in_flight,
+                std::size_t total_size) {
+    io::EventLoop loop;
+
+    SenderState state;
+    state.buffer_size = buffer_size;
+    state.total_size = total_size;
+
+    std::vector<std::shared_ptr<const char>> buffers;
+    for (std::size_t i = 0; i < buffers_in_flight; ++i) {
+        std::shared_ptr<char> buffer(new char[buffer_size], std::default_delete<char[]>());
+        std::memset(buffer.get(), 'a' + int(i % 26), buffer_size);
+        buffers.push_back(buffer);
+    }
+
+    io::benchmark::Stopwatch stopwatch;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({address, port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Connect error: " << error << std::endl;
+                ++state.errors;
+                return;
+            }
+
+            const auto zero_copy_error = client.zero_copy_send(zero_copy, buffer_size);
+            if (zero_copy_error) {
+                std::cerr << "Zero-copy send error: " << zero_copy_error << std::endl;
+            }
+
+            stopwatch.reset();
+            for (const auto& buffer : buffers) {
+                send_next(client, state, buffer);
+            }
+        },
+        nullptr
+    );
+
+    loop.run();
+
+    const double gigabytes = state.completed_size / 1024.0 / 1024.0 / 1024.0;
+    const double wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+    const double cpu_time_s = stopwatch.cpu_time().count() / 1000000.0;
+
+    const std::string prefix = std::string("zero-copy ") + (zero_copy ? "on" : "off") + ": ";
+    io::benchmark::print_result(prefix + "throughput", gigabytes * 1024.0 / wall_time_s, "MB/s");
+    io::benchmark::print_result(prefix + "CPU time per GB", cpu_time_s / gigabytes, "s");
+    if (state.errors) {
+        io::benchmark::print_result(prefix + "errors", double(state.errors), "");
+    }
+}
+
+// Receiver drops data, it exits when 'connections_count' connections are closed (0 - never)
+void run_receiver(io::EventLoop& loop, const std::string& address, std::uint16_t port, std::size_t connections_count) {
+    auto closed_connections = std::make_shared<std::size_t>(0);
+
+    auto server = new io::net::TcpServer(loop);
+    const auto listen_error = server->listen({address, port},
+        nullptr,
+        [](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+        },
+        [closed_connections, connections_count, server](io::net::TcpConnectedClient& client, const io::Error& error) {
+            if (++*closed_connections == connections_count) {
+                server->schedule_removal();
+            }
+        }
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        server->schedule_removal();
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t buffer_size = io::benchmark::env_or_default("TARM_IO_BENCH_BUFFER_SIZE", 1024 * 1024);
+    const std::size_t buffers_in_flight = io::benchmark::env_or_default("TARM_IO_BENCH_BUFFERS_IN_FLIGHT", 8);
+    const std::size_t total_size_mb = io::benchmark::env_or_default("TARM_IO_BENCH_TOTAL_SIZE_MB", 4096);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31544));
+
+    const std::size_t total_size = total_size_mb * 1024 * 1024;
+    const std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "receiver") {
+        io::EventLoop loop;
+        run_receiver(loop, "0.0.0.0", port, 0);
+        loop.run();
+        return 0;
+    }
+
+    if (mode == "sender") {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0] << " sender <address>" << std::endl;
+            return 1;
+        }
+
+        io::benchmark::print_header("TCP bulk send to " + std::string(argv[2]) + " (" +
+                                    std::to_string(buffer_size) + " bytes buffers)");
+        run_sender(false, argv[2], port, buffer_size, buffers_in_flight, total_size);
+        run_sender(true, argv[2], port, buffer_size, buffers_in_flight, total_size);
+        return 0;
+    }
+
+    io::EventLoop receiver_loop;
+    run_receiver(receiver_loop, "127.0.0.1", port, 2);
+    std::thread receiver_thread([&receiver_loop]() {
+        receiver_loop.run();
+    });
+
+    io::benchmark::print_header("TCP bulk send over loopback (" + std::to_string(buffer_size) + " bytes buffers)");
+    run_sender(false, "127.0.0.1", port, buffer_size, buffers_in_flight, total_size);
+    run_sender(true, "127.0.0.1", port, buffer_size, buffers_in_flight, total_size);
+
+    receiver_thread.join();
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Bulk TLS transfer over loopback with encryption and decryption by OpenSSL. Server is executed in a separate
+// thread and sends data from memory by messages of fixed size, client receives and drops it. Besides throughput
+// and CPU time, number of allocations (operator new) per transferred megabyte is printed for the whole process,
+// it shows the cost of intermediate buffers between OpenSSL and the network layer.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "net/Tls.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace tarm;
+
+namespace {
+
+const std::size_t SENDS_IN_FLIGHT = 4;
+
+struct Sender {
+    std::shared_ptr<const char> buffer;
+    std::uint32_t message_size = 0;
+    std::size_t remaining = 0;
+
+    void send_next(io::net::TlsConnectedClient& client) {
+        if (remaining == 0) {
+            return;
+        }
+
+        const auto size = static_cast<std::uint32_t>(std::min<std::size_t>(remaining, message_size));
+        remaining -= size;
+        client.send_data(buffer, size, [this](io::net::TlsConnectedClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Send error: " << error << std::endl;
+                return;
+            }
+
+            send_next(client);
+        });
+    }
+};
+
+void run(std::uint32_t message_size,
+         const std::string& cert_path,
+         const std::string& key_path,
+         std::size_t data_size,
+         std::uint16_t port) {
+    io::EventLoop server_loop;
+
+    Sender sender;
+    sender.buffer.reset(new char[message_size](), std::default_delete<char[]>());
+    sender.message_size = message_size;
+    sender.remaining = data_size;
+
+    auto server = new io::net::TlsServer(server_loop, cert_path, key_path);
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        [&sender](io::net::TlsConnectedClient& client, const io::Error& error) {
+            if (error) {
+                return;
+            }
+
+            for (std::size_t i = 0; i < SENDS_IN_FLIGHT; ++i) {
+                sender.send_next(client);
+            }
+        },
+        nullptr
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        server->schedule_removal();
+        server_loop.run();
+        return;
+    }
+
+    std::thread server_thread([&server_loop]() {
+        server_loop.run();
+    });
+
+    io::EventLoop client_loop;
+    std::size_t received_bytes = 0;
+
+    io::benchmark::Stopwatch stopwatch;
+    const auto allocations_before = io::benchmark::allocations_count();
+
+    auto client = new io::net::TlsClient(client_loop);
+    client->connect({"127.0.0.1", port},
+        [](io::net::TlsClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Connect error: " << error << std::endl;
+                client.schedule_removal();
+            }
+        },
+        [&received_bytes, data_size](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+            received_bytes += data.size;
+            if (received_bytes >= data_size) {
+                client.close();
+            }
+        },
+        [](io::net::TlsClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    client_loop.run();
+    const auto wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+    const auto cpu_time_us = stopwatch.cpu_time().count();
+    const auto allocations = io::benchmark::allocations_count() - allocations_before;
+
+    server_loop.execute_on_loop_thread([server](io::EventLoop&) {
+        server->schedule_removal();
+    });
+    server_thread.join();
+
+    const double received_mb = received_bytes / 1024.0 / 1024.0;
+    const std::string prefix = std::to_string(message_size / 1024) + " KB messages: ";
+    io::benchmark::print_result(prefix + "throughput", received_mb / wall_time_s, "MB/s");
+    io::benchmark::print_result(prefix + "CPU time per MB", cpu_time_us / received_mb, "us");
+    io::benchmark::print_result(prefix + "allocations per MB", allocations / received_mb, "");
+    if (received_bytes != data_size) {
+        io::benchmark::print_result(prefix + "missing bytes", double(data_size - received_bytes), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t data_size_mb = io::benchmark::env_or_default("TARM_IO_BENCH_DATA_SIZE_MB", 512);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31553));
+
+    const std::string data_dir = TARM_IO_TESTS_DATA_DIR;
+    const std::string cert_path = data_dir + "/certificate.pem";
+    const std::string key_path = data_dir + "/key.pem";
+
+    const std::size_t data_size = data_size_mb * 1024 * 1024;
+
+    io::benchmark::print_header("TLS bulk transfer (" + std::to_string(data_size_mb) + " MB)");
+    for (std::uint32_t message_size : {4 * 1024, 16 * 1024, 256 * 1024}) {
+        run(message_size, cert_path, key_path, data_size, port);
+    }
+
+    return 0;
+}
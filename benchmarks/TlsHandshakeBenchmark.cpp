@@ -0,0 +1,151 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Sequential TLS connections over loopback, client and server share one loop. Each connection performs
+// handshake, exchanges one small message (TLS 1.3 session tickets are received after the handshake) and is
+// closed. Handshakes are full or resumed using session of the previous connection, either from the server
+// session cache or from the session ticket.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "net/Tls.h"
+
+#include <iostream>
+#include <string>
+
+using namespace tarm;
+
+namespace {
+
+enum class Mode {
+    FULL,
+    SESSION_CACHE,
+    SESSION_TICKETS
+};
+
+std::string mode_name(Mode mode) {
+    switch (mode) {
+        case Mode::FULL:
+            return "full handshake";
+        case Mode::SESSION_CACHE:
+            return "resumed from session cache";
+        case Mode::SESSION_TICKETS:
+            return "resumed by session ticket";
+    }
+
+    return "";
+}
+
+struct State {
+    io::EventLoop* loop = nullptr;
+    io::net::TlsServer* server = nullptr;
+    Mode mode = Mode::FULL;
+    std::uint16_t port = 0;
+    std::size_t connections_left = 0;
+    std::size_t resumed_count = 0;
+    io::net::TlsSession session;
+};
+
+void connect_next(State& state) {
+    if (state.connections_left == 0) {
+        state.server->schedule_removal();
+        return;
+    }
+    --state.connections_left;
+
+    auto client = new io::net::TlsClient(*state.loop);
+    if (state.mode != Mode::FULL) {
+        client->set_session(state.session);
+    }
+
+    client->connect({"127.0.0.1", state.port},
+        [](io::net::TlsClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Connect error: " << error << std::endl;
+                return;
+            }
+
+            client.send_data("x");
+        },
+        [](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+            client.close();
+        },
+        [&state](io::net::TlsClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Close error: " << error << std::endl;
+            }
+
+            state.resumed_count += client.is_session_resumed() ? 1 : 0;
+            state.session = client.session();
+            client.schedule_removal();
+            connect_next(state);
+        }
+    );
+}
+
+void run(Mode mode, const std::string& cert_path, const std::string& key_path, std::uint16_t port, std::size_t connections_count) {
+    io::EventLoop loop;
+
+    auto server = new io::net::TlsServer(loop, cert_path, key_path);
+    if (mode == Mode::SESSION_CACHE) {
+        server->set_session_tickets(false);
+    } else if (mode == Mode::SESSION_TICKETS) {
+        server->set_session_cache(0, 5 * 60 * 1000);
+    } else {
+        server->set_session_cache(0, 5 * 60 * 1000);
+        server->set_session_tickets(false);
+    }
+
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        nullptr,
+        [](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            client.send_data(data.buf, static_cast<std::uint32_t>(data.size));
+        }
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        server->schedule_removal();
+        loop.run();
+        return;
+    }
+
+    State state;
+    state.loop = &loop;
+    state.server = server;
+    state.mode = mode;
+    state.port = port;
+    state.connections_left = connections_count;
+
+    io::benchmark::Stopwatch stopwatch;
+    connect_next(state);
+    loop.run();
+
+    const auto wall_time = stopwatch.wall_time();
+    const auto cpu_time = stopwatch.cpu_time();
+
+    const std::string prefix = mode_name(mode) + ": ";
+    io::benchmark::print_result(prefix + "handshakes per second", connections_count / (wall_time.count() / 1000000.0), "");
+    io::benchmark::print_result(prefix + "CPU time per handshake", double(cpu_time.count()) / connections_count, "us");
+    io::benchmark::print_result(prefix + "resumed", double(state.resumed_count), "");
+}
+
+} // namespace
+
+int main() {
+    const std::size_t connections_count = io::benchmark::env_or_default("TARM_IO_BENCH_CONNECTIONS", 2000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31547));
+
+    const std::string data_dir = TARM_IO_TESTS_DATA_DIR;
+    const std::string cert_path = data_dir + "/certificate.pem";
+    const std::string key_path = data_dir + "/key.pem";
+
+    io::benchmark::print_header("TLS handshakes over loopback (" + std::to_string(connections_count) + " connections)");
+    run(Mode::FULL, cert_path, key_path, port, connections_count);
+    run(Mode::SESSION_CACHE, cert_path, key_path, port, connections_count);
+    run(Mode::SESSION_TICKETS, cert_path, key_path, port, connections_count);
+
+    return 0;
+}
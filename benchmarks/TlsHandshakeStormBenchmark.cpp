@@ -0,0 +1,263 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Data path latency of established TLS connections while the same server accepts a storm of new ones.
+// Server has its own loop and thread. Probe connections send small message each millisecond and measure
+// time until echo is received. Storm thread opens new connections with a fixed rate, each one is closed right
+// after the handshake. Server performs handshakes on the loop thread or in the thread pool
+// (TlsServer::set_handshake_offload).
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "Timer.h"
+#include "net/Tls.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+const std::size_t PROBES_COUNT = 8;
+const std::size_t PROBE_MESSAGE_SIZE = 64;
+const std::size_t MAX_STORM_CONNECTIONS_IN_FLIGHT = 256;
+
+struct LatencyStats {
+    std::vector<std::uint64_t> samples_ns;
+
+    void print(const std::string& prefix) {
+        if (samples_ns.empty()) {
+            return;
+        }
+
+        std::sort(samples_ns.begin(), samples_ns.end());
+        std::uint64_t sum = 0;
+        for (auto v : samples_ns) {
+            sum += v;
+        }
+
+        io::benchmark::print_result(prefix + "probe latency avg", double(sum) / samples_ns.size() / 1000.0, "us");
+        io::benchmark::print_result(prefix + "probe latency p99", samples_ns[samples_ns.size() * 99 / 100] / 1000.0, "us");
+        io::benchmark::print_result(prefix + "probe latency max", samples_ns.back() / 1000.0, "us");
+    }
+};
+
+void run_server(bool offload,
+                const std::string& cert_path,
+                const std::string& key_path,
+                std::uint16_t port,
+                std::promise<std::pair<io::EventLoop*, io::net::TlsServer*>>& started) {
+    io::EventLoop loop;
+
+    auto server = new io::net::TlsServer(loop, cert_path, key_path);
+    server->set_handshake_offload(offload);
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        nullptr,
+        [](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            client.send_data(data.buf, static_cast<std::uint32_t>(data.size));
+        }
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        server->schedule_removal();
+        started.set_value({nullptr, nullptr});
+        loop.run();
+        return;
+    }
+
+    started.set_value({&loop, server});
+    loop.run();
+}
+
+void run_storm(std::uint16_t port, std::size_t rate, const std::atomic<bool>& stop, std::size_t& handshakes_count) {
+    io::EventLoop loop;
+
+    std::size_t started_count = 0;
+    std::size_t in_flight_count = 0;
+    const auto start_time = std::chrono::steady_clock::now();
+
+    auto timer = new io::Timer(loop);
+    timer->start(1, 1, [&](io::Timer& timer) {
+        if (stop) {
+            timer.schedule_removal();
+            return;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+        const std::size_t target_count = static_cast<std::size_t>(elapsed.count() * rate / 1000000);
+        while (started_count < target_count && in_flight_count < MAX_STORM_CONNECTIONS_IN_FLIGHT) {
+            ++started_count;
+            ++in_flight_count;
+
+            auto client = new io::net::TlsClient(loop);
+            client->connect({"127.0.0.1", port},
+                [&](io::net::TlsClient& client, const io::Error& error) {
+                    if (error) {
+                        --in_flight_count;
+                        client.schedule_removal();
+                        return;
+                    }
+
+                    ++handshakes_count;
+                    client.close();
+                },
+                nullptr,
+                [&](io::net::TlsClient& client, const io::Error& error) {
+                    --in_flight_count;
+                    client.schedule_removal();
+                }
+            );
+        }
+
+        // Rate which can not be reached is not accumulated
+        if (started_count < target_count) {
+            started_count = target_count;
+        }
+    });
+
+    loop.run();
+}
+
+void run(bool offload,
+         std::size_t storm_rate,
+         const std::string& cert_path,
+         const std::string& key_path,
+         std::uint16_t port,
+         std::size_t duration_ms) {
+    std::promise<std::pair<io::EventLoop*, io::net::TlsServer*>> server_started;
+    auto server_future = server_started.get_future();
+    std::thread server_thread([&]() {
+        run_server(offload, cert_path, key_path, port, server_started);
+    });
+
+    const auto server = server_future.get();
+    if (server.first == nullptr) {
+        server_thread.join();
+        return;
+    }
+
+    io::EventLoop loop;
+
+    struct Probe {
+        io::net::TlsClient* client = nullptr;
+        bool waiting = false;
+        std::size_t received_size = 0;
+        std::chrono::steady_clock::time_point sent_time;
+    };
+    std::vector<Probe> probes(PROBES_COUNT);
+
+    LatencyStats stats;
+    std::atomic<bool> stop(false);
+    std::size_t handshakes_count = 0;
+    std::thread storm_thread;
+    io::benchmark::Stopwatch stopwatch;
+    std::size_t connected_count = 0;
+
+    const std::string message(PROBE_MESSAGE_SIZE, 'p');
+
+    auto start_probing = [&]() {
+        if (storm_rate) {
+            storm_thread = std::thread([&]() {
+                run_storm(port, storm_rate, stop, handshakes_count);
+            });
+        }
+
+        stopwatch.reset();
+
+        auto timer = new io::Timer(loop);
+        timer->start(1, 1, [&](io::Timer& timer) {
+            if (stopwatch.wall_time() >= std::chrono::milliseconds(duration_ms)) {
+                stop = true;
+                timer.schedule_removal();
+                for (auto& probe : probes) {
+                    probe.client->close();
+                }
+                return;
+            }
+
+            for (auto& probe : probes) {
+                if (!probe.waiting) {
+                    probe.waiting = true;
+                    probe.received_size = 0;
+                    probe.sent_time = std::chrono::steady_clock::now();
+                    probe.client->send_data(message);
+                }
+            }
+        });
+    };
+
+    for (auto& probe : probes) {
+        Probe* probe_ptr = &probe;
+        probe.client = new io::net::TlsClient(loop);
+        probe.client->connect({"127.0.0.1", port},
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                if (error) {
+                    std::cerr << "Probe connect error: " << error << std::endl;
+                    return;
+                }
+
+                if (++connected_count == PROBES_COUNT) {
+                    start_probing();
+                }
+            },
+            [&stats, probe_ptr](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+                probe_ptr->received_size += data.size;
+                if (probe_ptr->received_size == PROBE_MESSAGE_SIZE) {
+                    const auto latency = std::chrono::steady_clock::now() - probe_ptr->sent_time;
+                    stats.samples_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+                    probe_ptr->waiting = false;
+                }
+            },
+            [](io::net::TlsClient& client, const io::Error& error) {
+                client.schedule_removal();
+            }
+        );
+    }
+
+    loop.run();
+    const auto wall_time = stopwatch.wall_time();
+
+    if (storm_thread.joinable()) {
+        storm_thread.join();
+    }
+
+    server.first->execute_on_loop_thread([&server](io::EventLoop&) {
+        server.second->schedule_removal();
+    });
+    server_thread.join();
+
+    std::string prefix = storm_rate ? (offload ? "storm, offloaded handshakes: " : "storm, loop thread handshakes: ") : "no storm: ";
+    if (storm_rate) {
+        io::benchmark::print_result(prefix + "handshakes per second", handshakes_count / (wall_time.count() / 1000000.0), "");
+    }
+    stats.print(prefix);
+}
+
+} // namespace
+
+int main() {
+    const std::size_t storm_rate = io::benchmark::env_or_default("TARM_IO_BENCH_HANDSHAKES_RATE", 5000);
+    const std::size_t duration_ms = io::benchmark::env_or_default("TARM_IO_BENCH_DURATION_MS", 3000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31549));
+
+    const std::string data_dir = TARM_IO_TESTS_DATA_DIR;
+    const std::string cert_path = data_dir + "/certificate.pem";
+    const std::string key_path = data_dir + "/key.pem";
+
+    io::benchmark::print_header("TLS data path latency during handshake storm (" + std::to_string(storm_rate) + " handshakes/s target)");
+    run(false, 0, cert_path, key_path, port, duration_ms);
+    run(false, storm_rate, cert_path, key_path, port, duration_ms);
+    run(true, storm_rate, cert_path, key_path, port, duration_ms);
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Memory usage of idle TLS connections by default, with shared read buffer of the loop and with released
+// buffers (TlsServer::set_release_idle_buffers and TlsClient::set_release_idle_buffers) in addition to it.
+// Each connection makes handshake and one request/response exchange, so OpenSSL and receive buffers are allocated
+// on both ends, and then stays idle. Growth of process RSS is divided by number of connections (both ends are
+// in this process). Number of connections is limited by the limit of open files (2 descriptors per connection).
+// Each mode is measured in a separate process on Linux, so memory freed by one run is not reused by the other.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "net/Tls.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(TARM_IO_PLATFORM_LINUX) || defined(TARM_IO_PLATFORM_MACOSX)
+    #include <sys/resource.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+using namespace tarm;
+
+namespace {
+
+// Clients are connected in batches to not overflow listen backlog
+const std::size_t CONNECT_BATCH_SIZE = 256;
+const int LISTEN_BACKLOG_SIZE = 1024;
+// Connections per listening port, this keeps number of used ephemeral ports per destination in bounds
+const std::size_t CONNECTIONS_PER_PORT = 20000;
+
+std::size_t max_connections_by_files_limit() {
+#if defined(TARM_IO_PLATFORM_LINUX) || defined(TARM_IO_PLATFORM_MACOSX)
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return 0;
+    }
+
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+
+    // Reserving some descriptors for listening sockets and the loop itself
+    return limit.rlim_cur > 256 ? static_cast<std::size_t>(limit.rlim_cur - 256) / 2 : 0;
+#else
+    return 0;
+#endif
+}
+
+enum class Mode {
+    DEFAULT,
+    SHARED_READ_BUFFER,
+    RELEASE_IDLE_BUFFERS
+};
+
+std::string mode_name(Mode mode) {
+    switch (mode) {
+        case Mode::DEFAULT:
+            return "default";
+        case Mode::SHARED_READ_BUFFER:
+            return "shared read buffer";
+        case Mode::RELEASE_IDLE_BUFFERS:
+            return "release idle buffers";
+    }
+
+    return "";
+}
+
+struct State {
+    bool release_idle_buffers = false;
+    std::size_t connections_count = 0;
+    std::size_t started = 0;
+    std::size_t completed = 0;
+    std::size_t errors = 0;
+    std::size_t rss_after = 0;
+    std::uint16_t base_port = 0;
+    std::size_t ports_count = 0;
+    std::vector<io::net::TlsClient*> clients;
+    std::vector<io::net::TlsServer*> servers;
+};
+
+void start_batch(io::EventLoop& loop, State& state);
+
+void on_exchange_complete(io::EventLoop& loop, State& state) {
+    ++state.completed;
+    if (state.completed != state.started) {
+        return;
+    }
+
+    if (state.started < state.connections_count) {
+        start_batch(loop, state);
+        return;
+    }
+
+    state.rss_after = io::benchmark::resident_memory_size();
+
+    for (auto client : state.clients) {
+        client->schedule_removal();
+    }
+    for (auto server : state.servers) {
+        server->schedule_removal();
+    }
+}
+
+void start_batch(io::EventLoop& loop, State& state) {
+    const std::size_t batch_end = std::min(state.started + CONNECT_BATCH_SIZE, state.connections_count);
+    for (; state.started < batch_end; ++state.started) {
+        const auto port = static_cast<std::uint16_t>(state.base_port + state.started % state.ports_count);
+
+        auto client = new io::net::TlsClient(loop);
+        client->set_release_idle_buffers(state.release_idle_buffers);
+        state.clients.push_back(client);
+        client->connect({"127.0.0.1", port},
+            [&loop, &state](io::net::TlsClient& client, const io::Error& error) {
+                if (error) {
+                    ++state.errors;
+                    on_exchange_complete(loop, state);
+                    return;
+                }
+
+                client.send_data("?", 1);
+            },
+            [&loop, &state](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+                on_exchange_complete(loop, state);
+            }
+        );
+    }
+}
+
+void run(Mode mode,
+         const std::string& cert_path,
+         const std::string& key_path,
+         std::size_t connections_count,
+         std::uint16_t base_port) {
+    io::EventLoop loop;
+    loop.set_shared_read_buffer(mode != Mode::DEFAULT);
+
+    State state;
+    state.release_idle_buffers = mode == Mode::RELEASE_IDLE_BUFFERS;
+    state.connections_count = connections_count;
+    state.base_port = base_port;
+    state.ports_count = (connections_count + CONNECTIONS_PER_PORT - 1) / CONNECTIONS_PER_PORT;
+    state.clients.reserve(connections_count);
+
+    for (std::size_t i = 0; i < state.ports_count; ++i) {
+        auto server = new io::net::TlsServer(loop, cert_path, key_path);
+        server->set_release_idle_buffers(state.release_idle_buffers);
+        const auto listen_error = server->listen({"127.0.0.1", static_cast<std::uint16_t>(base_port + i)},
+            nullptr,
+            [](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+                client.send_data("!", 1);
+            },
+            nullptr,
+            LISTEN_BACKLOG_SIZE
+        );
+        if (listen_error) {
+            std::cerr << "Listen error: " << listen_error << std::endl;
+            server->schedule_removal();
+            for (auto server : state.servers) {
+                server->schedule_removal();
+            }
+            loop.run();
+            return;
+        }
+
+        state.servers.push_back(server);
+    }
+
+    const auto rss_before = io::benchmark::resident_memory_size();
+
+    start_batch(loop, state);
+    loop.run();
+
+    const std::string prefix = mode_name(mode) + ": ";
+    if (rss_before && state.rss_after) {
+        const double rss_growth = double(state.rss_after) - double(rss_before);
+        io::benchmark::print_result(prefix + "RSS per connection", rss_growth / double(connections_count) / 1024.0, "KB");
+        io::benchmark::print_result(prefix + "RSS growth", rss_growth / 1024.0 / 1024.0, "MB");
+    } else {
+        io::benchmark::print_result(prefix + "RSS is not available", 0, "");
+    }
+    if (state.errors) {
+        io::benchmark::print_result(prefix + "errors", double(state.errors), "");
+    }
+}
+
+void run_isolated(Mode mode,
+                  const std::string& cert_path,
+                  const std::string& key_path,
+                  std::size_t connections_count,
+                  std::uint16_t base_port) {
+#if defined(TARM_IO_PLATFORM_LINUX) || defined(TARM_IO_PLATFORM_MACOSX)
+    std::cout.flush();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        run(mode, cert_path, key_path, connections_count, base_port);
+        std::cout.flush();
+        _exit(0);
+    } else if (pid > 0) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return;
+    }
+#endif
+
+    run(mode, cert_path, key_path, connections_count, base_port);
+}
+
+} // namespace
+
+int main() {
+    const std::size_t requested_connections = io::benchmark::env_or_default("TARM_IO_BENCH_CONNECTIONS", 10000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31650));
+
+    const std::string data_dir = TARM_IO_TESTS_DATA_DIR;
+    const std::string cert_path = data_dir + "/certificate.pem";
+    const std::string key_path = data_dir + "/key.pem";
+
+    std::size_t connections = requested_connections;
+    const std::size_t max_connections = max_connections_by_files_limit();
+    if (max_connections && connections > max_connections) {
+        std::cout << "Number of connections is limited to " << max_connections
+                  << " by the limit of open files" << std::endl;
+        connections = max_connections;
+    }
+
+    io::benchmark::print_header("TLS idle connections memory (" + std::to_string(connections) + " connections)");
+    for (auto mode : {Mode::DEFAULT, Mode::SHARED_READ_BUFFER, Mode::RELEASE_IDLE_BUFFERS}) {
+        run_isolated(mode, cert_path, key_path, connections, port);
+    }
+
+    return 0;
+}
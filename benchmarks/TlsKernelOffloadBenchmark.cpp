@@ -0,0 +1,232 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// Bulk TLS transmit over loopback, encryption by OpenSSL (memory BIOs) versus kernel TLS (TlsServer::set_kernel_tls).
+// Server is executed in a separate thread and sends data from memory with send_data or a file with send_file.
+// Client decrypts data with OpenSSL in both cases and drops it. CPU usage is measured for the whole process.
+// If the kernel does not support TLS offload (module 'tls' is not loaded), only OpenSSL results are printed.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "fs/File.h"
+#include "net/Tls.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+const std::uint32_t SEND_CHUNK_SIZE = 256 * 1024;
+const std::size_t SENDS_IN_FLIGHT = 4;
+
+bool create_file(const std::string& path, std::size_t size) {
+    std::ofstream ofile(path, std::ios::binary);
+    if (ofile.fail()) {
+        return false;
+    }
+
+    std::vector<char> block(1024 * 1024);
+    for (std::size_t i = 0; i < block.size(); ++i) {
+        block[i] = static_cast<char>(i % 251);
+    }
+
+    for (std::size_t written = 0; written < size; written += block.size()) {
+        ofile.write(block.data(), static_cast<std::streamsize>(std::min(block.size(), size - written)));
+    }
+
+    return !ofile.fail();
+}
+
+void warm_up_page_cache(const std::string& path) {
+    std::ifstream ifile(path, std::ios::binary);
+    std::vector<char> block(1024 * 1024);
+    while (ifile.read(block.data(), static_cast<std::streamsize>(block.size()))) {
+    }
+}
+
+struct MemorySender {
+    std::shared_ptr<const char> buffer;
+    std::size_t remaining = 0;
+
+    void send_next(io::net::TlsConnectedClient& client) {
+        if (remaining == 0) {
+            return;
+        }
+
+        const auto size = static_cast<std::uint32_t>(std::min<std::size_t>(remaining, SEND_CHUNK_SIZE));
+        remaining -= size;
+        client.send_data(buffer, size, [this](io::net::TlsConnectedClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Send error: " << error << std::endl;
+                return;
+            }
+
+            send_next(client);
+        });
+    }
+};
+
+// Returns false if kernel TLS was requested but is not active
+bool run(bool kernel_tls,
+         bool use_send_file,
+         const std::string& cert_path,
+         const std::string& key_path,
+         const std::string& file_path,
+         std::size_t data_size,
+         std::uint16_t port) {
+    io::EventLoop server_loop;
+
+    MemorySender memory_sender;
+    memory_sender.buffer.reset(new char[SEND_CHUNK_SIZE], std::default_delete<char[]>());
+    memory_sender.remaining = data_size;
+
+    bool kernel_tls_active = false;
+
+    auto server = new io::net::TlsServer(server_loop, cert_path, key_path);
+    auto file = new io::fs::File(server_loop);
+    const auto kernel_tls_error = server->set_kernel_tls(kernel_tls);
+    if (kernel_tls_error) {
+        std::cerr << "Kernel TLS error: " << kernel_tls_error << std::endl;
+        server->schedule_removal();
+        file->schedule_removal();
+        server_loop.run();
+        return false;
+    }
+
+    const auto listen_error = server->listen({"127.0.0.1", port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            if (error) {
+                return;
+            }
+
+            kernel_tls_active = client.is_kernel_tls_active();
+            if (kernel_tls && !kernel_tls_active) {
+                client.close();
+                return;
+            }
+
+            if (!use_send_file) {
+                for (std::size_t i = 0; i < SENDS_IN_FLIGHT; ++i) {
+                    memory_sender.send_next(client);
+                }
+                return;
+            }
+
+            file->open(file_path, [&client, data_size](io::fs::File& file, const io::Error& error) {
+                if (error) {
+                    std::cerr << "Open error: " << error << std::endl;
+                    return;
+                }
+
+                client.send_file(file, 0, data_size, [](io::net::TlsConnectedClient& client, const io::Error& error) {
+                    if (error) {
+                        std::cerr << "Send file error: " << error << std::endl;
+                    }
+                });
+            });
+        },
+        nullptr
+    );
+    if (listen_error) {
+        std::cerr << "Listen error: " << listen_error << std::endl;
+        server->schedule_removal();
+        file->schedule_removal();
+        server_loop.run();
+        return false;
+    }
+
+    std::thread server_thread([&server_loop]() {
+        server_loop.run();
+    });
+
+    io::EventLoop client_loop;
+    std::size_t received_bytes = 0;
+
+    io::benchmark::Stopwatch stopwatch;
+
+    auto client = new io::net::TlsClient(client_loop);
+    client->connect({"127.0.0.1", port},
+        [](io::net::TlsClient& client, const io::Error& error) {
+            if (error) {
+                std::cerr << "Connect error: " << error << std::endl;
+                client.schedule_removal();
+            }
+        },
+        [&received_bytes, data_size](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+            received_bytes += data.size;
+            if (received_bytes >= data_size) {
+                client.close();
+            }
+        },
+        [](io::net::TlsClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    client_loop.run();
+    const auto wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+    const auto cpu_usage = stopwatch.cpu_usage();
+
+    server_loop.execute_on_loop_thread([server, file](io::EventLoop&) {
+        server->schedule_removal();
+        file->schedule_removal();
+    });
+    server_thread.join();
+
+    if (kernel_tls && !kernel_tls_active) {
+        return false;
+    }
+
+    const std::string prefix = std::string(kernel_tls ? "kernel TLS, " : "OpenSSL, ") +
+                               (use_send_file ? "send_file: " : "send_data: ");
+    io::benchmark::print_result(prefix + "throughput", received_bytes / wall_time_s / 1024.0 / 1024.0, "MB/s");
+    io::benchmark::print_result(prefix + "process CPU usage", cpu_usage * 100.0, "%");
+    io::benchmark::print_result(prefix + "CPU time per MB", stopwatch.cpu_time().count() / (received_bytes / 1024.0 / 1024.0), "us");
+    if (received_bytes != data_size) {
+        io::benchmark::print_result(prefix + "missing bytes", double(data_size - received_bytes), "");
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main() {
+    const std::size_t data_size_mb = io::benchmark::env_or_default("TARM_IO_BENCH_DATA_SIZE_MB", 512);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31551));
+
+    const std::string data_dir = TARM_IO_TESTS_DATA_DIR;
+    const std::string cert_path = data_dir + "/certificate.pem";
+    const std::string key_path = data_dir + "/key.pem";
+
+    const std::size_t data_size = data_size_mb * 1024 * 1024;
+    const std::string file_path = "tarm_io_kernel_tls_benchmark.bin";
+    if (!create_file(file_path, data_size)) {
+        std::cerr << "Failed to create file " << file_path << std::endl;
+        return 1;
+    }
+    warm_up_page_cache(file_path);
+
+    io::benchmark::print_header("TLS bulk transmit, OpenSSL versus kernel TLS (" + std::to_string(data_size_mb) + " MB)");
+    run(false, false, cert_path, key_path, file_path, data_size, port);
+    run(false, true, cert_path, key_path, file_path, data_size, port);
+    if (!run(true, false, cert_path, key_path, file_path, data_size, port)) {
+        std::cout << "Kernel TLS is not available, make sure that 'tls' kernel module is loaded" << std::endl;
+    } else {
+        run(true, true, cert_path, key_path, file_path, data_size, port);
+    }
+
+    std::remove(file_path.c_str());
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// UDP server which sends small datagrams to many peers, measured with and without batched send (sendmmsg).
+// Each tick server sends one datagram to every peer, next tick starts when all sends of the previous one
+// are completed. Peers are UdpClients executed in a separate loop of the same process, they also report
+// how many datagrams were actually delivered.
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoop.h"
+#include "Timer.h"
+#include "net/UdpClient.h"
+#include "net/UdpServer.h"
+
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+enum class Phase {
+    WAITING_PEERS,
+    SENDING,
+    DRAINING
+};
+
+struct SenderState {
+    Phase phase = Phase::WAITING_PEERS;
+    std::vector<io::net::UdpPeer*> peers;
+    std::size_t datagrams_to_send = 0;
+    std::size_t sent_datagrams = 0;
+    std::size_t completed_in_tick = 0;
+    std::size_t errors = 0;
+};
+
+void send_tick(SenderState& state, const std::string& message) {
+    state.completed_in_tick = 0;
+
+    for (auto peer : state.peers) {
+        peer->send_data(message.data(), static_cast<std::uint32_t>(message.size()),
+            [&state, &message](io::net::UdpPeer& peer, const io::Error& error) {
+                if (error) {
+                    ++state.errors;
+                } else {
+                    ++state.sent_datagrams;
+                }
+
+                if (++state.completed_in_tick < state.peers.size()) {
+                    return;
+                }
+
+                if (state.sent_datagrams + state.errors < state.datagrams_to_send) {
+                    send_tick(state, message);
+                } else {
+                    state.phase = Phase::DRAINING;
+                }
+            }
+        );
+    }
+}
+
+void run(std::size_t send_batch,
+         std::size_t peers_count,
+         std::size_t datagrams_count,
+         std::size_t datagram_size,
+         std::uint16_t port) {
+    io::EventLoop receivers_loop;
+    std::vector<io::net::UdpClient*> receivers;
+    std::size_t received_datagrams = 0;
+
+    io::EventLoop sender_loop;
+    SenderState state;
+    state.datagrams_to_send = datagrams_count;
+    const std::string message(datagram_size, 'a');
+
+    auto server = new io::net::UdpServer(sender_loop);
+    const auto batch_error = server->set_send_batch(send_batch);
+    if (batch_error) {
+        std::cerr << "Set send batch error: " << batch_error << std::endl;
+        return;
+    }
+
+    const auto receive_error = server->start_receive({"127.0.0.1", port},
+        [&state](io::net::UdpPeer& peer, const io::Error& error) {
+            if (!error) {
+                state.peers.push_back(&peer);
+            }
+        },
+        [](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+        },
+        60000,
+        nullptr
+    );
+    if (receive_error) {
+        std::cerr << "Start receive error: " << receive_error << std::endl;
+        return;
+    }
+
+    for (std::size_t i = 0; i < peers_count; ++i) {
+        auto client = new io::net::UdpClient(receivers_loop);
+        client->set_destination({"127.0.0.1", port},
+            [](io::net::UdpClient& client, const io::Error& error) {
+                if (!error) {
+                    client.send_data("hello");
+                }
+            },
+            [&received_datagrams](io::net::UdpClient& client, const io::DataChunk& data, const io::Error& error) {
+                if (!error) {
+                    ++received_datagrams;
+                }
+            }
+        );
+        receivers.push_back(client);
+    }
+
+    std::thread receivers_thread([&receivers_loop]() {
+        receivers_loop.run();
+    });
+
+    io::benchmark::Stopwatch stopwatch;
+    std::chrono::microseconds wall_time(0);
+    double cpu_usage = 0.0;
+    std::size_t allocations = 0;
+    std::size_t wait_ticks = 0;
+
+    // Waiting for peers, then sending until all datagrams are sent and giving receivers some time to drain sockets
+    auto timer = new io::Timer(sender_loop);
+    timer->start(10, 10, [&](io::Timer& timer) {
+        switch (state.phase) {
+            case Phase::WAITING_PEERS:
+                if (state.peers.size() < peers_count && ++wait_ticks < 200) {
+                    return;
+                }
+
+                if (state.peers.empty()) {
+                    std::cerr << "No peers connected" << std::endl;
+                    break;
+                }
+
+                state.phase = Phase::SENDING;
+                allocations = io::benchmark::allocations_count();
+                stopwatch.reset();
+                send_tick(state, message);
+                return;
+            case Phase::SENDING:
+                return;
+            case Phase::DRAINING:
+                if (wall_time.count() == 0) {
+                    wall_time = stopwatch.wall_time();
+                    cpu_usage = stopwatch.cpu_usage();
+                    allocations = io::benchmark::allocations_count() - allocations;
+                    return;
+                }
+                break;
+        }
+
+        timer.schedule_removal();
+        server->schedule_removal();
+        receivers_loop.execute_on_loop_thread([&receivers](io::EventLoop&) {
+            for (auto client : receivers) {
+                client->schedule_removal();
+            }
+        });
+    });
+
+    sender_loop.run();
+    receivers_thread.join();
+
+    const auto wall_time_s = wall_time.count() / 1000000.0;
+    const std::string prefix = "send batch " + std::to_string(send_batch) + ": ";
+    io::benchmark::print_result(prefix + "peers", double(state.peers.size()), "");
+    io::benchmark::print_result(prefix + "sent datagrams/s", wall_time_s > 0 ? state.sent_datagrams / wall_time_s : 0.0, "");
+    io::benchmark::print_result(prefix + "total send time", wall_time_s * 1000.0, "ms");
+    io::benchmark::print_result(prefix + "process CPU usage", cpu_usage * 100.0, "%");
+    io::benchmark::print_result(prefix + "delivered datagrams",
+                                state.sent_datagrams ? 100.0 * received_datagrams / state.sent_datagrams : 0.0, "%");
+    io::benchmark::print_result(prefix + "allocations per datagram",
+                                state.sent_datagrams ? double(allocations) / state.sent_datagrams : 0.0, "");
+    if (state.errors) {
+        io::benchmark::print_result(prefix + "errors", double(state.errors), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t peers = io::benchmark::env_or_default("TARM_IO_BENCH_PEERS", 1000);
+    const std::size_t datagrams = io::benchmark::env_or_default("TARM_IO_BENCH_DATAGRAMS", 1000000);
+    const std::size_t datagram_size = io::benchmark::env_or_default("TARM_IO_BENCH_DATAGRAM_SIZE", 32);
+    const std::size_t send_batch = io::benchmark::env_or_default("TARM_IO_BENCH_SEND_BATCH", 64);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31541));
+
+    io::benchmark::print_header("UDP fan-out (" + std::to_string(datagrams) + " datagrams of " +
+                                std::to_string(datagram_size) + " bytes to " + std::to_string(peers) + " peers)");
+    run(1, peers, datagrams, datagram_size, port);
+    run(send_batch, peers, datagrams, datagram_size, port);
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+// UDP server based on UdpServerGroup with peers tracking, measured with different number of loops.
+// Reports received packets per second and allocations per packet. Senders are executed in a separate EventLoopGroup of the same
+// process, each sender keeps a fixed number of packets in flight. Results scale only while there are
+// enough CPU cores for both sides. Each configuration is measured with and without batched receive (recvmmsg).
+
+#include "BenchmarkCommon.h"
+
+#include "EventLoopGroup.h"
+#include "Timer.h"
+#include "net/UdpClient.h"
+#include "net/UdpServerGroup.h"
+
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tarm;
+
+namespace {
+
+struct SendersState {
+    bool stop = false;
+    std::size_t sent_packets = 0;
+    std::size_t errors = 0;
+};
+
+// Padded to avoid false sharing between server loops
+struct alignas(64) ReceiverCounter {
+    std::size_t received_packets = 0;
+    std::size_t received_batches = 0;
+};
+
+void send_next_packet(io::net::UdpClient& client, SendersState& state, const std::string& message, std::shared_ptr<std::size_t> in_flight) {
+    client.send_data(message.data(), static_cast<std::uint32_t>(message.size()),
+        [&state, &message, in_flight](io::net::UdpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+            } else {
+                ++state.sent_packets;
+            }
+
+            if (state.stop) {
+                if (--*in_flight == 0) {
+                    client.schedule_removal();
+                }
+                return;
+            }
+
+            send_next_packet(client, state, message, in_flight);
+        }
+    );
+}
+
+void start_sender(io::EventLoop& loop, SendersState& state, std::uint16_t port, const std::string& message, std::size_t window) {
+    auto client = new io::net::UdpClient(loop);
+    client->set_destination({"127.0.0.1", port},
+        [&state, &message, window](io::net::UdpClient& client, const io::Error& error) {
+            if (error) {
+                ++state.errors;
+                client.schedule_removal();
+                return;
+            }
+
+            auto in_flight = std::make_shared<std::size_t>(window);
+            for (std::size_t i = 0; i < window; ++i) {
+                send_next_packet(client, state, message, in_flight);
+            }
+        }
+    );
+}
+
+void run(std::size_t server_loops_count,
+         std::size_t client_loops_count,
+         std::size_t senders_per_loop,
+         std::size_t window,
+         std::size_t packet_size,
+         std::size_t receive_batch,
+         std::size_t duration_ms,
+         std::uint16_t port) {
+    io::EventLoopGroup server_loops(server_loops_count);
+    io::net::UdpServerGroup server(server_loops);
+    const auto batch_error = server.set_receive_batch(receive_batch, packet_size,
+        [](io::net::UdpServer& server, const io::net::UdpDatagram*, std::size_t, const io::Error& error) {
+            if (!error) {
+                ++server.user_data_as_ptr<ReceiverCounter>()->received_batches;
+            }
+        }
+    );
+    if (batch_error) {
+        std::cerr << "Set receive batch error: " << batch_error << std::endl;
+        return;
+    }
+
+    const auto receive_error = server.start_receive({"127.0.0.1", port},
+        nullptr,
+        [](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            if (!error) {
+                ++peer.server().user_data_as_ptr<ReceiverCounter>()->received_packets;
+            }
+        },
+        10000,
+        nullptr
+    );
+    if (receive_error) {
+        std::cerr << "Start receive error: " << receive_error << std::endl;
+        return;
+    }
+
+    std::vector<ReceiverCounter> counters(server_loops_count);
+    for (std::size_t i = 0; i < server.size(); ++i) {
+        server.server(i).set_user_data(&counters[i]);
+    }
+
+    std::thread server_thread([&server_loops]() {
+        server_loops.run();
+    });
+
+    io::EventLoopGroup client_loops(client_loops_count);
+    std::vector<SendersState> states(client_loops_count);
+    const std::string message(packet_size, 'a');
+
+    for (std::size_t i = 0; i < client_loops_count; ++i) {
+        auto& loop = client_loops.loop(i);
+        auto& state = states[i];
+
+        for (std::size_t j = 0; j < senders_per_loop; ++j) {
+            start_sender(loop, state, port, message, window);
+        }
+
+        auto timer = new io::Timer(loop);
+        timer->start(duration_ms, [&state](io::Timer& timer) {
+            state.stop = true;
+            timer.schedule_removal();
+        });
+    }
+
+    const auto allocations_before = io::benchmark::allocations_count();
+    io::benchmark::Stopwatch stopwatch;
+    client_loops.run();
+    const auto wall_time_s = stopwatch.wall_time().count() / 1000000.0;
+    const auto cpu_usage = stopwatch.cpu_usage();
+    const auto allocations = io::benchmark::allocations_count() - allocations_before;
+
+    server.schedule_removal();
+    server_thread.join();
+
+    SendersState total;
+    for (auto& state : states) {
+        total.sent_packets += state.sent_packets;
+        total.errors += state.errors;
+    }
+
+    std::size_t received_packets = 0;
+    std::size_t received_batches = 0;
+    for (auto& counter : counters) {
+        received_packets += counter.received_packets;
+        received_batches += counter.received_batches;
+    }
+
+    const std::string prefix = std::to_string(server_loops_count) + " server loop(s), receive batch " +
+                               std::to_string(receive_batch) + ": ";
+    io::benchmark::print_result(prefix + "received packets/s", received_packets / wall_time_s, "");
+    io::benchmark::print_result(prefix + "sent packets/s", total.sent_packets / wall_time_s, "");
+    io::benchmark::print_result(prefix + "packets per receive callback batch",
+                                received_batches ? double(received_packets) / received_batches : 0.0, "");
+    io::benchmark::print_result(prefix + "process CPU usage", cpu_usage * 100.0, "%");
+    // Includes allocations of senders
+    io::benchmark::print_result(prefix + "allocations per packet",
+                                received_packets ? double(allocations) / received_packets : 0.0, "");
+    if (total.errors) {
+        io::benchmark::print_result(prefix + "errors", double(total.errors), "");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::size_t cores_count = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    const std::size_t max_loops = io::benchmark::env_or_default("TARM_IO_BENCH_MAX_LOOPS", cores_count);
+    const std::size_t client_loops = io::benchmark::env_or_default("TARM_IO_BENCH_CLIENT_LOOPS", max_loops);
+    const std::size_t senders = io::benchmark::env_or_default("TARM_IO_BENCH_SENDERS", 16);
+    const std::size_t window = io::benchmark::env_or_default("TARM_IO_BENCH_WINDOW", 8);
+    const std::size_t packet_size = io::benchmark::env_or_default("TARM_IO_BENCH_PACKET_SIZE", 64);
+    const std::size_t receive_batch = io::benchmark::env_or_default("TARM_IO_BENCH_RECEIVE_BATCH", 32);
+    const std::size_t duration_ms = io::benchmark::env_or_default("TARM_IO_BENCH_DURATION_MS", 1000);
+    const std::uint16_t port = static_cast<std::uint16_t>(io::benchmark::env_or_default("TARM_IO_BENCH_PORT", 31541));
+
+    io::benchmark::print_header("UDP packets per second (" + std::to_string(client_loops) + " client loops, " +
+                                std::to_string(senders) + " senders per loop, " +
+                                std::to_string(packet_size) + " bytes packets)");
+    for (std::size_t loops = 1; loops <= max_loops; loops *= 2) {
+        run(loops, client_loops, senders, window, packet_size, 1, duration_ms, port);
+        run(loops, client_loops, senders, window, packet_size, receive_batch, duration_ms, port);
+    }
+
+    return 0;
+}
@@ -0,0 +1,292 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "BufferPool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+
+namespace tarm {
+namespace io {
+
+namespace {
+
+// Each pooled buffer is a single block of memory: space for shared_ptr's control block followed by data.
+// So acquiring buffer from the pool does not require any allocations.
+constexpr std::size_t CONTROL_BLOCK_SPACE = 64;
+static_assert(CONTROL_BLOCK_SPACE % alignof(std::max_align_t) == 0, "");
+
+struct NoopDeleter {
+    void operator()(char*) const {
+    }
+};
+
+} // namespace
+
+const std::vector<std::size_t> BufferPool::DEFAULT_SIZE_CLASSES = {4 * 1024, 16 * 1024, 64 * 1024};
+const std::size_t BufferPool::DEFAULT_MAX_FREE_BUFFERS_PER_CLASS;
+
+class BufferPool::Impl {
+public:
+    Impl();
+    ~Impl();
+
+    static std::shared_ptr<char> acquire(const std::shared_ptr<Impl>& self, std::size_t size);
+
+    void release(char* block, std::size_t capacity);
+
+    void set_size_classes(std::vector<std::size_t> size_classes);
+    std::vector<std::size_t> size_classes() const;
+
+    void set_max_free_buffers_per_class(std::size_t count);
+    std::size_t max_free_buffers_per_class() const;
+
+    std::size_t free_buffers_count() const;
+
+    void close();
+
+private:
+    // Allocator which places shared_ptr's control block into the pooled block, memory is returned
+    // to the pool when control block is deallocated, i.e. when the last reference to buffer is dropped.
+    template<typename T>
+    class BlockAllocator {
+    public:
+        using value_type = T;
+
+        BlockAllocator(std::shared_ptr<Impl> pool, char* block, std::size_t capacity) :
+            m_pool(std::move(pool)),
+            m_block(block),
+            m_capacity(capacity) {
+        }
+
+        template<typename U>
+        BlockAllocator(const BlockAllocator<U>& other) :
+            m_pool(other.m_pool),
+            m_block(other.m_block),
+            m_capacity(other.m_capacity) {
+        }
+
+        T* allocate(std::size_t) {
+            static_assert(sizeof(T) <= CONTROL_BLOCK_SPACE, "Control block does not fit reserved space");
+            return reinterpret_cast<T*>(m_block);
+        }
+
+        void deallocate(T*, std::size_t) {
+            m_pool->release(m_block, m_capacity);
+        }
+
+        template<typename U>
+        bool operator==(const BlockAllocator<U>& other) const {
+            return m_block == other.m_block;
+        }
+
+        template<typename U>
+        bool operator!=(const BlockAllocator<U>& other) const {
+            return m_block != other.m_block;
+        }
+
+    private:
+        template<typename U>
+        friend class BlockAllocator;
+
+        std::shared_ptr<Impl> m_pool;
+        char* m_block;
+        std::size_t m_capacity;
+    };
+
+    struct SizeClass {
+        std::size_t size;
+        // Free blocks are linked through their first bytes
+        char* free_list = nullptr;
+        std::size_t free_count = 0;
+    };
+
+    static char*& next_free(char* block);
+
+    SizeClass* find_class(std::size_t size);
+    void free_blocks(SizeClass& size_class);
+
+    mutable std::mutex m_mutex;
+    std::vector<SizeClass> m_classes;
+    std::size_t m_max_free_buffers_per_class = DEFAULT_MAX_FREE_BUFFERS_PER_CLASS;
+    bool m_closed = false;
+};
+
+BufferPool::Impl::Impl() {
+    set_size_classes(DEFAULT_SIZE_CLASSES);
+}
+
+BufferPool::Impl::~Impl() {
+    for (auto& size_class : m_classes) {
+        free_blocks(size_class);
+    }
+}
+
+std::shared_ptr<char> BufferPool::Impl::acquire(const std::shared_ptr<Impl>& self, std::size_t size) {
+    std::unique_lock<std::mutex> lock(self->m_mutex);
+
+    auto size_class = self->find_class(size);
+    if (size_class == nullptr) {
+        lock.unlock();
+        return std::shared_ptr<char>(new char[size], std::default_delete<char[]>());
+    }
+
+    const std::size_t capacity = size_class->size;
+    char* block = size_class->free_list;
+    if (block) {
+        size_class->free_list = next_free(block);
+        --size_class->free_count;
+    }
+    lock.unlock();
+
+    if (block == nullptr) {
+        block = static_cast<char*>(::operator new(CONTROL_BLOCK_SPACE + capacity));
+    }
+
+    return std::shared_ptr<char>(block + CONTROL_BLOCK_SPACE, NoopDeleter(), BlockAllocator<char>(self, block, capacity));
+}
+
+void BufferPool::Impl::release(char* block, std::size_t capacity) {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto size_class = m_closed ? nullptr : find_class(capacity);
+        if (size_class && size_class->size == capacity && size_class->free_count < m_max_free_buffers_per_class) {
+            next_free(block) = size_class->free_list;
+            size_class->free_list = block;
+            ++size_class->free_count;
+            return;
+        }
+    }
+
+    ::operator delete(block);
+}
+
+void BufferPool::Impl::set_size_classes(std::vector<std::size_t> size_classes) {
+    std::sort(size_classes.begin(), size_classes.end());
+    size_classes.erase(std::unique(size_classes.begin(), size_classes.end()), size_classes.end());
+    size_classes.erase(std::remove(size_classes.begin(), size_classes.end(), 0), size_classes.end());
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto& size_class : m_classes) {
+        free_blocks(size_class);
+    }
+
+    m_classes.clear();
+    for (auto size : size_classes) {
+        SizeClass size_class;
+        size_class.size = size;
+        m_classes.push_back(size_class);
+    }
+}
+
+std::vector<std::size_t> BufferPool::Impl::size_classes() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    std::vector<std::size_t> result;
+    for (auto& size_class : m_classes) {
+        result.push_back(size_class.size);
+    }
+    return result;
+}
+
+void BufferPool::Impl::set_max_free_buffers_per_class(std::size_t count) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_max_free_buffers_per_class = count;
+    for (auto& size_class : m_classes) {
+        while (size_class.free_count > count) {
+            char* block = size_class.free_list;
+            size_class.free_list = next_free(block);
+            --size_class.free_count;
+            ::operator delete(block);
+        }
+    }
+}
+
+std::size_t BufferPool::Impl::max_free_buffers_per_class() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_max_free_buffers_per_class;
+}
+
+std::size_t BufferPool::Impl::free_buffers_count() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    std::size_t result = 0;
+    for (auto& size_class : m_classes) {
+        result += size_class.free_count;
+    }
+    return result;
+}
+
+void BufferPool::Impl::close() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_closed = true;
+    for (auto& size_class : m_classes) {
+        free_blocks(size_class);
+    }
+}
+
+char*& BufferPool::Impl::next_free(char* block) {
+    return *reinterpret_cast<char**>(block);
+}
+
+BufferPool::Impl::SizeClass* BufferPool::Impl::find_class(std::size_t size) {
+    for (auto& size_class : m_classes) {
+        if (size <= size_class.size) {
+            return &size_class;
+        }
+    }
+
+    return nullptr;
+}
+
+void BufferPool::Impl::free_blocks(SizeClass& size_class) {
+    while (size_class.free_list) {
+        char* block = size_class.free_list;
+        size_class.free_list = next_free(block);
+        ::operator delete(block);
+    }
+    size_class.free_count = 0;
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+BufferPool::BufferPool() :
+    m_impl(std::make_shared<Impl>()) {
+}
+
+BufferPool::~BufferPool() {
+    // Buffers which are still in use keep Impl alive and are freed on release
+    m_impl->close();
+}
+
+std::shared_ptr<char> BufferPool::acquire(std::size_t size) {
+    return Impl::acquire(m_impl, size);
+}
+
+void BufferPool::set_size_classes(std::vector<std::size_t> size_classes) {
+    return m_impl->set_size_classes(std::move(size_classes));
+}
+
+std::vector<std::size_t> BufferPool::size_classes() const {
+    return m_impl->size_classes();
+}
+
+void BufferPool::set_max_free_buffers_per_class(std::size_t count) {
+    return m_impl->set_max_free_buffers_per_class(count);
+}
+
+std::size_t BufferPool::max_free_buffers_per_class() const {
+    return m_impl->max_free_buffers_per_class();
+}
+
+std::size_t BufferPool::free_buffers_count() const {
+    return m_impl->free_buffers_count();
+}
+
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,56 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+#include "Export.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace tarm {
+namespace io {
+
+// Pool of receive buffers. Each EventLoop has its own pool which is used by network objects
+// of that loop for incoming data. Buffers are grouped by size classes, requested size is rounded
+// up to the nearest class. Buffer returns to the pool when the last shared_ptr to it (for example
+// DataChunk) is destroyed, so memory is reused without allocations. Requests larger than the
+// biggest class are served by regular allocations.
+// Note: buffers may be released from any thread, pool itself may be destroyed before its buffers.
+class BufferPool {
+public:
+    TARM_IO_FORBID_COPY(BufferPool);
+    TARM_IO_FORBID_MOVE(BufferPool);
+
+    TARM_IO_DLL_PUBLIC static const std::vector<std::size_t> DEFAULT_SIZE_CLASSES;
+    TARM_IO_DLL_PUBLIC static const std::size_t DEFAULT_MAX_FREE_BUFFERS_PER_CLASS = 32;
+
+    TARM_IO_DLL_PUBLIC BufferPool();
+    TARM_IO_DLL_PUBLIC ~BufferPool();
+
+    // Returns buffer of at least 'size' bytes.
+    TARM_IO_DLL_PUBLIC std::shared_ptr<char> acquire(std::size_t size);
+
+    // Classes are sorted and duplicates are removed. Buffers which were acquired before
+    // and do not fit new classes are freed on release. Free buffers are released immediately.
+    TARM_IO_DLL_PUBLIC void set_size_classes(std::vector<std::size_t> size_classes);
+    TARM_IO_DLL_PUBLIC std::vector<std::size_t> size_classes() const;
+
+    // Number of free buffers kept per each size class, the rest is returned to the system.
+    TARM_IO_DLL_PUBLIC void set_max_free_buffers_per_class(std::size_t count);
+    TARM_IO_DLL_PUBLIC std::size_t max_free_buffers_per_class() const;
+
+    // Number of buffers which are kept in the pool and ready for reuse.
+    TARM_IO_DLL_PUBLIC std::size_t free_buffers_count() const;
+
+private:
+    class Impl;
+    std::shared_ptr<Impl> m_impl;
+};
+
+} // namespace io
+} // namespace tarm
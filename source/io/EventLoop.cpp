@@ -7,6 +7,8 @@
 
 #include "detail/Common.h"
 #include "detail/LogMacros.h"
+#include "detail/MpscQueue.h"
+#include "detail/UniqueFunction.h"
 #include "CommonMacros.h"
 #include "Logger.h"
 #include "ScopeExitGuard.h"
@@ -56,6 +58,14 @@ struct Idle : public uv_idle_t {
     std::function<void(EventLoop&)> callback = nullptr;
 };
 
+using DeferredCallback = detail::UniqueFunction<void(EventLoop&)>;
+
+struct AsyncCallbackNode : public detail::MpscQueueNode {
+    DeferredCallback callback;
+    // Bulk of callbacks is passed as a single node
+    std::vector<EventLoop::WorkCallback> callbacks;
+};
+
 } // namespace
 
 class EventLoop::Impl : public uv_loop_t {
@@ -71,6 +81,7 @@ public:
     Error cancel_work(WorkHandle handle);
 
     void execute_on_loop_thread(const WorkCallback& callback);
+    void execute_on_loop_thread(std::vector<WorkCallback> callbacks);
 
     // Warning: do not perform heavy calculations or blocking calls here
     std::size_t schedule_call_on_each_loop_cycle(const WorkCallback& callback);
@@ -87,12 +98,28 @@ public:
 
     bool is_running() const;
 
-    void schedule_callback(const WorkCallback& callback);
+    BufferPool& buffer_pool();
+
+    void set_shared_read_buffer(bool enabled);
+    bool is_shared_read_buffer() const;
+    std::shared_ptr<char> acquire_shared_read_buffer(std::size_t size);
+
+    void schedule_callback(DeferredCallback callback);
+    void schedule_callback_after_poll(DeferredCallback callback);
+    void schedule_removal(RemovalCallback callback, void* object);
 
     void finish();
 
 protected:
+    void wakeup_on_pending_callbacks();
     void execute_pending_callbacks();
+    void clear_pending_callbacks();
+    void execute_deferred_callbacks();
+    void execute_after_poll_callbacks();
+    void execute_pending_removals();
+    void start_deferred_callbacks_handles();
+    void init_deferred_callbacks_handles();
+    void close_deferred_callbacks_handles();
     void close_signal_handlers();
 
     // statics
@@ -101,6 +128,9 @@ protected:
     template<typename WorkCallbackType, typename WorkDoneCallbackType>
     static void on_after_work(uv_work_t* req, int status);
     static void on_idle(uv_idle_t* handle);
+    static void on_deferred_callbacks_prepare(uv_prepare_t* handle);
+    static void on_deferred_callbacks_check(uv_check_t* handle);
+    static void on_deferred_callbacks_wakeup(uv_idle_t* handle);
     static void on_each_loop_cycle_handler_close(uv_handle_t* handle);
     static void on_async(uv_async_t* handle);
     static void on_dummy_idle_tick(uv_timer_t*);
@@ -115,18 +145,39 @@ private:
     std::int64_t m_dummy_idle_ref_counter = 0;
 
     std::unique_ptr<uv_async_t, void(*)(uv_async_t*)> m_async;
-    std::deque<std::function<void(EventLoop&)>> m_async_callbacks_queue;
-    std::mutex m_async_callbacks_queue_mutex;
+    // Lock-free queue of AsyncCallbackNode. Only the first callback pushed after the queue was drained
+    // sends wakeup to the loop, the rest are executed during the same drain.
+    detail::MpscQueue m_async_callbacks_queue;
+    std::atomic<bool> m_async_wakeup_pending{false};
 
     bool m_is_running = false;
     bool m_run_called = false;
 
-    std::size_t m_sync_callbacks_executor_handle = 0;
-    std::function<void(EventLoop&)> m_sync_callbacks_executor_function;
-    std::vector<std::function<void(EventLoop&)>> m_sync_callbacks_queue;
+    // Deferred (sync) callbacks are executed right before polling for I/O (prepare) and right after it (check).
+    // So callbacks scheduled from I/O callbacks are executed in the same loop iteration and no zero-timeout
+    // polling is performed while the queue is not empty. Idle handle is used only as a wakeup to not block
+    // in poll when callbacks were scheduled from other deferred callbacks executed at prepare stage.
+    uv_prepare_t m_sync_callbacks_prepare;
+    uv_check_t m_sync_callbacks_check;
+    uv_idle_t m_sync_callbacks_wakeup;
+    std::vector<DeferredCallback> m_sync_callbacks_queue;
+    std::vector<DeferredCallback> m_sync_callbacks_executing;
+    std::vector<DeferredCallback> m_after_poll_callbacks_queue;
+    std::vector<DeferredCallback> m_after_poll_callbacks_executing;
     bool m_have_active_sync_callbacks = false;
 
+    // Removable objects scheduled for removal, deleted in a single pass together with deferred callbacks.
+    std::vector<std::pair<RemovalCallback, void*>> m_pending_removals;
+    std::vector<std::pair<RemovalCallback, void*>> m_pending_removals_executing;
+    bool m_sync_callbacks_handles_closed = false;
+
     std::unordered_map<EventLoop::Signal, SignalHandler*, EnumClassHash> m_signal_handlers;
+
+    BufferPool m_buffer_pool;
+
+    bool m_shared_read_buffer_enabled = false;
+    std::shared_ptr<char> m_shared_read_buf;
+    std::size_t m_shared_read_buf_size = 0;
 };
 
 namespace {
@@ -143,20 +194,7 @@ void async_close(uv_async_t* async) {
 
 EventLoop::Impl::Impl(EventLoop& parent) :
     m_parent(&parent),
-    m_async(nullptr, async_close),
-    m_sync_callbacks_executor_function([this](EventLoop&) {
-        decltype(m_sync_callbacks_queue) queue_copy;
-        queue_copy.swap(m_sync_callbacks_queue);
-
-        for(auto&& v: queue_copy) {
-            v(*m_parent);
-        }
-
-        if (m_sync_callbacks_queue.empty()) {
-            stop_call_on_each_loop_cycle(m_sync_callbacks_executor_handle);
-            m_have_active_sync_callbacks = false;
-        }
-    }) {
+    m_async(nullptr, async_close) {
 
     this->data = &parent;
 
@@ -172,18 +210,18 @@ EventLoop::Impl::Impl(EventLoop& parent) :
     if (async_init_error) {
         LOG_ERROR(m_parent, "uv's async init failed: ", async_init_error.string());
     }
+
+    init_deferred_callbacks_handles();
 }
 
 void EventLoop::Impl::finish() {
     LOG_TRACE(m_parent, "dummy_idle_ref_counter:", m_dummy_idle_ref_counter);
 
     close_signal_handlers();
+    close_deferred_callbacks_handles();
 
-    {
-        std::lock_guard<std::mutex> guard(m_async_callbacks_queue_mutex);
-        m_async.reset();
-        m_async_callbacks_queue.clear();
-    }
+    m_async.reset();
+    clear_pending_callbacks();
 
     int status = uv_loop_close(this);
 
@@ -192,12 +230,15 @@ void EventLoop::Impl::finish() {
     }
 
     m_sync_callbacks_queue.clear();
+    m_after_poll_callbacks_queue.clear();
 
     if (status == UV_EBUSY) {
         // Making the last attemt to close everything and shut down gracefully
+        execute_pending_removals();
         status = uv_run(this, UV_RUN_ONCE);
 
         // TODO: a bit hackish approach to allow finish deinit of objects with 2-phase deinitialization like TlsClient
+        execute_pending_removals();
         status = uv_run(this, UV_RUN_ONCE);
 
         uv_loop_close(this);
@@ -208,13 +249,98 @@ void EventLoop::Impl::finish() {
 EventLoop::Impl::~Impl() {
 }
 
-void EventLoop::Impl::schedule_callback(const WorkCallback& callback) {
-    if (!m_have_active_sync_callbacks) {
-        m_sync_callbacks_executor_handle = schedule_call_on_each_loop_cycle(m_sync_callbacks_executor_function);
-        m_have_active_sync_callbacks = true;
+void EventLoop::Impl::init_deferred_callbacks_handles() {
+    // Init functions of loop watchers always return 0, so no need to handle errors here.
+    uv_prepare_init(this, &m_sync_callbacks_prepare);
+    m_sync_callbacks_prepare.data = this;
+
+    uv_check_init(this, &m_sync_callbacks_check);
+    m_sync_callbacks_check.data = this;
+
+    uv_idle_init(this, &m_sync_callbacks_wakeup);
+    m_sync_callbacks_wakeup.data = this;
+}
+
+void EventLoop::Impl::close_deferred_callbacks_handles() {
+    m_sync_callbacks_handles_closed = true;
+    m_have_active_sync_callbacks = false;
+
+    // Handles are members of this object, so no close callbacks are required
+    uv_close(reinterpret_cast<uv_handle_t*>(&m_sync_callbacks_prepare), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t*>(&m_sync_callbacks_check), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t*>(&m_sync_callbacks_wakeup), nullptr);
+}
+
+void EventLoop::Impl::start_deferred_callbacks_handles() {
+    if (m_have_active_sync_callbacks || m_sync_callbacks_handles_closed) {
+        return;
+    }
+
+    // Callbacks are guaranteed to be not null, so no errors are possible here
+    uv_prepare_start(&m_sync_callbacks_prepare, on_deferred_callbacks_prepare);
+    uv_check_start(&m_sync_callbacks_check, on_deferred_callbacks_check);
+    m_have_active_sync_callbacks = true;
+}
+
+void EventLoop::Impl::schedule_callback(DeferredCallback callback) {
+    m_sync_callbacks_queue.push_back(std::move(callback));
+    start_deferred_callbacks_handles();
+}
+
+void EventLoop::Impl::schedule_callback_after_poll(DeferredCallback callback) {
+    m_after_poll_callbacks_queue.push_back(std::move(callback));
+    start_deferred_callbacks_handles();
+}
+
+void EventLoop::Impl::schedule_removal(RemovalCallback callback, void* object) {
+    m_pending_removals.emplace_back(callback, object);
+    start_deferred_callbacks_handles();
+}
+
+void EventLoop::Impl::execute_pending_removals() {
+    // Objects removed here may schedule removal of other objects, those will be removed on the next pass.
+    // Swapping with a member (not a local) container keeps allocated capacity between passes.
+    m_pending_removals_executing.swap(m_pending_removals);
+
+    for (auto& removal : m_pending_removals_executing) {
+        removal.first(removal.second);
     }
 
-    m_sync_callbacks_queue.push_back(callback);
+    m_pending_removals_executing.clear();
+}
+
+void EventLoop::Impl::execute_after_poll_callbacks() {
+    // Callbacks executed here usually schedule the same amount of new ones, keeping capacity for them
+    m_after_poll_callbacks_executing.swap(m_after_poll_callbacks_queue);
+    m_after_poll_callbacks_queue.reserve(m_after_poll_callbacks_executing.capacity());
+
+    for(auto&& v: m_after_poll_callbacks_executing) {
+        v(*m_parent);
+    }
+
+    m_after_poll_callbacks_executing.clear();
+}
+
+void EventLoop::Impl::execute_deferred_callbacks() {
+    m_sync_callbacks_executing.swap(m_sync_callbacks_queue);
+
+    for(auto&& v: m_sync_callbacks_executing) {
+        v(*m_parent);
+    }
+
+    m_sync_callbacks_executing.clear();
+
+    execute_pending_removals();
+
+    if (m_sync_callbacks_queue.empty() &&
+        m_after_poll_callbacks_queue.empty() &&
+        m_pending_removals.empty() &&
+        m_have_active_sync_callbacks) {
+        uv_prepare_stop(&m_sync_callbacks_prepare);
+        uv_check_stop(&m_sync_callbacks_check);
+        uv_idle_stop(&m_sync_callbacks_wakeup);
+        m_have_active_sync_callbacks = false;
+    }
 }
 
 Error EventLoop::Impl::init_async() {
@@ -343,10 +469,7 @@ Error EventLoop::Impl::run() {
 
         // If there were pending async callbacks after the loop exit, executing one more run
         // because some new events may be scheduled right away.
-        {
-            std::lock_guard<std::mutex> guard(m_async_callbacks_queue_mutex);
-            has_pending_callbacks = m_async_callbacks_queue.size();
-        }
+        has_pending_callbacks = !m_async_callbacks_queue.empty();
 
         execute_pending_callbacks();
     } while(run_status == 0 && has_pending_callbacks);
@@ -487,28 +610,97 @@ void EventLoop::Impl::close_signal_handlers() {
 }
 
 void EventLoop::Impl::execute_on_loop_thread(const WorkCallback& callback) {
-    {
-        std::lock_guard<std::mutex> guard(m_async_callbacks_queue_mutex);
-        m_async_callbacks_queue.push_back(callback);
+    auto node = new AsyncCallbackNode;
+    node->callback = callback;
+    m_async_callbacks_queue.push(node);
+
+    wakeup_on_pending_callbacks();
+}
+
+void EventLoop::Impl::execute_on_loop_thread(std::vector<WorkCallback> callbacks) {
+    if (callbacks.empty()) {
+        return;
     }
 
-    uv_async_send(m_async.get());
+    auto node = new AsyncCallbackNode;
+    node->callbacks = std::move(callbacks);
+    m_async_callbacks_queue.push(node);
+
+    wakeup_on_pending_callbacks();
+}
+
+void EventLoop::Impl::wakeup_on_pending_callbacks() {
+    if (!m_async_wakeup_pending.exchange(true)) {
+        uv_async_send(m_async.get());
+    }
 }
 
 bool EventLoop::Impl::is_running() const {
     return m_is_running;
 }
 
+BufferPool& EventLoop::Impl::buffer_pool() {
+    return m_buffer_pool;
+}
+
+void EventLoop::Impl::set_shared_read_buffer(bool enabled) {
+    m_shared_read_buffer_enabled = enabled;
+    if (!enabled) {
+        m_shared_read_buf.reset();
+        m_shared_read_buf_size = 0;
+    }
+}
+
+bool EventLoop::Impl::is_shared_read_buffer() const {
+    return m_shared_read_buffer_enabled;
+}
+
+std::shared_ptr<char> EventLoop::Impl::acquire_shared_read_buffer(std::size_t size) {
+    // Buffer held by somebody else was retained by user or is used by other connection right now
+    if (m_shared_read_buf == nullptr || m_shared_read_buf.use_count() > 1 || m_shared_read_buf_size < size) {
+        m_shared_read_buf = m_buffer_pool.acquire(size);
+        m_shared_read_buf_size = size;
+    }
+
+    return m_shared_read_buf;
+}
+
 void EventLoop::Impl::execute_pending_callbacks() {
-    std::deque<std::function<void(EventLoop&)>> callbacks_queue_copy;
+    // Resetting flag before draining, so callbacks pushed from now on will send a new wakeup.
+    // Exchange (not store) is used to synchronize with producers which have set the flag.
+    m_async_wakeup_pending.exchange(false, std::memory_order_acq_rel);
+
+    // Detaching callbacks available at this moment first, ones added by the callbacks
+    // themselves will be executed on the next wakeup.
+    detail::MpscQueueNode* first = nullptr;
+    detail::MpscQueueNode* last = nullptr;
+    while (auto node = m_async_callbacks_queue.pop()) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        if (last) {
+            last->next.store(node, std::memory_order_relaxed);
+        } else {
+            first = node;
+        }
+        last = node;
+    }
 
-    {
-        std::lock_guard<decltype(m_async_callbacks_queue_mutex)> guard(m_async_callbacks_queue_mutex);
-        m_async_callbacks_queue.swap(callbacks_queue_copy);
+    while (first) {
+        std::unique_ptr<AsyncCallbackNode> callback_node(static_cast<AsyncCallbackNode*>(first));
+        first = first->next.load(std::memory_order_relaxed);
+
+        if (callback_node->callback) {
+            callback_node->callback(*m_parent);
+        }
+
+        for (auto& callback : callback_node->callbacks) {
+            callback(*m_parent);
+        }
     }
+}
 
-    for(auto& callback : callbacks_queue_copy) {
-        callback(*m_parent);
+void EventLoop::Impl::clear_pending_callbacks() {
+    while (auto node = m_async_callbacks_queue.pop()) {
+        delete static_cast<AsyncCallbackNode*>(node);
     }
 }
 
@@ -550,6 +742,27 @@ void EventLoop::Impl::on_idle(uv_idle_t* handle) {
     }
 }
 
+void EventLoop::Impl::on_deferred_callbacks_prepare(uv_prepare_t* handle) {
+    auto& this_ = *reinterpret_cast<EventLoop::Impl*>(handle->data);
+    this_.execute_deferred_callbacks();
+
+    // Some callbacks were scheduled by deferred ones, do not block in poll and execute them at check stage.
+    if (this_.m_have_active_sync_callbacks) {
+        uv_idle_start(&this_.m_sync_callbacks_wakeup, on_deferred_callbacks_wakeup);
+    }
+}
+
+void EventLoop::Impl::on_deferred_callbacks_check(uv_check_t* handle) {
+    auto& this_ = *reinterpret_cast<EventLoop::Impl*>(handle->data);
+    uv_idle_stop(&this_.m_sync_callbacks_wakeup);
+    this_.execute_after_poll_callbacks();
+    this_.execute_deferred_callbacks();
+}
+
+void EventLoop::Impl::on_deferred_callbacks_wakeup(uv_idle_t* /*handle*/) {
+    // Do nothing, the only purpose of this callback is to prevent loop from blocking in poll.
+}
+
 void EventLoop::Impl::on_each_loop_cycle_handler_close(uv_handle_t* handle) {
     auto& idle = *reinterpret_cast<Idle*>(handle);
     auto& this_ = *reinterpret_cast<EventLoop::Impl*>(handle->data);
@@ -622,6 +835,10 @@ void EventLoop::execute_on_loop_thread(const WorkCallback& callback) {
     m_impl->execute_on_loop_thread(callback);
 }
 
+void EventLoop::execute_on_loop_thread(std::vector<WorkCallback> callbacks) {
+    m_impl->execute_on_loop_thread(std::move(callbacks));
+}
+
 EventLoop::WorkHandle EventLoop::add_work(const WorkCallback& thread_pool_work_callback,
                                           const WorkDoneCallback& loop_thread_work_done_callback) {
     return m_impl->add_work(thread_pool_work_callback, loop_thread_work_done_callback);
@@ -664,10 +881,34 @@ void* EventLoop::raw_loop() {
     return m_impl.get();
 }
 
+BufferPool& EventLoop::buffer_pool() {
+    return m_impl->buffer_pool();
+}
+
+void EventLoop::set_shared_read_buffer(bool enabled) {
+    return m_impl->set_shared_read_buffer(enabled);
+}
+
+bool EventLoop::is_shared_read_buffer() const {
+    return m_impl->is_shared_read_buffer();
+}
+
+std::shared_ptr<char> EventLoop::acquire_shared_read_buffer(std::size_t size) {
+    return m_impl->acquire_shared_read_buffer(size);
+}
+
 void EventLoop::schedule_callback(const WorkCallback& callback) {
     return m_impl->schedule_callback(callback);
 }
 
+void EventLoop::schedule_callback_after_poll(const WorkCallback& callback) {
+    return m_impl->schedule_callback_after_poll(callback);
+}
+
+void EventLoop::schedule_removal(RemovalCallback callback, void* object) {
+    return m_impl->schedule_removal(callback, object);
+}
+
 Error EventLoop::add_signal_handler(Signal signal, const SignalCallback& callback) {
     return m_impl->add_signal_handler(signal, callback, SignalHandler::REPEAT);
 }
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "BufferPool.h"
 #include "CommonMacros.h"
 #include "Error.h"
 #include "Export.h"
@@ -14,12 +15,19 @@
 #include <functional>
 #include <memory>
 #include <limits>
+#include <vector>
 
 // DOC: calling some loop methods and not calling run() will result in memory leak
 
 namespace tarm {
 namespace io {
 
+namespace detail {
+
+class EventLoopAccess;
+
+} // namespace detail
+
 class EventLoop : public Logger,
                   public UserDataHolder {
 public:
@@ -56,6 +64,8 @@ public:
     // Call callback on the EventLoop's thread. Could be executed from any thread
     // Note: this method is thread safe
     TARM_IO_DLL_PUBLIC void execute_on_loop_thread(const WorkCallback& callback);
+    // Same as above, but passes all callbacks to the loop at once. Callbacks are executed in order.
+    TARM_IO_DLL_PUBLIC void execute_on_loop_thread(std::vector<WorkCallback> callbacks);
 
     // Schedule on loop's thread, will block loop. Not thread safe.
     TARM_IO_DLL_PUBLIC void schedule_callback(const WorkCallback& callback);
@@ -81,7 +91,31 @@ public:
     // to schedule raw libuv operations using tarm-io library event loop.
     TARM_IO_DLL_PUBLIC void* raw_loop();
 
+    // Pool of buffers for received data of all network objects of this loop.
+    TARM_IO_DLL_PUBLIC BufferPool& buffer_pool();
+
+    // When enabled, TCP connections of this loop do not keep their own receive buffers between reads,
+    // all of them read into one shared buffer. This saves memory of idle connections. If user keeps
+    // DataChunk after receive callback, that buffer is left to user and a new one is used for next reads.
+    // Disabled by default.
+    TARM_IO_DLL_PUBLIC void set_shared_read_buffer(bool enabled);
+    TARM_IO_DLL_PUBLIC bool is_shared_read_buffer() const;
+
 private:
+    friend class Removable;
+    friend class detail::EventLoopAccess;
+
+    // Objects are removed in batches, once per loop cycle. See Removable::schedule_removal.
+    using RemovalCallback = void(*)(void*);
+    void schedule_removal(RemovalCallback callback, void* object);
+
+    // Same as schedule_callback, but callback is never executed before the next poll for I/O,
+    // the same way as libuv completes requests which were done synchronously.
+    void schedule_callback_after_poll(const WorkCallback& callback);
+
+    // Returns shared read buffer of at least 'size' bytes if it is not held by anyone else, otherwise new one.
+    std::shared_ptr<char> acquire_shared_read_buffer(std::size_t size);
+
     class Impl;
     std::unique_ptr<Impl> m_impl;
 };
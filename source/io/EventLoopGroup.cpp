@@ -0,0 +1,111 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "EventLoopGroup.h"
+
+#include <thread>
+#include <vector>
+
+#include <assert.h>
+
+namespace tarm {
+namespace io {
+
+class EventLoopGroup::Impl {
+public:
+    Impl(std::size_t loops_count);
+
+    std::size_t size() const;
+
+    EventLoop& loop(std::size_t index);
+
+    void execute_on_each_loop_thread(const EventLoop::WorkCallback& callback);
+
+    Error run();
+
+private:
+    std::vector<std::unique_ptr<EventLoop>> m_loops;
+};
+
+EventLoopGroup::Impl::Impl(std::size_t loops_count) {
+    if (loops_count == 0) {
+        loops_count = std::thread::hardware_concurrency();
+        if (loops_count == 0) {
+            loops_count = 1;
+        }
+    }
+
+    for (std::size_t i = 0; i < loops_count; ++i) {
+        m_loops.emplace_back(new EventLoop);
+    }
+}
+
+std::size_t EventLoopGroup::Impl::size() const {
+    return m_loops.size();
+}
+
+EventLoop& EventLoopGroup::Impl::loop(std::size_t index) {
+    assert(index < m_loops.size());
+    return *m_loops[index];
+}
+
+void EventLoopGroup::Impl::execute_on_each_loop_thread(const EventLoop::WorkCallback& callback) {
+    for (auto& loop : m_loops) {
+        loop->execute_on_loop_thread(callback);
+    }
+}
+
+Error EventLoopGroup::Impl::run() {
+    std::vector<Error> errors(m_loops.size(), Error(0));
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < m_loops.size(); ++i) {
+        threads.emplace_back([this, i, &errors]() {
+            errors[i] = m_loops[i]->run();
+        });
+    }
+
+    errors[0] = m_loops[0]->run();
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (auto& error : errors) {
+        if (error) {
+            return error;
+        }
+    }
+
+    return Error(0);
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+EventLoopGroup::EventLoopGroup(std::size_t loops_count) :
+    m_impl(new Impl(loops_count)) {
+}
+
+EventLoopGroup::~EventLoopGroup() {
+}
+
+std::size_t EventLoopGroup::size() const {
+    return m_impl->size();
+}
+
+EventLoop& EventLoopGroup::loop(std::size_t index) {
+    return m_impl->loop(index);
+}
+
+void EventLoopGroup::execute_on_each_loop_thread(const EventLoop::WorkCallback& callback) {
+    return m_impl->execute_on_each_loop_thread(callback);
+}
+
+Error EventLoopGroup::run() {
+    return m_impl->run();
+}
+
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,48 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+#include "Error.h"
+#include "EventLoop.h"
+#include "Export.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace tarm {
+namespace io {
+
+// Set of event loops, each one is executed in a separate thread by run().
+// Objects which belong to some loop should be created before run() or on the thread of that loop.
+class EventLoopGroup {
+public:
+    TARM_IO_FORBID_COPY(EventLoopGroup);
+    TARM_IO_FORBID_MOVE(EventLoopGroup);
+
+    // If loops_count is 0, number of loops is equal to number of CPU cores.
+    TARM_IO_DLL_PUBLIC explicit EventLoopGroup(std::size_t loops_count = 0);
+    TARM_IO_DLL_PUBLIC ~EventLoopGroup();
+
+    TARM_IO_DLL_PUBLIC std::size_t size() const;
+
+    TARM_IO_DLL_PUBLIC EventLoop& loop(std::size_t index);
+
+    // Call callback on the thread of each loop
+    // Note: this method is thread safe
+    TARM_IO_DLL_PUBLIC void execute_on_each_loop_thread(const EventLoop::WorkCallback& callback);
+
+    // Runs all loops, first one is executed on the calling thread. Returns when all loops exit.
+    // Result is the first error returned by any of loops.
+    TARM_IO_DLL_PUBLIC Error run();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace io
+} // namespace tarm
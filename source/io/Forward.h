@@ -11,12 +11,14 @@ namespace io {
 namespace net {
 
 class TcpServer;
+class TcpServerGroup;
 class TcpConnectedClient;
 class TcpClient;
 
 class TlsServer;
 class TlsConnectedClient;
 class TlsClient;
+class TlsSession;
 
 class DtlsServer;
 class DtlsConnectedClient;
@@ -24,10 +26,19 @@ class DtlsClient;
 
 class UdpClient;
 class UdpServer;
+class UdpServerGroup;
 class UdpPeer;
 
 } // namespace net
 
+namespace fs {
+
+class File;
+
+} // namespace fs
+
+class BufferPool;
+class EventLoopGroup;
 class RefCounted;
 class Removable;
 
@@ -37,6 +48,8 @@ namespace net {
 namespace detail {
 
 struct PeerId;
+class TcpPipe;
+class UdpSendQueue;
 
 } // namespace detail
 } // namespace net
@@ -3,17 +3,25 @@
  *  Licensed under the MIT License. See License.txt in the project root for license information.
  *----------------------------------------------------------------------------------------------*/
 
-#include "Common.h"
+#pragma once
+
+#include <cstddef>
 
 namespace tarm {
 namespace io {
-namespace detail {
 
-void default_alloc_buffer(uv_handle_t* /*handle*/, std::size_t suggested_size, uv_buf_t* buf) {
-    buf->base = new char[suggested_size];
-    buf->len = static_cast<decltype(uv_buf_t::len)>(suggested_size); // This cast is OK because suggested size is not more than 64 kB
-}
+// Memory supplied by user for incoming data, for example free space of application's ring buffer.
+// Library does not own this memory, it should remain valid until data is received into it.
+struct ReadBuffer {
+    ReadBuffer() = default;
+    ReadBuffer(char* d, std::size_t s) :
+        data(d),
+        size(s) {
+    }
+
+    char* data = nullptr;
+    std::size_t size = 0;
+};
 
-} // namespace detail
 } // namespace io
 } // namespace tarm
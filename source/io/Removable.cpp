@@ -29,8 +29,7 @@ public:
 
 protected:
     // statics
-    static void on_removal(uv_idle_t* handle);
-    static void on_delete_idle_handle_close(uv_handle_t* handle);
+    static void on_removal(void* object);
 
 private:
     EventLoop* m_loop;
@@ -69,12 +68,9 @@ void Removable::Impl::schedule_removal() {
 
     LOG_TRACE(m_loop, m_parent, "");
 
-    auto idle_ptr = new uv_idle_t;
-    idle_ptr->data = this;
-
-    // No need to handle errors here as we guarantee that callback is not null
-    uv_idle_init(reinterpret_cast<uv_loop_t*>(m_loop->raw_loop()), idle_ptr);
-    uv_idle_start(idle_ptr, on_removal);
+    // Loop keeps single queue of all objects to remove and deletes them in one pass,
+    // so no per-object allocations and libuv handles are required here.
+    m_loop->schedule_removal(on_removal, this);
 }
 
 void Removable::Impl::set_on_schedule_removal(const OnScheduleRemovalCallback& callback) {
@@ -87,15 +83,8 @@ void Removable::Impl::set_on_schedule_removal(const OnScheduleRemovalCallback& c
 
 ////////////////////////////////////////////// static //////////////////////////////////////////////
 
-void Removable::Impl::on_delete_idle_handle_close(uv_handle_t* handle) {
-    auto& this_ = *reinterpret_cast<Removable::Impl*>(handle->data);
-
-    delete this_.m_parent;
-    delete reinterpret_cast<uv_idle_t*>(handle);
-}
-
-void Removable::Impl::on_removal(uv_idle_t* handle) {
-    auto& this_ = *reinterpret_cast<Removable::Impl*>(handle->data);
+void Removable::Impl::on_removal(void* object) {
+    auto& this_ = *reinterpret_cast<Removable::Impl*>(object);
 
     this_.m_about_to_remove = true;
 
@@ -103,8 +92,7 @@ void Removable::Impl::on_removal(uv_idle_t* handle) {
         this_.m_on_remove_callback(*this_.m_parent);
     }
 
-    uv_idle_stop(handle);
-    uv_close(reinterpret_cast<uv_handle_t*>(handle), on_delete_idle_handle_close);
+    delete this_.m_parent;
 }
 
 Removable::DefaultDelete Removable::Impl::default_delete() {
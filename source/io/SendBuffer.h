@@ -0,0 +1,70 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace tarm {
+namespace io {
+
+// One segment of data sent by scatter/gather send_data overloads.
+// Segment keeps ownership of its memory (except raw pointer case) until send is completed.
+class SendBuffer {
+public:
+    TARM_IO_FORBID_COPY(SendBuffer);
+
+    // Memory pointed by 'c_str' should remain valid until send is completed
+    SendBuffer(const char* c_str, std::uint32_t size) :
+        m_data(c_str),
+        m_size(size) {
+    }
+
+    SendBuffer(std::shared_ptr<const char> buffer, std::uint32_t size) :
+        m_shared_buffer(std::move(buffer)),
+        m_data(m_shared_buffer.get()),
+        m_size(size) {
+    }
+
+    SendBuffer(std::unique_ptr<char[]> buffer, std::uint32_t size) :
+        m_unique_buffer(std::move(buffer)),
+        m_data(m_unique_buffer.get()),
+        m_size(size) {
+    }
+
+    SendBuffer(std::string&& message) :
+        m_string(std::move(message)),
+        m_is_string(true),
+        m_size(static_cast<std::uint32_t>(m_string.size())) {
+    }
+
+    SendBuffer(SendBuffer&& other) = default;
+    SendBuffer& operator=(SendBuffer&& other) = default;
+
+    const char* data() const {
+        // Pointer is not cached for strings because it is changed on move of a short string
+        return m_is_string ? m_string.data() : m_data;
+    }
+
+    std::uint32_t size() const {
+        return m_size;
+    }
+
+private:
+    std::shared_ptr<const char> m_shared_buffer;
+    std::unique_ptr<char[]> m_unique_buffer;
+    std::string m_string;
+    const char* m_data = nullptr;
+    bool m_is_string = false;
+    std::uint32_t m_size = 0;
+};
+
+} // namespace io
+} // namespace tarm
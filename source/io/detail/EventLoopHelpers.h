@@ -7,7 +7,9 @@
 
 #include "../EventLoop.h"
 
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <utility>
 
 namespace tarm {
@@ -44,6 +46,17 @@ void defer_execution_if_required(EventLoop& loop, F&& f, EventLoop& loop_as_para
     }
 }
 
+// Internal hooks of the loop for implementation of library objects, they are not part of public interface.
+class EventLoopAccess {
+public:
+    static void schedule_callback_after_poll(EventLoop& loop, const EventLoop::WorkCallback& callback) {
+        loop.schedule_callback_after_poll(callback);
+    }
+
+    static std::shared_ptr<char> acquire_shared_read_buffer(EventLoop& loop, std::size_t size) {
+        return loop.acquire_shared_read_buffer(size);
+    }
+};
 
 } // namespace detail
 } // namespace io
@@ -13,8 +13,21 @@ enum {
     IO_UV_HANDLE_BOUND =        0x00002000,
     IO_UV_HANDLE_SHUTTING =     0x00000100,
     IO_UV_HANDLE_READ_PENDING = 0x00010000,
+    IO_UV_HANDLE_UDP_CONNECTED = 0x02000000,
 };
 
+// uv_udp_connect is available since libuv 1.27.0
+#if UV_VERSION_HEX >= 0x11b00
+    #define TARM_IO_HAS_UV_UDP_CONNECT
+#endif
+
+// Batched receive of UDP datagrams replaces callback of internal uv_udp_t::io_watcher (uv__io_t).
+// Layout of these internals was checked against libuv 1.30.x only (bundled version), with other
+// versions datagrams are received one by one.
+#if defined(TARM_IO_PLATFORM_LINUX) && UV_VERSION_HEX >= 0x11e00 && UV_VERSION_HEX < 0x11f00
+    #define TARM_IO_HAS_UV_UDP_IO_WATCHER
+#endif
+
 
 // Reimplementation of uv_tcp_close_reset for old versions of libuv
 #if !(UV_VERSION_MAJOR >= 1 && UV_VERSION_MINOR >= 32 && UV_VERSION_PATCH >= 0)
@@ -0,0 +1,96 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "../CommonMacros.h"
+
+#include <atomic>
+
+namespace tarm {
+namespace io {
+namespace detail {
+
+// Base class for nodes of MpscQueue. Queue does not own its nodes.
+struct MpscQueueNode {
+    std::atomic<MpscQueueNode*> next{nullptr};
+};
+
+// Intrusive lock-free multiple producers single consumer queue (algorithm by Dmitry Vyukov).
+// push() is wait-free and could be called from any thread. pop() should be called only from one thread.
+// Note: pop() may return nullptr while some producer is in the middle of push(), in this case
+//       item becomes available for consumer right after that push() is complete.
+//       Popped node is not referenced by the queue anymore, so its 'next' field could be reused by consumer.
+class MpscQueue {
+public:
+    TARM_IO_FORBID_COPY(MpscQueue);
+    TARM_IO_FORBID_MOVE(MpscQueue);
+
+    MpscQueue() :
+        m_head(&m_stub),
+        m_tail(&m_stub) {
+    }
+
+    void push(MpscQueueNode* node) {
+        push_chain(node, node);
+    }
+
+    // Pushes sequence of nodes already linked by 'next' fields with a single atomic exchange.
+    void push_chain(MpscQueueNode* first, MpscQueueNode* last) {
+        last->next.store(nullptr, std::memory_order_relaxed);
+        MpscQueueNode* prev = m_head.exchange(last, std::memory_order_acq_rel);
+        prev->next.store(first, std::memory_order_release);
+    }
+
+    MpscQueueNode* pop() {
+        MpscQueueNode* tail = m_tail;
+        MpscQueueNode* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return nullptr; // Producer has not finished linking yet
+        }
+
+        push(&m_stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+    // Approximate check, intended to be called from consumer thread.
+    bool empty() const {
+        return m_tail == &m_stub &&
+               m_stub.next.load(std::memory_order_acquire) == nullptr &&
+               m_head.load(std::memory_order_acquire) == &m_stub;
+    }
+
+private:
+    std::atomic<MpscQueueNode*> m_head;
+    MpscQueueNode* m_tail;
+    MpscQueueNode m_stub;
+};
+
+} // namespace detail
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,209 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "../CommonMacros.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tarm {
+namespace io {
+namespace detail {
+
+// Size of inline storage is enough to hold std::function or lambda which captures up to 6 pointers.
+constexpr std::size_t UNIQUE_FUNCTION_INLINE_SIZE = 6 * sizeof(void*);
+
+template<typename Signature, std::size_t InlineSize = UNIQUE_FUNCTION_INLINE_SIZE>
+class UniqueFunction;
+
+// Move-only callable wrapper for internal storage of callbacks.
+// Unlike std::function it keeps callables of size up to InlineSize in place, without heap allocation,
+// and does not require callable to be copyable. Larger callables are allocated on heap.
+template<typename R, typename... Args, std::size_t InlineSize>
+class UniqueFunction<R(Args...), InlineSize> {
+public:
+    TARM_IO_FORBID_COPY(UniqueFunction);
+
+    UniqueFunction() = default;
+
+    UniqueFunction(std::nullptr_t) {
+    }
+
+    template<typename F,
+             typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, UniqueFunction>::value>::type>
+    UniqueFunction(F&& f) {
+        assign(std::forward<F>(f));
+    }
+
+    UniqueFunction(UniqueFunction&& other) noexcept {
+        move_from(other);
+    }
+
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    UniqueFunction& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    template<typename F,
+             typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, UniqueFunction>::value>::type>
+    UniqueFunction& operator=(F&& f) {
+        reset();
+        assign(std::forward<F>(f));
+        return *this;
+    }
+
+    ~UniqueFunction() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return m_ops != nullptr;
+    }
+
+    R operator()(Args... args) const {
+        return m_ops->invoke(const_cast<Storage&>(m_storage), std::forward<Args>(args)...);
+    }
+
+    void reset() {
+        if (m_ops) {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+private:
+    using Storage = typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type;
+
+    struct Ops {
+        R (*invoke)(Storage&, Args&&...);
+        void (*move)(Storage& from, Storage& to);
+        void (*destroy)(Storage&);
+    };
+
+    template<typename F>
+    struct InlineOps {
+        static F& get(Storage& s) {
+            return *reinterpret_cast<F*>(&s);
+        }
+
+        static R invoke(Storage& s, Args&&... args) {
+            return get(s)(std::forward<Args>(args)...);
+        }
+
+        static void move(Storage& from, Storage& to) {
+            new (&to) F(std::move(get(from)));
+            get(from).~F();
+        }
+
+        static void destroy(Storage& s) {
+            get(s).~F();
+        }
+
+        static const Ops ops;
+    };
+
+    template<typename F>
+    struct HeapOps {
+        static F*& get(Storage& s) {
+            return *reinterpret_cast<F**>(&s);
+        }
+
+        static R invoke(Storage& s, Args&&... args) {
+            return (*get(s))(std::forward<Args>(args)...);
+        }
+
+        static void move(Storage& from, Storage& to) {
+            new (&to) F*(get(from));
+        }
+
+        static void destroy(Storage& s) {
+            delete get(s);
+        }
+
+        static const Ops ops;
+    };
+
+    template<typename F>
+    using is_inline = std::integral_constant<bool,
+        sizeof(F) <= InlineSize &&
+        alignof(std::max_align_t) % alignof(F) == 0 &&
+        std::is_nothrow_move_constructible<F>::value>;
+
+    template<typename F>
+    void assign(F&& f) {
+        using FunctionType = typename std::decay<F>::type;
+        if (is_empty(f, 0)) {
+            return;
+        }
+
+        emplace<FunctionType>(std::forward<F>(f), is_inline<FunctionType>());
+    }
+
+    template<typename FunctionType, typename F>
+    void emplace(F&& f, std::true_type /*inline*/) {
+        new (&m_storage) FunctionType(std::forward<F>(f));
+        m_ops = &InlineOps<FunctionType>::ops;
+    }
+
+    template<typename FunctionType, typename F>
+    void emplace(F&& f, std::false_type /*inline*/) {
+        new (&m_storage) FunctionType*(new FunctionType(std::forward<F>(f)));
+        m_ops = &HeapOps<FunctionType>::ops;
+    }
+
+    void move_from(UniqueFunction& other) {
+        if (other.m_ops) {
+            other.m_ops->move(other.m_storage, m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    // Empty std::function or null function pointer result in empty UniqueFunction
+    template<typename F>
+    static auto is_empty(const F& f, int) -> decltype(!f, bool()) {
+        return !f;
+    }
+
+    template<typename F>
+    static bool is_empty(const F&, long) {
+        return false;
+    }
+
+    Storage m_storage;
+    const Ops* m_ops = nullptr;
+};
+
+template<typename R, typename... Args, std::size_t InlineSize>
+template<typename F>
+const typename UniqueFunction<R(Args...), InlineSize>::Ops UniqueFunction<R(Args...), InlineSize>::InlineOps<F>::ops = {
+    &UniqueFunction<R(Args...), InlineSize>::InlineOps<F>::invoke,
+    &UniqueFunction<R(Args...), InlineSize>::InlineOps<F>::move,
+    &UniqueFunction<R(Args...), InlineSize>::InlineOps<F>::destroy
+};
+
+template<typename R, typename... Args, std::size_t InlineSize>
+template<typename F>
+const typename UniqueFunction<R(Args...), InlineSize>::Ops UniqueFunction<R(Args...), InlineSize>::HeapOps<F>::ops = {
+    &UniqueFunction<R(Args...), InlineSize>::HeapOps<F>::invoke,
+    &UniqueFunction<R(Args...), InlineSize>::HeapOps<F>::move,
+    &UniqueFunction<R(Args...), InlineSize>::HeapOps<F>::destroy
+};
+
+} // namespace detail
+} // namespace io
+} // namespace tarm
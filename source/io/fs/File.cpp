@@ -73,6 +73,7 @@ public:
     void read_block(off_t offset, unsigned int bytes_count, const ReadCallback& read_callback);
 
     const Path& path() const;
+    int raw_handle() const;
 
     void stat(const StatCallback& callback);
 
@@ -315,6 +316,10 @@ const Path& File::Impl::path() const {
     return m_path;
 }
 
+int File::Impl::raw_handle() const {
+    return m_file_handle;
+}
+
 void File::Impl::schedule_read() {
     if (!is_open()) {
         return;
@@ -630,6 +635,10 @@ const Path& File::path() const {
     return m_impl->path();
 }
 
+int File::raw_handle() const {
+    return m_impl->raw_handle();
+}
+
 void File::stat(const StatCallback& callback) {
     return m_impl->stat(callback);
 }
@@ -52,6 +52,10 @@ public:
 
     TARM_IO_DLL_PUBLIC const Path& path() const;
 
+    // Native file descriptor, -1 if file is not open. Allows to pass the file to system calls
+    // such as sendfile. Descriptor is owned by the object and should not be closed by user.
+    TARM_IO_DLL_PUBLIC int raw_handle() const;
+
     TARM_IO_DLL_PUBLIC void stat(const StatCallback& callback);
 
     TARM_IO_DLL_PUBLIC void schedule_removal() override;
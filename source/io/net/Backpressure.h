@@ -0,0 +1,38 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+// Default backpressure policy for proxy-like forwarding of data from 'upstream' to 'downstream' connection.
+// Reading of 'upstream' is paused when data queued for sending to 'downstream' reaches 'high_watermark'
+// and is resumed when it drops to 'low_watermark'. Replaces watermarks and their callbacks of 'downstream'.
+// Any combination of TCP and TLS clients is supported.
+// Warning: 'upstream' should outlive 'downstream' or watermarks of 'downstream' should be disabled before
+//          removal of 'upstream'.
+template<typename UpstreamType, typename DownstreamType>
+void pause_read_on_backpressure(UpstreamType& upstream,
+                                DownstreamType& downstream,
+                                std::size_t high_watermark,
+                                std::size_t low_watermark) {
+    UpstreamType* upstream_ptr = &upstream;
+
+    downstream.set_send_watermarks(high_watermark, low_watermark);
+    downstream.set_high_watermark_callback([upstream_ptr](DownstreamType&) {
+        upstream_ptr->pause_read();
+    });
+    downstream.set_drain_callback([upstream_ptr](DownstreamType&) {
+        upstream_ptr->resume_read();
+    });
+}
+
+} // namespace net
+} // namespace io
+} // namespace tarm
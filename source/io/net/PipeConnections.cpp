@@ -0,0 +1,511 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "net/PipeConnections.h"
+
+#include "detail/TcpPipe.h"
+
+#include "BufferPool.h"
+#include "EventLoop.h"
+#include "net/TcpClient.h"
+#include "net/TcpConnectedClient.h"
+
+#include <uv.h>
+
+#include <memory>
+
+#ifndef TARM_IO_PLATFORM_WINDOWS
+    #include <sys/socket.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+#ifdef TARM_IO_PLATFORM_LINUX
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <signal.h>
+    #include <time.h>
+#endif
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+#ifdef TARM_IO_PLATFORM_WINDOWS
+
+class TcpPipe {
+public:
+    static Error start(TcpConnectedClient&, TcpClient&, const PipeEndCallback&, TcpPipeMode) {
+        return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED);
+    }
+};
+
+#else
+
+class TcpPipe {
+public:
+    static Error start(TcpConnectedClient& first, TcpClient& second, const PipeEndCallback& end_callback, TcpPipeMode mode);
+
+private:
+    // Poll handle uses duplicate of the socket descriptor because libuv allows only one watcher per descriptor
+    struct SocketPoll : public uv_poll_t {
+        int fd = -1;
+        std::size_t side_index = 0;
+    };
+
+    struct Side {
+        SocketPoll* poll = nullptr;
+        std::function<void()> close;
+        std::function<void(std::function<void()>)> set_close_observer;
+    };
+
+    // Data is moved from 'source' side to 'destination' side
+    struct Direction {
+        std::size_t source = 0;
+        std::size_t destination = 0;
+        // Splice mode, data is kept in the kernel pipe
+        int pipe_fds[2] = {-1, -1};
+        std::size_t pipe_capacity = 0;
+        // Relay mode, data is kept in the buffer
+        std::shared_ptr<char> buffer;
+        std::size_t buffer_offset = 0;
+        // Bytes which are read from source and are not written to destination yet
+        std::size_t pending = 0;
+        bool wait_readable = false;
+        bool wait_writable = false;
+        bool source_finished = false;
+        bool finished = false;
+    };
+
+    static const std::size_t NO_SIDE = std::size_t(-1);
+    // Pipe is enlarged from default 64KB, so less syscalls are made per transferred data
+    static const int PIPE_SIZE = 256 * 1024;
+    static const std::size_t RELAY_BUFFER_SIZE = 64 * 1024;
+    // Limits time spent in a single notification, so other events of the loop are not delayed
+    static const std::size_t MAX_BYTES_PER_ITERATION = 1024 * 1024;
+
+    TcpPipe(const PipeEndCallback& end_callback);
+    ~TcpPipe();
+
+    int open_poll(uv_tcp_t* tcp_stream, std::size_t side_index);
+    void init_direction(Direction& direction, EventLoop& loop, TcpPipeMode mode);
+
+    void pump(Direction& direction);
+    ssize_t read_source(Direction& direction);
+    ssize_t write_destination(Direction& direction);
+    int update_polls();
+
+    // 'closed_side' is index of the side which was closed by user, it is not closed again
+    void end(const Error& error, std::size_t closed_side);
+    void close_polls();
+
+    static void on_poll(uv_poll_t* handle, int status, int events);
+    static void on_poll_close(uv_handle_t* handle);
+
+    Side m_sides[2];
+    Direction m_directions[2];
+    PipeEndCallback m_end_callback;
+    std::size_t m_open_polls = 0;
+    bool m_ended = false;
+};
+
+const std::size_t TcpPipe::NO_SIDE;
+const int TcpPipe::PIPE_SIZE;
+const std::size_t TcpPipe::RELAY_BUFFER_SIZE;
+const std::size_t TcpPipe::MAX_BYTES_PER_ITERATION;
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+const int RELAY_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+// SO_NOSIGPIPE is set on sockets by libuv
+const int RELAY_SEND_FLAGS = 0;
+#endif
+
+#ifdef TARM_IO_PLATFORM_LINUX
+
+// Unlike send, splice has no MSG_NOSIGNAL flag. SIGPIPE is blocked for the call and the signal raised by it
+// is discarded, so closed connection is reported as EPIPE error.
+ssize_t splice_to_socket(int pipe_fd, int socket_fd, std::size_t size) {
+    sigset_t sigpipe_set;
+    sigemptyset(&sigpipe_set);
+    sigaddset(&sigpipe_set, SIGPIPE);
+
+    sigset_t old_set;
+    pthread_sigmask(SIG_BLOCK, &sigpipe_set, &old_set);
+
+    sigset_t pending_set;
+    sigpending(&pending_set);
+    const bool sigpipe_was_pending = sigismember(&pending_set, SIGPIPE) == 1;
+
+    const ssize_t result = ::splice(pipe_fd, nullptr, socket_fd, nullptr, size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    const int splice_errno = errno;
+
+    if (result == -1 && splice_errno == EPIPE && !sigpipe_was_pending) {
+        const timespec no_wait = {0, 0};
+        while (sigtimedwait(&sigpipe_set, nullptr, &no_wait) == -1 && errno == EINTR) {
+        }
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+
+    errno = splice_errno;
+    return result;
+}
+
+#endif // TARM_IO_PLATFORM_LINUX
+
+} // namespace
+
+TcpPipe::TcpPipe(const PipeEndCallback& end_callback) :
+    m_end_callback(end_callback) {
+    m_directions[0].source = 0;
+    m_directions[0].destination = 1;
+    m_directions[1].source = 1;
+    m_directions[1].destination = 0;
+}
+
+TcpPipe::~TcpPipe() {
+    for (auto& direction : m_directions) {
+        for (auto fd : direction.pipe_fds) {
+            if (fd != -1) {
+                ::close(fd);
+            }
+        }
+    }
+}
+
+Error TcpPipe::start(TcpConnectedClient& first, TcpClient& second, const PipeEndCallback& end_callback, TcpPipeMode mode) {
+    if (!first.is_open() || !second.is_open()) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    if (first.pending_send_bytes() || second.pending_send_bytes()) {
+        return Error(StatusCode::OPERATION_ALREADY_IN_PROGRESS);
+    }
+
+    auto first_stream = reinterpret_cast<uv_tcp_t*>(first.tcp_client_stream());
+    auto second_stream = reinterpret_cast<uv_tcp_t*>(second.tcp_client_stream());
+    if (first_stream->loop != second_stream->loop) {
+        return Error(StatusCode::INVALID_ARGUMENT, "Connections belong to different loops");
+    }
+
+    auto pipe = new TcpPipe(end_callback);
+
+    int status = pipe->open_poll(first_stream, 0);
+    if (status == 0) {
+        status = pipe->open_poll(second_stream, 1);
+    }
+
+    if (status < 0) {
+        if (pipe->m_open_polls) {
+            pipe->close_polls();
+        } else {
+            delete pipe;
+        }
+        return Error(status);
+    }
+
+    auto& loop = *reinterpret_cast<EventLoop*>(first_stream->loop->data);
+    for (auto& direction : pipe->m_directions) {
+        pipe->init_direction(direction, loop, mode);
+        direction.wait_readable = true;
+    }
+
+    // Data which is already received by libuv was delivered to receive callbacks, the rest is read by the pipe
+    first.pause_read();
+    second.pause_read();
+
+    TcpConnectedClient* first_ptr = &first;
+    TcpClient* second_ptr = &second;
+
+    pipe->m_sides[0].close = [first_ptr]() {
+        first_ptr->close();
+    };
+    pipe->m_sides[0].set_close_observer = [first_ptr](std::function<void()> observer) {
+        first_ptr->set_close_observer(std::move(observer));
+    };
+    pipe->m_sides[1].close = [second_ptr]() {
+        second_ptr->close();
+    };
+    pipe->m_sides[1].set_close_observer = [second_ptr](std::function<void()> observer) {
+        second_ptr->set_close_observer(std::move(observer));
+    };
+
+    for (std::size_t i = 0; i < 2; ++i) {
+        pipe->m_sides[i].set_close_observer([pipe, i]() {
+            pipe->end(Error(StatusCode::OPERATION_CANCELED), i);
+        });
+    }
+
+    status = pipe->update_polls();
+    if (status < 0) {
+        pipe->end(Error(status), NO_SIDE);
+    }
+
+    return Error(0);
+}
+
+int TcpPipe::open_poll(uv_tcp_t* tcp_stream, std::size_t side_index) {
+    uv_os_fd_t socket_fd = -1;
+    const int fileno_status = uv_fileno(reinterpret_cast<uv_handle_t*>(tcp_stream), &socket_fd);
+    if (fileno_status < 0) {
+        return fileno_status;
+    }
+
+    const int poll_fd = ::dup(socket_fd);
+    if (poll_fd == -1) {
+        return uv_translate_sys_error(errno);
+    }
+
+    auto poll = new SocketPoll;
+    poll->fd = poll_fd;
+    poll->side_index = side_index;
+    const int init_status = uv_poll_init(tcp_stream->loop, poll, poll_fd);
+    if (init_status < 0) {
+        ::close(poll_fd);
+        delete poll;
+        return init_status;
+    }
+
+    poll->data = this;
+    m_sides[side_index].poll = poll;
+    ++m_open_polls;
+    return 0;
+}
+
+void TcpPipe::init_direction(Direction& direction, EventLoop& loop, TcpPipeMode mode) {
+#ifdef TARM_IO_PLATFORM_LINUX
+    if (mode == TcpPipeMode::DEFAULT && ::pipe2(direction.pipe_fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+        // Failure is not critical, pipe keeps its default size
+        ::fcntl(direction.pipe_fds[1], F_SETPIPE_SZ, PIPE_SIZE);
+        const int capacity = ::fcntl(direction.pipe_fds[1], F_GETPIPE_SZ);
+        direction.pipe_capacity = capacity > 0 ? std::size_t(capacity) : 64 * 1024;
+        return;
+    }
+
+    direction.pipe_fds[0] = -1;
+    direction.pipe_fds[1] = -1;
+#else
+    (void)mode;
+#endif
+
+    direction.buffer = loop.buffer_pool().acquire(RELAY_BUFFER_SIZE);
+}
+
+void TcpPipe::pump(Direction& direction) {
+    std::size_t transferred = 0;
+
+    while (!m_ended && !direction.finished) {
+        if (direction.pending) {
+            const ssize_t result = write_destination(direction);
+            if (result > 0) {
+                direction.pending -= std::size_t(result);
+                transferred += std::size_t(result);
+                continue;
+            }
+
+            if (result == UV_EAGAIN) {
+                // Backpressure, source is not read until destination is writable
+                direction.wait_readable = false;
+                direction.wait_writable = true;
+                return;
+            }
+
+            end(Error(result), NO_SIDE);
+            return;
+        }
+
+        if (direction.source_finished) {
+            // All data is transferred, FIN is passed on to destination
+            direction.finished = true;
+            direction.wait_readable = false;
+            direction.wait_writable = false;
+
+            if (::shutdown(m_sides[direction.destination].poll->fd, SHUT_WR) == -1) {
+                end(Error(uv_translate_sys_error(errno)), NO_SIDE);
+                return;
+            }
+
+            if (m_directions[0].finished && m_directions[1].finished) {
+                end(Error(0), NO_SIDE);
+            }
+            return;
+        }
+
+        if (transferred >= MAX_BYTES_PER_ITERATION) {
+            direction.wait_readable = true;
+            direction.wait_writable = false;
+            return;
+        }
+
+        const ssize_t result = read_source(direction);
+        if (result > 0) {
+            direction.pending = std::size_t(result);
+            direction.buffer_offset = 0;
+        } else if (result == 0) {
+            direction.source_finished = true;
+        } else if (result == UV_EAGAIN) {
+            direction.wait_readable = true;
+            direction.wait_writable = false;
+            return;
+        } else {
+            end(Error(result), NO_SIDE);
+            return;
+        }
+    }
+}
+
+ssize_t TcpPipe::read_source(Direction& direction) {
+    const int source_fd = m_sides[direction.source].poll->fd;
+
+    ssize_t result = -1;
+    do {
+#ifdef TARM_IO_PLATFORM_LINUX
+        if (direction.pipe_fds[1] != -1) {
+            result = ::splice(source_fd, nullptr, direction.pipe_fds[1], nullptr, direction.pipe_capacity,
+                              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            continue;
+        }
+#endif
+        result = ::recv(source_fd, direction.buffer.get(), RELAY_BUFFER_SIZE, 0);
+    } while (result == -1 && errno == EINTR);
+
+    return result >= 0 ? result : uv_translate_sys_error(errno);
+}
+
+ssize_t TcpPipe::write_destination(Direction& direction) {
+    const int destination_fd = m_sides[direction.destination].poll->fd;
+
+    ssize_t result = -1;
+    do {
+#ifdef TARM_IO_PLATFORM_LINUX
+        if (direction.pipe_fds[0] != -1) {
+            result = splice_to_socket(direction.pipe_fds[0], destination_fd, direction.pending);
+            continue;
+        }
+#endif
+        result = ::send(destination_fd, direction.buffer.get() + direction.buffer_offset, direction.pending, RELAY_SEND_FLAGS);
+        if (result > 0) {
+            direction.buffer_offset += std::size_t(result);
+        }
+    } while (result == -1 && errno == EINTR);
+
+    return result >= 0 ? result : uv_translate_sys_error(errno);
+}
+
+int TcpPipe::update_polls() {
+    for (std::size_t i = 0; i < 2; ++i) {
+        int events = 0;
+        if (m_directions[i].wait_readable) {
+            events |= UV_READABLE;
+        }
+        if (m_directions[1 - i].wait_writable) {
+            events |= UV_WRITABLE;
+        }
+
+        const int status = events ? uv_poll_start(m_sides[i].poll, events, on_poll) : uv_poll_stop(m_sides[i].poll);
+        if (status < 0) {
+            return status;
+        }
+    }
+
+    return 0;
+}
+
+void TcpPipe::end(const Error& error, std::size_t closed_side) {
+    if (m_ended) {
+        return;
+    }
+
+    m_ended = true;
+
+    for (std::size_t i = 0; i < 2; ++i) {
+        if (i != closed_side) {
+            m_sides[i].set_close_observer(nullptr);
+        }
+    }
+
+    close_polls();
+
+    // Object is removed when poll handles are closed, so it is still valid here
+    auto end_callback = std::move(m_end_callback);
+    m_end_callback = nullptr;
+    if (end_callback) {
+        end_callback(error);
+        return;
+    }
+
+    for (std::size_t i = 0; i < 2; ++i) {
+        if (i != closed_side) {
+            m_sides[i].close();
+        }
+    }
+}
+
+void TcpPipe::close_polls() {
+    for (auto& side : m_sides) {
+        if (side.poll) {
+            uv_close(reinterpret_cast<uv_handle_t*>(side.poll), on_poll_close);
+            side.poll = nullptr;
+        }
+    }
+}
+
+void TcpPipe::on_poll(uv_poll_t* handle, int status, int events) {
+    auto& this_ = *reinterpret_cast<TcpPipe*>(handle->data);
+    const std::size_t side_index = reinterpret_cast<SocketPoll*>(handle)->side_index;
+
+    // libuv reports socket errors as UV_EBADF and stops the poll, actual error is returned by the next
+    // read or write, so both directions of the side are continued.
+    if (status < 0 || (events & UV_READABLE)) {
+        this_.pump(this_.m_directions[side_index]);
+    }
+    if (status < 0 || (events & UV_WRITABLE)) {
+        this_.pump(this_.m_directions[1 - side_index]);
+    }
+
+    if (this_.m_ended) {
+        return;
+    }
+
+    const int update_status = this_.update_polls();
+    if (update_status < 0) {
+        this_.end(Error(update_status), NO_SIDE);
+    }
+}
+
+void TcpPipe::on_poll_close(uv_handle_t* handle) {
+    auto poll = reinterpret_cast<SocketPoll*>(handle);
+    auto& this_ = *reinterpret_cast<TcpPipe*>(handle->data);
+
+    ::close(poll->fd);
+    delete poll;
+
+    if (--this_.m_open_polls == 0) {
+        delete &this_;
+    }
+}
+
+#endif // TARM_IO_PLATFORM_WINDOWS
+
+Error pipe_connections(TcpConnectedClient& first,
+                       TcpClient& second,
+                       const PipeEndCallback& end_callback,
+                       TcpPipeMode mode) {
+    return TcpPipe::start(first, second, end_callback, mode);
+}
+
+} // namespace detail
+
+Error pipe_connections(TcpConnectedClient& first, TcpClient& second, const PipeEndCallback& end_callback) {
+    return detail::pipe_connections(first, second, end_callback, detail::TcpPipeMode::DEFAULT);
+}
+
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,42 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "Error.h"
+#include "Export.h"
+#include "Forward.h"
+
+#include <functional>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+using PipeEndCallback = std::function<void(const Error&)>;
+
+// Proxy primitive. Forwards data between two connections of the same loop in both directions, until both
+// directions are finished. On Linux data is moved by splice(2) through a kernel pipe and is never copied to
+// user space, on other Unix platforms (or when pipe can not be created) it is relayed through a buffer from
+// the pool of the loop. Reading of both connections is paused and their receive callbacks are not called.
+// Backpressure is preserved, source is not read while its destination can not accept more data, so the
+// sending side is slowed down by TCP flow control. When source is finished (FIN received), remaining data is
+// transferred and destination is half-closed, the opposite direction continues to work.
+// When both directions are finished, on error or when one of connections is closed by user, pipe is ended
+// and 'end_callback' is called. Connections are not closed by the pipe, usually they are removed from the
+// callback. If callback is not set, connections are closed.
+// Data sent to connections before should be passed to the OS already (see pending_send_bytes), and nothing
+// should be sent to them until the end of the pipe.
+// Warning: half-close is done on socket level, bypassing the connection object. After 'end_callback' do not call
+//          send_data or shutdown() on a connection which was half-closed by the pipe (its source connection was
+//          finished before the end), close it instead.
+// Note: not implemented on Windows.
+TARM_IO_DLL_PUBLIC Error pipe_connections(TcpConnectedClient& first,
+                                          TcpClient& second,
+                                          const PipeEndCallback& end_callback = nullptr);
+
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include "Backpressure.h"
+#include "PipeConnections.h"
 #include "TcpClient.h"
 #include "TcpConnectedClient.h"
 #include "TcpServer.h"
+#include "TcpServerGroup.h"
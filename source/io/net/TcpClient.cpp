@@ -35,6 +35,10 @@ public:
 
     void shutdown();
 
+    void resume_read();
+
+    uv_tcp_t* tcp_client_stream();
+
     EventLoop* loop();
 
 protected:
@@ -66,6 +70,10 @@ TcpClient::Impl::~Impl() {
     LOG_TRACE(m_loop, this, "");
 }
 
+uv_tcp_t* TcpClient::Impl::tcp_client_stream() {
+    return m_tcp_stream;
+}
+
 EventLoop* TcpClient::Impl::loop() {
     return m_loop;
 }
@@ -76,6 +84,7 @@ void TcpClient::Impl::connect(const Endpoint& endpoint,
                               const DataReceiveCallback& receive_callback,
                               const CloseCallback& close_callback) {
     if (m_tcp_stream) {
+        cancel_direct_sends();
         m_tcp_stream->data = nullptr;
         uv_close(reinterpret_cast<uv_handle_t*>(m_tcp_stream), on_close);
         m_tcp_stream = nullptr;
@@ -136,6 +145,14 @@ void TcpClient::Impl::shutdown() {
         return;
     }
 
+    // FIN is sent after the file which is being sent
+    if (should_hold_send()) {
+        hold_send([this]() {
+            this->shutdown();
+        });
+        return;
+    }
+
     auto shutdown_req = new uv_shutdown_t;
     shutdown_req->data = this;
     uv_shutdown(shutdown_req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), on_shutdown);
@@ -158,6 +175,7 @@ bool TcpClient::Impl::close() {
     LOG_TRACE(m_loop, m_parent, "endpoint:", m_destination_endpoint, "m_tcp_stream:",m_tcp_stream);
 
     m_is_open = false;
+    cancel_direct_sends();
 
     if (m_tcp_stream && !uv_is_closing(reinterpret_cast<uv_handle_t*>(m_tcp_stream))) {
         uv_close(reinterpret_cast<uv_handle_t*>(m_tcp_stream), on_close);
@@ -178,6 +196,7 @@ void TcpClient::Impl::close_with_reset() {
     LOG_TRACE(m_loop, m_parent, "endpoint:", m_destination_endpoint);
 
     m_is_open = false;
+    cancel_direct_sends(true);
 
     if (m_tcp_stream && !uv_is_closing(reinterpret_cast<uv_handle_t*>(m_tcp_stream))) {
         uv_tcp_close_reset(m_tcp_stream, on_close);
@@ -244,7 +263,8 @@ void TcpClient::Impl::on_connect(uv_connect_t* req, int uv_status) {
     }
     */
 
-    if (this_.is_open()) { // could be closed in on_new_connection callback
+    // Could be closed or paused in connect callback
+    if (this_.is_open() && !this_.m_read_paused) {
         const Error read_error = uv_read_start(req->handle, alloc_read_buffer, on_read);
         if (read_error) {
             this_.on_read_error(read_error);
@@ -252,6 +272,24 @@ void TcpClient::Impl::on_connect(uv_connect_t* req, int uv_status) {
     }
 }
 
+void TcpClient::Impl::resume_read() {
+    if (!m_read_paused) {
+        return;
+    }
+
+    m_read_paused = false;
+
+    // If connection is not established yet, reading is started on connect
+    if (!is_open()) {
+        return;
+    }
+
+    const Error read_error = uv_read_start(reinterpret_cast<uv_stream_t*>(m_tcp_stream), alloc_read_buffer, on_read);
+    if (read_error) {
+        on_read_error(read_error);
+    }
+}
+
 void TcpClient::Impl::on_close(uv_handle_t* handle) {
     auto loop_ptr = reinterpret_cast<EventLoop*>(handle->loop->data);
     LOG_TRACE(loop_ptr, "");
@@ -279,6 +317,10 @@ void TcpClient::Impl::on_close(uv_handle_t* handle) {
 
 void TcpClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
     auto& this_ = *reinterpret_cast<TcpClient::Impl*>(handle->data);
+
+    if (this_.on_no_read_buffer(nread)) {
+        return;
+    }
     auto& loop = *reinterpret_cast<EventLoop*>(handle->loop->data);
 
     this_.m_connect_req.reset();
@@ -287,7 +329,7 @@ void TcpClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t
     if (!error) {
         if (nread && this_.m_receive_callback) {
             const auto prev_use_count = this_.m_read_buf.use_count();
-            this_.m_receive_callback(*this_.m_parent, {this_.m_read_buf,  std::size_t(nread), this_.m_data_offset}, Error(0));
+            this_.m_receive_callback(*this_.m_parent, {this_.received_data_buffer(buf), std::size_t(nread), this_.m_data_offset}, Error(0));
             if (prev_use_count != this_.m_read_buf.use_count()) { // user made a copy
                 this_.m_read_buf.reset(); // will reallocate new one on demand
             }
@@ -308,6 +350,8 @@ void TcpClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t
 
         if (this_.m_close_callback) {
             this_.m_is_open = false;
+            // Peer may still receive data which is already passed to the socket only after end of file
+            this_.cancel_direct_sends(error != StatusCode::END_OF_FILE);
 
             // Need this because user may connect to other endpoint in close callback
             auto old_tcp_stream = this_.m_tcp_stream;
@@ -319,6 +363,8 @@ void TcpClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t
             uv_close(reinterpret_cast<uv_handle_t*>(old_tcp_stream), on_close);
         }
     }
+
+    this_.release_shared_read_buffer();
 }
 
 ///////////////////////////////////////// implementation ///////////////////////////////////////////
@@ -383,14 +429,58 @@ void TcpClient::send_data(std::string&& message, const EndSendCallback& callback
     return m_impl->send_data(std::move(message), callback);
 }
 
+void TcpClient::send_data(std::vector<SendBuffer> buffers, const EndSendCallback& callback) {
+    return m_impl->send_data(std::move(buffers), callback);
+}
+
 std::size_t TcpClient::pending_send_requesets() const {
     return m_impl->pending_write_requests();
 }
 
+std::size_t TcpClient::pending_send_bytes() const {
+    return m_impl->pending_send_bytes();
+}
+
+void TcpClient::set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark) {
+    return m_impl->set_send_watermarks(high_watermark, low_watermark);
+}
+
+void TcpClient::set_high_watermark_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_high_watermark_callback(callback);
+}
+
+void TcpClient::set_drain_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_drain_callback(callback);
+}
+
 void TcpClient::shutdown() {
     return m_impl->shutdown();
 }
 
+void TcpClient::set_read_buffer_callback(const ReadBufferCallback& callback) {
+    return m_impl->set_read_buffer_callback(callback);
+}
+
+void TcpClient::send_file(fs::File& file,
+                        std::uint64_t offset,
+                        std::uint64_t length,
+                        const EndSendCallback& callback,
+                        const SendFileProgressCallback& progress_callback) {
+    return m_impl->send_file(file, offset, length, callback, progress_callback);
+}
+
+void TcpClient::pause_read() {
+    return m_impl->pause_read();
+}
+
+void TcpClient::resume_read() {
+    return m_impl->resume_read();
+}
+
+bool TcpClient::is_read_paused() const {
+    return m_impl->is_read_paused();
+}
+
 void TcpClient::delay_send(bool enabled) {
     return m_impl->delay_send(enabled);
 }
@@ -399,10 +489,26 @@ bool TcpClient::is_delay_send() const {
     return m_impl->is_delay_send();
 }
 
+Error TcpClient::zero_copy_send(bool enabled, std::size_t min_size) {
+    return m_impl->zero_copy_send(enabled, min_size);
+}
+
+bool TcpClient::is_zero_copy_send() const {
+    return m_impl->is_zero_copy_send();
+}
+
 void TcpClient::close_with_reset() {
     return m_impl->close_with_reset();
 }
 
+void* TcpClient::tcp_client_stream() {
+    return m_impl->tcp_client_stream();
+}
+
+void TcpClient::set_close_observer(std::function<void()> observer) {
+    return m_impl->set_close_observer(std::move(observer));
+}
+
 } // namespace net
 } // namespace io
 } // namespace tarm
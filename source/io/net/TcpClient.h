@@ -9,12 +9,16 @@
 #include "net/Endpoint.h"
 #include "EventLoop.h"
 #include "Export.h"
+#include "Forward.h"
 #include "DataChunk.h"
+#include "ReadBuffer.h"
 #include "Removable.h"
+#include "SendBuffer.h"
 #include "UserDataHolder.h"
 #include "Error.h"
 
 #include <memory>
+#include <vector>
 
 namespace tarm {
 namespace io {
@@ -23,10 +27,16 @@ namespace net {
 class TcpClient : public Removable,
                   public UserDataHolder {
 public:
+    friend class detail::TcpPipe;
+    friend class TlsClient;
+
     using ConnectCallback = std::function<void(TcpClient&, const Error&)>;
     using DataReceiveCallback = std::function<void(TcpClient&, const DataChunk&, const Error&)>;
     using CloseCallback = std::function<void(TcpClient&, const Error&)>;
     using EndSendCallback = std::function<void(TcpClient&, const Error&)>;
+    using SendWatermarkCallback = std::function<void(TcpClient&)>;
+    using ReadBufferCallback = std::function<ReadBuffer(TcpClient&, std::size_t suggested_size)>;
+    using SendFileProgressCallback = std::function<void(TcpClient&, std::uint64_t bytes_sent)>;
 
     TARM_IO_FORBID_COPY(TcpClient);
     TARM_IO_FORBID_MOVE(TcpClient);
@@ -66,18 +76,62 @@ public:
     TARM_IO_DLL_PUBLIC void send_data(std::unique_ptr<char[]> buffer, std::uint32_t size, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(const std::string& message, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(std::string&& message, const EndSendCallback& callback = nullptr);
+    // All buffers are sent as a single write, callback is called once
+    TARM_IO_DLL_PUBLIC void send_data(std::vector<SendBuffer> buffers, const EndSendCallback& callback = nullptr);
+
+    // Sends 'length' bytes of opened 'file' starting from 'offset' without copying of data through user space.
+    // Data is passed to the socket as fast as it is able to accept it. Sends made before are transferred first,
+    // sends made after are held until the file is sent. Progress callback receives total number of sent bytes.
+    // File should stay open until EndSendCallback is called. Currently implemented only on Linux (sendfile).
+    TARM_IO_DLL_PUBLIC void send_file(fs::File& file,
+                                      std::uint64_t offset,
+                                      std::uint64_t length,
+                                      const EndSendCallback& callback = nullptr,
+                                      const SendFileProgressCallback& progress_callback = nullptr);
 
     TARM_IO_DLL_PUBLIC std::size_t pending_send_requesets() const;
+    // Number of bytes passed to send_data which are not transferred to the operating system yet.
+    // Data which could be written to the socket immediately is not counted.
+    TARM_IO_DLL_PUBLIC std::size_t pending_send_bytes() const;
+
+    // Send side backpressure. When pending send bytes reach 'high_watermark', high watermark callback is called.
+    // After that, when they drop to 'low_watermark' or below, drain callback is called. Each callback is called
+    // once per crossing. Value 0 of 'high_watermark' disables watermarks (default).
+    TARM_IO_DLL_PUBLIC void set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark);
+    TARM_IO_DLL_PUBLIC void set_high_watermark_callback(const SendWatermarkCallback& callback);
+    TARM_IO_DLL_PUBLIC void set_drain_callback(const SendWatermarkCallback& callback);
+
+    // Stops reading of data from the connection, so the other side is slowed down by TCP flow control.
+    // Warning: closing of connection by the other side is not detected while reading is paused.
+    TARM_IO_DLL_PUBLIC void pause_read();
+    TARM_IO_DLL_PUBLIC void resume_read();
+    TARM_IO_DLL_PUBLIC bool is_read_paused() const;
+
+    // Pull mode reads. Before each read callback supplies memory where received data is placed directly,
+    // DataChunk passed to DataReceiveCallback points into that memory and does not own it. If empty buffer is
+    // returned, reading is paused, call resume_read when there is free space. Callback is not used by default.
+    TARM_IO_DLL_PUBLIC void set_read_buffer_callback(const ReadBufferCallback& callback);
 
     TARM_IO_DLL_PUBLIC void shutdown();
 
     TARM_IO_DLL_PUBLIC void delay_send(bool enabled);
     TARM_IO_DLL_PUBLIC bool is_delay_send() const;
 
+    // Zero-copy mode for large sends (MSG_ZEROCOPY, Linux only). Data of std::shared_ptr<const char> buffers
+    // of at least 'min_size' bytes is transmitted by the kernel directly from the buffer. Buffer is referenced and
+    // should not be modified until the kernel releases it, EndSendCallback is called only then. So callbacks of
+    // zero-copy sends may be called after callbacks of sends made later. Smaller sends, other buffer types and
+    // sends made while previous data is queued are copied as usual. Connection should be established.
+    TARM_IO_DLL_PUBLIC Error zero_copy_send(bool enabled, std::size_t min_size = 64 * 1024);
+    TARM_IO_DLL_PUBLIC bool is_zero_copy_send() const;
+
 protected:
     TARM_IO_DLL_PUBLIC ~TcpClient();
 
 private:
+    void* tcp_client_stream();
+    void set_close_observer(std::function<void()> observer);
+
     class Impl;
     std::unique_ptr<Impl> m_impl;
 };
@@ -30,6 +30,7 @@ public:
     void shutdown();
 
     void start_read(const DataReceiveCallback& data_receive_callback);
+    void resume_read();
     uv_tcp_t* tcp_client_stream();
 
     TcpServer& server();
@@ -70,10 +71,21 @@ void TcpConnectedClient::Impl::shutdown() {
         return;
     }
 
+    // FIN is sent after the file which is being sent
+    if (should_hold_send()) {
+        hold_send([this]() {
+            this->shutdown();
+        });
+        return;
+    }
+
     LOG_TRACE(m_loop, m_parent, "endpoint:", this->endpoint());
 
     m_is_open = false;
 
+    // Corked data is sent before FIN
+    flush();
+
     auto shutdown_req = new uv_shutdown_t;
     shutdown_req->data = this;
     uv_shutdown(shutdown_req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), on_shutdown);
@@ -92,6 +104,8 @@ void TcpConnectedClient::Impl::close() {
 
     m_is_open = false;
 
+    flush();
+    cancel_direct_sends();
     uv_close(reinterpret_cast<uv_handle_t*>(m_tcp_stream), on_close);
 }
 
@@ -104,12 +118,20 @@ void TcpConnectedClient::Impl::close_with_reset() {
 
     m_is_open = false;
 
+    flush();
+    cancel_direct_sends(true);
     uv_tcp_close_reset(m_tcp_stream, on_close);
 }
 
 void TcpConnectedClient::Impl::start_read(const DataReceiveCallback& data_receive_callback) {
     m_receive_callback = nullptr;
 
+    // Reading was paused in new connection callback, it is started by resume_read
+    if (m_read_paused) {
+        m_receive_callback = data_receive_callback;
+        return;
+    }
+
     const Error read_error = uv_read_start(reinterpret_cast<uv_stream_t*>(m_tcp_stream),
                                            alloc_read_buffer,
                                            on_read);
@@ -122,6 +144,27 @@ void TcpConnectedClient::Impl::start_read(const DataReceiveCallback& data_receiv
     }
 }
 
+void TcpConnectedClient::Impl::resume_read() {
+    if (!m_read_paused) {
+        return;
+    }
+
+    m_read_paused = false;
+
+    if (!is_open()) {
+        return;
+    }
+
+    const Error read_error = uv_read_start(reinterpret_cast<uv_stream_t*>(m_tcp_stream),
+                                           alloc_read_buffer,
+                                           on_read);
+    if (read_error) {
+        m_loop->schedule_callback([this, read_error](io::EventLoop&) {
+            this->on_read_error(read_error);
+        });
+    }
+}
+
 TcpServer& TcpConnectedClient::Impl::server() {
     return *m_server;
 }
@@ -161,6 +204,10 @@ void TcpConnectedClient::Impl::on_close(uv_handle_t* handle) {
 void TcpConnectedClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf) {
     auto& this_ = *reinterpret_cast<TcpConnectedClient::Impl*>(handle->data);
 
+    if (this_.on_no_read_buffer(nread)) {
+        return;
+    }
+
     if (nread >= 0) {
         LOG_TRACE(this_.m_loop, this_.m_parent, "Received data, size:", nread);
     } else {
@@ -171,7 +218,7 @@ void TcpConnectedClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const
     if (!error) {
         if (nread && this_.m_receive_callback) {
             const auto prev_use_count = this_.m_read_buf.use_count();
-            this_.m_receive_callback(*this_.m_parent, {this_.m_read_buf,  std::size_t(nread), this_.m_data_offset}, Error(0));
+            this_.m_receive_callback(*this_.m_parent, {this_.received_data_buffer(buf), std::size_t(nread), this_.m_data_offset}, Error(0));
             if (prev_use_count != this_.m_read_buf.use_count()) { // user made a copy
                 this_.m_read_buf.reset(); // will reallocate new one on demand
             }
@@ -195,6 +242,8 @@ void TcpConnectedClient::Impl::on_read(uv_stream_t* handle, ssize_t nread, const
         this_.m_close_callback = nullptr;
         this_.close();
     }
+
+    this_.release_shared_read_buffer();
 }
 
 ///////////////////////////////////////// implementation ///////////////////////////////////////////
@@ -247,10 +296,30 @@ void TcpConnectedClient::send_data(std::string&& message, const EndSendCallback&
     return m_impl->send_data(std::move(message), callback);
 }
 
+void TcpConnectedClient::send_data(std::vector<SendBuffer> buffers, const EndSendCallback& callback) {
+    return m_impl->send_data(std::move(buffers), callback);
+}
+
 std::size_t TcpConnectedClient::pending_send_requesets() const {
     return m_impl->pending_write_requests();
 }
 
+std::size_t TcpConnectedClient::pending_send_bytes() const {
+    return m_impl->pending_send_bytes();
+}
+
+void TcpConnectedClient::set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark) {
+    return m_impl->set_send_watermarks(high_watermark, low_watermark);
+}
+
+void TcpConnectedClient::set_high_watermark_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_high_watermark_callback(callback);
+}
+
+void TcpConnectedClient::set_drain_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_drain_callback(callback);
+}
+
 void TcpConnectedClient::shutdown() {
     return m_impl->shutdown();
 }
@@ -263,6 +332,34 @@ void* TcpConnectedClient::tcp_client_stream() {
     return m_impl->tcp_client_stream();
 }
 
+void TcpConnectedClient::set_close_observer(std::function<void()> observer) {
+    return m_impl->set_close_observer(std::move(observer));
+}
+
+void TcpConnectedClient::set_read_buffer_callback(const ReadBufferCallback& callback) {
+    return m_impl->set_read_buffer_callback(callback);
+}
+
+void TcpConnectedClient::send_file(fs::File& file,
+                        std::uint64_t offset,
+                        std::uint64_t length,
+                        const EndSendCallback& callback,
+                        const SendFileProgressCallback& progress_callback) {
+    return m_impl->send_file(file, offset, length, callback, progress_callback);
+}
+
+void TcpConnectedClient::pause_read() {
+    return m_impl->pause_read();
+}
+
+void TcpConnectedClient::resume_read() {
+    return m_impl->resume_read();
+}
+
+bool TcpConnectedClient::is_read_paused() const {
+    return m_impl->is_read_paused();
+}
+
 void TcpConnectedClient::delay_send(bool enabled) {
     return m_impl->delay_send(enabled);
 }
@@ -271,6 +368,26 @@ bool TcpConnectedClient::is_delay_send() const {
     return m_impl->is_delay_send();
 }
 
+void TcpConnectedClient::cork_send(bool enabled) {
+    return m_impl->cork_send(enabled);
+}
+
+bool TcpConnectedClient::is_cork_send() const {
+    return m_impl->is_cork_send();
+}
+
+void TcpConnectedClient::flush() {
+    return m_impl->flush();
+}
+
+Error TcpConnectedClient::zero_copy_send(bool enabled, std::size_t min_size) {
+    return m_impl->zero_copy_send(enabled, min_size);
+}
+
+bool TcpConnectedClient::is_zero_copy_send() const {
+    return m_impl->is_zero_copy_send();
+}
+
 TcpServer& TcpConnectedClient::server() {
     return m_impl->server();
 }
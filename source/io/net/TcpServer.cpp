@@ -5,6 +5,7 @@
 
 
 #include "detail/Common.h"
+#include "detail/LibuvCompatibility.h"
 #include "detail/LogMacros.h"
 #include "net/TcpServer.h"
 
@@ -40,6 +41,9 @@ public:
 
     const Endpoint& endpoint() const;
 
+    void set_reuse_port(bool enabled);
+    bool is_reuse_port() const;
+
     bool schedule_removal();
 
     bool is_open() const;
@@ -72,6 +76,7 @@ private:
     Endpoint m_endpoint;
 
     bool m_is_open = false;
+    bool m_reuse_port = false;
 };
 
 TcpServer::Impl::Impl(EventLoop& loop, TcpServer& parent) :
@@ -111,12 +116,35 @@ Error TcpServer::Impl::listen(const Endpoint& endpoint,
         return init_error;
     }
 
+    if (m_reuse_port) {
+#ifdef SO_REUSEPORT
+        int value = 1;
+        const Error reuse_port_error = tarm_io_socket_option(reinterpret_cast<uv_handle_t*>(m_server_handle), SO_REUSEPORT, &value);
+#else
+        const Error reuse_port_error(StatusCode::OPERATION_NOT_SUPPORTED_ON_SOCKET);
+#endif
+        if (reuse_port_error) {
+            LOG_ERROR(m_loop, m_parent, "Failed to set SO_REUSEPORT:", reuse_port_error.string());
+            return reuse_port_error;
+        }
+    }
+
     const int bind_status = uv_tcp_bind(m_server_handle, reinterpret_cast<const struct sockaddr*>(m_endpoint.raw_endpoint()), 0);
     if (bind_status < 0) {
         LOG_ERROR(m_loop, m_parent, "Bind failed:", uv_strerror(bind_status));
         return bind_status;
     }
 
+    if (m_endpoint.port() == 0) {
+        // Port assigned by the system
+        struct sockaddr_storage info;
+        int info_len = sizeof info;
+        const Error getsockname_error = uv_tcp_getsockname(m_server_handle, reinterpret_cast<struct sockaddr*>(&info), &info_len);
+        if (!getsockname_error) {
+            m_endpoint = Endpoint(reinterpret_cast<const Endpoint::sockaddr_placeholder*>(&info));
+        }
+    }
+
     m_new_connection_callback = new_connection_callback;
     m_data_receive_callback = data_receive_callback;
     m_close_connection_callback = close_connection_callback;
@@ -135,6 +163,14 @@ const Endpoint& TcpServer::Impl::endpoint() const {
     return m_endpoint;
 }
 
+void TcpServer::Impl::set_reuse_port(bool enabled) {
+    m_reuse_port = enabled;
+}
+
+bool TcpServer::Impl::is_reuse_port() const {
+    return m_reuse_port;
+}
+
 void TcpServer::Impl::shutdown(const ShutdownServerCallback& shutdown_callback) {
     LOG_TRACE(m_loop, m_parent);
 
@@ -357,6 +393,14 @@ const Endpoint& TcpServer::endpoint() const {
     return m_impl->endpoint();
 }
 
+void TcpServer::set_reuse_port(bool enabled) {
+    return m_impl->set_reuse_port(enabled);
+}
+
+bool TcpServer::is_reuse_port() const {
+    return m_impl->is_reuse_port();
+}
+
 void TcpServer::schedule_removal() {
     const bool ready_to_remove = m_impl->schedule_removal();
     if (ready_to_remove) {
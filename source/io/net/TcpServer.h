@@ -47,6 +47,12 @@ public:
 
     TARM_IO_DLL_PUBLIC TcpServer(EventLoop& loop);
 
+    // Allows several servers (usually running in different loops) to listen on the same endpoint,
+    // kernel distributes incoming connections between them (SO_REUSEPORT). Should be called before listen.
+    // Note: not supported on Windows, listen returns error in this case.
+    TARM_IO_DLL_PUBLIC void set_reuse_port(bool enabled);
+    TARM_IO_DLL_PUBLIC bool is_reuse_port() const;
+
     TARM_IO_DLL_PUBLIC
     Error listen(const Endpoint& endpoint,
                  const NewConnectionCallback& new_connection_callback,
@@ -63,6 +69,7 @@ public:
 
     TARM_IO_DLL_PUBLIC void schedule_removal() override;
 
+    // Endpoint passed to listen. If its port is 0, port assigned by the system is reported.
     TARM_IO_DLL_PUBLIC const Endpoint& endpoint() const;
 
 protected:
@@ -0,0 +1,146 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "net/TcpServerGroup.h"
+
+#include <vector>
+
+#include <assert.h>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+class TcpServerGroup::Impl {
+public:
+    Impl(EventLoopGroup& loop_group);
+
+    Error listen(const Endpoint& endpoint,
+                 const NewConnectionCallback& new_connection_callback,
+                 const DataReceivedCallback& data_receive_callback,
+                 const CloseConnectionCallback& close_connection_callback,
+                 int backlog_size);
+
+    void schedule_removal();
+
+    std::size_t size() const;
+
+    TcpServer& server(std::size_t index);
+
+    const Endpoint& endpoint() const;
+
+private:
+    EventLoopGroup* m_loop_group;
+
+    // Servers are Removable objects, they are owned by their loops
+    std::vector<TcpServer*> m_servers;
+
+    Endpoint m_endpoint;
+};
+
+TcpServerGroup::Impl::Impl(EventLoopGroup& loop_group) :
+    m_loop_group(&loop_group) {
+}
+
+Error TcpServerGroup::Impl::listen(const Endpoint& endpoint,
+                                   const NewConnectionCallback& new_connection_callback,
+                                   const DataReceivedCallback& data_receive_callback,
+                                   const CloseConnectionCallback& close_connection_callback,
+                                   int backlog_size) {
+    if (!m_servers.empty()) {
+        return StatusCode::CONNECTION_ALREADY_IN_PROGRESS;
+    }
+
+    m_endpoint = endpoint;
+
+    for (std::size_t i = 0; i < m_loop_group->size(); ++i) {
+        auto server = new TcpServer(m_loop_group->loop(i));
+        server->set_reuse_port(true);
+        m_servers.push_back(server);
+
+        // If port is 0, the first server gets it from the system and the rest share it
+        const Error listen_error = server->listen(m_endpoint,
+                                                  new_connection_callback,
+                                                  data_receive_callback,
+                                                  close_connection_callback,
+                                                  backlog_size);
+        if (listen_error) {
+            // Loops are not running yet, so it is safe to remove servers from this thread
+            for (auto s : m_servers) {
+                s->schedule_removal();
+            }
+            m_servers.clear();
+
+            return listen_error;
+        }
+
+        if (i == 0) {
+            m_endpoint = server->endpoint();
+        }
+    }
+
+    return Error(0);
+}
+
+void TcpServerGroup::Impl::schedule_removal() {
+    for (std::size_t i = 0; i < m_servers.size(); ++i) {
+        auto server = m_servers[i];
+        m_loop_group->loop(i).execute_on_loop_thread([server](EventLoop&) {
+            server->schedule_removal();
+        });
+    }
+
+    m_servers.clear();
+}
+
+std::size_t TcpServerGroup::Impl::size() const {
+    return m_servers.size();
+}
+
+TcpServer& TcpServerGroup::Impl::server(std::size_t index) {
+    assert(index < m_servers.size());
+    return *m_servers[index];
+}
+
+const Endpoint& TcpServerGroup::Impl::endpoint() const {
+    return m_endpoint;
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+TcpServerGroup::TcpServerGroup(EventLoopGroup& loop_group) :
+    m_impl(new Impl(loop_group)) {
+}
+
+TcpServerGroup::~TcpServerGroup() {
+}
+
+Error TcpServerGroup::listen(const Endpoint& endpoint,
+                             const NewConnectionCallback& new_connection_callback,
+                             const DataReceivedCallback& data_receive_callback,
+                             const CloseConnectionCallback& close_connection_callback,
+                             int backlog_size) {
+    return m_impl->listen(endpoint, new_connection_callback, data_receive_callback, close_connection_callback, backlog_size);
+}
+
+void TcpServerGroup::schedule_removal() {
+    return m_impl->schedule_removal();
+}
+
+std::size_t TcpServerGroup::size() const {
+    return m_impl->size();
+}
+
+TcpServer& TcpServerGroup::server(std::size_t index) {
+    return m_impl->server(index);
+}
+
+const Endpoint& TcpServerGroup::endpoint() const {
+    return m_impl->endpoint();
+}
+
+} // namespace net
+} // namespace io
+} // namespace tarm
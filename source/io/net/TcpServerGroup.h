@@ -0,0 +1,67 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoopGroup.h"
+#include "Export.h"
+#include "net/Endpoint.h"
+#include "net/TcpServer.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+// Set of TCP servers, one per each loop of EventLoopGroup, which listen the same endpoint.
+// Incoming connections are distributed between loops by kernel (SO_REUSEPORT), so server
+// is able to utilize several CPU cores. Callbacks are invoked on the thread of the loop
+// which owns connection.
+class TcpServerGroup {
+public:
+    using NewConnectionCallback = TcpServer::NewConnectionCallback;
+    using DataReceivedCallback = TcpServer::DataReceivedCallback;
+    using CloseConnectionCallback = TcpServer::CloseConnectionCallback;
+
+    TARM_IO_FORBID_COPY(TcpServerGroup);
+    TARM_IO_FORBID_MOVE(TcpServerGroup);
+
+    TARM_IO_DLL_PUBLIC TcpServerGroup(EventLoopGroup& loop_group);
+    TARM_IO_DLL_PUBLIC ~TcpServerGroup();
+
+    // Should be called before EventLoopGroup::run(). Callbacks are shared by all servers
+    // and may be invoked simultaneously from different threads. If port of endpoint is 0,
+    // all servers listen on the same port assigned by the system, see endpoint().
+    TARM_IO_DLL_PUBLIC
+    Error listen(const Endpoint& endpoint,
+                 const NewConnectionCallback& new_connection_callback,
+                 const DataReceivedCallback& data_receive_callback,
+                 const CloseConnectionCallback& close_connection_callback,
+                 int backlog_size = 128);
+
+    // Closes and removes all servers, each one on its loop's thread.
+    // Note: this method is thread safe
+    TARM_IO_DLL_PUBLIC void schedule_removal();
+
+    TARM_IO_DLL_PUBLIC std::size_t size() const;
+
+    // Server which belongs to the loop with the same index in the group.
+    // Note: server should be accessed only from the thread of its loop.
+    TARM_IO_DLL_PUBLIC TcpServer& server(std::size_t index);
+
+    // Endpoint passed to listen, with actual port if 0 was requested
+    TARM_IO_DLL_PUBLIC const Endpoint& endpoint() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -10,4 +10,5 @@
 #include "TlsClient.h"
 #include "TlsConnectedClient.h"
 #include "TlsServer.h"
+#include "TlsSession.h"
 
@@ -14,6 +14,8 @@
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
+#include <uv.h>
+
 #include <string>
 
 namespace tarm {
@@ -33,6 +35,9 @@ public:
                  const CloseCallback& close_callback);
     void close();
 
+    ::SSL_SESSION* session() const;
+    void set_session(::SSL_SESSION* session);
+
 protected:
     const SSL_METHOD* ssl_method();
     void ssl_set_state() override;
@@ -41,6 +46,9 @@ protected:
     void on_handshake_complete() override;
     void on_handshake_failed(long openssl_error_code, const Error& error) override;
     void on_alert(int code) override;
+    int kernel_tls_socket_fd() override;
+
+    static int on_new_session(::SSL* ssl, ::SSL_SESSION* session);
 
 private:
     ConnectCallback m_connect_callback;
@@ -48,10 +56,21 @@ private:
     CloseCallback m_close_callback;
     TlsVersionRange m_version_range;
 
+    // Owned references
+    ::SSL_SESSION* m_session = nullptr;
+    ::SSL_SESSION* m_offered_session = nullptr;
+
     detail::OpenSslContext<TlsClient, TlsClient::Impl> m_openssl_context;
 };
 
 TlsClient::Impl::~Impl() {
+    if (m_session) {
+        SSL_SESSION_free(m_session);
+    }
+
+    if (m_offered_session) {
+        SSL_SESSION_free(m_offered_session);
+    }
 }
 
 TlsClient::Impl::Impl(EventLoop& loop, TlsVersionRange version_range, TlsClient& parent) :
@@ -69,6 +88,7 @@ void TlsClient::Impl::connect(const Endpoint endpoint,
                                  const DataReceiveCallback& receive_callback,
                                  const CloseCallback& close_callback) {
     m_client = new TcpClient(*m_loop);
+    attach_send_watermarks();
 
     if (!is_ssl_inited()) {
         auto context_errror = m_openssl_context.init_ssl_context(ssl_method());
@@ -83,11 +103,23 @@ void TlsClient::Impl::connect(const Endpoint endpoint,
             return;
         }
 
+        // Sessions are not stored in the context, every client captures its own one
+        SSL_CTX_set_session_cache_mode(m_openssl_context.ssl_ctx(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(m_openssl_context.ssl_ctx(), &TlsClient::Impl::on_new_session);
+
+        if (m_kernel_tls_requested) {
+            detail::kernel_tls_init_context(m_openssl_context.ssl_ctx());
+        }
+
         Error ssl_init_error = this->ssl_init(m_openssl_context.ssl_ctx());
         if (ssl_init_error) {
             m_loop->schedule_callback([=](EventLoop&) { connect_callback(*this->m_parent, ssl_init_error); });
             return;
         }
+
+        if (m_offered_session && SSL_set_session(this->ssl(), m_offered_session) != 1) {
+            LOG_WARNING(m_loop, this->m_parent, "Failed to set session for resumption, full handshake will be performed");
+        }
     }
 
     m_connect_callback = connect_callback;
@@ -135,7 +167,7 @@ void TlsClient::Impl::connect(const Endpoint endpoint,
             */
 
             if (m_close_callback) {
-                m_close_callback(*this->m_parent, error);
+                m_close_callback(*this->m_parent, this->transport_close_error(error));
                 m_close_callback = nullptr; // Not reacting on SSL shutdown callback if any
             }
         };
@@ -143,6 +175,33 @@ void TlsClient::Impl::connect(const Endpoint endpoint,
     m_client->connect(endpoint, on_connect, on_data_receive, on_close);
 }
 
+::SSL_SESSION* TlsClient::Impl::session() const {
+    return m_session;
+}
+
+void TlsClient::Impl::set_session(::SSL_SESSION* session) {
+    if (session) {
+        SSL_SESSION_up_ref(session);
+    }
+
+    if (m_offered_session) {
+        SSL_SESSION_free(m_offered_session);
+    }
+
+    m_offered_session = session;
+}
+
+int TlsClient::Impl::on_new_session(::SSL* ssl, ::SSL_SESSION* session) {
+    auto& this_ = static_cast<TlsClient::Impl&>(*reinterpret_cast<OpenSslClientImplBase*>(SSL_get_ex_data(ssl, 0)));
+    if (this_.m_session) {
+        SSL_SESSION_free(this_.m_session);
+    }
+
+    // Returning 1 means that reference to the session is taken
+    this_.m_session = session;
+    return 1;
+}
+
 void TlsClient::Impl::close() {
     const auto error = this->ssl_shutdown([this](TcpClient& client, const Error& error) {
         if (m_close_callback) {
@@ -188,6 +247,20 @@ void TlsClient::Impl::on_alert(int /*code*/) {
     // Do nothing
 }
 
+int TlsClient::Impl::kernel_tls_socket_fd() {
+#ifdef TARM_IO_PLATFORM_LINUX
+    uv_os_fd_t socket_fd = -1;
+    auto stream = reinterpret_cast<uv_handle_t*>(m_client->tcp_client_stream());
+    if (stream == nullptr || uv_fileno(stream, &socket_fd) != 0) {
+        return -1;
+    }
+
+    return socket_fd;
+#else
+    return -1;
+#endif
+}
+
 ///////////////////////////////////////// implementation ///////////////////////////////////////////
 
 TlsClient::TlsClient(EventLoop& loop, TlsVersionRange version_range) :
@@ -240,14 +313,95 @@ void TlsClient::send_data(std::string&& message, const EndSendCallback& callback
     return m_impl->send_data(std::move(message), callback);
 }
 
+void TlsClient::send_data(std::vector<SendBuffer> buffers, const EndSendCallback& callback) {
+    return m_impl->send_data(std::move(buffers), callback);
+}
+
 void TlsClient::send_data(const char* c_str, std::uint32_t size, const EndSendCallback& callback) {
     return m_impl->send_data(c_str, size, callback);
 }
 
+void TlsClient::send_file(fs::File& file,
+                          std::uint64_t offset,
+                          std::uint64_t length,
+                          const EndSendCallback& callback,
+                          const SendFileProgressCallback& progress_callback) {
+    return m_impl->send_file(file, offset, length, callback, progress_callback);
+}
+
 TlsVersion TlsClient::negotiated_tls_version() const {
     return m_impl->negotiated_tls_version();
 }
 
+TlsSession TlsClient::session() const {
+    auto ssl_session = m_impl->session();
+    if (ssl_session == nullptr) {
+        return TlsSession();
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if (SSL_SESSION_is_resumable(ssl_session) != 1) {
+        return TlsSession();
+    }
+#endif
+
+    SSL_SESSION_up_ref(ssl_session);
+    return TlsSession(ssl_session);
+}
+
+void TlsClient::set_session(const TlsSession& session) {
+    return m_impl->set_session(reinterpret_cast<::SSL_SESSION*>(session.ssl_session()));
+}
+
+bool TlsClient::is_session_resumed() const {
+    return m_impl->is_session_resumed();
+}
+
+Error TlsClient::set_kernel_tls(bool enabled) {
+    if (enabled && !detail::kernel_tls_is_supported()) {
+        return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED, "Kernel TLS is not supported on this platform or OpenSSL version");
+    }
+
+    m_impl->set_kernel_tls(enabled);
+    return StatusCode::OK;
+}
+
+bool TlsClient::is_kernel_tls_active() const {
+    return m_impl->is_kernel_tls_active();
+}
+
+void TlsClient::set_release_idle_buffers(bool enabled) {
+    return m_impl->set_release_idle_buffers(enabled);
+}
+
+std::size_t TlsClient::pending_send_bytes() const {
+    return m_impl->pending_send_bytes();
+}
+
+void TlsClient::set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark) {
+    return m_impl->set_send_watermarks(high_watermark, low_watermark);
+}
+
+void TlsClient::set_high_watermark_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_high_watermark_callback(callback);
+}
+
+void TlsClient::set_drain_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_drain_callback(callback);
+}
+
+void TlsClient::pause_read() {
+    return m_impl->pause_read();
+}
+
+void TlsClient::resume_read() {
+    return m_impl->resume_read();
+}
+
+bool TlsClient::is_read_paused() const {
+    return m_impl->is_read_paused();
+}
+
 } // namespace net
 } // namespace io
 } // namespace tarm
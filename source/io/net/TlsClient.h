@@ -13,9 +13,12 @@
 #include "Export.h"
 #include "Forward.h"
 #include "Removable.h"
+#include "SendBuffer.h"
+#include "net/TlsSession.h"
 #include "net/TlsVersion.h"
 
 #include <memory>
+#include <vector>
 
 namespace tarm {
 namespace io {
@@ -28,6 +31,8 @@ public:
     using ConnectCallback = std::function<void(TlsClient&, const Error&)>;
     using CloseCallback = std::function<void(TlsClient&, const Error&)>;
     using EndSendCallback = std::function<void(TlsClient&, const Error&)>;
+    using SendWatermarkCallback = std::function<void(TlsClient&)>;
+    using SendFileProgressCallback = std::function<void(TlsClient&, std::uint64_t bytes_sent)>;
     using DataReceiveCallback = std::function<void(TlsClient&, const DataChunk&, const Error&)>;
 
     TARM_IO_FORBID_COPY(TlsClient);
@@ -55,9 +60,59 @@ public:
     TARM_IO_DLL_PUBLIC void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(const std::string& message, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(std::string&& message, const EndSendCallback& callback = nullptr);
+    // All buffers are sent as a single write, callback is called once
+    TARM_IO_DLL_PUBLIC void send_data(std::vector<SendBuffer> buffers, const EndSendCallback& callback = nullptr);
+
+    // Sends 'length' bytes of the file starting from 'offset', see TcpClient::send_file. With kernel TLS data is
+    // passed to the socket by the kernel. Otherwise file is read by chunks and encrypted by OpenSSL, in that case
+    // only one file may be sent at a time and no other data should be sent until EndSendCallback is called.
+    TARM_IO_DLL_PUBLIC void send_file(fs::File& file,
+                                      std::uint64_t offset,
+                                      std::uint64_t length,
+                                      const EndSendCallback& callback = nullptr,
+                                      const SendFileProgressCallback& progress_callback = nullptr);
+
+    // Number of encrypted bytes which are not transferred to the operating system yet
+    TARM_IO_DLL_PUBLIC std::size_t pending_send_bytes() const;
+
+    // Send side backpressure, see TcpClient::set_send_watermarks. Watermarks are applied to encrypted data.
+    TARM_IO_DLL_PUBLIC void set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark);
+    TARM_IO_DLL_PUBLIC void set_high_watermark_callback(const SendWatermarkCallback& callback);
+    TARM_IO_DLL_PUBLIC void set_drain_callback(const SendWatermarkCallback& callback);
+
+    // Stops reading of data from the connection, see TcpClient::pause_read. Data which is already received
+    // but not decrypted yet is delivered after resume. Has no effect until connection is established.
+    TARM_IO_DLL_PUBLIC void pause_read();
+    TARM_IO_DLL_PUBLIC void resume_read();
+    TARM_IO_DLL_PUBLIC bool is_read_paused() const;
 
     TARM_IO_DLL_PUBLIC TlsVersion negotiated_tls_version() const;
 
+    // Session resumption. Session established by this client is returned by 'session', it may be passed to
+    // 'set_session' of another client (or of this one before the next connect) to the same server to skip
+    // full handshake. With TLS 1.3 session is sent by server after the handshake, so it is available once
+    // some data is received from the server. Empty session is returned if there is nothing to resume.
+    TARM_IO_DLL_PUBLIC TlsSession session() const;
+    // Session to offer on the next connect. If server does not accept it, full handshake is performed.
+    TARM_IO_DLL_PUBLIC void set_session(const TlsSession& session);
+    TARM_IO_DLL_PUBLIC bool is_session_resumed() const;
+
+    // Kernel TLS (Linux only). After the handshake traffic keys are installed into the socket and sent data is
+    // encrypted by the kernel, without copying it to OpenSSL. Received data is still decrypted by OpenSSL.
+    // TLS 1.2 and 1.3 with AES-GCM and ChaCha20-Poly1305 ciphers are supported. If the kernel or the negotiated
+    // parameters do not support it, connection silently works as usual. Should be called before connect.
+    // Requires OpenSSL 1.1.1 or newer. Renegotiation is disabled when kernel TLS is requested.
+    TARM_IO_DLL_PUBLIC Error set_kernel_tls(bool enabled);
+    // True if sent data is encrypted by the kernel. Available once connection is established.
+    TARM_IO_DLL_PUBLIC bool is_kernel_tls_active() const;
+
+    // Reduces memory held by idle connection. OpenSSL frees its record buffers when they are empty
+    // (SSL_MODE_RELEASE_BUFFERS) and buffer for decrypted data is returned to the loop's BufferPool after each
+    // receive, so buffers are allocated again for each burst of traffic. To share receive buffer of the underlying
+    // TCP connections as well, see EventLoop::set_shared_read_buffer. Should be called before connect.
+    // Disabled by default.
+    TARM_IO_DLL_PUBLIC void set_release_idle_buffers(bool enabled);
+
 protected:
     TARM_IO_DLL_PUBLIC ~TlsClient();
 
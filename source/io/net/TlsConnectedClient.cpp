@@ -15,6 +15,8 @@
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
+#include <uv.h>
+
 namespace tarm {
 namespace io {
 namespace net {
@@ -47,6 +49,7 @@ protected:
     void on_handshake_complete() override;
     void on_handshake_failed(long openssl_error_code, const Error& error) override;
     void on_alert(int code) override;
+    int kernel_tls_socket_fd() override;
 
 private:
     TlsServer* m_tls_server = nullptr;;
@@ -69,6 +72,10 @@ TlsConnectedClient::Impl::Impl(EventLoop& loop,
     m_new_connection_callback(new_connection_callback) {
     m_client = &tcp_client;
     m_client->set_user_data(&parent);
+    attach_send_watermarks();
+    set_handshake_offload(m_tls_context.handshake_offload);
+    set_kernel_tls(m_tls_context.kernel_tls);
+    set_release_idle_buffers(m_tls_context.release_idle_buffers);
 }
 
 TlsConnectedClient::Impl::~Impl() {
@@ -151,6 +158,20 @@ void TlsConnectedClient::Impl::on_alert(int code) {
     // Do nothing
 }
 
+int TlsConnectedClient::Impl::kernel_tls_socket_fd() {
+#ifdef TARM_IO_PLATFORM_LINUX
+    uv_os_fd_t socket_fd = -1;
+    auto stream = reinterpret_cast<uv_handle_t*>(m_client->tcp_client_stream());
+    if (stream == nullptr || uv_fileno(stream, &socket_fd) != 0) {
+        return -1;
+    }
+
+    return socket_fd;
+#else
+    return -1;
+#endif
+}
+
 TlsServer& TlsConnectedClient::Impl::server() {
     return *m_tls_server;
 }
@@ -181,6 +202,10 @@ void TlsConnectedClient::on_data_receive(const char* buf, std::size_t size, cons
     return m_impl->on_data_receive(buf, size, error);
 }
 
+Error TlsConnectedClient::close_error(const Error& tcp_error) const {
+    return m_impl->transport_close_error(tcp_error);
+}
+
 Error TlsConnectedClient::init_ssl() {
     return m_impl->init_ssl();
 }
@@ -201,10 +226,22 @@ void TlsConnectedClient::send_data(std::string&& message, const EndSendCallback&
     return m_impl->send_data(std::move(message), callback);
 }
 
+void TlsConnectedClient::send_data(std::vector<SendBuffer> buffers, const EndSendCallback& callback) {
+    return m_impl->send_data(std::move(buffers), callback);
+}
+
 void TlsConnectedClient::send_data(const char* c_str, std::uint32_t size, const EndSendCallback& callback) {
     return m_impl->send_data(c_str, size, callback);
 }
 
+void TlsConnectedClient::send_file(fs::File& file,
+                                   std::uint64_t offset,
+                                   std::uint64_t length,
+                                   const EndSendCallback& callback,
+                                   const SendFileProgressCallback& progress_callback) {
+    return m_impl->send_file(file, offset, length, callback, progress_callback);
+}
+
 void TlsConnectedClient::close() {
     return m_impl->close();
 }
@@ -229,6 +266,42 @@ TlsVersion TlsConnectedClient::negotiated_tls_version() const {
     return m_impl->negotiated_tls_version();
 }
 
+bool TlsConnectedClient::is_session_resumed() const {
+    return m_impl->is_session_resumed();
+}
+
+bool TlsConnectedClient::is_kernel_tls_active() const {
+    return m_impl->is_kernel_tls_active();
+}
+
+std::size_t TlsConnectedClient::pending_send_bytes() const {
+    return m_impl->pending_send_bytes();
+}
+
+void TlsConnectedClient::set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark) {
+    return m_impl->set_send_watermarks(high_watermark, low_watermark);
+}
+
+void TlsConnectedClient::set_high_watermark_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_high_watermark_callback(callback);
+}
+
+void TlsConnectedClient::set_drain_callback(const SendWatermarkCallback& callback) {
+    return m_impl->set_drain_callback(callback);
+}
+
+void TlsConnectedClient::pause_read() {
+    return m_impl->pause_read();
+}
+
+void TlsConnectedClient::resume_read() {
+    return m_impl->resume_read();
+}
+
+bool TlsConnectedClient::is_read_paused() const {
+    return m_impl->is_read_paused();
+}
+
 } // namespace net
 } // namespace io
 } // namespace tarm
@@ -12,9 +12,11 @@
 #include "Export.h"
 #include "Forward.h"
 #include "Removable.h"
+#include "SendBuffer.h"
 #include "net/TlsVersion.h"
 
 #include <memory>
+#include <vector>
 
 namespace tarm {
 namespace io {
@@ -30,6 +32,8 @@ public:
     using DataReceiveCallback = std::function<void(TlsConnectedClient&, const DataChunk&, const Error&)>;
     using CloseCallback = std::function<void(TlsConnectedClient&, const Error&)>;
     using EndSendCallback = std::function<void(TlsConnectedClient&, const Error&)>;
+    using SendWatermarkCallback = std::function<void(TlsConnectedClient&)>;
+    using SendFileProgressCallback = std::function<void(TlsConnectedClient&, std::uint64_t bytes_sent)>;
 
     using NewConnectionCallback = std::function<void(TlsConnectedClient&, const Error&)>;
 
@@ -45,12 +49,41 @@ public:
     TARM_IO_DLL_PUBLIC void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(const std::string& message, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(std::string&& message, const EndSendCallback& callback = nullptr);
+    // All buffers are sent as a single write, callback is called once
+    TARM_IO_DLL_PUBLIC void send_data(std::vector<SendBuffer> buffers, const EndSendCallback& callback = nullptr);
+
+    // See TlsClient::send_file
+    TARM_IO_DLL_PUBLIC void send_file(fs::File& file,
+                                      std::uint64_t offset,
+                                      std::uint64_t length,
+                                      const EndSendCallback& callback = nullptr,
+                                      const SendFileProgressCallback& progress_callback = nullptr);
+
+    // Number of encrypted bytes which are not transferred to the operating system yet
+    TARM_IO_DLL_PUBLIC std::size_t pending_send_bytes() const;
+
+    // Send side backpressure, see TcpClient::set_send_watermarks. Watermarks are applied to encrypted data.
+    TARM_IO_DLL_PUBLIC void set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark);
+    TARM_IO_DLL_PUBLIC void set_high_watermark_callback(const SendWatermarkCallback& callback);
+    TARM_IO_DLL_PUBLIC void set_drain_callback(const SendWatermarkCallback& callback);
+
+    // Stops reading of data from the connection, see TcpClient::pause_read. Data which is already received
+    // but not decrypted yet is delivered after resume. Has no effect until connection is established.
+    TARM_IO_DLL_PUBLIC void pause_read();
+    TARM_IO_DLL_PUBLIC void resume_read();
+    TARM_IO_DLL_PUBLIC bool is_read_paused() const;
 
     TARM_IO_DLL_PUBLIC TlsServer& server();
     TARM_IO_DLL_PUBLIC const TlsServer& server() const;
 
     TARM_IO_DLL_PUBLIC TlsVersion negotiated_tls_version() const;
 
+    // True if abbreviated handshake was performed, using session from the cache or ticket.
+    TARM_IO_DLL_PUBLIC bool is_session_resumed() const;
+
+    // True if sent data is encrypted by the kernel, see TlsServer::set_kernel_tls
+    TARM_IO_DLL_PUBLIC bool is_kernel_tls_active() const;
+
 protected:
     ~TlsConnectedClient();
 
@@ -63,6 +96,7 @@ private:
 
     void set_data_receive_callback(const DataReceiveCallback& callback);
     void on_data_receive(const char* buf, std::size_t size, const Error& error);
+    Error close_error(const Error& tcp_error) const;
     Error init_ssl();
 
     class Impl;
@@ -10,6 +10,7 @@
 #include "detail/ConstexprString.h"
 #include "detail/TlsContext.h"
 #include "detail/OpenSslContext.h"
+#include "detail/OpenSslKernelTls.h"
 
 #include <openssl/pem.h>
 #include <openssl/evp.h>
@@ -44,6 +45,12 @@ public:
 
     TlsVersionRange version_range() const;
 
+    Error set_session_cache(std::size_t cache_size, std::uint64_t timeout_ms);
+    Error set_session_tickets(bool enabled, std::uint64_t key_rotation_interval_ms);
+    Error set_handshake_offload(bool enabled);
+    Error set_kernel_tls(bool enabled);
+    void set_release_idle_buffers(bool enabled);
+
     bool schedule_removal();
 
 protected:
@@ -71,6 +78,16 @@ private:
 
     detail::OpenSslContext<TlsServer, TlsServer::Impl> m_openssl_context;
 
+    // Applied to SSL context on listen
+    std::size_t m_session_cache_size = 1024 * 20;
+    std::uint64_t m_session_timeout_ms = 5 * 60 * 1000;
+    bool m_session_tickets = true;
+    std::uint64_t m_session_ticket_key_rotation_interval_ms = 60 * 60 * 1000;
+
+    bool m_handshake_offload = false;
+    bool m_kernel_tls = false;
+    bool m_release_idle_buffers = false;
+
     NewConnectionCallback m_new_connection_callback = nullptr;
     DataReceivedCallback m_data_receive_callback = nullptr;
     CloseConnectionCallback m_close_connection_callback = nullptr;
@@ -129,6 +146,64 @@ TlsVersionRange TlsServer::Impl::version_range() const {
     return m_version_range;
 }
 
+Error TlsServer::Impl::set_session_cache(std::size_t cache_size, std::uint64_t timeout_ms) {
+    if (cache_size && timeout_ms == 0) {
+        return Error(StatusCode::INVALID_ARGUMENT, "Session timeout should be greater than 0");
+    }
+
+    m_session_cache_size = cache_size;
+    m_session_timeout_ms = timeout_ms ? timeout_ms : m_session_timeout_ms;
+
+    if (m_openssl_context.ssl_ctx()) {
+        return m_openssl_context.set_session_cache(m_session_cache_size, m_session_timeout_ms);
+    }
+
+    return StatusCode::OK;
+}
+
+Error TlsServer::Impl::set_session_tickets(bool enabled, std::uint64_t key_rotation_interval_ms) {
+    if (enabled && key_rotation_interval_ms == 0) {
+        return Error(StatusCode::INVALID_ARGUMENT, "Ticket key rotation interval should be greater than 0");
+    }
+
+    m_session_tickets = enabled;
+    m_session_ticket_key_rotation_interval_ms = enabled ? key_rotation_interval_ms : m_session_ticket_key_rotation_interval_ms;
+
+    if (m_openssl_context.ssl_ctx()) {
+        return m_openssl_context.set_session_tickets(m_session_tickets, m_session_ticket_key_rotation_interval_ms);
+    }
+
+    return StatusCode::OK;
+}
+
+Error TlsServer::Impl::set_handshake_offload(bool enabled) {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    if (enabled) {
+        return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED, "Handshake offload requires OpenSSL 1.1.0 or newer");
+    }
+#endif
+
+    m_handshake_offload = enabled;
+    return StatusCode::OK;
+}
+
+Error TlsServer::Impl::set_kernel_tls(bool enabled) {
+    if (enabled && !detail::kernel_tls_is_supported()) {
+        return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED, "Kernel TLS is not supported on this platform or OpenSSL version");
+    }
+
+    m_kernel_tls = enabled;
+    if (m_kernel_tls && m_openssl_context.ssl_ctx()) {
+        detail::kernel_tls_init_context(m_openssl_context.ssl_ctx());
+    }
+
+    return StatusCode::OK;
+}
+
+void TlsServer::Impl::set_release_idle_buffers(bool enabled) {
+    m_release_idle_buffers = enabled;
+}
+
 void TlsServer::Impl::on_new_connection(TcpConnectedClient& tcp_client, const Error& tcp_error) {
     detail::TlsContext context {
         m_certificate.get(),
@@ -136,6 +211,9 @@ void TlsServer::Impl::on_new_connection(TcpConnectedClient& tcp_client, const Er
         m_openssl_context.ssl_ctx(),
         m_version_range
     };
+    context.handshake_offload = m_handshake_offload;
+    context.kernel_tls = m_kernel_tls;
+    context.release_idle_buffers = m_release_idle_buffers;
 
     // Can not use unique_ptr here because TlsConnectedClient has proteted destructor and
     // TlsServer is a friend of TlsConnectedClient, but we can not transfer that friendhsip to unique_ptr.
@@ -173,7 +251,7 @@ void TlsServer::Impl::on_connection_close(TcpConnectedClient& tcp_client, const
     if (tcp_client.user_data()) {
         auto& tls_client = *reinterpret_cast<TlsConnectedClient*>(tcp_client.user_data());
         if (m_close_connection_callback) {
-            m_close_connection_callback(tls_client, tcp_error);
+            m_close_connection_callback(tls_client, tls_client.close_error(tcp_error));
         }
 
         delete &tls_client;
@@ -230,6 +308,20 @@ Error TlsServer::Impl::listen(const Endpoint endpoint,
         return certificate_error;
     }
 
+    const auto& session_cache_error = m_openssl_context.set_session_cache(m_session_cache_size, m_session_timeout_ms);
+    if (session_cache_error) {
+        return session_cache_error;
+    }
+
+    const auto& session_tickets_error = m_openssl_context.set_session_tickets(m_session_tickets, m_session_ticket_key_rotation_interval_ms);
+    if (session_tickets_error) {
+        return session_tickets_error;
+    }
+
+    if (m_kernel_tls) {
+        detail::kernel_tls_init_context(m_openssl_context.ssl_ctx());
+    }
+
     using namespace std::placeholders;
     return m_tcp_server->listen(endpoint,
                                 std::bind(&TlsServer::Impl::on_new_connection, this, _1, _2),
@@ -326,6 +418,26 @@ TlsVersionRange TlsServer::version_range() const {
     return m_impl->version_range();
 }
 
+Error TlsServer::set_session_cache(std::size_t cache_size, std::uint64_t timeout_ms) {
+    return m_impl->set_session_cache(cache_size, timeout_ms);
+}
+
+Error TlsServer::set_session_tickets(bool enabled, std::uint64_t key_rotation_interval_ms) {
+    return m_impl->set_session_tickets(enabled, key_rotation_interval_ms);
+}
+
+Error TlsServer::set_handshake_offload(bool enabled) {
+    return m_impl->set_handshake_offload(enabled);
+}
+
+Error TlsServer::set_kernel_tls(bool enabled) {
+    return m_impl->set_kernel_tls(enabled);
+}
+
+void TlsServer::set_release_idle_buffers(bool enabled) {
+    return m_impl->set_release_idle_buffers(enabled);
+}
+
 void TlsServer::schedule_removal() {
     const bool ready_to_remove = m_impl->schedule_removal();
     if (ready_to_remove) {
@@ -18,6 +18,7 @@
 #include <memory>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 
 namespace tarm {
 namespace io {
@@ -70,6 +71,32 @@ public:
 
     TARM_IO_DLL_PUBLIC TlsVersionRange version_range() const;
 
+    // Session resumption. Server keeps sessions of recent connections in a cache of 'cache_size' entries,
+    // clients which offer cached session (see TlsClient::set_session) skip full handshake. Sessions expire after
+    // 'timeout_ms' (1 second granularity), this also limits lifetime of session tickets. Size 0 disables the cache.
+    // By default the cache keeps 20480 sessions for 5 minutes. May be called before or after listen.
+    TARM_IO_DLL_PUBLIC Error set_session_cache(std::size_t cache_size, std::uint64_t timeout_ms);
+
+    // Stateless session resumption, session state is encrypted into a ticket which is stored by client.
+    // Ticket keys are random and are rotated each 'key_rotation_interval_ms', tickets of the previous key
+    // are accepted and renewed during the next interval. Enabled by default with 1 hour interval.
+    // Note: with TLS 1.3 and disabled tickets sessions are resumed only from the cache.
+    TARM_IO_DLL_PUBLIC Error set_session_tickets(bool enabled, std::uint64_t key_rotation_interval_ms = 60 * 60 * 1000);
+
+    // Handshake crypto (key exchange and signature) is performed in the thread pool of the loop (see
+    // EventLoop::add_work) instead of the loop thread, so established connections are not stalled by bursts of
+    // new ones. Each handshake step gets additional latency of passing it to the thread pool and back.
+    // Applied to connections accepted after the call. Disabled by default. Requires OpenSSL 1.1.0 or newer.
+    TARM_IO_DLL_PUBLIC Error set_handshake_offload(bool enabled);
+
+    // Kernel TLS for accepted connections, see TlsClient::set_kernel_tls. Applied to connections accepted after
+    // the call. Disabled by default.
+    TARM_IO_DLL_PUBLIC Error set_kernel_tls(bool enabled);
+
+    // Memory saving for idle accepted connections, see TlsClient::set_release_idle_buffers. Applied to connections
+    // accepted after the call. Disabled by default.
+    TARM_IO_DLL_PUBLIC void set_release_idle_buffers(bool enabled);
+
 protected:
     TARM_IO_DLL_PUBLIC ~TlsServer();
 
@@ -0,0 +1,56 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "net/TlsSession.h"
+
+#include <openssl/ssl.h>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+class TlsSession::Impl {
+public:
+    Impl(::SSL_SESSION* ssl_session);
+    ~Impl();
+
+    ::SSL_SESSION* ssl_session() const;
+
+private:
+    ::SSL_SESSION* m_ssl_session = nullptr;
+};
+
+TlsSession::Impl::Impl(::SSL_SESSION* ssl_session) :
+    m_ssl_session(ssl_session) {
+}
+
+TlsSession::Impl::~Impl() {
+    SSL_SESSION_free(m_ssl_session);
+}
+
+::SSL_SESSION* TlsSession::Impl::ssl_session() const {
+    return m_ssl_session;
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+TlsSession::TlsSession() {
+}
+
+TlsSession::TlsSession(void* ssl_session) :
+    m_impl(ssl_session ? new Impl(reinterpret_cast<::SSL_SESSION*>(ssl_session)) : nullptr) {
+}
+
+bool TlsSession::is_empty() const {
+    return m_impl == nullptr;
+}
+
+void* TlsSession::ssl_session() const {
+    return m_impl ? m_impl->ssl_session() : nullptr;
+}
+
+} // namespace net
+} // namespace io
+} // namespace tarm
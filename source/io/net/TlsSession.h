@@ -0,0 +1,39 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "Export.h"
+#include "Forward.h"
+
+#include <memory>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+// Established TLS session which can be resumed by a new connection to the same server, see TlsClient::session.
+// Objects are cheap to copy, copies refer to the same session. Session may be used from any thread.
+class TlsSession {
+public:
+    // Empty session
+    TARM_IO_DLL_PUBLIC TlsSession();
+
+    TARM_IO_DLL_PUBLIC bool is_empty() const;
+
+private:
+    friend class TlsClient;
+
+    // Takes ownership of the reference to OpenSSL session
+    TlsSession(void* ssl_session);
+    void* ssl_session() const;
+
+    class Impl;
+    std::shared_ptr<Impl> m_impl;
+};
+
+} // namespace net
+} // namespace io
+} // namespace tarm
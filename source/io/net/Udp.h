@@ -6,6 +6,7 @@
 #pragma once
 
 #include "UdpClient.h"
+#include "UdpDatagram.h"
 #include "UdpPeer.h"
 #include "UdpServer.h"
-
+#include "UdpServerGroup.h"
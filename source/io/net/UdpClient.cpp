@@ -11,6 +11,8 @@
 
 #include <cstring>
 #include <cstddef>
+#include <vector>
+
 #include <assert.h>
 
 namespace tarm {
@@ -37,6 +39,13 @@ public:
                          std::size_t timeout_ms,
                          const CloseCallback& close_callback);
 
+    Error set_receive_batch(std::size_t datagrams_count,
+                            std::size_t max_datagram_size,
+                            const DataBatchReceivedCallback& batch_callback);
+
+    // Called by UdpImplBase
+    void on_datagrams_received(const detail::UdpReceiveBatch& batch, int count);
+
 protected:
     Error start_receive();
     Error setup_udp_handle(const Endpoint& endpoint);
@@ -52,7 +61,13 @@ protected:
     static void on_close_no_removal(uv_handle_t* handle);
 
 private:
+    // Returns false if datagram was ignored
+    bool on_datagram_received(const struct sockaddr* addr, const DataChunk& data_chunk);
+    void on_receive_error(const Error& error);
+
     DataReceivedCallback m_receive_callback = nullptr;
+    DataBatchReceivedCallback m_data_batch_receive_callback = nullptr;
+    std::vector<UdpDatagram> m_received_datagrams;
 
     CloseCallback m_close_callback = nullptr;
 
@@ -125,7 +140,6 @@ UdpClient::Impl::~Impl() {
     LOG_TRACE(m_loop, m_parent, "Deleted UdpClient");
 }
 
-// TODO: use uv_udp_connect if libuv version is >= 1.27.0
 Error UdpClient::Impl::setup_udp_handle(const Endpoint& endpoint) {
     const auto handle_init_error = ensure_handle_inited();
     if (handle_init_error) {
@@ -153,6 +167,24 @@ Error UdpClient::Impl::setup_udp_handle(const Endpoint& endpoint) {
     m_destination_endpoint = endpoint;
     m_raw_endpoint = m_destination_endpoint.raw_endpoint();
 
+#ifdef TARM_IO_HAS_UV_UDP_CONNECT
+    // With connected socket kernel drops datagrams from other addresses and does not resolve route on each send
+    if (m_udp_handle->flags & IO_UV_HANDLE_UDP_CONNECTED) {
+        const Error disconnect_error = uv_udp_connect(m_udp_handle.get(), nullptr);
+        if (disconnect_error) {
+            return disconnect_error;
+        }
+    }
+
+    const Error connect_error = uv_udp_connect(m_udp_handle.get(), reinterpret_cast<const ::sockaddr*>(m_raw_endpoint));
+    if (connect_error) {
+        return connect_error;
+    }
+
+    // Destination address should not be passed to send calls for connected socket
+    m_raw_endpoint = nullptr;
+#endif
+
     return Error(0);
 }
 
@@ -165,6 +197,9 @@ void UdpClient::Impl::close_no_removal() {
 }
 
 bool UdpClient::Impl::close_impl(CloseHandler handler) {
+    // Datagrams queued during the current loop cycle are sent before close
+    flush();
+
     if (is_open()) {
         uv_udp_recv_stop(m_udp_handle.get());
         uv_close(reinterpret_cast<uv_handle_t*>(m_udp_handle.get()), handler);
@@ -175,7 +210,7 @@ bool UdpClient::Impl::close_impl(CloseHandler handler) {
 }
 
 Error UdpClient::Impl::start_receive() {
-    Error recv_start_error = uv_udp_recv_start(m_udp_handle.get(), io::detail::default_alloc_buffer, on_data_received);
+    Error recv_start_error = start_receive_impl(on_data_received);
     if (recv_start_error) {
         return recv_start_error;
     }
@@ -183,6 +218,97 @@ Error UdpClient::Impl::start_receive() {
     return Error(0);
 }
 
+Error UdpClient::Impl::set_receive_batch(std::size_t datagrams_count,
+                                         std::size_t max_datagram_size,
+                                         const DataBatchReceivedCallback& batch_callback) {
+    const Error error = UdpImplBase::set_receive_batch(datagrams_count, max_datagram_size);
+    if (error) {
+        return error;
+    }
+
+    m_data_batch_receive_callback = batch_callback;
+    if (m_receive_batch) {
+        m_received_datagrams.reserve(m_receive_batch->datagrams_count());
+    }
+
+    return Error(0);
+}
+
+bool UdpClient::Impl::on_datagram_received(const struct sockaddr* addr, const DataChunk& data_chunk) {
+    if (m_raw_endpoint == nullptr) {
+        // Socket is connected, datagrams from other addresses are filtered by kernel
+        if (m_receive_callback) {
+            m_receive_callback(*m_parent, data_chunk, Error(0));
+        }
+
+        return true;
+    }
+
+    const auto& address_in_from = *reinterpret_cast<const struct sockaddr_in*>(addr);
+    const auto& address_in_expect = *reinterpret_cast<sockaddr_in*>(m_destination_endpoint.raw_endpoint());
+
+    if (address_in_from.sin_addr.s_addr != address_in_expect.sin_addr.s_addr ||
+        address_in_from.sin_port != address_in_expect.sin_port) {
+        return false;
+    }
+
+    if (m_receive_callback) {
+        m_receive_callback(*m_parent, data_chunk, Error(0));
+    }
+
+    return true;
+}
+
+void UdpClient::Impl::on_datagrams_received(const detail::UdpReceiveBatch& batch, int count) {
+    set_last_packet_time(::uv_hrtime());
+
+    if (count < 0) {
+        on_receive_error(Error(count));
+        return;
+    }
+
+    for (std::size_t i = 0; i < std::size_t(count); ++i) {
+        // Receiving may be stopped from callback
+        if (m_udp_handle->recv_cb == nullptr) {
+            break;
+        }
+
+        const auto addr = batch.address(i);
+        const auto size = batch.datagram_size(i);
+        if (!addr || !size) {
+            continue;
+        }
+
+        if (batch.is_truncated(i)) {
+            LOG_WARNING(m_loop, m_parent, "Datagram is longer than", batch.max_datagram_size(), "bytes, dropping it");
+            continue;
+        }
+
+        // Chunk shares ownership of the whole batch buffer
+        const DataChunk data_chunk(std::shared_ptr<const char>(m_read_buf, m_read_buf.get() + i * batch.max_datagram_size()), size);
+        const bool accepted = on_datagram_received(addr, data_chunk);
+        if (accepted && m_data_batch_receive_callback) {
+            m_received_datagrams.emplace_back(detail::PeerId{addr}, data_chunk);
+        }
+    }
+
+    if (!m_received_datagrams.empty()) {
+        m_data_batch_receive_callback(*m_parent, m_received_datagrams.data(), m_received_datagrams.size(), Error(0));
+        m_received_datagrams.clear();
+    }
+}
+
+void UdpClient::Impl::on_receive_error(const Error& error) {
+    if (m_receive_callback) {
+        DataChunk data(nullptr, 0);
+        m_receive_callback(*m_parent, data, error);
+    }
+
+    if (m_data_batch_receive_callback) {
+        m_data_batch_receive_callback(*m_parent, nullptr, 0, error);
+    }
+}
+
 ///////////////////////////////////////////  static  ////////////////////////////////////////////
 
 void UdpClient::Impl::on_data_received(uv_udp_t* handle,
@@ -196,30 +322,26 @@ void UdpClient::Impl::on_data_received(uv_udp_t* handle,
 
     this_.set_last_packet_time(::uv_hrtime());
 
-    std::shared_ptr<const char> buf(uv_buf->base, std::default_delete<char[]>());
-
-    if (!this_.m_receive_callback) {
+    Error error(nread);
+    if (error) {
+        this_.on_receive_error(error);
         return;
     }
 
-    Error error(nread);
-
-    if (!error) {
-        if (addr && nread) {
-            const auto& address_in_from = *reinterpret_cast<const struct sockaddr_in*>(addr);
-            const auto& address_in_expect = *reinterpret_cast<sockaddr_in*>(this_.m_destination_endpoint.raw_endpoint());
-
-            if (address_in_from.sin_addr.s_addr == address_in_expect.sin_addr.s_addr &&
-                address_in_from.sin_port == address_in_expect.sin_port) {
+    if (!addr || !nread) {
+        return;
+    }
 
-                DataChunk data_chunk(buf, std::size_t(nread));
-                this_.m_receive_callback(parent, data_chunk, error);
-            }
+    const auto prev_use_count = this_.m_read_buf.use_count();
+    {
+        const DataChunk data_chunk(this_.m_read_buf, std::size_t(nread));
+        const bool accepted = this_.on_datagram_received(addr, data_chunk);
+        if (accepted && this_.m_data_batch_receive_callback) {
+            const UdpDatagram datagram(detail::PeerId{addr}, data_chunk);
+            this_.m_data_batch_receive_callback(parent, &datagram, 1, Error(0));
         }
-    } else {
-        DataChunk data(nullptr, 0);
-        this_.m_receive_callback(parent, data, error);
     }
+    this_.release_read_buffer(prev_use_count);
 }
 
 void UdpClient::Impl::on_close_no_removal(uv_handle_t* handle) {
@@ -286,6 +408,20 @@ std::uint16_t UdpClient::bound_port() const {
     return m_impl->bound_port();
 }
 
+Error UdpClient::set_send_batch(std::size_t datagrams_count) {
+    return m_impl->set_send_batch(datagrams_count);
+}
+
+void UdpClient::flush() {
+    return m_impl->flush();
+}
+
+Error UdpClient::set_receive_batch(std::size_t datagrams_count,
+                                   std::size_t max_datagram_size,
+                                   const DataBatchReceivedCallback& batch_callback) {
+    return m_impl->set_receive_batch(datagrams_count, max_datagram_size, batch_callback);
+}
+
 const Endpoint& UdpClient::endpoint() const {
     return m_impl->endpoint();
 }
@@ -9,6 +9,7 @@
 #include "CommonMacros.h"
 #include "DataChunk.h"
 #include "net/Endpoint.h"
+#include "net/UdpDatagram.h"
 #include "Error.h"
 #include "EventLoop.h"
 #include "Export.h"
@@ -28,6 +29,7 @@ class UdpClient : public Removable,
 public:
     using DestinationSetCallback = std::function<void(UdpClient&, const Error&)>;
     using DataReceivedCallback = std::function<void(UdpClient&, const DataChunk&, const Error&)>;
+    using DataBatchReceivedCallback = std::function<void(UdpClient&, const UdpDatagram*, std::size_t, const Error&)>;
     using CloseCallback = std::function<void(UdpClient&, const Error&)>;
     using EndSendCallback = std::function<void(UdpClient&, const Error&)>;
 
@@ -36,7 +38,9 @@ public:
 
     TARM_IO_DLL_PUBLIC UdpClient(EventLoop& loop);
 
-    // Analog of connect for TCP
+    // Analog of connect for TCP. Socket is connected to the endpoint (if supported by libuv), so datagrams
+    // from other addresses are dropped by kernel and errors like ICMP "port unreachable" are reported
+    // to receive callback as CONNECTION_REFUSED.
     TARM_IO_DLL_PUBLIC void set_destination(const Endpoint& endpoint,
                                        const DestinationSetCallback& destination_set_callback,
                                        const DataReceivedCallback& receive_callback = nullptr);
@@ -57,6 +61,16 @@ public:
     TARM_IO_DLL_PUBLIC Error set_receive_buffer_size(std::size_t size);
     TARM_IO_DLL_PUBLIC Error set_send_buffer_size(std::size_t size);
 
+    // Enables batched receive of datagrams from destination, see UdpServer::set_receive_batch for details.
+    // Should be called before set_destination, OPERATION_ALREADY_IN_PROGRESS is returned while receiving.
+    TARM_IO_DLL_PUBLIC Error set_receive_batch(std::size_t datagrams_count,
+                                               std::size_t max_datagram_size,
+                                               const DataBatchReceivedCallback& batch_callback = nullptr);
+
+    // Batched send of datagrams, see UdpServer::set_send_batch for details.
+    TARM_IO_DLL_PUBLIC Error set_send_batch(std::size_t datagrams_count);
+    TARM_IO_DLL_PUBLIC void flush();
+
     TARM_IO_DLL_PUBLIC void send_data(const char* c_str, std::uint32_t size, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(std::shared_ptr<const char> buffer, std::uint32_t size, const EndSendCallback& callback = nullptr);
     TARM_IO_DLL_PUBLIC void send_data(const std::string& message, const EndSendCallback& callback = nullptr);
@@ -0,0 +1,30 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "../DataChunk.h"
+
+#include "detail/PeerId.h"
+
+namespace tarm {
+namespace io {
+namespace net {
+
+// Datagram delivered as a part of batch, see set_receive_batch of UdpServer and UdpClient.
+struct UdpDatagram {
+    UdpDatagram(const detail::PeerId& id, const DataChunk& chunk) :
+        peer_id(id),
+        data(chunk) {
+    }
+
+    // Identity of sender, datagrams of the same peer have equal ids
+    detail::PeerId peer_id;
+    DataChunk data;
+};
+
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -31,6 +31,9 @@ public:
 
     const detail::PeerId& id() const;
 
+    // Peers share the socket of the server, so datagrams are queued to the server's queue
+    detail::UdpSendQueue* send_queue();
+
 private:
     UdpServer* m_server = nullptr;
     const detail::PeerId m_id;
@@ -61,6 +64,10 @@ const detail::PeerId& UdpPeer::Impl::id() const {
     return m_id;
 }
 
+detail::UdpSendQueue* UdpPeer::Impl::send_queue() {
+    return m_server->send_queue();
+}
+
 /////////////////////////////////////////// interface ///////////////////////////////////////////
 
 UdpPeer::UdpPeer(EventLoop& loop, UdpServer& server, void* udp_handle, const Endpoint& endpoint, const detail::PeerId& id) :
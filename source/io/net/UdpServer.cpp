@@ -17,6 +17,7 @@
 #include <iostream>
 #include <assert.h>
 #include <unordered_map>
+#include <vector>
 
 namespace tarm {
 namespace io {
@@ -41,6 +42,18 @@ public:
 
     std::size_t peers_count() const;
 
+    void set_reuse_port(bool enabled);
+    bool is_reuse_port() const;
+
+    const Endpoint& endpoint() const;
+
+    Error set_receive_batch(std::size_t datagrams_count,
+                            std::size_t max_datagram_size,
+                            const DataBatchReceivedCallback& batch_callback);
+
+    // Called by UdpImplBase
+    void on_datagrams_received(const detail::UdpReceiveBatch& batch, int count);
+
 protected:
     // statics
     static void on_data_received(
@@ -50,9 +63,14 @@ protected:
     static void free_udp_peer(UdpPeer* peer);
 
 private:
+    // Returns false if datagram was ignored
+    bool on_datagram_received(const struct sockaddr* addr, const DataChunk& data_chunk);
+    void on_receive_error(const Error& error);
+
     NewPeerCallback m_new_peer_callback = nullptr;
     DataReceivedCallback m_data_receive_callback = nullptr;
     PeerTimeoutCallback m_peer_timeout_callback = nullptr;
+    DataBatchReceivedCallback m_data_batch_receive_callback = nullptr;
 
     CloseServerCallback m_server_close_callback = nullptr;
 
@@ -60,7 +78,12 @@ private:
     std::unordered_map<detail::PeerId, std::unique_ptr<Timer, typename Timer::DefaultDelete>> m_inactive_peers;
     std::unique_ptr<BacklogWithTimeout<std::shared_ptr<UdpPeer>>> m_peers_backlog;
 
+    std::vector<UdpDatagram> m_received_datagrams;
+
     bool m_connection_in_progress = false;
+    bool m_reuse_port = false;
+
+    Endpoint m_endpoint;
 };
 
 UdpServer::Impl::Impl(EventLoop& loop, UdpServer& parent) :
@@ -72,14 +95,42 @@ Error UdpServer::Impl::bind(const Endpoint& endpoint) {
         return StatusCode::INVALID_ARGUMENT;
     }
 
-    const auto handle_init_error = ensure_handle_inited();
+    const auto handle_init_error = ensure_handle_inited(endpoint.type() == Endpoint::IP_V4 ? AF_INET : AF_INET6);
     if (handle_init_error) {
         return handle_init_error;
     }
 
+    if (m_reuse_port) {
+#ifdef SO_REUSEPORT
+        int value = 1;
+        const Error reuse_port_error = tarm_io_socket_option(reinterpret_cast<uv_handle_t*>(m_udp_handle.get()), SO_REUSEPORT, &value);
+#else
+        const Error reuse_port_error(StatusCode::OPERATION_NOT_SUPPORTED_ON_SOCKET);
+#endif
+        if (reuse_port_error) {
+            LOG_ERROR(m_loop, m_parent, "Failed to set SO_REUSEPORT:", reuse_port_error.string());
+            return reuse_port_error;
+        }
+    }
+
     const Error bind_error =
         uv_udp_bind(m_udp_handle.get(), reinterpret_cast<const struct sockaddr*>(endpoint.raw_endpoint()), 0);
-    return bind_error;
+    if (bind_error) {
+        return bind_error;
+    }
+
+    m_endpoint = endpoint;
+    if (m_endpoint.port() == 0) {
+        // Port assigned by the system
+        struct sockaddr_storage info;
+        int info_len = sizeof info;
+        const Error getsockname_error = uv_udp_getsockname(m_udp_handle.get(), reinterpret_cast<struct sockaddr*>(&info), &info_len);
+        if (!getsockname_error) {
+            m_endpoint = Endpoint(reinterpret_cast<const Endpoint::sockaddr_placeholder*>(&info));
+        }
+    }
+
+    return Error(0);
 }
 
 Error UdpServer::Impl::start_receive(const Endpoint& endpoint, const DataReceivedCallback& data_receive_callback) {
@@ -92,7 +143,11 @@ Error UdpServer::Impl::start_receive(const Endpoint& endpoint, const DataReceive
 
     m_data_receive_callback = data_receive_callback;
 
-    Error receive_start_error = uv_udp_recv_start(m_udp_handle.get(), io::detail::default_alloc_buffer, on_data_received);
+    if (m_receive_batch) {
+        m_received_datagrams.reserve(m_receive_batch->datagrams_count());
+    }
+
+    Error receive_start_error = start_receive_impl(on_data_received);
     if (receive_start_error) {
         return receive_start_error;
     }
@@ -147,6 +202,9 @@ Error UdpServer::Impl::start_receive(const Endpoint& endpoint,
 void UdpServer::Impl::close(const CloseServerCallback& close_callback) {
     LOG_TRACE(m_loop, m_parent, "");
 
+    // Datagrams queued during the current loop cycle are sent before close
+    flush();
+
     if (is_open()) {
         m_server_close_callback = close_callback;
         uv_udp_recv_stop(m_udp_handle.get());
@@ -157,6 +215,8 @@ void UdpServer::Impl::close(const CloseServerCallback& close_callback) {
 bool UdpServer::Impl::close_with_removal() {
     m_parent->set_removal_scheduled();
 
+    flush();
+
     if (is_open()) {
         m_connection_in_progress = false;
         Error error = uv_udp_recv_stop(m_udp_handle.get());
@@ -209,6 +269,136 @@ std::size_t UdpServer::Impl::peers_count() const {
     return m_peers.size();
 }
 
+void UdpServer::Impl::set_reuse_port(bool enabled) {
+    m_reuse_port = enabled;
+}
+
+bool UdpServer::Impl::is_reuse_port() const {
+    return m_reuse_port;
+}
+
+const Endpoint& UdpServer::Impl::endpoint() const {
+    return m_endpoint;
+}
+
+Error UdpServer::Impl::set_receive_batch(std::size_t datagrams_count,
+                                         std::size_t max_datagram_size,
+                                         const DataBatchReceivedCallback& batch_callback) {
+    const Error error = UdpImplBase::set_receive_batch(datagrams_count, max_datagram_size);
+    if (error) {
+        return error;
+    }
+
+    m_data_batch_receive_callback = batch_callback;
+    return Error(0);
+}
+
+bool UdpServer::Impl::on_datagram_received(const struct sockaddr* addr, const DataChunk& data_chunk) {
+    if (!m_data_receive_callback) {
+        return true;
+    }
+
+    const Error error(0);
+    detail::PeerId peer_id{addr};
+
+    if (peer_bookkeeping_enabled()) {
+        auto inative_peer_it = m_inactive_peers.find(peer_id);
+        if (inative_peer_it != m_inactive_peers.end()) {
+            const Endpoint e{reinterpret_cast<const Endpoint::sockaddr_placeholder*>(addr)};
+            LOG_TRACE(m_loop, m_parent, "Peer", e, "is inactive, ignoring packet");
+            return false;
+        }
+
+        auto& peer_ptr = m_peers[peer_id];
+        if (!peer_ptr.get()) {
+            peer_ptr.reset(new UdpPeer(*m_loop,
+                                       *m_parent,
+                                       m_udp_handle.get(),
+                                       {reinterpret_cast<const Endpoint::sockaddr_placeholder*>(addr)},
+                                       peer_id),
+                           free_udp_peer); // Ref count is == 1 here
+            LOG_TRACE(m_loop, m_parent, "New tracked peer:", peer_ptr->endpoint());
+
+            peer_ptr->set_last_packet_time(::uv_hrtime());
+            m_peers_backlog->add_item(peer_ptr);
+
+            if (m_new_peer_callback) {
+                m_new_peer_callback(*peer_ptr.get(), Error(0));
+            }
+        }
+
+        peer_ptr->set_last_packet_time(::uv_hrtime());
+
+        // This should be the last because peer may be reseted in callback
+        m_data_receive_callback(*peer_ptr, data_chunk, error);
+    } else {
+        // Ref/Unref semantics here was added to prolong lifetime of oneshot UdpPeer objects
+        // and to allow call send data in receive callback for UdpServer without peers tracking.
+        auto peer = new UdpPeer(*m_loop,
+                                *m_parent,
+                                m_udp_handle.get(),
+                                {reinterpret_cast<const Endpoint::sockaddr_placeholder*>(addr)},
+                                peer_id); // Ref count is == 1 here
+        LOG_TRACE(m_loop, m_parent, "New untracked peer:", peer->endpoint());
+        m_data_receive_callback(*peer, data_chunk, error);
+        peer->unref();
+    }
+
+    return true;
+}
+
+void UdpServer::Impl::on_datagrams_received(const detail::UdpReceiveBatch& batch, int count) {
+    if (count < 0) {
+        on_receive_error(Error(count));
+        return;
+    }
+
+    for (std::size_t i = 0; i < std::size_t(count); ++i) {
+        // Receiving may be stopped from callback
+        if (m_udp_handle->recv_cb == nullptr) {
+            break;
+        }
+
+        const auto addr = batch.address(i);
+        const auto size = batch.datagram_size(i);
+        if (!addr || !size) {
+            continue;
+        }
+
+        if (batch.is_truncated(i)) {
+            LOG_WARNING(m_loop, m_parent, "Datagram is longer than", batch.max_datagram_size(), "bytes, dropping it");
+            continue;
+        }
+
+        // Chunk shares ownership of the whole batch buffer
+        const DataChunk data_chunk(std::shared_ptr<const char>(m_read_buf, m_read_buf.get() + i * batch.max_datagram_size()), size);
+        const bool accepted = on_datagram_received(addr, data_chunk);
+        if (accepted && m_data_batch_receive_callback) {
+            m_received_datagrams.emplace_back(detail::PeerId{addr}, data_chunk);
+        }
+    }
+
+    if (!m_received_datagrams.empty()) {
+        m_data_batch_receive_callback(*m_parent, m_received_datagrams.data(), m_received_datagrams.size(), Error(0));
+        m_received_datagrams.clear();
+    }
+}
+
+void UdpServer::Impl::on_receive_error(const Error& error) {
+    LOG_ERROR(m_loop, m_parent, "failed to receive UDP packet", error.string());
+
+    if (m_data_receive_callback) {
+        DataChunk data(nullptr, 0);
+        // TODO: could address be available here???
+        UdpPeer peer(*m_loop, *m_parent, m_udp_handle.get(), Endpoint{0u, 0u}, 0);
+        m_data_receive_callback(peer, data, error);
+    }
+
+    if (m_data_batch_receive_callback) {
+        m_data_batch_receive_callback(*m_parent, nullptr, 0, error);
+    }
+}
+
 ///////////////////////////////////////////  static  ////////////////////////////////////////////
 
 void UdpServer::Impl::on_data_received(uv_udp_t* handle,
@@ -220,69 +410,27 @@ void UdpServer::Impl::on_data_received(uv_udp_t* handle,
     auto& this_ = *reinterpret_cast<UdpServer::Impl*>(handle->data);
     auto& parent = *this_.m_parent;
 
-    // TODO: need some mechanism to reuse memory
-    std::shared_ptr<const char> buf(uv_buf->base, std::default_delete<char[]>());
-
-    if (this_.m_data_receive_callback) {
-        Error error(nread);
-
-        if (!error) {
-            if (addr && nread) {
-                detail::PeerId peer_id{addr};
-
-                DataChunk data_chunk(buf, std::size_t(nread));
-                if (this_.peer_bookkeeping_enabled()) {
-                    auto inative_peer_it = this_.m_inactive_peers.find(peer_id);
-                    if (inative_peer_it != this_.m_inactive_peers.end()) {
-                        const Endpoint e{reinterpret_cast<const Endpoint::sockaddr_placeholder*>(addr)};
-                        LOG_TRACE(this_.m_loop, &parent, "Peer", e, "is inactive, ignoring packet");
-                        return;
-                    }
-
-                    auto& peer_ptr = this_.m_peers[peer_id];
-                    if (!peer_ptr.get()) {
-                        peer_ptr.reset(new UdpPeer(*this_.m_loop,
-                                                   *this_.m_parent,
-                                                   this_.m_udp_handle.get(),
-                                                   {reinterpret_cast<const Endpoint::sockaddr_placeholder*>(addr)},
-                                                   peer_id),
-                                       free_udp_peer); // Ref count is == 1 here
-                        LOG_TRACE(this_.m_loop, &parent, "New tracked peer:", peer_ptr->endpoint());
-
-                        peer_ptr->set_last_packet_time(::uv_hrtime());
-                        this_.m_peers_backlog->add_item(peer_ptr);
-
-                        if (this_.m_new_peer_callback) {
-                            this_.m_new_peer_callback(*peer_ptr.get(), Error(0));
-                        }
-                    }
-
-                    peer_ptr->set_last_packet_time(::uv_hrtime());
-
-                    // This should be the last because peer may be reseted in callback
-                    this_.m_data_receive_callback(*peer_ptr, data_chunk, error);
-                } else {
-                    // Ref/Unref semantics here was added to prolong lifetime of oneshot UdpPeer objects
-                    // and to allow call send data in receive callback for UdpServer without peers tracking.
-                    auto peer = new UdpPeer(*this_.m_loop,
-                                            *this_.m_parent,
-                                            this_.m_udp_handle.get(),
-                                            {reinterpret_cast<const Endpoint::sockaddr_placeholder*>(addr)},
-                                            peer_id); // Ref count is == 1 here
-                    LOG_TRACE(this_.m_loop, &parent, "New untracked peer:", peer->endpoint());
-                    this_.m_data_receive_callback(*peer, data_chunk, error);
-                    peer->unref();
-                }
-            }
-        } else {
-            DataChunk data(nullptr, 0);
-            // TODO: could address be available here???
-            UdpPeer peer(*this_.m_loop, *this_.m_parent, this_.m_udp_handle.get(), Endpoint{0u, 0u}, 0);
+    Error error(nread);
+    if (error) {
+        this_.on_receive_error(error);
+        return;
+    }
 
-            LOG_ERROR(this_.m_loop, &parent, "failed to receive UDP packet", error.string());
-            this_.m_data_receive_callback(peer, data, error);
+    if (!addr || !nread) {
+        return;
+    }
+
+    // Read buffer is taken from the loop's pool and reused for the next packets if user does not keep it.
+    const auto prev_use_count = this_.m_read_buf.use_count();
+    {
+        const DataChunk data_chunk(this_.m_read_buf, std::size_t(nread));
+        const bool accepted = this_.on_datagram_received(addr, data_chunk);
+        if (accepted && this_.m_data_batch_receive_callback) {
+            const UdpDatagram datagram(detail::PeerId{addr}, data_chunk);
+            this_.m_data_batch_receive_callback(parent, &datagram, 1, Error(0));
         }
     }
+    this_.release_read_buffer(prev_use_count);
 }
 
 void UdpServer::Impl::on_close(uv_handle_t* handle) {
@@ -343,6 +491,10 @@ void UdpServer::close_peer(UdpPeer& peer, std::size_t inactivity_timeout_ms) {
     return m_impl->close_peer(peer, inactivity_timeout_ms);
 }
 
+detail::UdpSendQueue* UdpServer::send_queue() {
+    return m_impl->send_queue();
+}
+
 BufferSizeResult UdpServer::receive_buffer_size() const {
     return m_impl->receive_buffer_size();
 }
@@ -363,6 +515,32 @@ std::size_t UdpServer::peers_count() const {
     return m_impl->peers_count();
 }
 
+void UdpServer::set_reuse_port(bool enabled) {
+    return m_impl->set_reuse_port(enabled);
+}
+
+bool UdpServer::is_reuse_port() const {
+    return m_impl->is_reuse_port();
+}
+
+const Endpoint& UdpServer::endpoint() const {
+    return m_impl->endpoint();
+}
+
+Error UdpServer::set_receive_batch(std::size_t datagrams_count,
+                                   std::size_t max_datagram_size,
+                                   const DataBatchReceivedCallback& batch_callback) {
+    return m_impl->set_receive_batch(datagrams_count, max_datagram_size, batch_callback);
+}
+
+Error UdpServer::set_send_batch(std::size_t datagrams_count) {
+    return m_impl->set_send_batch(datagrams_count);
+}
+
+void UdpServer::flush() {
+    return m_impl->flush();
+}
+
 } // namespace net
 } // namespace io
 } // namespace tarm
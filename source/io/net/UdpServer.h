@@ -17,6 +17,7 @@
 #include "BufferSizeResult.h"
 
 #include "Endpoint.h"
+#include "UdpDatagram.h"
 #include "UdpPeer.h"
 
 #include <memory>
@@ -33,6 +34,7 @@ public:
     using NewPeerCallback = std::function<void(UdpPeer&, const Error&)>;
     using DataReceivedCallback = std::function<void(UdpPeer&, const DataChunk&, const Error&)>;
     using PeerTimeoutCallback = std::function<void(UdpPeer&, const Error&)>;
+    using DataBatchReceivedCallback = std::function<void(UdpServer&, const UdpDatagram*, std::size_t, const Error&)>;
 
     using CloseServerCallback = std::function<void(UdpServer&, const Error&)>;
 
@@ -66,6 +68,38 @@ public:
 
     TARM_IO_DLL_PUBLIC std::size_t peers_count() const;
 
+    // Endpoint passed to start_receive. If its port is 0, port assigned by the system is reported.
+    TARM_IO_DLL_PUBLIC const Endpoint& endpoint() const;
+
+    // Allows several servers (usually running in different loops) to receive on the same endpoint,
+    // kernel distributes packets between them by hash of source and destination addresses (SO_REUSEPORT),
+    // so packets of the same peer are always delivered to the same server. Should be called before start_receive.
+    // Note: not supported on Windows, start_receive returns error in this case.
+    TARM_IO_DLL_PUBLIC void set_reuse_port(bool enabled);
+    TARM_IO_DLL_PUBLIC bool is_reuse_port() const;
+
+    // Enables batched receive: up to 'datagrams_count' datagrams are read by a single system call (recvmmsg)
+    // into one buffer from the loop's pool, each datagram takes up to 'max_datagram_size' bytes of it.
+    // Longer datagrams are dropped. Receive callback is still called for each datagram, after that
+    // batch_callback (if set) is called once with all datagrams of the batch. Data chunks of the batch
+    // share the same buffer, it is reused only when none of them is kept by user.
+    // datagrams_count == 1 disables batching. Should be called before start_receive, OPERATION_ALREADY_IN_PROGRESS
+    // is returned while receiving.
+    // Note: batched system call is available on Linux only with the bundled version of libuv, otherwise
+    //       datagrams are received one by one and batch_callback is called for each of them.
+    TARM_IO_DLL_PUBLIC Error set_receive_batch(std::size_t datagrams_count,
+                                               std::size_t max_datagram_size,
+                                               const DataBatchReceivedCallback& batch_callback = nullptr);
+
+    // Enables batched send for all peers of the server: datagrams sent during a loop cycle are queued
+    // and sent at the end of the cycle with up to 'datagrams_count' datagrams per system call (sendmmsg).
+    // Send callbacks are called for each datagram as usual. datagrams_count == 1 disables batching.
+    // Note: batched system call is available on Linux only, on other platforms this setting is ignored.
+    TARM_IO_DLL_PUBLIC Error set_send_batch(std::size_t datagrams_count);
+
+    // Sends queued datagrams immediately instead of waiting for the end of the loop cycle.
+    // Send callbacks of sent datagrams are called before return.
+    TARM_IO_DLL_PUBLIC void flush();
 
     // TODO: method to iterate on peers???
 
@@ -76,6 +110,7 @@ private:
     friend class UdpPeer;
 
     void close_peer(UdpPeer& peer, std::size_t inactivity_timeout_ms);
+    detail::UdpSendQueue* send_queue();
 
     class Impl;
     std::unique_ptr<Impl> m_impl;
@@ -0,0 +1,215 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "net/UdpServerGroup.h"
+
+#include <vector>
+
+#include <assert.h>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+class UdpServerGroup::Impl {
+public:
+    Impl(EventLoopGroup& loop_group);
+
+    Error set_receive_batch(std::size_t datagrams_count,
+                            std::size_t max_datagram_size,
+                            const DataBatchReceivedCallback& batch_callback);
+
+    Error set_send_batch(std::size_t datagrams_count);
+
+    template<typename StartFunction>
+    Error start_receive(const Endpoint& endpoint, StartFunction start_function);
+
+    void schedule_removal();
+
+    std::size_t size() const;
+
+    UdpServer& server(std::size_t index);
+
+    const Endpoint& endpoint() const;
+
+private:
+    EventLoopGroup* m_loop_group;
+
+    // Servers are Removable objects, they are owned by their loops
+    std::vector<UdpServer*> m_servers;
+
+    Endpoint m_endpoint;
+
+    // Zero means that batch settings were not set
+    std::size_t m_receive_batch_datagrams_count = 0;
+    std::size_t m_receive_batch_max_datagram_size = 0;
+    DataBatchReceivedCallback m_data_batch_receive_callback = nullptr;
+
+    std::size_t m_send_batch_datagrams_count = 0;
+};
+
+UdpServerGroup::Impl::Impl(EventLoopGroup& loop_group) :
+    m_loop_group(&loop_group) {
+}
+
+Error UdpServerGroup::Impl::set_receive_batch(std::size_t datagrams_count,
+                                              std::size_t max_datagram_size,
+                                              const DataBatchReceivedCallback& batch_callback) {
+    if (datagrams_count == 0 || max_datagram_size == 0) {
+        return StatusCode::INVALID_ARGUMENT;
+    }
+
+    m_receive_batch_datagrams_count = datagrams_count;
+    m_receive_batch_max_datagram_size = max_datagram_size;
+    m_data_batch_receive_callback = batch_callback;
+
+    return Error(0);
+}
+
+Error UdpServerGroup::Impl::set_send_batch(std::size_t datagrams_count) {
+    if (datagrams_count == 0) {
+        return StatusCode::INVALID_ARGUMENT;
+    }
+
+    m_send_batch_datagrams_count = datagrams_count;
+
+    return Error(0);
+}
+
+template<typename StartFunction>
+Error UdpServerGroup::Impl::start_receive(const Endpoint& endpoint, StartFunction start_function) {
+    if (!m_servers.empty()) {
+        return StatusCode::CONNECTION_ALREADY_IN_PROGRESS;
+    }
+
+    m_endpoint = endpoint;
+
+    for (std::size_t i = 0; i < m_loop_group->size(); ++i) {
+        auto server = new UdpServer(m_loop_group->loop(i));
+        server->set_reuse_port(true);
+        m_servers.push_back(server);
+
+        Error start_error(0);
+        if (m_receive_batch_datagrams_count) {
+            start_error = server->set_receive_batch(m_receive_batch_datagrams_count,
+                                                    m_receive_batch_max_datagram_size,
+                                                    m_data_batch_receive_callback);
+        }
+
+        if (!start_error && m_send_batch_datagrams_count) {
+            start_error = server->set_send_batch(m_send_batch_datagrams_count);
+        }
+
+        if (!start_error) {
+            // If port is 0, the first server gets it from the system and the rest share it
+            start_error = start_function(*server, m_endpoint);
+        }
+
+        if (start_error) {
+            // Loops are not running yet, so it is safe to remove servers from this thread
+            for (auto s : m_servers) {
+                s->schedule_removal();
+            }
+            m_servers.clear();
+
+            return start_error;
+        }
+
+        if (i == 0) {
+            m_endpoint = server->endpoint();
+        }
+    }
+
+    return Error(0);
+}
+
+void UdpServerGroup::Impl::schedule_removal() {
+    for (std::size_t i = 0; i < m_servers.size(); ++i) {
+        auto server = m_servers[i];
+        m_loop_group->loop(i).execute_on_loop_thread([server](EventLoop&) {
+            server->schedule_removal();
+        });
+    }
+
+    m_servers.clear();
+}
+
+std::size_t UdpServerGroup::Impl::size() const {
+    return m_servers.size();
+}
+
+UdpServer& UdpServerGroup::Impl::server(std::size_t index) {
+    assert(index < m_servers.size());
+    return *m_servers[index];
+}
+
+const Endpoint& UdpServerGroup::Impl::endpoint() const {
+    return m_endpoint;
+}
+
+///////////////////////////////////////// implementation ///////////////////////////////////////////
+
+UdpServerGroup::UdpServerGroup(EventLoopGroup& loop_group) :
+    m_impl(new Impl(loop_group)) {
+}
+
+UdpServerGroup::~UdpServerGroup() {
+}
+
+Error UdpServerGroup::set_receive_batch(std::size_t datagrams_count,
+                                        std::size_t max_datagram_size,
+                                        const DataBatchReceivedCallback& batch_callback) {
+    return m_impl->set_receive_batch(datagrams_count, max_datagram_size, batch_callback);
+}
+
+Error UdpServerGroup::set_send_batch(std::size_t datagrams_count) {
+    return m_impl->set_send_batch(datagrams_count);
+}
+
+Error UdpServerGroup::start_receive(const Endpoint& endpoint,
+                                    const DataReceivedCallback& receive_callback) {
+    return m_impl->start_receive(endpoint, [&](UdpServer& server, const Endpoint& server_endpoint) {
+        return server.start_receive(server_endpoint, receive_callback);
+    });
+}
+
+Error UdpServerGroup::start_receive(const Endpoint& endpoint,
+                                    const NewPeerCallback& new_peer_callback,
+                                    const DataReceivedCallback& receive_callback,
+                                    std::size_t timeout_ms,
+                                    const PeerTimeoutCallback& timeout_callback) {
+    return m_impl->start_receive(endpoint, [&](UdpServer& server, const Endpoint& server_endpoint) {
+        return server.start_receive(server_endpoint, new_peer_callback, receive_callback, timeout_ms, timeout_callback);
+    });
+}
+
+Error UdpServerGroup::start_receive(const Endpoint& endpoint,
+                                    const DataReceivedCallback& receive_callback,
+                                    std::size_t timeout_ms,
+                                    const PeerTimeoutCallback& timeout_callback) {
+    return m_impl->start_receive(endpoint, [&](UdpServer& server, const Endpoint& server_endpoint) {
+        return server.start_receive(server_endpoint, receive_callback, timeout_ms, timeout_callback);
+    });
+}
+
+void UdpServerGroup::schedule_removal() {
+    return m_impl->schedule_removal();
+}
+
+std::size_t UdpServerGroup::size() const {
+    return m_impl->size();
+}
+
+UdpServer& UdpServerGroup::server(std::size_t index) {
+    return m_impl->server(index);
+}
+
+const Endpoint& UdpServerGroup::endpoint() const {
+    return m_impl->endpoint();
+}
+
+} // namespace net
+} // namespace io
+} // namespace tarm
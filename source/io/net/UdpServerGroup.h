@@ -0,0 +1,86 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoopGroup.h"
+#include "Export.h"
+#include "net/Endpoint.h"
+#include "net/UdpServer.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace tarm {
+namespace io {
+namespace net {
+
+// Set of UDP servers, one per each loop of EventLoopGroup, which receive on the same endpoint.
+// Packets are distributed between loops by kernel (SO_REUSEPORT) using hash of source and
+// destination addresses, so all packets of a peer are handled by the same loop. Each server
+// keeps its own peers table and inactivity timeouts, there is no state shared between loops.
+// Callbacks are invoked on the thread of the loop which owns the peer.
+class UdpServerGroup {
+public:
+    using NewPeerCallback = UdpServer::NewPeerCallback;
+    using DataReceivedCallback = UdpServer::DataReceivedCallback;
+    using PeerTimeoutCallback = UdpServer::PeerTimeoutCallback;
+    using DataBatchReceivedCallback = UdpServer::DataBatchReceivedCallback;
+
+    TARM_IO_FORBID_COPY(UdpServerGroup);
+    TARM_IO_FORBID_MOVE(UdpServerGroup);
+
+    TARM_IO_DLL_PUBLIC UdpServerGroup(EventLoopGroup& loop_group);
+    TARM_IO_DLL_PUBLIC ~UdpServerGroup();
+
+    // Batched receive settings applied to each server, see UdpServer::set_receive_batch.
+    // Should be called before start_receive.
+    TARM_IO_DLL_PUBLIC Error set_receive_batch(std::size_t datagrams_count,
+                                               std::size_t max_datagram_size,
+                                               const DataBatchReceivedCallback& batch_callback = nullptr);
+
+    // Batched send settings applied to each server, see UdpServer::set_send_batch.
+    // Should be called before start_receive.
+    TARM_IO_DLL_PUBLIC Error set_send_batch(std::size_t datagrams_count);
+
+    // start_receive methods should be called before EventLoopGroup::run(). Callbacks are shared by all servers
+    // and may be invoked simultaneously from different threads. See UdpServer for parameters description.
+    // If port of endpoint is 0, all servers receive on the same port assigned by the system, see endpoint().
+    TARM_IO_DLL_PUBLIC Error start_receive(const Endpoint& endpoint,
+                                      const DataReceivedCallback& receive_callback);
+
+    TARM_IO_DLL_PUBLIC Error start_receive(const Endpoint& endpoint,
+                                      const NewPeerCallback& new_peer_callback,
+                                      const DataReceivedCallback& receive_callback,
+                                      std::size_t timeout_ms,
+                                      const PeerTimeoutCallback& timeout_callback);
+
+    TARM_IO_DLL_PUBLIC Error start_receive(const Endpoint& endpoint,
+                                      const DataReceivedCallback& receive_callback,
+                                      std::size_t timeout_ms,
+                                      const PeerTimeoutCallback& timeout_callback);
+
+    // Closes and removes all servers, each one on its loop's thread.
+    // Note: this method is thread safe
+    TARM_IO_DLL_PUBLIC void schedule_removal();
+
+    TARM_IO_DLL_PUBLIC std::size_t size() const;
+
+    // Server which belongs to the loop with the same index in the group.
+    // Note: server should be accessed only from the thread of its loop.
+    TARM_IO_DLL_PUBLIC UdpServer& server(std::size_t index);
+
+    // Endpoint passed to start_receive, with actual port if 0 was requested
+    TARM_IO_DLL_PUBLIC const Endpoint& endpoint() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace net
+} // namespace io
+} // namespace tarm
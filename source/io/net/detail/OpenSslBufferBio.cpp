@@ -0,0 +1,277 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "OpenSslBufferBio.h"
+
+#include <openssl/bio.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+namespace {
+
+// Match default size classes of BufferPool
+const std::size_t MIN_OUTPUT_CHUNK_SIZE = 4 * 1024;
+const std::size_t MAX_OUTPUT_CHUNK_SIZE = 64 * 1024;
+
+// Upper bound of the record size growth on encryption, including the record header
+const std::size_t MAX_RECORD_OVERHEAD = SSL3_RT_HEADER_LENGTH + SSL3_RT_MAX_ENCRYPTED_OVERHEAD;
+
+} // namespace
+
+OpenSslBufferBio::OpenSslBufferBio(EventLoop& loop) :
+    m_loop(&loop) {
+}
+
+bool OpenSslBufferBio::is_supported() {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    return method() != nullptr;
+#else
+    return false;
+#endif
+}
+
+::BIO* OpenSslBufferBio::create(EventLoop& loop, OpenSslBufferBio*& buffer_bio) {
+    buffer_bio = nullptr;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    auto bio_method = method();
+    if (bio_method == nullptr) {
+        return nullptr;
+    }
+
+    ::BIO* bio = BIO_new(bio_method);
+    if (bio == nullptr) {
+        return nullptr;
+    }
+
+    buffer_bio = new OpenSslBufferBio(loop);
+    BIO_set_data(bio, buffer_bio);
+    BIO_set_init(bio, 1);
+    return bio;
+#else
+    (void)loop;
+    return nullptr;
+#endif
+}
+
+::BIO_METHOD* OpenSslBufferBio::method() {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    // Method is shared by all connections and is never freed
+    static ::BIO_METHOD* bio_method = []() -> ::BIO_METHOD* {
+        const int index = BIO_get_new_index();
+        if (index == -1) {
+            return nullptr;
+        }
+
+        auto result = BIO_meth_new(index | BIO_TYPE_SOURCE_SINK, "tarm-io buffer");
+        if (result == nullptr) {
+            return nullptr;
+        }
+
+        BIO_meth_set_write(result, &OpenSslBufferBio::on_write);
+        BIO_meth_set_read(result, &OpenSslBufferBio::on_read);
+        BIO_meth_set_ctrl(result, &OpenSslBufferBio::on_ctrl);
+        BIO_meth_set_destroy(result, &OpenSslBufferBio::on_destroy);
+        return result;
+    }();
+
+    return bio_method;
+#else
+    return nullptr;
+#endif
+}
+
+int OpenSslBufferBio::on_write(::BIO* bio, const char* data, int size) {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    BIO_clear_retry_flags(bio);
+    if (size <= 0) {
+        return 0;
+    }
+
+    auto& this_ = *reinterpret_cast<OpenSslBufferBio*>(BIO_get_data(bio));
+    this_.write(data, static_cast<std::size_t>(size));
+    return size;
+#else
+    return -1;
+#endif
+}
+
+int OpenSslBufferBio::on_read(::BIO* bio, char* data, int size) {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    BIO_clear_retry_flags(bio);
+    if (size <= 0) {
+        return 0;
+    }
+
+    auto& this_ = *reinterpret_cast<OpenSslBufferBio*>(BIO_get_data(bio));
+    const int result = this_.read(data, static_cast<std::size_t>(size));
+    if (result == 0) {
+        // Same as memory BIO, more data will be provided later
+        BIO_set_retry_read(bio);
+        return -1;
+    }
+
+    return result;
+#else
+    return -1;
+#endif
+}
+
+long OpenSslBufferBio::on_ctrl(::BIO* bio, int command, long num, void* /*ptr*/) {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    auto& this_ = *reinterpret_cast<OpenSslBufferBio*>(BIO_get_data(bio));
+
+    switch (command) {
+        case BIO_CTRL_PENDING:
+            return static_cast<long>(std::min<std::size_t>(this_.input_size(), std::numeric_limits<int>::max()));
+        case BIO_CTRL_WPENDING:
+            return static_cast<long>(std::min<std::size_t>(this_.output_size(), std::numeric_limits<int>::max()));
+        case BIO_CTRL_RESET:
+            this_.m_input = nullptr;
+            this_.m_input_size = 0;
+            std::vector<char>().swap(this_.m_retained_input);
+            this_.m_retained_input_offset = 0;
+            this_.clear_output();
+            return 1;
+        case BIO_CTRL_GET_CLOSE:
+            return BIO_get_shutdown(bio);
+        case BIO_CTRL_SET_CLOSE:
+            BIO_set_shutdown(bio, static_cast<int>(num));
+            return 1;
+        case BIO_CTRL_FLUSH:
+        case BIO_CTRL_DUP:
+            return 1;
+        default:
+            return 0;
+    }
+#else
+    return 0;
+#endif
+}
+
+int OpenSslBufferBio::on_destroy(::BIO* bio) {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    delete reinterpret_cast<OpenSslBufferBio*>(BIO_get_data(bio));
+    BIO_set_data(bio, nullptr);
+    BIO_set_init(bio, 0);
+#endif
+    return 1;
+}
+
+void OpenSslBufferBio::set_input(const char* buf, std::size_t size) {
+    if (!m_retained_input.empty()) {
+        // Order of data is preserved
+        append_input(buf, size);
+        return;
+    }
+
+    m_input = buf;
+    m_input_size = size;
+}
+
+void OpenSslBufferBio::append_input(const char* buf, std::size_t size) {
+    retain_input();
+    m_retained_input.insert(m_retained_input.end(), buf, buf + size);
+}
+
+void OpenSslBufferBio::retain_input() {
+    if (m_input_size) {
+        m_retained_input.insert(m_retained_input.end(), m_input, m_input + m_input_size);
+    }
+
+    m_input = nullptr;
+    m_input_size = 0;
+}
+
+std::size_t OpenSslBufferBio::input_size() const {
+    return m_retained_input.size() - m_retained_input_offset + m_input_size;
+}
+
+int OpenSslBufferBio::read(char* data, std::size_t size) {
+    std::size_t result = 0;
+
+    if (!m_retained_input.empty()) {
+        result = std::min(size, m_retained_input.size() - m_retained_input_offset);
+        std::memcpy(data, m_retained_input.data() + m_retained_input_offset, result);
+        m_retained_input_offset += result;
+        if (m_retained_input_offset == m_retained_input.size()) {
+            // Memory is not kept by idle connections
+            std::vector<char>().swap(m_retained_input);
+            m_retained_input_offset = 0;
+        }
+    } else if (m_input_size) {
+        result = std::min(size, m_input_size);
+        std::memcpy(data, m_input, result);
+        m_input += result;
+        m_input_size -= result;
+    }
+
+    return static_cast<int>(result);
+}
+
+void OpenSslBufferBio::reserve_output(std::size_t size) {
+    const std::size_t records_count = size / SSL3_RT_MAX_PLAIN_LENGTH + 1;
+    m_output_hint = size + records_count * MAX_RECORD_OVERHEAD;
+}
+
+void OpenSslBufferBio::write(const char* data, std::size_t size) {
+    while (size) {
+        if (m_output.empty() || m_output.back().size == m_output_chunk_capacity) {
+            const std::size_t expected_size = std::min(std::max(m_output_hint, MIN_OUTPUT_CHUNK_SIZE), MAX_OUTPUT_CHUNK_SIZE);
+            m_output_chunk_capacity = std::max(size, expected_size);
+            m_output.push_back({m_loop->buffer_pool().acquire(m_output_chunk_capacity), 0});
+        }
+
+        auto& chunk = m_output.back();
+        const std::size_t write_size = std::min(size, m_output_chunk_capacity - chunk.size);
+        std::memcpy(chunk.buf.get() + chunk.size, data, write_size);
+        chunk.size += static_cast<std::uint32_t>(write_size);
+
+        data += write_size;
+        size -= write_size;
+        m_output_size += write_size;
+        m_output_hint -= std::min(m_output_hint, write_size);
+    }
+}
+
+void OpenSslBufferBio::take_output(std::vector<OutputChunk>& chunks) {
+    // Vectors are swapped, so their memory is reused without allocations
+    chunks.clear();
+    chunks.swap(m_output);
+    m_output_chunk_capacity = 0;
+    m_output_size = 0;
+    m_output_hint = 0;
+}
+
+void OpenSslBufferBio::copy_output(std::vector<char>& data) const {
+    data.clear();
+    data.reserve(m_output_size);
+    for (const auto& chunk : m_output) {
+        data.insert(data.end(), chunk.buf.get(), chunk.buf.get() + chunk.size);
+    }
+}
+
+void OpenSslBufferBio::clear_output() {
+    m_output.clear();
+    m_output_chunk_capacity = 0;
+    m_output_size = 0;
+    m_output_hint = 0;
+}
+
+std::size_t OpenSslBufferBio::output_size() const {
+    return m_output_size;
+}
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,87 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoop.h"
+
+#include <openssl/ssl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+// BIO of TLS connection which replaces pair of memory BIOs and avoids intermediate copies of data.
+// Records produced by OpenSSL are written directly into buffers of the loop's BufferPool, which are passed
+// to the underlying client as is. Received data is read by OpenSSL directly from the receive buffer of the
+// underlying client, only data which was not consumed by the end of the receive callback is copied.
+// Custom BIO methods are available since OpenSSL 1.1.0, see is_supported().
+class OpenSslBufferBio {
+public:
+    TARM_IO_FORBID_COPY(OpenSslBufferBio);
+    TARM_IO_FORBID_MOVE(OpenSslBufferBio);
+
+    struct OutputChunk {
+        std::shared_ptr<char> buf;
+        std::uint32_t size;
+    };
+
+    static bool is_supported();
+
+    // Returned BIO owns the object, nullptr is returned on error
+    static ::BIO* create(EventLoop& loop, OpenSslBufferBio*& buffer_bio);
+
+    // Buffer is not copied and should remain valid until retain_input() call
+    void set_input(const char* buf, std::size_t size);
+    // Data is copied
+    void append_input(const char* buf, std::size_t size);
+    // Copies data which was not read yet by OpenSSL from the buffer passed to set_input()
+    void retain_input();
+    std::size_t input_size() const;
+
+    // Hint for the size of the next output chunk, for example size of the data passed to SSL_write
+    void reserve_output(std::size_t size);
+    // Previous content of 'chunks' is dropped
+    void take_output(std::vector<OutputChunk>& chunks);
+    void copy_output(std::vector<char>& data) const;
+    void clear_output();
+    std::size_t output_size() const;
+
+private:
+    explicit OpenSslBufferBio(EventLoop& loop);
+
+    static ::BIO_METHOD* method();
+    static int on_write(::BIO* bio, const char* data, int size);
+    static int on_read(::BIO* bio, char* data, int size);
+    static long on_ctrl(::BIO* bio, int command, long num, void* ptr);
+    static int on_destroy(::BIO* bio);
+
+    int read(char* data, std::size_t size);
+    void write(const char* data, std::size_t size);
+
+    EventLoop* m_loop;
+
+    const char* m_input = nullptr;
+    std::size_t m_input_size = 0;
+    std::vector<char> m_retained_input;
+    std::size_t m_retained_input_offset = 0;
+
+    std::vector<OutputChunk> m_output;
+    std::size_t m_output_chunk_capacity = 0;
+    std::size_t m_output_size = 0;
+    std::size_t m_output_hint = 0;
+};
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
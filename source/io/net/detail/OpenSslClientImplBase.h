@@ -7,18 +7,26 @@
 
 #include "detail/LogMacros.h"
 #include "detail/RawBufferGetter.h"
+#include "fs/File.h"
 #include "global/Configuration.h"
+#include "net/detail/OpenSslBufferBio.h"
+#include "net/detail/OpenSslKernelTls.h"
 #include "net/DtlsVersion.h"
 #include "net/TlsVersion.h"
 #include "DataChunk.h"
 #include "EventLoop.h"
+#include "SendBuffer.h"
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <type_traits>
+#include <vector>
 
 #include <assert.h>
 
@@ -27,6 +35,14 @@ namespace io {
 namespace net {
 namespace detail {
 
+// Underlying clients which are able to send multiple buffers at once, see send_data(std::vector<SendBuffer>, ...)
+template<typename ClientType>
+struct HasScatterGatherSend : std::false_type {};
+template<>
+struct HasScatterGatherSend<TcpClient> : std::true_type {};
+template<>
+struct HasScatterGatherSend<TcpConnectedClient> : std::true_type {};
+
 template<typename ParentType, typename ImplType>
 class OpenSslClientImplBase {
 public:
@@ -45,6 +61,8 @@ public:
 
     void do_handshake();
     void finish_handshake();
+    // Server only. Handshake steps are performed in the thread pool of the loop, see TlsServer::set_handshake_offload
+    void set_handshake_offload(bool enabled);
     virtual void on_handshake_complete() = 0;
     virtual void on_handshake_failed(long openssl_error_code, const Error& error) = 0;
 
@@ -56,6 +74,15 @@ public:
     void send_data(std::unique_ptr<char[]> buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
     void send_data(const std::string& message, const typename ParentType::EndSendCallback& callback);
     void send_data(std::string&& message, const typename ParentType::EndSendCallback& callback);
+    void send_data(std::vector<SendBuffer> buffers, const typename ParentType::EndSendCallback& callback);
+
+    // TLS only. With kernel TLS file is sent by the underlying client, otherwise it is read by chunks and
+    // encrypted by OpenSSL. Only one file may be sent at a time.
+    void send_file(fs::File& file,
+                   std::uint64_t offset,
+                   std::uint64_t length,
+                   const typename ParentType::EndSendCallback& callback,
+                   const std::function<void(ParentType&, std::uint64_t)>& progress_callback);
 
     void on_data_receive(const char* buf, std::size_t size);
 
@@ -63,11 +90,34 @@ public:
 
     Error ssl_shutdown(const typename ParentType::UnderlyingClientType::EndSendCallback& on_send);
 
+    // Peer may reset the connection when close_notify is replied after it closed the socket,
+    // this is a clean close of TLS connection.
+    Error transport_close_error(const Error& error) const;
+
     TlsVersion negotiated_tls_version() const;
     DtlsVersion negotiated_dtls_version() const;
+    bool is_session_resumed() const;
 
     const Endpoint& endpoint() const;
 
+    // TLS only. Watermarks are applied to encrypted data queued by the underlying TCP client.
+    std::size_t pending_send_bytes() const;
+    void set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark);
+    void set_high_watermark_callback(const std::function<void(ParentType&)>& callback);
+    void set_drain_callback(const std::function<void(ParentType&)>& callback);
+
+    // TLS only. Has no effect until handshake is finished.
+    void pause_read();
+    void resume_read();
+    bool is_read_paused() const;
+
+    // TLS only. Should be called before ssl_init, see TlsClient::set_kernel_tls
+    void set_kernel_tls(bool enabled);
+    bool is_kernel_tls_active() const;
+
+    // Should be called before ssl_init, see TlsClient::set_release_idle_buffers
+    void set_release_idle_buffers(bool enabled);
+
 protected:
     enum HandshakeState {
         NONE = 0,
@@ -79,7 +129,76 @@ protected:
     template<typename T>
     void send_data_impl(T buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
 
-    void internal_read_from_sll_and_send(const typename ParentType::UnderlyingClientType::EndSendCallback& on_send);
+    bool ssl_write(const char* buf, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+    void send_encrypted(std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+
+    // Socket of the underlying connection for kernel TLS, -1 if it is not available
+    virtual int kernel_tls_socket_fd();
+
+    std::uint64_t kernel_tls_tx_sequence_number();
+    void enable_kernel_tls(std::uint64_t sequence_number);
+    typename ParentType::UnderlyingClientType::EndSendCallback kernel_tls_send_callback(const typename ParentType::EndSendCallback& callback);
+    void send_kernel_tls_close_notify();
+
+    // Data is passed to the underlying client as is and encrypted by the kernel
+    template<typename T>
+    void send_plaintext(T buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+    void send_plaintext(std::string buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+
+    // Returns false if there is no encrypted data to send
+    bool internal_read_from_sll_and_send(const typename ParentType::UnderlyingClientType::EndSendCallback& on_send);
+    void send_encrypted_chunks(std::vector<OpenSslBufferBio::OutputChunk>& chunks,
+                               const typename ParentType::UnderlyingClientType::EndSendCallback& on_send);
+    template<typename ClientType>
+    void send_encrypted_chunks_impl(ClientType& client,
+                                    std::vector<OpenSslBufferBio::OutputChunk>& chunks,
+                                    const typename ClientType::EndSendCallback& on_send,
+                                    std::true_type has_scatter_gather_send);
+    template<typename ClientType>
+    void send_encrypted_chunks_impl(ClientType& client,
+                                    std::vector<OpenSslBufferBio::OutputChunk>& chunks,
+                                    const typename ClientType::EndSendCallback& on_send,
+                                    std::false_type has_scatter_gather_send);
+
+    // Access to BIOs, TLS connections use single OpenSslBufferBio and DTLS ones use pair of memory BIOs
+    std::size_t pending_encrypted_size() const;
+    std::size_t pending_received_size() const;
+    void discard_encrypted();
+    // Data is copied
+    bool write_received(const char* buf, std::size_t size);
+
+    // Shared with the thread pool, owner is reset if connection is destroyed before the work is done
+    struct HandshakeWork {
+        OpenSslClientImplBase* owner = nullptr;
+        ::SSL* ssl = nullptr; // Holds own reference
+        int result = 0;
+        int ssl_error = SSL_ERROR_NONE;
+        unsigned long openssl_error_code = 0;
+    };
+
+    void offload_handshake();
+    void on_handshake_work_done(const HandshakeWork& work, const Error& error);
+    void on_handshake_step(int handshake_result, int ssl_error, unsigned long openssl_error_code);
+
+    // File send without kernel TLS, owner is reset if connection is destroyed while file is read
+    struct FileSend {
+        OpenSslClientImplBase* owner = nullptr;
+        fs::File* file = nullptr;
+        std::uint64_t offset = 0;
+        std::uint64_t remaining = 0;
+        std::uint64_t sent = 0;
+        bool end_of_file = false;
+        typename ParentType::EndSendCallback end_send_callback;
+        std::function<void(ParentType&, std::uint64_t)> progress_callback;
+    };
+
+    static void read_file_chunk(const std::shared_ptr<FileSend>& file_send);
+    void on_file_chunk_read(const DataChunk& data, const Error& error);
+    void on_file_chunk_sent(std::size_t size, const Error& error);
+    void finish_file_send(const Error& error);
+
+    // Should be called when underlying client is created
+    void attach_send_watermarks();
 
     ParentType* m_parent;
     EventLoop* m_loop;
@@ -92,6 +211,10 @@ protected:
 
     BIO* m_ssl_read_bio = nullptr;
     BIO* m_ssl_write_bio = nullptr;
+    // Owned by the SSL object, both BIOs above point to it when it is used
+    OpenSslBufferBio* m_buffer_bio = nullptr;
+    // Only keeps memory between sends
+    std::vector<OpenSslBufferBio::OutputChunk> m_encrypted_chunks;
 
     HandshakeState m_ssl_handshake_state = HandshakeState::NONE;
 
@@ -100,6 +223,30 @@ protected:
 
     bool m_ssl_inited = false;
 
+    std::size_t m_send_high_watermark = 0;
+    std::size_t m_send_low_watermark = 0;
+    std::function<void(ParentType&)> m_high_watermark_callback = nullptr;
+    std::function<void(ParentType&)> m_drain_callback = nullptr;
+
+    bool m_read_paused = false;
+    bool m_reading_from_ssl = false;
+
+    bool m_handshake_offload = false;
+    std::shared_ptr<HandshakeWork> m_handshake_work;
+    // Data received while handshake step is performed in the thread pool
+    std::vector<char> m_handshake_work_pending_data;
+
+    bool m_kernel_tls_requested = false;
+    bool m_kernel_tls_tx = false;
+    // Sends which are not written to the socket yet, close_notify alert is sent after them
+    std::size_t m_kernel_tls_pending_sends = 0;
+    bool m_kernel_tls_close_notify_requested = false;
+    typename ParentType::UnderlyingClientType::EndSendCallback m_kernel_tls_close_notify_callback = nullptr;
+
+    std::shared_ptr<FileSend> m_file_send;
+
+    bool m_release_idle_buffers = false;
+
 private:
     static void ssl_state_callback(const SSL* ssl, int where, int ret);
 
@@ -107,7 +254,9 @@ private:
 
     // https://www.openssl.org/docs/man1.0.2/man3/SSL_read.html
     static const std::size_t DECRYPT_BUF_SIZE = 16 * 1024;
+    static const std::size_t FILE_SEND_CHUNK_SIZE = 64 * 1024;
     static_assert(DECRYPT_BUF_SIZE <= std::numeric_limits<int>::max(), "");
+    // Acquired from the loop's BufferPool on the first read
     std::shared_ptr<char> m_decrypt_buf;
 
     std::size_t m_data_offset = 0;
@@ -119,12 +268,27 @@ template<typename ParentType, typename ImplType>
 OpenSslClientImplBase<ParentType, ImplType>::OpenSslClientImplBase(EventLoop& loop, ParentType& parent) :
     m_parent(&parent),
     m_loop(&loop),
-    m_ssl(nullptr, &::SSL_free),
-    m_decrypt_buf(new char[DECRYPT_BUF_SIZE], std::default_delete<char[]>()) {
+    m_ssl(nullptr, &::SSL_free) {
 }
 
 template<typename ParentType, typename ImplType>
 OpenSslClientImplBase<ParentType, ImplType>::~OpenSslClientImplBase() {
+    if (m_handshake_work) {
+        m_handshake_work->owner = nullptr;
+    }
+
+    if (m_file_send) {
+        m_file_send->owner = nullptr;
+    }
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::is_session_resumed() const {
+    if (!is_open() || m_ssl_handshake_state < HandshakeState::FINISHING) {
+        return false;
+    }
+
+    return SSL_session_reused(m_ssl.get()) == 1;
 }
 
 template<typename ParentType, typename ImplType>
@@ -195,6 +359,7 @@ bool OpenSslClientImplBase<ParentType, ImplType>::is_open() const {
 
 template<typename ParentType, typename ImplType>
 Error OpenSslClientImplBase<ParentType, ImplType>::ssl_init(::SSL_CTX* ssl_ctx) {
+    m_buffer_bio = nullptr;
     m_ssl.reset(SSL_new(ssl_ctx));
     if (m_ssl == nullptr) {
         LOG_ERROR(m_loop, m_parent, "Failed to create SSL");
@@ -202,20 +367,52 @@ Error OpenSslClientImplBase<ParentType, ImplType>::ssl_init(::SSL_CTX* ssl_ctx)
     }
 
     SSL_set_ex_data(m_ssl.get(), 0, this);
+
+    if (m_kernel_tls_requested) {
+        const auto kernel_tls_error = detail::kernel_tls_init_ssl(m_ssl.get());
+        if (kernel_tls_error) {
+            LOG_WARNING(m_loop, m_parent, "Kernel TLS will not be used:", kernel_tls_error.string());
+            m_kernel_tls_requested = false;
+        }
+    }
+
     SSL_set_info_callback(m_ssl.get(), &OpenSslClientImplBase<ParentType, ImplType>::ssl_state_callback);
 
-    m_ssl_read_bio = BIO_new(BIO_s_mem());
-    if (m_ssl_read_bio == nullptr) {
-        LOG_ERROR(m_loop, m_parent, "Failed to create read BIO");
-        return Error(StatusCode::OPENSSL_ERROR, "Failed to create read BIO");
+    if (m_release_idle_buffers) {
+        // OpenSSL frees its read and write record buffers (about 34 KB) once they are empty
+        SSL_set_mode(m_ssl.get(), SSL_MODE_RELEASE_BUFFERS);
     }
 
-    m_ssl_write_bio = BIO_new(BIO_s_mem());
-    if (m_ssl_write_bio == nullptr) {
-        LOG_ERROR(m_loop, m_parent, "Failed to create write BIO");
-        return Error(StatusCode::OPENSSL_ERROR, "Failed to create write BIO");
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    // Datagrams are kept in memory BIOs
+    const bool use_buffer_bio = !SSL_is_dtls(m_ssl.get()) && OpenSslBufferBio::is_supported();
+#else
+    const bool use_buffer_bio = false;
+#endif
+    if (use_buffer_bio) {
+        auto bio = OpenSslBufferBio::create(*m_loop, m_buffer_bio);
+        if (bio == nullptr) {
+            LOG_ERROR(m_loop, m_parent, "Failed to create BIO");
+            return Error(StatusCode::OPENSSL_ERROR, "Failed to create BIO");
+        }
+
+        m_ssl_read_bio = bio;
+        m_ssl_write_bio = bio;
+    } else {
+        m_ssl_read_bio = BIO_new(BIO_s_mem());
+        if (m_ssl_read_bio == nullptr) {
+            LOG_ERROR(m_loop, m_parent, "Failed to create read BIO");
+            return Error(StatusCode::OPENSSL_ERROR, "Failed to create read BIO");
+        }
+
+        m_ssl_write_bio = BIO_new(BIO_s_mem());
+        if (m_ssl_write_bio == nullptr) {
+            LOG_ERROR(m_loop, m_parent, "Failed to create write BIO");
+            return Error(StatusCode::OPENSSL_ERROR, "Failed to create write BIO");
+        }
     }
 
+    // Single BIO is owned once when it is passed as both read and write one
     SSL_set_bio(m_ssl.get(), m_ssl_read_bio, m_ssl_write_bio);
 
     ssl_set_state();
@@ -233,6 +430,17 @@ bool OpenSslClientImplBase<ParentType, ImplType>::is_ssl_inited() const {
 
 template<typename ParentType, typename ImplType>
 void OpenSslClientImplBase<ParentType, ImplType>::read_from_ssl() {
+    // When reading is paused from the callback, the rest of received data stays in OpenSSL until resume
+    if (m_read_paused) {
+        return;
+    }
+
+    m_reading_from_ssl = true;
+
+    if (m_decrypt_buf == nullptr) {
+        m_decrypt_buf = m_loop->buffer_pool().acquire(DECRYPT_BUF_SIZE);
+    }
+
     int decrypted_size = SSL_read(m_ssl.get(), m_decrypt_buf.get(), static_cast<int>(DECRYPT_BUF_SIZE));
     std::size_t counter = 0;
     while (decrypted_size > 0) {
@@ -241,10 +449,26 @@ void OpenSslClientImplBase<ParentType, ImplType>::read_from_ssl() {
         on_ssl_read({m_decrypt_buf, static_cast<std::size_t>(decrypted_size), m_data_offset}, StatusCode::OK);
         m_data_offset += static_cast<std::size_t>(decrypted_size);
         if (prev_use_count != m_decrypt_buf.use_count()) { // user made a copy
-            m_decrypt_buf.reset(new char[DECRYPT_BUF_SIZE], std::default_delete<char[]>());
+            m_decrypt_buf = m_loop->buffer_pool().acquire(DECRYPT_BUF_SIZE);
         }
-        decrypted_size = SSL_read(m_ssl.get(), m_decrypt_buf.get(), DECRYPT_BUF_SIZE);
         ++counter;
+
+        if (m_read_paused) {
+            m_reading_from_ssl = false;
+            if (m_release_idle_buffers) {
+                m_decrypt_buf.reset();
+            }
+            return;
+        }
+
+        decrypted_size = SSL_read(m_ssl.get(), m_decrypt_buf.get(), DECRYPT_BUF_SIZE);
+    }
+
+    m_reading_from_ssl = false;
+
+    if (m_release_idle_buffers) {
+        // Returned to the pool, so idle connections do not hold it
+        m_decrypt_buf.reset();
     }
 
     // TODO: fixme!!!111
@@ -265,23 +489,161 @@ void OpenSslClientImplBase<ParentType, ImplType>::read_from_ssl() {
             on_ssl_read({nullptr, 0}, Error(StatusCode::OPENSSL_ERROR, str ? str : ""));
             return;
         }
+    } else if (SSL_get_error(m_ssl.get(), decrypted_size) == SSL_ERROR_ZERO_RETURN &&
+               !(SSL_get_shutdown(m_ssl.get()) & SSL_SENT_SHUTDOWN)) {
+        // Peer finished the connection cleanly, close_notify is replied. This also keeps the session resumable,
+        // otherwise OpenSSL removes it from the cache when SSL object is freed.
+        const Error shutdown_error = ssl_shutdown(nullptr);
+        if (shutdown_error) {
+            LOG_ERROR(m_loop, m_parent, "Failed to reply close_notify:", shutdown_error);
+        }
+    }
+
+    if (m_kernel_tls_tx && pending_encrypted_size() > 0) {
+        // For example response to the key update, it can not be protected with the keys of the kernel
+        LOG_ERROR(m_loop, m_parent, "Post-handshake message can not be sent with kernel TLS");
+        discard_encrypted();
+        on_ssl_read({nullptr, 0}, Error(StatusCode::OPENSSL_ERROR, "Post-handshake message can not be sent with kernel TLS"));
     }
 }
 
 template<typename ParentType, typename ImplType>
-void OpenSslClientImplBase<ParentType, ImplType>::internal_read_from_sll_and_send(const typename ParentType::UnderlyingClientType::EndSendCallback& on_send) {
+bool OpenSslClientImplBase<ParentType, ImplType>::internal_read_from_sll_and_send(const typename ParentType::UnderlyingClientType::EndSendCallback& on_send) {
+    if (m_buffer_bio) {
+        // Records are already in the pooled buffers, they are passed to the underlying client without copying.
+        // Member vector may be reused from the send callbacks, so it is moved out for the time of sending.
+        std::vector<OpenSslBufferBio::OutputChunk> chunks;
+        chunks.swap(m_encrypted_chunks);
+        m_buffer_bio->take_output(chunks);
+        if (chunks.empty()) {
+            LOG_WARNING(m_loop, m_parent, "No data to read from OpenSSL BIO");
+            return false;
+        }
+
+        send_encrypted_chunks(chunks, on_send);
+
+        chunks.clear();
+        if (m_encrypted_chunks.capacity() == 0) {
+            chunks.swap(m_encrypted_chunks);
+        }
+        return true;
+    }
 
     const auto write_pending = BIO_pending(m_ssl_write_bio);
-    if (write_pending == 0) {
+    if (write_pending <= 0) {
         LOG_WARNING(m_loop, m_parent, "No data to read from OpenSSL BIO");
-        return;
+        return false;
     }
 
     std::shared_ptr<char> buf(new char[write_pending], [](const char* p) { delete[] p; });
     const auto size = BIO_read(m_ssl_write_bio, buf.get(), write_pending);
+    if (size <= 0) {
+        LOG_ERROR(m_loop, m_parent, "BIO_read failed code:", size);
+        return false;
+    }
 
     LOG_TRACE(m_loop, m_parent, "Getting data from SSL and sending to server, size:", size);
     m_client->send_data(buf, size, on_send);
+    return true;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_encrypted_chunks(std::vector<OpenSslBufferBio::OutputChunk>& chunks,
+                                                                        const typename ParentType::UnderlyingClientType::EndSendCallback& on_send) {
+    using UnderlyingClientType = typename ParentType::UnderlyingClientType;
+
+    LOG_TRACE(m_loop, m_parent, "Getting data from SSL and sending to server, chunks:", chunks.size());
+
+    if (chunks.size() == 1) {
+        m_client->send_data(std::move(chunks.front().buf), chunks.front().size, on_send);
+        return;
+    }
+
+    send_encrypted_chunks_impl(*m_client, chunks, on_send, HasScatterGatherSend<UnderlyingClientType>());
+}
+
+template<typename ParentType, typename ImplType>
+template<typename ClientType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_encrypted_chunks_impl(ClientType& client,
+                                                                             std::vector<OpenSslBufferBio::OutputChunk>& chunks,
+                                                                             const typename ClientType::EndSendCallback& on_send,
+                                                                             std::true_type /*has_scatter_gather_send*/) {
+    std::vector<SendBuffer> buffers;
+    buffers.reserve(chunks.size());
+    for (auto& chunk : chunks) {
+        buffers.emplace_back(std::move(chunk.buf), chunk.size);
+    }
+
+    client.send_data(std::move(buffers), on_send);
+}
+
+template<typename ParentType, typename ImplType>
+template<typename ClientType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_encrypted_chunks_impl(ClientType& client,
+                                                                             std::vector<OpenSslBufferBio::OutputChunk>& chunks,
+                                                                             const typename ClientType::EndSendCallback& on_send,
+                                                                             std::false_type /*has_scatter_gather_send*/) {
+    // Chunks are sent in order, callback is called once after the last one with the first error if any
+    auto first_error = std::make_shared<Error>(StatusCode::OK);
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const bool is_last = i + 1 == chunks.size();
+        client.send_data(std::move(chunks[i].buf), chunks[i].size,
+            [first_error, is_last, on_send](ClientType& client, const Error& error) {
+                if (error && !*first_error) {
+                    *first_error = error;
+                }
+
+                if (is_last && on_send) {
+                    on_send(client, *first_error);
+                }
+            }
+        );
+    }
+}
+
+template<typename ParentType, typename ImplType>
+std::size_t OpenSslClientImplBase<ParentType, ImplType>::pending_encrypted_size() const {
+    if (m_buffer_bio) {
+        return m_buffer_bio->output_size();
+    }
+
+    const auto size = BIO_pending(m_ssl_write_bio);
+    return size > 0 ? static_cast<std::size_t>(size) : 0;
+}
+
+template<typename ParentType, typename ImplType>
+std::size_t OpenSslClientImplBase<ParentType, ImplType>::pending_received_size() const {
+    if (m_buffer_bio) {
+        return m_buffer_bio->input_size();
+    }
+
+    const auto size = BIO_pending(m_ssl_read_bio);
+    return size > 0 ? static_cast<std::size_t>(size) : 0;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::discard_encrypted() {
+    if (m_buffer_bio) {
+        m_buffer_bio->clear_output();
+    } else {
+        (void)BIO_reset(m_ssl_write_bio);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::write_received(const char* buf, std::size_t size) {
+    if (m_buffer_bio) {
+        m_buffer_bio->append_input(buf, size);
+        return true;
+    }
+
+    const auto write_size = BIO_write(m_ssl_read_bio, buf, static_cast<int>(size));
+    if (write_size <= 0) {
+        LOG_ERROR(m_loop, m_parent, "BIO_write failed with code:", write_size);
+        return false;
+    }
+
+    return true;
 }
 
 template<typename ParentType, typename ImplType>
@@ -293,16 +655,109 @@ void OpenSslClientImplBase<ParentType, ImplType>::do_handshake() {
         return;
     }
 
-    auto handshake_result = SSL_do_handshake(m_ssl.get());
+    if (m_handshake_offload) {
+        offload_handshake();
+        return;
+    }
+
+    const auto handshake_result = SSL_do_handshake(m_ssl.get());
+    const auto ssl_error = handshake_result == 1 ? SSL_ERROR_NONE : SSL_get_error(m_ssl.get(), handshake_result);
+    const bool is_failed = handshake_result != 1 && ssl_error != SSL_ERROR_WANT_READ && ssl_error != SSL_ERROR_WANT_WRITE;
+    on_handshake_step(handshake_result, ssl_error, is_failed ? ERR_get_error() : 0);
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_handshake_offload(bool enabled) {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    m_handshake_offload = enabled;
+#else
+    (void)enabled; // SSL_up_ref is not available
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::offload_handshake() {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    if (m_handshake_work) {
+        return; // Received data is passed to OpenSSL when current step is done
+    }
+
+    LOG_TRACE(m_loop, m_parent, "Performing handshake step in the thread pool");
+
+    auto work = std::make_shared<HandshakeWork>();
+    work->owner = this;
+    work->ssl = m_ssl.get();
+    SSL_up_ref(work->ssl);
+    m_handshake_work = work;
+
+    // Info callback refers to this object, it is not called from the thread pool
+    SSL_set_info_callback(m_ssl.get(), nullptr);
+
+    m_loop->add_work(
+        [work](EventLoop&) {
+            // Error queue of OpenSSL is thread local
+            ERR_clear_error();
+            work->result = SSL_do_handshake(work->ssl);
+            if (work->result != 1) {
+                work->ssl_error = SSL_get_error(work->ssl, work->result);
+                if (work->ssl_error != SSL_ERROR_WANT_READ && work->ssl_error != SSL_ERROR_WANT_WRITE) {
+                    work->openssl_error_code = ERR_get_error();
+                }
+            }
+            ERR_clear_error();
+        },
+        [work](EventLoop&, const Error& error) {
+            SSLPtr ssl(work->ssl, &::SSL_free);
+            if (work->owner) {
+                work->owner->on_handshake_work_done(*work, error);
+            }
+        }
+    );
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::on_handshake_work_done(const HandshakeWork& work, const Error& error) {
+    m_handshake_work.reset();
+    SSL_set_info_callback(m_ssl.get(), &OpenSslClientImplBase<ParentType, ImplType>::ssl_state_callback);
+
+    if (error) {
+        on_handshake_failed(-1, error);
+        return;
+    }
+
+    const bool has_pending_data = !m_handshake_work_pending_data.empty();
+    if (has_pending_data) {
+        const bool is_written = write_received(m_handshake_work_pending_data.data(), m_handshake_work_pending_data.size());
+        std::vector<char>().swap(m_handshake_work_pending_data);
+        if (!is_written) {
+            on_handshake_failed(-1, Error(StatusCode::OPENSSL_ERROR, "Handshake failed, invalid data"));
+            return;
+        }
+    }
+
+    const bool wants_read = work.result != 1 && work.ssl_error == SSL_ERROR_WANT_READ;
+    if (wants_read && has_pending_data && pending_encrypted_size() == 0) {
+        // Step was performed on incomplete data, the rest is already received
+        do_handshake();
+        return;
+    }
+
+    on_handshake_step(work.result, work.ssl_error, work.openssl_error_code);
+
+    if (wants_read && has_pending_data) {
+        do_handshake();
+    }
+}
 
-    int write_pending = BIO_pending(m_ssl_write_bio);
-    int read_pending = BIO_pending(m_ssl_read_bio);
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::on_handshake_step(int handshake_result, int ssl_error, unsigned long openssl_error_code) {
+    const std::size_t write_pending = pending_encrypted_size();
+    const std::size_t read_pending = pending_received_size();
     LOG_TRACE(m_loop, m_parent, "write_pending:", write_pending);
     LOG_TRACE(m_loop, m_parent, "read_pending:", read_pending);
 
     if (handshake_result < 0) {
-        auto ssl_error = SSL_get_error(m_ssl.get(), handshake_result);
-
         if (ssl_error == SSL_ERROR_WANT_READ) {
             LOG_TRACE(m_loop, m_parent, "SSL_ERROR_WANT_READ");
             if (write_pending == 0) {
@@ -321,7 +776,6 @@ void OpenSslClientImplBase<ParentType, ImplType>::do_handshake() {
         } else if (ssl_error == SSL_ERROR_WANT_WRITE) {
             LOG_TRACE(m_loop, m_parent, "SSL_ERROR_WANT_WRITE");
         } else {
-            const auto openssl_error_code = ERR_get_error();
             LOG_ERROR(m_loop, m_parent, "Handshake error:", openssl_error_code);
             if (write_pending) {
                 // Just notification for other side without care about result
@@ -332,14 +786,18 @@ void OpenSslClientImplBase<ParentType, ImplType>::do_handshake() {
             on_handshake_failed(openssl_error_code, Error(StatusCode::OPENSSL_ERROR, str ? str : ""));
         }
     } else if (handshake_result == 1) {
+        const auto kernel_tls_sequence_number = m_kernel_tls_requested ? kernel_tls_tx_sequence_number() : 0;
+
         if (write_pending) {
             m_ssl_handshake_state = HandshakeState::FINISHING;
 
             internal_read_from_sll_and_send(
-                [this, read_pending](typename ParentType::UnderlyingClientType& client, const Error& error) {
+                [this, read_pending, kernel_tls_sequence_number](typename ParentType::UnderlyingClientType& client, const Error& error) {
                     if (error) {
                         on_handshake_failed(-1, error);
                     } else {
+                        // Keys are installed only when the last records encrypted by OpenSSL are in the socket
+                        enable_kernel_tls(kernel_tls_sequence_number);
                         finish_handshake();
 
                         if (read_pending) {
@@ -349,6 +807,7 @@ void OpenSslClientImplBase<ParentType, ImplType>::do_handshake() {
                 }
             );
         } else {
+            enable_kernel_tls(kernel_tls_sequence_number);
             finish_handshake();
 
             if (read_pending) {
@@ -356,7 +815,6 @@ void OpenSslClientImplBase<ParentType, ImplType>::do_handshake() {
             }
         }
     } else {
-        const auto openssl_error_code = ERR_get_error();
         const char* str = ERR_reason_error_string(openssl_error_code);
         LOG_ERROR(m_loop, m_parent, "The TLS/SSL handshake was not successful but was shut down controlled and by the specifications of the TLS/SSL protocol. Error code:", openssl_error_code, "message:", str ? str : "");
         on_handshake_failed(openssl_error_code, Error(StatusCode::OPENSSL_ERROR, str ? str : ""));
@@ -415,39 +873,95 @@ void OpenSslClientImplBase<ParentType, ImplType>::send_data_impl(T buffer, std::
         return;
     }
 
-    const auto buf_data = io::detail::raw_buffer_get(buffer);
-    const auto write_result = SSL_write(m_ssl.get(), buf_data, size);
-    if (write_result <= 0) {
-        LOG_ERROR(m_loop, m_parent, "Failed to write buf of size", size);
+    if (m_kernel_tls_tx) {
+        send_plaintext(std::move(buffer), size, callback);
+        return;
+    }
 
-        const auto openssl_error_code = ERR_get_error();
+    if (!ssl_write(io::detail::raw_buffer_get(buffer), size, callback)) {
+        return;
+    }
+
+    send_encrypted(size, callback);
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_data(std::vector<SendBuffer> buffers, const typename ParentType::EndSendCallback& callback) {
+    if (!is_open()) {
         if (callback) {
-            const char* str = ERR_reason_error_string(openssl_error_code);
-            callback(*m_parent, Error(StatusCode::OPENSSL_ERROR, str ? str : ""));
+            callback(*m_parent, Error(StatusCode::NOT_CONNECTED));
         }
+        return;
+    }
+
+    if (buffers.empty()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::INVALID_ARGUMENT));
+        }
+        return;
+    }
+
+    for (const auto& buffer : buffers) {
+        if (buffer.size() == 0 || buffer.data() == nullptr) {
+            if (callback) {
+                callback(*m_parent, Error(StatusCode::INVALID_ARGUMENT));
+            }
+            return;
+        }
+    }
 
+    if (m_kernel_tls_tx) {
+        m_client->send_data(std::move(buffers), kernel_tls_send_callback(callback));
         return;
     }
 
-    const auto pending_size = BIO_pending(m_ssl_write_bio);
-    assert(pending_size >= 0);
-    std::shared_ptr<char> ptr(new char[pending_size], [](const char* p) { delete[] p;});
+    // Records of all buffers are accumulated in the write BIO and sent to underlying client at once.
+    // Buffers are not needed after SSL_write, so they are released on return.
+    std::uint32_t total_size = 0;
+    for (const auto& buffer : buffers) {
+        if (!ssl_write(buffer.data(), buffer.size(), callback)) {
+            return;
+        }
+        total_size += buffer.size();
+    }
+
+    send_encrypted(total_size, callback);
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::ssl_write(const char* buf, std::uint32_t size, const typename ParentType::EndSendCallback& callback) {
+    if (m_buffer_bio) {
+        m_buffer_bio->reserve_output(size);
+    }
+
+    const auto write_result = SSL_write(m_ssl.get(), buf, size);
+    if (write_result <= 0) {
+        LOG_ERROR(m_loop, m_parent, "Failed to write buf of size", size);
 
-    const auto actual_size = BIO_read(m_ssl_write_bio, ptr.get(), pending_size);
-    if (actual_size <= 0) {
-        LOG_ERROR(m_loop, m_parent, "BIO_read failed code:", actual_size);
+        const auto openssl_error_code = ERR_get_error();
         if (callback) {
-            callback(*m_parent, Error(StatusCode::OPENSSL_ERROR, "Nothing to read from SSL"));
+            const char* str = ERR_reason_error_string(openssl_error_code);
+            callback(*m_parent, Error(StatusCode::OPENSSL_ERROR, str ? str : ""));
         }
-        return;
+
+        return false;
     }
 
-    LOG_TRACE(m_loop, m_parent, "Sending message to client. Original size:", size, "encrypted_size:", actual_size);
-    m_client->send_data(ptr, actual_size, [callback, this](typename ParentType::UnderlyingClientType& tcp_client, const Error& error) {
+    return true;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_encrypted(std::uint32_t size, const typename ParentType::EndSendCallback& callback) {
+    LOG_TRACE(m_loop, m_parent, "Sending message to client. Original size:", size, "encrypted_size:", pending_encrypted_size());
+    const bool is_sent = internal_read_from_sll_and_send([callback, this](typename ParentType::UnderlyingClientType& tcp_client, const Error& error) {
         if (callback) {
             callback(*m_parent, error);
         }
     });
+
+    if (!is_sent && callback) {
+        callback(*m_parent, Error(StatusCode::OPENSSL_ERROR, "Nothing to read from SSL"));
+    }
 }
 
 template<typename ParentType, typename ImplType>
@@ -456,6 +970,16 @@ void OpenSslClientImplBase<ParentType, ImplType>::on_data_receive(const char* bu
     assert(size <= std::numeric_limits<int>::max());
 
     if (m_ssl_handshake_state == HandshakeState::FINISHED) {
+        if (m_buffer_bio) {
+            // Records are read by OpenSSL directly from the receive buffer, the rest is copied if reading stops
+            m_buffer_bio->set_input(buf, size);
+            read_from_ssl();
+            if (m_buffer_bio) {
+                m_buffer_bio->retain_input();
+            }
+            return;
+        }
+
         const auto write_size = BIO_write(m_ssl_read_bio, buf, static_cast<int>(size));
         if (write_size < 0) {
             LOG_ERROR(m_loop, m_parent, "BIO_write failed with code:", write_size);
@@ -463,10 +987,12 @@ void OpenSslClientImplBase<ParentType, ImplType>::on_data_receive(const char* bu
         }
 
         read_from_ssl();
+    } else if (m_handshake_work) {
+        // OpenSSL object is used by the thread pool
+        m_handshake_work_pending_data.insert(m_handshake_work_pending_data.end(), buf, buf + size);
     } else {
-        const auto write_size = BIO_write(m_ssl_read_bio, buf, static_cast<int>(size));
-        if (write_size <= 0) {
-            LOG_ERROR(m_loop, m_parent, "BIO_write failed with code:", write_size);
+        // Handshake step may be performed in the thread pool, so data is copied
+        if (!write_received(buf, size)) {
             on_handshake_failed(-1, Error(StatusCode::OPENSSL_ERROR, "Handshake failed, invalid data"));
             return;
         }
@@ -475,6 +1001,84 @@ void OpenSslClientImplBase<ParentType, ImplType>::on_data_receive(const char* bu
     }
 }
 
+template<typename ParentType, typename ImplType>
+std::size_t OpenSslClientImplBase<ParentType, ImplType>::pending_send_bytes() const {
+    return m_client ? m_client->pending_send_bytes() : 0;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark) {
+    m_send_high_watermark = high_watermark;
+    m_send_low_watermark = low_watermark;
+
+    if (m_client) {
+        m_client->set_send_watermarks(high_watermark, low_watermark);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_high_watermark_callback(const std::function<void(ParentType&)>& callback) {
+    m_high_watermark_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_drain_callback(const std::function<void(ParentType&)>& callback) {
+    m_drain_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::pause_read() {
+    if (!is_open() || m_read_paused) {
+        return;
+    }
+
+    m_read_paused = true;
+    m_client->pause_read();
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::resume_read() {
+    if (!m_read_paused) {
+        return;
+    }
+
+    m_read_paused = false;
+
+    if (!is_open()) {
+        return;
+    }
+
+    m_client->resume_read();
+
+    // Data decrypted by OpenSSL or received before pause could be already buffered. If resume is called
+    // from the receive callback, the loop of read_from_ssl continues with that data itself.
+    if (!m_reading_from_ssl) {
+        read_from_ssl();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::is_read_paused() const {
+    return m_read_paused;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::attach_send_watermarks() {
+    using UnderlyingClientType = typename ParentType::UnderlyingClientType;
+
+    m_client->set_send_watermarks(m_send_high_watermark, m_send_low_watermark);
+    m_client->set_high_watermark_callback([this](UnderlyingClientType&) {
+        if (m_high_watermark_callback) {
+            m_high_watermark_callback(*m_parent);
+        }
+    });
+    m_client->set_drain_callback([this](UnderlyingClientType&) {
+        if (m_drain_callback) {
+            m_drain_callback(*m_parent);
+        }
+    });
+}
+
 template<typename ParentType, typename ImplType>
 bool OpenSslClientImplBase<ParentType, ImplType>::schedule_removal() {
     LOG_TRACE(m_loop, m_parent, "");
@@ -497,6 +1101,17 @@ template<typename ParentType, typename ImplType>
 Error OpenSslClientImplBase<ParentType, ImplType>::ssl_shutdown(const typename ParentType::UnderlyingClientType::EndSendCallback& on_send) {
     LOG_TRACE(m_loop, m_parent, "");
 
+    if (m_kernel_tls_tx) {
+        // OpenSSL is not able to protect the alert with the keys of the kernel
+        SSL_set_shutdown(m_ssl.get(), SSL_get_shutdown(m_ssl.get()) | SSL_SENT_SHUTDOWN);
+        m_kernel_tls_close_notify_callback = on_send;
+        m_kernel_tls_close_notify_requested = true;
+        if (m_kernel_tls_pending_sends == 0) {
+            send_kernel_tls_close_notify();
+        }
+        return Error(0);
+    }
+
     auto return_code = SSL_shutdown(m_ssl.get());
     if (return_code < 0) {
         const auto openssl_error_code = ERR_get_error();
@@ -504,14 +1119,260 @@ Error OpenSslClientImplBase<ParentType, ImplType>::ssl_shutdown(const typename P
         return Error(StatusCode::OPENSSL_ERROR, str ? str : "");
     }
 
-    const auto write_pending = BIO_pending(m_ssl_write_bio);
-    if (write_pending) {
+    if (pending_encrypted_size()) {
         internal_read_from_sll_and_send(on_send);
     }
 
     return Error(0);
 }
 
+template<typename ParentType, typename ImplType>
+Error OpenSslClientImplBase<ParentType, ImplType>::transport_close_error(const Error& error) const {
+    if (error == StatusCode::CONNECTION_RESET_BY_PEER && m_ssl && (SSL_get_shutdown(m_ssl.get()) & SSL_RECEIVED_SHUTDOWN)) {
+        return Error(0);
+    }
+
+    return error;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_kernel_tls(bool enabled) {
+    m_kernel_tls_requested = enabled;
+}
+
+template<typename ParentType, typename ImplType>
+bool OpenSslClientImplBase<ParentType, ImplType>::is_kernel_tls_active() const {
+    return m_kernel_tls_tx;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::set_release_idle_buffers(bool enabled) {
+    m_release_idle_buffers = enabled;
+}
+
+template<typename ParentType, typename ImplType>
+int OpenSslClientImplBase<ParentType, ImplType>::kernel_tls_socket_fd() {
+    return -1;
+}
+
+template<typename ParentType, typename ImplType>
+std::uint64_t OpenSslClientImplBase<ParentType, ImplType>::kernel_tls_tx_sequence_number() {
+    if (m_buffer_bio) {
+        std::vector<char> pending_data;
+        m_buffer_bio->copy_output(pending_data);
+        return detail::kernel_tls_tx_sequence_number(m_ssl.get(), pending_data.data(), pending_data.size());
+    }
+
+    char* pending_data = nullptr;
+    const long pending_size = BIO_get_mem_data(m_ssl_write_bio, &pending_data);
+    return detail::kernel_tls_tx_sequence_number(m_ssl.get(), pending_data, pending_size > 0 ? std::size_t(pending_size) : 0);
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::enable_kernel_tls(std::uint64_t sequence_number) {
+    if (!m_kernel_tls_requested) {
+        return;
+    }
+
+    // All handshake records are already written to the socket: the last flight is sent before this call
+    // and the previous ones were answered by the peer.
+    const int socket_fd = kernel_tls_socket_fd();
+    if (socket_fd < 0) {
+        detail::kernel_tls_discard_secrets(m_ssl.get());
+        return;
+    }
+
+    const auto error = detail::kernel_tls_enable_tx(m_ssl.get(), socket_fd, sequence_number);
+    if (error) {
+        LOG_DEBUG(m_loop, m_parent, "Kernel TLS is not enabled:", error.string());
+        return;
+    }
+
+    LOG_DEBUG(m_loop, m_parent, "Kernel TLS is enabled");
+    m_kernel_tls_tx = true;
+}
+
+template<typename ParentType, typename ImplType>
+typename ParentType::UnderlyingClientType::EndSendCallback
+OpenSslClientImplBase<ParentType, ImplType>::kernel_tls_send_callback(const typename ParentType::EndSendCallback& callback) {
+    ++m_kernel_tls_pending_sends;
+
+    return [this, callback](typename ParentType::UnderlyingClientType&, const Error& error) {
+        --m_kernel_tls_pending_sends;
+
+        if (callback) {
+            callback(*m_parent, error);
+        }
+
+        if (m_kernel_tls_pending_sends == 0 && m_kernel_tls_close_notify_requested) {
+            send_kernel_tls_close_notify();
+        }
+    };
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_kernel_tls_close_notify() {
+    m_kernel_tls_close_notify_requested = false;
+
+    const auto error = detail::kernel_tls_send_close_notify(kernel_tls_socket_fd());
+    if (error) {
+        LOG_WARNING(m_loop, m_parent, "Failed to send close_notify alert:", error.string());
+    }
+
+    const auto callback = std::move(m_kernel_tls_close_notify_callback);
+    m_kernel_tls_close_notify_callback = nullptr;
+    if (callback) {
+        callback(*m_client, error);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+template<typename T>
+void OpenSslClientImplBase<ParentType, ImplType>::send_plaintext(T buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback) {
+    m_client->send_data(std::move(buffer), size, kernel_tls_send_callback(callback));
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_plaintext(std::string buffer, std::uint32_t /*size*/, const typename ParentType::EndSendCallback& callback) {
+    m_client->send_data(std::move(buffer), kernel_tls_send_callback(callback));
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::send_file(fs::File& file,
+                                                            std::uint64_t offset,
+                                                            std::uint64_t length,
+                                                            const typename ParentType::EndSendCallback& callback,
+                                                            const std::function<void(ParentType&, std::uint64_t)>& progress_callback) {
+    if (!is_open()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::NOT_CONNECTED));
+        }
+        return;
+    }
+
+    if (length == 0 || !file.is_open()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::INVALID_ARGUMENT));
+        }
+        return;
+    }
+
+    using UnderlyingClientType = typename ParentType::UnderlyingClientType;
+
+    if (m_kernel_tls_tx) {
+        typename UnderlyingClientType::SendFileProgressCallback underlying_progress_callback = nullptr;
+        if (progress_callback) {
+            underlying_progress_callback = [this, progress_callback](UnderlyingClientType&, std::uint64_t bytes_sent) {
+                progress_callback(*m_parent, bytes_sent);
+            };
+        }
+
+        m_client->send_file(file, offset, length, kernel_tls_send_callback(callback), underlying_progress_callback);
+        return;
+    }
+
+    if (m_file_send) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::OPERATION_ALREADY_IN_PROGRESS));
+        }
+        return;
+    }
+
+    m_file_send = std::make_shared<FileSend>();
+    m_file_send->owner = this;
+    m_file_send->file = &file;
+    m_file_send->offset = offset;
+    m_file_send->remaining = length;
+    m_file_send->end_send_callback = callback;
+    m_file_send->progress_callback = progress_callback;
+
+    read_file_chunk(m_file_send);
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::read_file_chunk(const std::shared_ptr<FileSend>& file_send) {
+    const auto size = std::min<std::uint64_t>(file_send->remaining, std::uint64_t(FILE_SEND_CHUNK_SIZE));
+    file_send->file->read_block(static_cast<off_t>(file_send->offset),
+                                static_cast<unsigned int>(size),
+        [file_send](fs::File&, const DataChunk& data, const Error& error) {
+            if (file_send->owner) {
+                file_send->owner->on_file_chunk_read(data, error);
+            }
+        }
+    );
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::on_file_chunk_read(const DataChunk& data, const Error& error) {
+    if (error) {
+        finish_file_send(error);
+        return;
+    }
+
+    if (!is_open()) {
+        finish_file_send(Error(StatusCode::NOT_CONNECTED));
+        return;
+    }
+
+    // File is shorter than requested, reading past the end does not call the callback at all
+    const auto size = static_cast<std::uint32_t>(data.size);
+    m_file_send->end_of_file = size < std::min<std::uint64_t>(m_file_send->remaining, std::uint64_t(FILE_SEND_CHUNK_SIZE));
+
+    const auto on_error = [this](ParentType&, const Error& error) {
+        finish_file_send(error);
+    };
+    if (!ssl_write(data.buf.get(), size, on_error)) {
+        return;
+    }
+
+    send_encrypted(size, [this, size](ParentType&, const Error& error) {
+        on_file_chunk_sent(size, error);
+    });
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::on_file_chunk_sent(std::size_t size, const Error& error) {
+    if (m_file_send == nullptr) {
+        return;
+    }
+
+    if (error) {
+        finish_file_send(error);
+        return;
+    }
+
+    m_file_send->offset += size;
+    m_file_send->remaining -= size;
+    m_file_send->sent += size;
+
+    if (m_file_send->progress_callback) {
+        // Callback is copied because connection may be closed from it
+        const auto progress_callback = m_file_send->progress_callback;
+        progress_callback(*m_parent, m_file_send->sent);
+    }
+
+    if (m_file_send == nullptr) {
+        return;
+    }
+
+    if (m_file_send->end_of_file) {
+        finish_file_send(Error(StatusCode::END_OF_FILE));
+    } else if (m_file_send->remaining) {
+        read_file_chunk(m_file_send);
+    } else {
+        finish_file_send(StatusCode::OK);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslClientImplBase<ParentType, ImplType>::finish_file_send(const Error& error) {
+    const auto file_send = std::move(m_file_send);
+    m_file_send.reset();
+    if (file_send->end_send_callback) {
+        file_send->end_send_callback(*m_parent, error);
+    }
+}
+
 template<typename ParentType, typename ImplType>
 void OpenSslClientImplBase<ParentType, ImplType>::ssl_state_callback(const SSL* ssl, int where, int ret) {
     auto& this_ = *reinterpret_cast<OpenSslClientImplBase*>(SSL_get_ex_data(ssl, 0));
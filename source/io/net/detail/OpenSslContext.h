@@ -12,8 +12,18 @@
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    #include <openssl/core_names.h>
+#else
+    #include <openssl/hmac.h>
+#endif
 
+#include <chrono>
+#include <cstring>
 #include <memory>
+#include <mutex>
 
 namespace tarm {
 namespace io {
@@ -36,6 +46,10 @@ public:
     Error set_dtls_version(DtlsVersion version_min, DtlsVersion version_max);
     Error ssl_init_certificate_and_key(::X509* certificate, ::EVP_PKEY* key);
 
+    // Server side session resumption, see TlsServer::set_session_cache and TlsServer::set_session_tickets
+    Error set_session_cache(std::size_t cache_size, std::uint64_t timeout_ms);
+    Error set_session_tickets(bool enabled, std::uint64_t key_rotation_interval_ms);
+
     ::SSL_CTX* ssl_ctx();
 
 protected:
@@ -51,6 +65,53 @@ protected:
     void enable_dtls_version(DtlsVersion version);
     void disable_dtls_version(DtlsVersion version);
 
+    // Keys are generated on demand. Tickets are encrypted by the current key, tickets of the previous key
+    // are accepted and renewed.
+    struct SessionTicketKey {
+        unsigned char name[16];
+        unsigned char aes_key[32];
+        unsigned char hmac_key[32];
+        std::chrono::steady_clock::time_point created;
+        bool valid = false;
+    };
+
+    // Keys are owned by SSL context, so they stay valid while handshake is performed in the thread pool
+    // (see TlsServer::set_handshake_offload), even if the server is removed meanwhile.
+    struct SessionTicketKeys {
+        std::mutex mutex;
+        SessionTicketKey keys[2]; // Current and previous
+        std::chrono::milliseconds rotation_interval{0};
+    };
+
+    static int session_ticket_keys_index();
+    static void free_session_ticket_keys(void* parent, void* ptr, ::CRYPTO_EX_DATA* ad, int index, long argl, void* argp);
+
+    static void rotate_session_ticket_keys(SessionTicketKeys& keys);
+    static const SessionTicketKey* find_session_ticket_key(const SessionTicketKeys& keys, const unsigned char* name);
+    // Copies key for the ticket and initializes cipher, returns result for OpenSSL
+    static int init_session_ticket_cipher(::SSL* ssl,
+                                          unsigned char* key_name,
+                                          unsigned char* iv,
+                                          ::EVP_CIPHER_CTX* cipher_ctx,
+                                          int encrypt,
+                                          SessionTicketKey& key);
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static int on_session_ticket_key(::SSL* ssl,
+                                     unsigned char* key_name,
+                                     unsigned char* iv,
+                                     ::EVP_CIPHER_CTX* cipher_ctx,
+                                     ::EVP_MAC_CTX* mac_ctx,
+                                     int encrypt);
+#else
+    static int on_session_ticket_key(::SSL* ssl,
+                                     unsigned char* key_name,
+                                     unsigned char* iv,
+                                     ::EVP_CIPHER_CTX* cipher_ctx,
+                                     ::HMAC_CTX* hmac_ctx,
+                                     int encrypt);
+#endif
+
     ParentType* m_parent;
     EventLoop* m_loop;
 
@@ -260,6 +321,220 @@ Error OpenSslContext<ParentType, ImplType>::ssl_init_certificate_and_key(::X509*
     return StatusCode::OK;
 }
 
+template<typename ParentType, typename ImplType>
+Error OpenSslContext<ParentType, ImplType>::set_session_cache(std::size_t cache_size, std::uint64_t timeout_ms) {
+    if (m_ssl_ctx == nullptr) {
+        return Error(StatusCode::OPENSSL_ERROR, "SSL context is not initialized");
+    }
+
+    if (cache_size && timeout_ms == 0) {
+        return Error(StatusCode::INVALID_ARGUMENT, "Session timeout should be greater than 0");
+    }
+
+    // Sessions are bound to the context, this is required to resume sessions of verified peers
+    static const unsigned char SESSION_ID_CONTEXT[] = "tarm-io";
+    SSL_CTX_set_session_id_context(m_ssl_ctx.get(), SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+
+    SSL_CTX_set_session_cache_mode(m_ssl_ctx.get(), cache_size ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_OFF);
+    SSL_CTX_sess_set_cache_size(m_ssl_ctx.get(), static_cast<long>(cache_size));
+    // OpenSSL has 1 second granularity, timeout also limits lifetime of session tickets
+    if (timeout_ms) {
+        SSL_CTX_set_timeout(m_ssl_ctx.get(), static_cast<long>((timeout_ms + 999) / 1000));
+    }
+
+    return StatusCode::OK;
+}
+
+template<typename ParentType, typename ImplType>
+Error OpenSslContext<ParentType, ImplType>::set_session_tickets(bool enabled, std::uint64_t key_rotation_interval_ms) {
+    if (m_ssl_ctx == nullptr) {
+        return Error(StatusCode::OPENSSL_ERROR, "SSL context is not initialized");
+    }
+
+    if (!enabled) {
+        SSL_CTX_set_options(m_ssl_ctx.get(), SSL_OP_NO_TICKET);
+        return StatusCode::OK;
+    }
+
+    if (key_rotation_interval_ms == 0) {
+        return Error(StatusCode::INVALID_ARGUMENT, "Ticket key rotation interval should be greater than 0");
+    }
+
+    SSL_CTX_clear_options(m_ssl_ctx.get(), SSL_OP_NO_TICKET);
+
+    auto keys = reinterpret_cast<SessionTicketKeys*>(SSL_CTX_get_ex_data(m_ssl_ctx.get(), session_ticket_keys_index()));
+    if (keys == nullptr) {
+        keys = new SessionTicketKeys;
+        if (SSL_CTX_set_ex_data(m_ssl_ctx.get(), session_ticket_keys_index(), keys) != 1) {
+            delete keys;
+            return Error(StatusCode::OPENSSL_ERROR, "Failed to set session ticket keys");
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(keys->mutex);
+        keys->rotation_interval = std::chrono::milliseconds(key_rotation_interval_ms);
+        keys->keys[0].valid = false;
+        keys->keys[1].valid = false;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(m_ssl_ctx.get(), &OpenSslContext<ParentType, ImplType>::on_session_ticket_key);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(m_ssl_ctx.get(), &OpenSslContext<ParentType, ImplType>::on_session_ticket_key);
+#endif
+
+    return StatusCode::OK;
+}
+
+template<typename ParentType, typename ImplType>
+int OpenSslContext<ParentType, ImplType>::session_ticket_keys_index() {
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, &free_session_ticket_keys);
+    return index;
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslContext<ParentType, ImplType>::free_session_ticket_keys(void* /*parent*/,
+                                                                    void* ptr,
+                                                                    ::CRYPTO_EX_DATA* /*ad*/,
+                                                                    int /*index*/,
+                                                                    long /*argl*/,
+                                                                    void* /*argp*/) {
+    delete reinterpret_cast<SessionTicketKeys*>(ptr);
+}
+
+template<typename ParentType, typename ImplType>
+void OpenSslContext<ParentType, ImplType>::rotate_session_ticket_keys(SessionTicketKeys& keys) {
+    auto& current = keys.keys[0];
+    auto& previous = keys.keys[1];
+
+    const auto now = std::chrono::steady_clock::now();
+    if (current.valid && now - current.created < keys.rotation_interval) {
+        return;
+    }
+
+    // Previous key is kept only during one interval after rotation
+    previous = current;
+    if (previous.valid && now - previous.created >= 2 * keys.rotation_interval) {
+        previous.valid = false;
+    }
+
+    // On failure tickets are not issued and full handshake is performed
+    current.valid = RAND_bytes(current.name, sizeof(current.name)) == 1 &&
+                    RAND_bytes(current.aes_key, sizeof(current.aes_key)) == 1 &&
+                    RAND_bytes(current.hmac_key, sizeof(current.hmac_key)) == 1;
+    current.created = now;
+}
+
+template<typename ParentType, typename ImplType>
+auto OpenSslContext<ParentType, ImplType>::find_session_ticket_key(const SessionTicketKeys& keys,
+                                                                   const unsigned char* name) -> const SessionTicketKey* {
+    for (const auto& key : keys.keys) {
+        if (key.valid && std::memcmp(key.name, name, sizeof(key.name)) == 0) {
+            return &key;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename ParentType, typename ImplType>
+int OpenSslContext<ParentType, ImplType>::init_session_ticket_cipher(::SSL* ssl,
+                                                                   unsigned char* key_name,
+                                                                   unsigned char* iv,
+                                                                   ::EVP_CIPHER_CTX* cipher_ctx,
+                                                                   int encrypt,
+                                                                   SessionTicketKey& key) {
+    auto keys = reinterpret_cast<SessionTicketKeys*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), session_ticket_keys_index()));
+    if (keys == nullptr) {
+        return -1;
+    }
+
+    bool is_current_key = true;
+    {
+        // Handshakes of the same server may be performed concurrently
+        std::lock_guard<std::mutex> lock(keys->mutex);
+        rotate_session_ticket_keys(*keys);
+
+        const SessionTicketKey* found_key = encrypt ? &keys->keys[0] : find_session_ticket_key(*keys, key_name);
+        if (found_key == nullptr || !found_key->valid) {
+            // Unknown or expired key, full handshake is made. Or ticket is not issued if key is not available.
+            return encrypt ? -1 : 0;
+        }
+
+        key = *found_key;
+        is_current_key = found_key == &keys->keys[0];
+    }
+
+    if (encrypt) {
+        if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1) {
+            return -1;
+        }
+
+        std::memcpy(key_name, key.name, sizeof(key.name));
+        return EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key.aes_key, iv) == 1 ? 1 : -1;
+    }
+
+    if (EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr, key.aes_key, iv) != 1) {
+        return -1;
+    }
+
+    // Ticket of the previous key is renewed. TLS 1.3 tickets are single use, so resumed connection always
+    // receives a new one.
+#ifdef TLS1_3_VERSION
+    if (SSL_version(ssl) == TLS1_3_VERSION) {
+        return 2;
+    }
+#endif
+
+    return is_current_key ? 1 : 2;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+template<typename ParentType, typename ImplType>
+int OpenSslContext<ParentType, ImplType>::on_session_ticket_key(::SSL* ssl,
+                                                               unsigned char* key_name,
+                                                               unsigned char* iv,
+                                                               ::EVP_CIPHER_CTX* cipher_ctx,
+                                                               ::EVP_MAC_CTX* mac_ctx,
+                                                               int encrypt) {
+    SessionTicketKey key;
+    const int result = init_session_ticket_cipher(ssl, key_name, iv, cipher_ctx, encrypt, key);
+    if (result <= 0) {
+        return result;
+    }
+
+    char digest[] = "SHA256";
+    const OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmac_key, sizeof(key.hmac_key)),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+        OSSL_PARAM_construct_end()
+    };
+
+    return EVP_MAC_CTX_set_params(mac_ctx, params) == 1 ? result : -1;
+}
+
+#else
+
+template<typename ParentType, typename ImplType>
+int OpenSslContext<ParentType, ImplType>::on_session_ticket_key(::SSL* ssl,
+                                                               unsigned char* key_name,
+                                                               unsigned char* iv,
+                                                               ::EVP_CIPHER_CTX* cipher_ctx,
+                                                               ::HMAC_CTX* hmac_ctx,
+                                                               int encrypt) {
+    SessionTicketKey key;
+    const int result = init_session_ticket_cipher(ssl, key_name, iv, cipher_ctx, encrypt, key);
+    if (result <= 0) {
+        return result;
+    }
+
+    return HMAC_Init_ex(hmac_ctx, key.hmac_key, sizeof(key.hmac_key), EVP_sha256(), nullptr) == 1 ? result : -1;
+}
+
+#endif
+
 } // namespace detail
 } // namespace net
 } // namespace io
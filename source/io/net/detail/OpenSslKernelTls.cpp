@@ -0,0 +1,500 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "OpenSslKernelTls.h"
+
+#ifdef TARM_IO_HAS_KERNEL_TLS
+    #include <openssl/evp.h>
+    #include <openssl/kdf.h>
+
+    #include <uv.h>
+
+    #include <linux/tls.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+
+    #include <cerrno>
+    #include <cstring>
+    #include <memory>
+    #include <string>
+    #include <vector>
+
+    #ifndef TCP_ULP
+        #define TCP_ULP 31
+    #endif
+
+    #ifndef SOL_TLS
+        #define SOL_TLS 282
+    #endif
+#endif
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+#ifdef TARM_IO_HAS_KERNEL_TLS
+
+namespace {
+
+const std::size_t TLS_RECORD_HEADER_SIZE = 5;
+const std::size_t TLS_NONCE_SIZE = 12;
+const std::size_t MAX_KEY_SIZE = 32;
+
+struct KernelTlsSecrets {
+    std::vector<unsigned char> client_traffic_secret;
+    std::vector<unsigned char> server_traffic_secret;
+
+    void cleanse() {
+        OPENSSL_cleanse(client_traffic_secret.data(), client_traffic_secret.size());
+        OPENSSL_cleanse(server_traffic_secret.data(), server_traffic_secret.size());
+        client_traffic_secret.clear();
+        server_traffic_secret.clear();
+    }
+};
+
+void free_kernel_tls_secrets(void* /*parent*/, void* ptr, CRYPTO_EX_DATA* /*ad*/, int /*idx*/, long /*argl*/, void* /*argp*/) {
+    auto secrets = reinterpret_cast<KernelTlsSecrets*>(ptr);
+    if (secrets) {
+        secrets->cleanse();
+    }
+    delete secrets;
+}
+
+int kernel_tls_secrets_index() {
+    static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, &free_kernel_tls_secrets);
+    return index;
+}
+
+bool hex_decode(const char* begin, const char* end, std::vector<unsigned char>& result) {
+    if ((end - begin) % 2) {
+        return false;
+    }
+
+    auto decode_digit = [](char c) -> int {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    };
+
+    result.clear();
+    for (auto p = begin; p != end; p += 2) {
+        const int high = decode_digit(*p);
+        const int low = decode_digit(*(p + 1));
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        result.push_back(static_cast<unsigned char>(high << 4 | low));
+    }
+
+    return true;
+}
+
+// Line has format "<LABEL> <client random> <secret>" in hex, see SSL_CTX_set_keylog_callback.
+// May be called from the thread pool if handshake is offloaded.
+void on_keylog_line(const ::SSL* ssl, const char* line) {
+    auto secrets = reinterpret_cast<KernelTlsSecrets*>(SSL_get_ex_data(ssl, kernel_tls_secrets_index()));
+    if (secrets == nullptr) {
+        return;
+    }
+
+    std::vector<unsigned char>* secret = nullptr;
+    const char* const client_label = "CLIENT_TRAFFIC_SECRET_0 ";
+    const char* const server_label = "SERVER_TRAFFIC_SECRET_0 ";
+    const char* rest = nullptr;
+    if (std::strncmp(line, client_label, std::strlen(client_label)) == 0) {
+        secret = &secrets->client_traffic_secret;
+        rest = line + std::strlen(client_label);
+    } else if (std::strncmp(line, server_label, std::strlen(server_label)) == 0) {
+        secret = &secrets->server_traffic_secret;
+        rest = line + std::strlen(server_label);
+    } else {
+        return;
+    }
+
+    const char* secret_begin = std::strchr(rest, ' ');
+    if (secret_begin == nullptr) {
+        return;
+    }
+    ++secret_begin;
+
+    if (!hex_decode(secret_begin, secret_begin + std::strlen(secret_begin), *secret)) {
+        OPENSSL_cleanse(secret->data(), secret->size());
+        secret->clear();
+    }
+}
+
+using EvpPkeyCtxPtr = std::unique_ptr<::EVP_PKEY_CTX, decltype(&::EVP_PKEY_CTX_free)>;
+
+// HKDF-Expand-Label from RFC 8446 with empty context
+bool tls13_expand_label(const ::EVP_MD* md,
+                        const std::vector<unsigned char>& secret,
+                        const std::string& label,
+                        unsigned char* out,
+                        std::size_t out_size) {
+    const std::string full_label = "tls13 " + label;
+
+    std::vector<unsigned char> info;
+    info.push_back(static_cast<unsigned char>(out_size >> 8));
+    info.push_back(static_cast<unsigned char>(out_size & 0xFF));
+    info.push_back(static_cast<unsigned char>(full_label.size()));
+    info.insert(info.end(), full_label.begin(), full_label.end());
+    info.push_back(0);
+
+    EvpPkeyCtxPtr ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr), &::EVP_PKEY_CTX_free);
+    if (ctx == nullptr) {
+        return false;
+    }
+
+    std::size_t result_size = out_size;
+    return EVP_PKEY_derive_init(ctx.get()) == 1 &&
+           EVP_PKEY_CTX_hkdf_mode(ctx.get(), EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) == 1 &&
+           EVP_PKEY_CTX_set_hkdf_md(ctx.get(), md) == 1 &&
+           EVP_PKEY_CTX_set1_hkdf_key(ctx.get(), secret.data(), static_cast<int>(secret.size())) == 1 &&
+           EVP_PKEY_CTX_add1_hkdf_info(ctx.get(), info.data(), static_cast<int>(info.size())) == 1 &&
+           EVP_PKEY_derive(ctx.get(), out, &result_size) == 1 &&
+           result_size == out_size;
+}
+
+// Key block of TLS 1.2 from RFC 5246, section 6.3
+bool tls12_key_block(::SSL* ssl, const ::EVP_MD* md, unsigned char* out, std::size_t out_size) {
+    unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH];
+    const auto master_key_size = SSL_SESSION_get_master_key(SSL_get_session(ssl), master_key, sizeof(master_key));
+
+    unsigned char client_random[SSL3_RANDOM_SIZE];
+    unsigned char server_random[SSL3_RANDOM_SIZE];
+    SSL_get_client_random(ssl, client_random, sizeof(client_random));
+    SSL_get_server_random(ssl, server_random, sizeof(server_random));
+
+    EvpPkeyCtxPtr ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, nullptr), &::EVP_PKEY_CTX_free);
+    if (ctx == nullptr) {
+        return false;
+    }
+
+    const unsigned char label[] = "key expansion";
+    std::size_t result_size = out_size;
+    const bool result =
+        EVP_PKEY_derive_init(ctx.get()) == 1 &&
+        EVP_PKEY_CTX_set_tls1_prf_md(ctx.get(), md) == 1 &&
+        EVP_PKEY_CTX_set1_tls1_prf_secret(ctx.get(), master_key, static_cast<int>(master_key_size)) == 1 &&
+        EVP_PKEY_CTX_add1_tls1_prf_seed(ctx.get(), label, static_cast<int>(sizeof(label) - 1)) == 1 &&
+        EVP_PKEY_CTX_add1_tls1_prf_seed(ctx.get(), server_random, static_cast<int>(sizeof(server_random))) == 1 &&
+        EVP_PKEY_CTX_add1_tls1_prf_seed(ctx.get(), client_random, static_cast<int>(sizeof(client_random))) == 1 &&
+        EVP_PKEY_derive(ctx.get(), out, &result_size) == 1 &&
+        result_size == out_size;
+
+    OPENSSL_cleanse(master_key, sizeof(master_key));
+    return result;
+}
+
+// Nonce of AES-GCM consists of 4 bytes of salt and 8 bytes of IV. TLS 1.2 transmits IV explicitly in each
+// record, it is initialized by the sequence number like OpenSSL does. ChaCha20-Poly1305 has no salt.
+template<typename CryptoInfo>
+void fill_crypto_info(CryptoInfo& info,
+                      unsigned short version,
+                      unsigned short cipher_type,
+                      const unsigned char* key,
+                      const unsigned char* nonce,
+                      const unsigned char* sequence_number) {
+    const std::size_t salt_size = sizeof(info.salt);
+    const bool explicit_iv = version == TLS_1_2_VERSION && salt_size != 0;
+
+    info.info.version = version;
+    info.info.cipher_type = cipher_type;
+    std::memcpy(info.key, key, sizeof(info.key));
+    std::memcpy(info.salt, nonce, salt_size);
+    std::memcpy(info.iv, explicit_iv ? sequence_number : nonce + salt_size, sizeof(info.iv));
+    std::memcpy(info.rec_seq, sequence_number, sizeof(info.rec_seq));
+}
+
+} // namespace
+
+bool kernel_tls_is_supported() {
+    return true;
+}
+
+void kernel_tls_init_context(::SSL_CTX* ssl_ctx) {
+    SSL_CTX_set_keylog_callback(ssl_ctx, &on_keylog_line);
+}
+
+Error kernel_tls_init_ssl(::SSL* ssl) {
+    auto secrets = new KernelTlsSecrets;
+    if (SSL_set_ex_data(ssl, kernel_tls_secrets_index(), secrets) != 1) {
+        delete secrets;
+        return Error(StatusCode::OPENSSL_ERROR, "Failed to attach kernel TLS data");
+    }
+
+#ifdef SSL_OP_NO_RENEGOTIATION
+    // Keys installed into the kernel can not be changed by renegotiation
+    SSL_set_options(ssl, SSL_OP_NO_RENEGOTIATION);
+#endif
+
+    return StatusCode::OK;
+}
+
+std::uint64_t kernel_tls_tx_sequence_number(::SSL* ssl, const char* pending_data, std::size_t pending_size) {
+    // Finished message of TLS 1.2 is the first record protected by the traffic keys
+    if (SSL_version(ssl) != TLS1_3_VERSION) {
+        return 1;
+    }
+
+    // Finished message of TLS 1.3 is protected by the handshake keys, but server sends session tickets with
+    // the traffic keys right after the handshake. All protected records have application data type.
+    if (!SSL_is_server(ssl)) {
+        return 0;
+    }
+
+    std::uint64_t records_count = 0;
+    std::size_t offset = 0;
+    while (offset + TLS_RECORD_HEADER_SIZE <= pending_size) {
+        const auto header = reinterpret_cast<const unsigned char*>(pending_data + offset);
+        if (header[0] == SSL3_RT_APPLICATION_DATA) {
+            ++records_count;
+        }
+        offset += TLS_RECORD_HEADER_SIZE + (std::size_t(header[3]) << 8 | header[4]);
+    }
+
+    return records_count;
+}
+
+Error kernel_tls_crypto_info(::SSL* ssl, std::uint64_t sequence_number, std::vector<unsigned char>& crypto_info_data) {
+    const int version = SSL_version(ssl);
+    if (version != TLS1_2_VERSION && version != TLS1_3_VERSION) {
+        return Error(StatusCode::OPERATION_NOT_SUPPORTED_ON_SOCKET, "Kernel TLS supports only TLS 1.2 and 1.3");
+    }
+
+    const ::SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+    if (cipher == nullptr) {
+        return Error(StatusCode::OPENSSL_ERROR, "No cipher is negotiated");
+    }
+
+    unsigned short cipher_type = 0;
+    std::size_t key_size = 0;
+    std::size_t tls12_fixed_iv_size = 4;
+    switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+        case NID_aes_128_gcm:
+            cipher_type = TLS_CIPHER_AES_GCM_128;
+            key_size = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+            break;
+#ifdef TLS_CIPHER_AES_GCM_256
+        case NID_aes_256_gcm:
+            cipher_type = TLS_CIPHER_AES_GCM_256;
+            key_size = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+            break;
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        case NID_chacha20_poly1305:
+            cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+            key_size = TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE;
+            tls12_fixed_iv_size = TLS_NONCE_SIZE;
+            break;
+#endif
+        default:
+            return Error(StatusCode::OPERATION_NOT_SUPPORTED_ON_SOCKET, "Cipher is not supported by kernel TLS");
+    }
+
+    const ::EVP_MD* md = SSL_CIPHER_get_handshake_digest(cipher);
+    if (md == nullptr) {
+        return Error(StatusCode::OPENSSL_ERROR, "No digest for the cipher");
+    }
+
+    const bool is_server = SSL_is_server(ssl) == 1;
+
+    unsigned char key[MAX_KEY_SIZE];
+    unsigned char nonce[TLS_NONCE_SIZE] = {0};
+
+    if (version == TLS1_3_VERSION) {
+#ifdef TLS_1_3_VERSION
+        auto secrets = reinterpret_cast<KernelTlsSecrets*>(SSL_get_ex_data(ssl, kernel_tls_secrets_index()));
+        if (secrets == nullptr) {
+            return Error(StatusCode::OPENSSL_ERROR, "Kernel TLS was not requested before the handshake");
+        }
+
+        const auto& secret = is_server ? secrets->server_traffic_secret : secrets->client_traffic_secret;
+        if (secret.empty() ||
+            !tls13_expand_label(md, secret, "key", key, key_size) ||
+            !tls13_expand_label(md, secret, "iv", nonce, TLS_NONCE_SIZE)) {
+            OPENSSL_cleanse(key, sizeof(key));
+            OPENSSL_cleanse(nonce, sizeof(nonce));
+            return Error(StatusCode::OPENSSL_ERROR, "Failed to derive TLS 1.3 traffic keys");
+        }
+#else
+        return Error(StatusCode::OPERATION_NOT_SUPPORTED_ON_SOCKET, "Kernel TLS 1.3 is not supported by system headers");
+#endif
+    } else {
+        // client_write_key, server_write_key, client_write_IV, server_write_IV. AEAD ciphers have no MAC keys.
+        unsigned char key_block[2 * MAX_KEY_SIZE + 2 * TLS_NONCE_SIZE];
+        const std::size_t key_block_size = 2 * key_size + 2 * tls12_fixed_iv_size;
+        if (!tls12_key_block(ssl, md, key_block, key_block_size)) {
+            OPENSSL_cleanse(key_block, sizeof(key_block));
+            return Error(StatusCode::OPENSSL_ERROR, "Failed to derive TLS 1.2 key block");
+        }
+
+        std::memcpy(key, key_block + (is_server ? key_size : 0), key_size);
+        std::memcpy(nonce, key_block + 2 * key_size + (is_server ? tls12_fixed_iv_size : 0), tls12_fixed_iv_size);
+        OPENSSL_cleanse(key_block, sizeof(key_block));
+    }
+
+    unsigned char sequence_number_bytes[8];
+    for (std::size_t i = 0; i < sizeof(sequence_number_bytes); ++i) {
+        sequence_number_bytes[i] = static_cast<unsigned char>(sequence_number >> (8 * (7 - i)));
+    }
+
+#ifdef TLS_1_3_VERSION
+    const unsigned short kernel_version = version == TLS1_3_VERSION ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+#else
+    const unsigned short kernel_version = TLS_1_2_VERSION;
+#endif
+
+    union {
+        ::tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+#ifdef TLS_CIPHER_AES_GCM_256
+        ::tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        ::tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#endif
+    } crypto_info;
+    std::memset(&crypto_info, 0, sizeof(crypto_info));
+
+    std::size_t crypto_info_size = 0;
+    switch (cipher_type) {
+        case TLS_CIPHER_AES_GCM_128:
+            fill_crypto_info(crypto_info.aes_gcm_128, kernel_version, cipher_type, key, nonce, sequence_number_bytes);
+            crypto_info_size = sizeof(crypto_info.aes_gcm_128);
+            break;
+#ifdef TLS_CIPHER_AES_GCM_256
+        case TLS_CIPHER_AES_GCM_256:
+            fill_crypto_info(crypto_info.aes_gcm_256, kernel_version, cipher_type, key, nonce, sequence_number_bytes);
+            crypto_info_size = sizeof(crypto_info.aes_gcm_256);
+            break;
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        case TLS_CIPHER_CHACHA20_POLY1305:
+            fill_crypto_info(crypto_info.chacha20_poly1305, kernel_version, cipher_type, key, nonce, sequence_number_bytes);
+            crypto_info_size = sizeof(crypto_info.chacha20_poly1305);
+            break;
+#endif
+    }
+
+    OPENSSL_cleanse(key, sizeof(key));
+    OPENSSL_cleanse(nonce, sizeof(nonce));
+
+    if (!crypto_info_data.empty()) {
+        OPENSSL_cleanse(crypto_info_data.data(), crypto_info_data.size());
+    }
+    const auto crypto_info_bytes = reinterpret_cast<const unsigned char*>(&crypto_info);
+    crypto_info_data.assign(crypto_info_bytes, crypto_info_bytes + crypto_info_size);
+
+    OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+    return StatusCode::OK;
+}
+
+void kernel_tls_discard_secrets(::SSL* ssl) {
+    auto secrets = reinterpret_cast<KernelTlsSecrets*>(SSL_get_ex_data(ssl, kernel_tls_secrets_index()));
+    if (secrets) {
+        secrets->cleanse();
+    }
+}
+
+Error kernel_tls_enable_tx(::SSL* ssl, int socket_fd, std::uint64_t sequence_number) {
+    std::vector<unsigned char> crypto_info;
+    Error error = kernel_tls_crypto_info(ssl, sequence_number, crypto_info);
+    // Secrets are not needed anymore, keys can not be installed later
+    kernel_tls_discard_secrets(ssl);
+    if (error) {
+        return error;
+    }
+
+    // Fails with ENOENT if 'tls' kernel module is not loaded
+    if (::setsockopt(socket_fd, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+        error = Error(uv_translate_sys_error(errno));
+    } else if (::setsockopt(socket_fd, SOL_TLS, TLS_TX, crypto_info.data(), static_cast<socklen_t>(crypto_info.size())) != 0) {
+        // Socket with TLS ULP but without configured keys passes data as is
+        error = Error(uv_translate_sys_error(errno));
+    }
+
+    OPENSSL_cleanse(crypto_info.data(), crypto_info.size());
+    return error;
+}
+
+Error kernel_tls_send_close_notify(int socket_fd) {
+    unsigned char alert[2] = {SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY};
+    ::iovec iov;
+    iov.iov_base = alert;
+    iov.iov_len = sizeof(alert);
+
+    char control[CMSG_SPACE(sizeof(unsigned char))];
+    std::memset(control, 0, sizeof(control));
+
+    ::msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    auto cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+    *CMSG_DATA(cmsg) = SSL3_RT_ALERT;
+
+    ssize_t result = 0;
+    do {
+        result = ::sendmsg(socket_fd, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1) {
+        return Error(uv_translate_sys_error(errno));
+    }
+
+    return result == ssize_t(sizeof(alert)) ? Error(StatusCode::OK) : Error(StatusCode::RESOURCE_TEMPORARILY_UNAVAILABLE);
+}
+
+#else
+
+bool kernel_tls_is_supported() {
+    return false;
+}
+
+void kernel_tls_init_context(::SSL_CTX* /*ssl_ctx*/) {
+}
+
+Error kernel_tls_init_ssl(::SSL* /*ssl*/) {
+    return StatusCode::FUNCTION_NOT_IMPLEMENTED;
+}
+
+std::uint64_t kernel_tls_tx_sequence_number(::SSL* /*ssl*/, const char* /*pending_data*/, std::size_t /*pending_size*/) {
+    return 0;
+}
+
+Error kernel_tls_crypto_info(::SSL* /*ssl*/, std::uint64_t /*sequence_number*/, std::vector<unsigned char>& /*crypto_info*/) {
+    return StatusCode::FUNCTION_NOT_IMPLEMENTED;
+}
+
+void kernel_tls_discard_secrets(::SSL* /*ssl*/) {
+}
+
+Error kernel_tls_enable_tx(::SSL* /*ssl*/, int /*socket_fd*/, std::uint64_t /*sequence_number*/) {
+    return StatusCode::FUNCTION_NOT_IMPLEMENTED;
+}
+
+Error kernel_tls_send_close_notify(int /*socket_fd*/) {
+    return StatusCode::FUNCTION_NOT_IMPLEMENTED;
+}
+
+#endif // TARM_IO_HAS_KERNEL_TLS
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,63 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "Error.h"
+#include "Export.h"
+
+#include <openssl/ssl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Secrets of TLS 1.3 are obtained with keylog callback, which was added in OpenSSL 1.1.1
+#if defined(TARM_IO_PLATFORM_LINUX) && OPENSSL_VERSION_NUMBER >= 0x10101000L
+    #define TARM_IO_HAS_KERNEL_TLS
+#endif
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+// Kernel TLS (kTLS) transmit offload. After the handshake traffic keys of the connection are derived from
+// the secrets negotiated by OpenSSL and installed into the socket, so plaintext written to the socket
+// is encrypted by the kernel. Only TLS 1.2 and 1.3 with AES-GCM and ChaCha20-Poly1305 ciphers are supported.
+// Receiving is still performed by OpenSSL, because control records (alerts, session tickets, key updates)
+// can not be read from kTLS socket with plain read calls which libuv makes.
+
+// Returns false if kTLS is not available on the current platform or with the current OpenSSL version.
+bool kernel_tls_is_supported();
+
+// Should be called for the context before any SSL object for kTLS is created from it.
+TARM_IO_DLL_PUBLIC void kernel_tls_init_context(::SSL_CTX* ssl_ctx);
+
+// Should be called for the SSL object before the handshake.
+TARM_IO_DLL_PUBLIC Error kernel_tls_init_ssl(::SSL* ssl);
+
+// Sequence number of the next record sent after the handshake. 'pending_data' is content of the write BIO
+// with the last flight of the handshake which is not sent yet.
+TARM_IO_DLL_PUBLIC std::uint64_t kernel_tls_tx_sequence_number(::SSL* ssl, const char* pending_data, std::size_t pending_size);
+
+// Traffic keys of the sending side of the connection after the handshake, in the format of TLS_TX socket
+// option (one of tls12_crypto_info_* structures). Exposed for testing against OpenSSL.
+TARM_IO_DLL_PUBLIC Error kernel_tls_crypto_info(::SSL* ssl, std::uint64_t sequence_number, std::vector<unsigned char>& crypto_info);
+
+// Cleanses secrets captured during the handshake. They are cleansed when SSL object is freed too.
+void kernel_tls_discard_secrets(::SSL* ssl);
+
+// Socket should not have any data queued for sending. On error socket remains usable for the plain
+// (encrypted by OpenSSL) data. Secrets are discarded in any case.
+Error kernel_tls_enable_tx(::SSL* ssl, int socket_fd, std::uint64_t sequence_number);
+
+// Sends close_notify alert on the socket with enabled kTLS.
+Error kernel_tls_send_close_notify(int socket_fd);
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -6,12 +6,38 @@
 #pragma once
 
 #include "EventLoop.h"
+#include "ReadBuffer.h"
+#include "SendBuffer.h"
+#include "TcpSendQueue.h"
+#include "detail/EventLoopHelpers.h"
 #include "detail/LogMacros.h"
 #include "detail/RawBufferGetter.h"
+#include "detail/UniqueFunction.h"
+#include "fs/File.h"
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <assert.h>
 
+#ifdef TARM_IO_PLATFORM_LINUX
+    #include <linux/errqueue.h>
+    #include <netinet/in.h>
+    #include <sys/sendfile.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <climits>
+
+    #ifndef IOV_MAX
+        #define IOV_MAX 1024
+    #endif
+#endif
+
 namespace tarm {
 namespace io {
 namespace net {
@@ -31,8 +57,20 @@ public:
     void send_data(std::unique_ptr<char[]> buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
     void send_data(const std::string& message, const typename ParentType::EndSendCallback& callback);
     void send_data(std::string&& message, const typename ParentType::EndSendCallback& callback);
+    void send_data(std::vector<SendBuffer> buffers, const typename ParentType::EndSendCallback& callback);
+
+    void send_file(fs::File& file,
+                   std::uint64_t offset,
+                   std::uint64_t length,
+                   const typename ParentType::EndSendCallback& callback,
+                   const typename ParentType::SendFileProgressCallback& progress_callback);
 
     std::size_t pending_write_requests() const;
+    std::size_t pending_send_bytes() const;
+
+    void set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark);
+    void set_high_watermark_callback(const typename ParentType::SendWatermarkCallback& callback);
+    void set_drain_callback(const typename ParentType::SendWatermarkCallback& callback);
 
     Error init_stream();
 
@@ -41,8 +79,25 @@ public:
     void delay_send(bool enabled);
     bool is_delay_send() const;
 
+    void cork_send(bool enabled);
+    bool is_cork_send() const;
+    void flush();
+
+    Error zero_copy_send(bool enabled, std::size_t min_size);
+    bool is_zero_copy_send() const;
+
+    // Reading is resumed by implementations because they own read callbacks
+    void pause_read();
+    bool is_read_paused() const;
+
+    void set_read_buffer_callback(const typename ParentType::ReadBufferCallback& callback);
+
     Error get_socket_error() const;
 
+    // Observer is notified once when connection is closed, used by pipe_connections which transfers data
+    // through the socket directly
+    void set_close_observer(std::function<void()> observer);
+
 protected:
     template<typename T>
     void send_data_impl(T buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
@@ -54,6 +109,25 @@ protected:
 
     void on_read_error(const Error& error);
 
+    // Should be called at the end of read callback, see EventLoop::set_shared_read_buffer
+    void release_shared_read_buffer();
+
+    // Memory of received data for DataChunk, it is not owned by chunk if it was supplied by user
+    std::shared_ptr<char> received_data_buffer(const uv_buf_t* buf) const;
+
+    // Returns true if user has not supplied buffer for the read, reading is paused in this case
+    bool on_no_read_buffer(ssize_t nread);
+
+    // Sends made while a file is being sent are held and made after it, in order of calls
+    bool should_hold_send() const;
+    void hold_send(io::detail::UniqueFunction<void()> send);
+
+    // Should be called when connection is closed. File and zero-copy sends bypass libuv, so they are
+    // completed here, not yet transferred data is completed with OPERATION_CANCELED error.
+    // Buffers of zero-copy sends are released when kernel completes them, or immediately if connection is reset.
+    // Close observer is notified here too.
+    void cancel_direct_sends(bool connection_reset = false);
+
     // data
     EventLoop* m_loop;
     uv_loop_t* m_uv_loop;
@@ -63,9 +137,24 @@ protected:
 
     uv_tcp_t* m_tcp_stream = nullptr;
     std::size_t m_pending_write_requests = 0;
+    // Requests passed to libuv (or corked) which are not completed yet
+    std::size_t m_queued_write_requests = 0;
+    // Bytes of those requests, data written immediately by try_write is not counted
+    std::size_t m_queued_write_bytes = 0;
+
+    // Watermarks are disabled while high watermark is 0
+    std::size_t m_send_high_watermark = 0;
+    std::size_t m_send_low_watermark = 0;
+    bool m_send_high_watermark_reached = false;
+    typename ParentType::SendWatermarkCallback m_high_watermark_callback = nullptr;
+    typename ParentType::SendWatermarkCallback m_drain_callback = nullptr;
 
     std::shared_ptr<char> m_read_buf;
     std::size_t m_read_buf_size = 0;
+    bool m_read_buf_shared = false;
+
+    typename ParentType::ReadBufferCallback m_read_buffer_callback = nullptr;
+    bool m_read_buf_supplied_by_user = false;
 
     std::size_t m_data_offset = 0;
 
@@ -74,15 +163,187 @@ protected:
     // This field added because libuv does not allow to get this property from TCP handle
     bool m_delay_send = true;
 
+    // When set before connection is established, reading is not started
+    bool m_read_paused = false;
+
+    // Queue is created on first corked send
+    bool m_cork_send = false;
+    std::shared_ptr<TcpSendQueue> m_send_queue;
+
     typename ParentType::CloseCallback m_close_callback = nullptr;
 
 private:
     template<typename T>
     struct WriteRequest : public uv_write_t {
         uv_buf_t uv_buf;
-        typename ParentType::EndSendCallback end_send_callback;
+        io::detail::UniqueFunction<void(ParentType&, const Error&)> end_send_callback;
+        std::size_t queued_bytes;
         T buf;
     };
+
+    // Buffers of scatter/gather send
+    struct BufferList {
+        std::vector<SendBuffer> buffers;
+        std::vector<uv_buf_t> uv_bufs;
+    };
+
+    template<typename T>
+    void start_write(WriteRequest<T>* req, const uv_buf_t* bufs, unsigned int nbufs);
+
+    // Data send which was made while a file is being sent, it is counted as pending and its bytes as queued
+    template<typename T>
+    struct HeldDataSend {
+        TcpClientImplBase* client;
+        T buffer;
+        std::uint32_t size;
+        typename ParentType::EndSendCallback callback;
+
+        void operator()() {
+            --client->m_pending_write_requests;
+            // Bytes are removed after the send, so watermarks are not crossed twice
+            client->send_held_data(std::move(buffer), size, callback);
+            client->remove_queued_write_bytes(size);
+        }
+    };
+
+    template<typename T>
+    void send_held_data(T buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+    void send_held_data(std::shared_ptr<const char> buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+    void send_held_data(std::vector<SendBuffer> buffers, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+
+    // Data is written directly to the socket while file or zero-copy send is in progress
+    bool is_direct_send_in_progress() const;
+
+    void release_held_sends();
+    // Held sends are failed with deferred callbacks when connection is closed, so order of callbacks is preserved
+    void fail_held_send(const typename ParentType::EndSendCallback& callback);
+
+    // Poll handle uses duplicate of the socket descriptor because libuv allows only one watcher per descriptor
+    struct SocketPoll : public uv_poll_t {
+        int fd = -1;
+    };
+
+    // File is sent by non-blocking sendfile on the loop thread, each time the socket becomes writable
+    struct FileSend {
+        int file_handle = -1;
+        std::uint64_t offset = 0;
+        std::uint64_t remaining = 0;
+        std::uint64_t sent = 0;
+        // Not started until sends which were made before the file are transferred
+        bool started = false;
+        SocketPoll* poll = nullptr;
+        io::detail::UniqueFunction<void(ParentType&, const Error&)> end_send_callback;
+        typename ParentType::SendFileProgressCallback progress_callback;
+    };
+
+    // Limits time spent in a single writable notification, so other events of the loop are not delayed
+    static const std::size_t MAX_FILE_SEND_BYTES_PER_ITERATION = 1024 * 1024;
+
+    void start_file_send();
+    void continue_file_send();
+    int wait_file_send_writable();
+    void finish_file_send(int status);
+
+    static void on_file_send_writable(uv_poll_t* handle, int status, int events);
+    static void on_socket_poll_close(uv_handle_t* handle);
+
+    FileSend* m_file_send = nullptr;
+    std::function<void()> m_close_observer;
+    std::deque<io::detail::UniqueFunction<void()>> m_held_sends;
+    bool m_releasing_held_sends = false;
+
+    // Send with MSG_ZEROCOPY, buffer is referenced until kernel reports completion via socket error queue
+    struct ZeroCopySend {
+        std::shared_ptr<const char> buffer;
+        std::size_t size = 0;
+        std::size_t written = 0;
+        // Bytes which are counted as queued, data not passed to the socket yet
+        std::size_t queued_bytes = 0;
+        // Counter of the last MSG_ZEROCOPY call with data of this send, completions refer to these counters
+        std::uint32_t last_id = 0;
+        bool has_id = false;
+        // Send failed, callback is called already but buffer is still referenced until completion
+        bool end_send_reported = false;
+        io::detail::UniqueFunction<void(ParentType&, const Error&)> end_send_callback;
+    };
+
+    // After close data which was passed to the socket is still transmitted by kernel from buffers of zero-copy
+    // sends, so these buffers and poll of the socket are kept until completions or socket error.
+    struct ZeroCopyRelease {
+        SocketPoll* poll = nullptr;
+        std::deque<ZeroCopySend> sends;
+        std::uint32_t completed_end = 0;
+    };
+
+    void send_zero_copy(std::shared_ptr<const char> buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback);
+    void continue_zero_copy_write();
+    bool read_zero_copy_completions();
+    void complete_zero_copy_sends();
+    void cancel_zero_copy_sends(bool connection_reset);
+    int update_zero_copy_poll();
+
+    static bool read_zero_copy_completions(int fd, std::uint32_t& completed_end, bool& copied);
+    static void release_zero_copy_buffers(ZeroCopyRelease* release);
+    static void on_zero_copy_poll(uv_poll_t* handle, int status, int events);
+    static void on_zero_copy_release_poll(uv_poll_t* handle, int status, int events);
+
+    int open_socket_poll(SocketPoll*& poll);
+
+    bool m_zero_copy_send = false;
+    std::size_t m_zero_copy_min_size = 0;
+    SocketPoll* m_zero_copy_poll = nullptr;
+    // Only the last send may be in progress of writing, others wait for completion by kernel
+    std::deque<ZeroCopySend> m_zero_copy_sends;
+    bool m_zero_copy_writing = false;
+    std::uint32_t m_zero_copy_next_id = 0;
+    // Sends with counters lower than this value are completed
+    std::uint32_t m_zero_copy_completed_end = 0;
+
+    // Writes as much data as possible without queueing when there are no queued write requests.
+    // Returns number of written bytes or negative libuv error code.
+    int try_write(const uv_buf_t* bufs, unsigned int nbufs);
+
+    void add_queued_write_bytes(std::size_t size);
+    void remove_queued_write_bytes(std::size_t size);
+
+    // Callbacks of sends which were completed inline by try_write are called after the next poll for I/O.
+    // Sends completed by libuv while there are such callbacks are deferred too, to preserve order of callbacks.
+    struct DeferredEndSend {
+        io::detail::UniqueFunction<void(ParentType&, const Error&)> end_send_callback;
+        Error status;
+    };
+
+    // State is allocated separately because it may outlive the client if deferred callback is already scheduled.
+    struct DeferredEndSends {
+        TcpClientImplBase* owner = nullptr;
+        bool scheduled = false;
+        std::vector<DeferredEndSend> queue;
+        std::vector<DeferredEndSend> executing;
+    };
+
+    template<typename CallbackType>
+    void defer_end_send(CallbackType&& callback, const Error& status);
+    void execute_deferred_end_sends();
+    bool has_deferred_end_sends() const;
+
+    DeferredEndSends* m_deferred_end_sends = nullptr;
+
+    // Memory of completed write requests is reused, so sending data does not allocate
+    // in a steady state. Block is large enough to hold request with any supported buffer type.
+    using WriteRequestBlock = typename std::aligned_union<0,
+                                                          WriteRequest<const char*>,
+                                                          WriteRequest<std::shared_ptr<const char>>,
+                                                          WriteRequest<std::unique_ptr<char[]>>,
+                                                          WriteRequest<std::string>,
+                                                          WriteRequest<BufferList>>::type;
+    static const std::size_t MAX_CACHED_WRITE_REQUESTS = 16;
+
+    template<typename T>
+    WriteRequest<T>* new_write_request();
+    template<typename T>
+    void delete_write_request(WriteRequest<T>* request);
+
+    std::vector<WriteRequestBlock*> m_write_requests_cache;
 };
 
 ///////////////////////////////////////// implementation ///////////////////////////////////////////
@@ -97,6 +358,32 @@ TcpClientImplBase<ParentType, ImplType>::TcpClientImplBase(EventLoop& loop, Pare
 template<typename ParentType, typename ImplType>
 TcpClientImplBase<ParentType, ImplType>::~TcpClientImplBase() {
     m_read_buf.reset();
+
+    // Sends which are still queued are completed using write requests cache, so queue is released first
+    m_send_queue.reset();
+
+    if (m_deferred_end_sends) {
+        if (m_deferred_end_sends->scheduled) {
+            m_deferred_end_sends->owner = nullptr; // released by scheduled callback
+        } else {
+            delete m_deferred_end_sends;
+        }
+    }
+
+    for (auto block : m_write_requests_cache) {
+        delete block;
+    }
+
+    if (m_file_send) {
+        if (m_file_send->poll) {
+            uv_close(reinterpret_cast<uv_handle_t*>(m_file_send->poll), on_socket_poll_close);
+        }
+        delete m_file_send;
+    }
+
+    if (m_zero_copy_poll) {
+        uv_close(reinterpret_cast<uv_handle_t*>(m_zero_copy_poll), on_socket_poll_close);
+    }
 }
 
 template<typename ParentType, typename ImplType>
@@ -136,24 +423,269 @@ void TcpClientImplBase<ParentType, ImplType>::send_data_impl(T buffer, std::uint
         return;
     }
 
-    auto req = new WriteRequest<T>;
+    if (should_hold_send()) {
+        ++m_pending_write_requests;
+        add_queued_write_bytes(size);
+        hold_send(HeldDataSend<T>{this, std::move(buffer), size, callback});
+        return;
+    }
+
+    // const_cast is a workaround for lack of constness support in uv_buf_t
+    const uv_buf_t uv_buf = uv_buf_init(const_cast<char*>(io::detail::raw_buffer_get(buffer)), size);
+    const int try_write_result = try_write(&uv_buf, 1);
+    if (try_write_result < 0 || std::size_t(try_write_result) == size) {
+        // Fast path, buffer is not needed anymore and no write request is allocated
+        ++m_pending_write_requests;
+        defer_end_send(callback, try_write_result < 0 ? try_write_result : 0);
+        return;
+    }
+
+    const std::size_t written_size = std::size_t(try_write_result);
+
+    auto req = new_write_request<T>();
     req->end_send_callback = callback;
     req->data = this;
     req->buf = std::move(buffer);
-    // const_cast is a workaround for lack of constness support in uv_buf_t
-    req->uv_buf = uv_buf_init(const_cast<char*>(io::detail::raw_buffer_get(req->buf)), size);
+    // Pointer is taken again because data of moved std::string may be relocated
+    req->uv_buf = uv_buf_init(const_cast<char*>(io::detail::raw_buffer_get(req->buf)) + written_size,
+                              static_cast<unsigned int>(size - written_size));
+
+    start_write(req, &req->uv_buf, 1);
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::send_data(std::vector<SendBuffer> buffers, const typename ParentType::EndSendCallback& callback) {
+    if (!is_open()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::NOT_CONNECTED));
+        }
+        return;
+    }
 
-    const Error write_error = uv_write(req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), &req->uv_buf, 1, after_write<T>);
+    if (buffers.empty()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::INVALID_ARGUMENT));
+        }
+        return;
+    }
+
+    std::uint32_t buffers_size = 0;
+    for (const auto& buffer : buffers) {
+        if (buffer.size() == 0 || buffer.data() == nullptr) {
+            if (callback) {
+                callback(*m_parent, Error(StatusCode::INVALID_ARGUMENT));
+            }
+            return;
+        }
+        buffers_size += static_cast<std::uint32_t>(buffer.size());
+    }
+
+    if (should_hold_send()) {
+        ++m_pending_write_requests;
+        add_queued_write_bytes(buffers_size);
+        hold_send(HeldDataSend<std::vector<SendBuffer>>{this, std::move(buffers), buffers_size, callback});
+        return;
+    }
+
+    auto req = new_write_request<BufferList>();
+    req->end_send_callback = callback;
+    req->data = this;
+    req->buf.buffers = std::move(buffers);
+    req->buf.uv_bufs.reserve(req->buf.buffers.size());
+    std::size_t total_size = 0;
+    for (const auto& buffer : req->buf.buffers) {
+        // const_cast is a workaround for lack of constness support in uv_buf_t
+        req->buf.uv_bufs.push_back(uv_buf_init(const_cast<char*>(buffer.data()), buffer.size()));
+        total_size += buffer.size();
+    }
+
+    auto& uv_bufs = req->buf.uv_bufs;
+    const int try_write_result = try_write(uv_bufs.data(), static_cast<unsigned int>(uv_bufs.size()));
+    if (try_write_result < 0 || std::size_t(try_write_result) == total_size) {
+        auto end_send_callback = std::move(req->end_send_callback);
+        delete_write_request(req);
+        ++m_pending_write_requests;
+        defer_end_send(std::move(end_send_callback), try_write_result < 0 ? try_write_result : 0);
+        return;
+    }
+
+    std::size_t written_size = std::size_t(try_write_result);
+
+    // Skipping written data
+    std::size_t first_buf = 0;
+    while (written_size >= uv_bufs[first_buf].len) {
+        written_size -= uv_bufs[first_buf].len;
+        ++first_buf;
+    }
+    uv_bufs[first_buf].base += written_size;
+    uv_bufs[first_buf].len -= static_cast<decltype(uv_buf_t::len)>(written_size);
+
+    // All buffers are sent by a single write (writev)
+    start_write(req, uv_bufs.data() + first_buf, static_cast<unsigned int>(uv_bufs.size() - first_buf));
+}
+
+template<typename ParentType, typename ImplType>
+template<typename T>
+void TcpClientImplBase<ParentType, ImplType>::start_write(WriteRequest<T>* req, const uv_buf_t* bufs, unsigned int nbufs) {
+    req->queued_bytes = 0;
+    for (unsigned int i = 0; i < nbufs; ++i) {
+        req->queued_bytes += bufs[i].len;
+    }
+
+    if (m_cork_send) {
+        if (m_send_queue == nullptr) {
+            m_send_queue = std::make_shared<TcpSendQueue>(*m_loop, *reinterpret_cast<uv_stream_t*>(m_tcp_stream));
+        }
+
+        m_send_queue->push(req, bufs, nbufs, after_write<T>);
+        ++m_pending_write_requests;
+        ++m_queued_write_requests;
+        add_queued_write_bytes(req->queued_bytes);
+        return;
+    }
+
+    const Error write_error = uv_write(req, reinterpret_cast<uv_stream_t*>(m_tcp_stream), bufs, nbufs, after_write<T>);
     if (write_error) {
         LOG_ERROR(m_loop, m_parent, "Error:", write_error.string());
-        if (callback) {
-            callback(*m_parent, write_error);
+        auto end_send_callback = std::move(req->end_send_callback);
+        delete_write_request(req);
+        if (end_send_callback) {
+            end_send_callback(*m_parent, write_error);
         }
-        delete req;
         return;
     }
 
     ++m_pending_write_requests;
+    ++m_queued_write_requests;
+    add_queued_write_bytes(req->queued_bytes);
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::add_queued_write_bytes(std::size_t size) {
+    m_queued_write_bytes += size;
+
+    if (m_send_high_watermark == 0 || m_send_high_watermark_reached || m_queued_write_bytes < m_send_high_watermark) {
+        return;
+    }
+
+    m_send_high_watermark_reached = true;
+    if (m_high_watermark_callback) {
+        m_high_watermark_callback(*m_parent);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::remove_queued_write_bytes(std::size_t size) {
+    assert(m_queued_write_bytes >= size);
+    m_queued_write_bytes -= size;
+
+    if (!m_send_high_watermark_reached || m_queued_write_bytes > m_send_low_watermark) {
+        return;
+    }
+
+    m_send_high_watermark_reached = false;
+    // Nobody is waiting for drain of a closed connection
+    if (m_drain_callback && is_open()) {
+        m_drain_callback(*m_parent);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+int TcpClientImplBase<ParentType, ImplType>::try_write(const uv_buf_t* bufs, unsigned int nbufs) {
+    // Data of queued requests should be written first
+    if (m_cork_send || m_queued_write_requests) {
+        return 0;
+    }
+
+#ifdef TARM_IO_PLATFORM_LINUX
+    // Direct sendmsg is used because uv_try_write goes through the whole uv_write machinery
+    // and may raise SIGPIPE on a reset connection.
+    uv_os_fd_t fd = -1;
+    if (uv_fileno(reinterpret_cast<uv_handle_t*>(m_tcp_stream), &fd) != 0) {
+        return 0;
+    }
+
+    ::msghdr header;
+    std::memset(&header, 0, sizeof(header));
+    // uv_buf_t is ABI compatible with iovec on Unix, libuv relies on this too
+    header.msg_iov = reinterpret_cast<struct iovec*>(const_cast<uv_buf_t*>(bufs));
+    // Otherwise sendmsg fails with EMSGSIZE, the rest is written as partial write
+    header.msg_iovlen = std::min<std::size_t>(nbufs, IOV_MAX);
+
+    ssize_t result = 0;
+    do {
+        result = ::sendmsg(fd, &header, MSG_NOSIGNAL);
+    } while (result == -1 && errno == EINTR);
+
+    if (result >= 0) {
+        return static_cast<int>(result);
+    }
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+        return 0;
+    }
+
+    const int error = uv_translate_sys_error(errno);
+    LOG_ERROR(m_loop, m_parent, "Error:", uv_strerror(error));
+    return error;
+#else
+    const int result = uv_try_write(reinterpret_cast<uv_stream_t*>(m_tcp_stream), bufs, nbufs);
+    // Errors are reported by regular write
+    return result > 0 ? result : 0;
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+template<typename CallbackType>
+void TcpClientImplBase<ParentType, ImplType>::defer_end_send(CallbackType&& callback, const Error& status) {
+    if (m_deferred_end_sends == nullptr) {
+        m_deferred_end_sends = new DeferredEndSends;
+        m_deferred_end_sends->owner = this;
+    }
+
+    m_deferred_end_sends->queue.push_back({std::forward<CallbackType>(callback), status});
+    if (m_deferred_end_sends->scheduled) {
+        return;
+    }
+
+    m_deferred_end_sends->scheduled = true;
+
+    // Only pointer is captured, so callback is stored without allocation
+    auto state = m_deferred_end_sends;
+    io::detail::EventLoopAccess::schedule_callback_after_poll(*m_loop, [state](EventLoop&) {
+        if (state->owner == nullptr) {
+            delete state;
+            return;
+        }
+
+        state->scheduled = false;
+        state->owner->execute_deferred_end_sends();
+    });
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::execute_deferred_end_sends() {
+    // Callbacks may send more data, those sends are deferred to the next pass
+    auto& executing = m_deferred_end_sends->executing;
+    executing.swap(m_deferred_end_sends->queue);
+    // Capacity is kept equal in both containers, so sends from callbacks do not allocate in a steady state
+    m_deferred_end_sends->queue.reserve(executing.capacity());
+
+    for (auto& end_send : executing) {
+        assert(m_pending_write_requests >= 1);
+        --m_pending_write_requests;
+
+        if (end_send.end_send_callback) {
+            end_send.end_send_callback(*m_parent, end_send.status);
+        }
+    }
+
+    executing.clear();
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::has_deferred_end_sends() const {
+    return m_deferred_end_sends && (!m_deferred_end_sends->queue.empty() || !m_deferred_end_sends->executing.empty());
 }
 
 template<typename ParentType, typename ImplType>
@@ -170,8 +702,14 @@ void TcpClientImplBase<ParentType, ImplType>::send_data(const char* c_str, std::
 
 template<typename ParentType, typename ImplType>
 void TcpClientImplBase<ParentType, ImplType>::send_data(std::shared_ptr<const char> buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback) {
+    // Zero-copy send is written directly, so it is used only when there is no queued data to keep the order
+    if (m_zero_copy_send && size >= m_zero_copy_min_size && buffer != nullptr && is_open() &&
+        !should_hold_send() && !m_cork_send && m_queued_write_requests == 0) {
+        send_zero_copy(std::move(buffer), size, callback);
+        return;
+    }
 
-    send_data_impl(buffer, size, callback);
+    send_data_impl(std::move(buffer), size, callback);
 }
 
 template<typename ParentType, typename ImplType>
@@ -193,11 +731,598 @@ void TcpClientImplBase<ParentType, ImplType>::send_data(std::string&& message, c
     send_data_impl(std::move(message), size, callback);
 }
 
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::send_file(fs::File& file,
+                                                        std::uint64_t offset,
+                                                        std::uint64_t length,
+                                                        const typename ParentType::EndSendCallback& callback,
+                                                        const typename ParentType::SendFileProgressCallback& progress_callback) {
+    if (!is_open()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::NOT_CONNECTED));
+        }
+        return;
+    }
+
+    if (length == 0 || !file.is_open()) {
+        if (callback) {
+            callback(*m_parent, Error(StatusCode::INVALID_ARGUMENT));
+        }
+        return;
+    }
+
+#ifndef TARM_IO_PLATFORM_LINUX
+    if (callback) {
+        callback(*m_parent, Error(StatusCode::FUNCTION_NOT_IMPLEMENTED));
+    }
+#else
+    if (should_hold_send()) {
+        auto file_ptr = &file;
+        ++m_pending_write_requests;
+        hold_send([this, file_ptr, offset, length, callback, progress_callback]() {
+            --this->m_pending_write_requests;
+            if (this->is_open()) {
+                this->send_file(*file_ptr, offset, length, callback, progress_callback);
+            } else {
+                this->fail_held_send(callback);
+            }
+        });
+        return;
+    }
+
+    m_file_send = new FileSend;
+    m_file_send->file_handle = file.raw_handle();
+    m_file_send->offset = offset;
+    m_file_send->remaining = length;
+    m_file_send->end_send_callback = callback;
+    m_file_send->progress_callback = progress_callback;
+    ++m_pending_write_requests;
+
+    // Corked data precedes the file
+    flush();
+
+    if (m_queued_write_requests == 0) {
+        start_file_send();
+    }
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::start_file_send() {
+    m_file_send->started = true;
+
+    // Data is sent on the next writable notification, so progress callback is never called from send_file
+    const int wait_status = wait_file_send_writable();
+    if (wait_status < 0) {
+        finish_file_send(wait_status);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::continue_file_send() {
+#ifdef TARM_IO_PLATFORM_LINUX
+    uv_os_fd_t socket_fd = -1;
+    if (!is_open() || uv_fileno(reinterpret_cast<uv_handle_t*>(m_tcp_stream), &socket_fd) != 0) {
+        finish_file_send(UV_ECANCELED);
+        return;
+    }
+
+    auto& file_send = *m_file_send;
+    int status = 0;
+    std::uint64_t sent_in_iteration = 0;
+    while (file_send.remaining && sent_in_iteration < MAX_FILE_SEND_BYTES_PER_ITERATION) {
+        off_t offset = static_cast<off_t>(file_send.offset);
+        const auto size = static_cast<std::size_t>(std::min<std::uint64_t>(file_send.remaining,
+                                                                            std::uint64_t(MAX_FILE_SEND_BYTES_PER_ITERATION)));
+        const ssize_t result = ::sendfile(socket_fd, file_send.file_handle, &offset, size);
+        if (result > 0) {
+            file_send.offset += std::uint64_t(result);
+            file_send.remaining -= std::uint64_t(result);
+            file_send.sent += std::uint64_t(result);
+            sent_in_iteration += std::uint64_t(result);
+        } else if (result == 0) {
+            // File is shorter than requested
+            status = UV_EOF;
+            break;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            status = uv_translate_sys_error(errno);
+            break;
+        }
+    }
+
+    if (sent_in_iteration && file_send.progress_callback) {
+        // Callback is copied because connection may be closed from it
+        const auto progress_callback = file_send.progress_callback;
+        progress_callback(*m_parent, file_send.sent);
+        if (m_file_send == nullptr) {
+            return;
+        }
+    }
+
+    if (status == 0 && m_file_send->remaining) {
+        status = wait_file_send_writable();
+        if (status == 0) {
+            return;
+        }
+    }
+
+    finish_file_send(status);
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+int TcpClientImplBase<ParentType, ImplType>::wait_file_send_writable() {
+#ifdef TARM_IO_PLATFORM_LINUX
+    auto& file_send = *m_file_send;
+    if (file_send.poll == nullptr) {
+        const int open_status = open_socket_poll(file_send.poll);
+        if (open_status < 0) {
+            return open_status;
+        }
+    }
+
+    return uv_poll_start(file_send.poll, UV_WRITABLE, on_file_send_writable);
+#else
+    return UV_ENOSYS;
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+int TcpClientImplBase<ParentType, ImplType>::open_socket_poll(SocketPoll*& poll) {
+#ifdef TARM_IO_PLATFORM_LINUX
+    uv_os_fd_t socket_fd = -1;
+    const int fileno_status = uv_fileno(reinterpret_cast<uv_handle_t*>(m_tcp_stream), &socket_fd);
+    if (fileno_status < 0) {
+        return fileno_status;
+    }
+
+    const int poll_fd = ::dup(socket_fd);
+    if (poll_fd == -1) {
+        return uv_translate_sys_error(errno);
+    }
+
+    auto new_poll = new SocketPoll;
+    new_poll->fd = poll_fd;
+    const int init_status = uv_poll_init(m_uv_loop, new_poll, poll_fd);
+    if (init_status < 0) {
+        ::close(poll_fd);
+        delete new_poll;
+        return init_status;
+    }
+
+    new_poll->data = this;
+    poll = new_poll;
+    return 0;
+#else
+    return UV_ENOSYS;
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::finish_file_send(int status) {
+    auto file_send = m_file_send;
+    m_file_send = nullptr;
+
+    if (file_send->poll) {
+        uv_close(reinterpret_cast<uv_handle_t*>(file_send->poll), on_socket_poll_close);
+    }
+
+    if (status < 0) {
+        LOG_ERROR(m_loop, m_parent, "Error:", uv_strerror(status));
+    }
+
+    // Callback is deferred like callbacks of other sends, so order of callbacks is preserved
+    defer_end_send(std::move(file_send->end_send_callback), status);
+    delete file_send;
+
+    release_held_sends();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::cancel_direct_sends(bool connection_reset) {
+    if (m_file_send) {
+        finish_file_send(UV_ECANCELED);
+    }
+
+    cancel_zero_copy_sends(connection_reset);
+
+    if (m_close_observer) {
+        auto observer = std::move(m_close_observer);
+        m_close_observer = nullptr;
+        observer();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_close_observer(std::function<void()> observer) {
+    m_close_observer = std::move(observer);
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::is_direct_send_in_progress() const {
+    return m_file_send != nullptr || m_zero_copy_writing;
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::should_hold_send() const {
+    return is_direct_send_in_progress() || (!m_held_sends.empty() && !m_releasing_held_sends);
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::hold_send(io::detail::UniqueFunction<void()> send) {
+    m_held_sends.push_back(std::move(send));
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::release_held_sends() {
+    const bool was_releasing = m_releasing_held_sends;
+    m_releasing_held_sends = true;
+
+    // Stops on the next file or partially written zero-copy send, the rest is released after it
+    while (!is_direct_send_in_progress() && !m_held_sends.empty()) {
+        auto send = std::move(m_held_sends.front());
+        m_held_sends.pop_front();
+        send();
+    }
+
+    m_releasing_held_sends = was_releasing;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::fail_held_send(const typename ParentType::EndSendCallback& callback) {
+    ++m_pending_write_requests;
+    defer_end_send(callback, Error(StatusCode::NOT_CONNECTED));
+}
+
+template<typename ParentType, typename ImplType>
+template<typename T>
+void TcpClientImplBase<ParentType, ImplType>::send_held_data(T buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback) {
+    if (is_open()) {
+        send_data_impl(std::move(buffer), size, callback);
+    } else {
+        fail_held_send(callback);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::send_held_data(std::shared_ptr<const char> buffer, std::uint32_t size, const typename ParentType::EndSendCallback& callback) {
+    if (is_open()) {
+        send_data(std::move(buffer), size, callback);
+    } else {
+        fail_held_send(callback);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::send_held_data(std::vector<SendBuffer> buffers, std::uint32_t, const typename ParentType::EndSendCallback& callback) {
+    if (is_open()) {
+        send_data(std::move(buffers), callback);
+    } else {
+        fail_held_send(callback);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+Error TcpClientImplBase<ParentType, ImplType>::zero_copy_send(bool enabled, std::size_t min_size) {
+#ifndef TARM_IO_PLATFORM_LINUX
+    return Error(StatusCode::FUNCTION_NOT_IMPLEMENTED);
+#else
+    if (!is_open()) {
+        return Error(StatusCode::NOT_CONNECTED);
+    }
+
+    if (enabled && m_zero_copy_poll == nullptr) {
+        uv_os_fd_t socket_fd = -1;
+        const Error fileno_error = uv_fileno(reinterpret_cast<uv_handle_t*>(m_tcp_stream), &socket_fd);
+        if (fileno_error) {
+            return fileno_error;
+        }
+
+        const int value = 1;
+        if (::setsockopt(socket_fd, SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(value)) != 0) {
+            return Error(uv_translate_sys_error(errno));
+        }
+
+        const Error open_error = open_socket_poll(m_zero_copy_poll);
+        if (open_error) {
+            return open_error;
+        }
+    }
+
+    m_zero_copy_send = enabled;
+    m_zero_copy_min_size = min_size;
+    return Error(0);
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::is_zero_copy_send() const {
+    return m_zero_copy_send;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::send_zero_copy(std::shared_ptr<const char> buffer,
+                                                             std::uint32_t size,
+                                                             const typename ParentType::EndSendCallback& callback) {
+    m_zero_copy_sends.emplace_back();
+    auto& send = m_zero_copy_sends.back();
+    send.buffer = std::move(buffer);
+    send.size = size;
+    send.end_send_callback = callback;
+
+    ++m_pending_write_requests;
+    m_zero_copy_writing = true;
+
+    continue_zero_copy_write();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::continue_zero_copy_write() {
+#ifdef TARM_IO_PLATFORM_LINUX
+    auto& send = m_zero_copy_sends.back();
+
+    int status = 0;
+    bool zero_copy = true;
+    while (send.written < send.size) {
+        ::iovec iov;
+        iov.iov_base = const_cast<char*>(send.buffer.get() + send.written);
+        iov.iov_len = send.size - send.written;
+
+        ::msghdr header;
+        std::memset(&header, 0, sizeof(header));
+        header.msg_iov = &iov;
+        header.msg_iovlen = 1;
+
+        const ssize_t result = ::sendmsg(m_zero_copy_poll->fd, &header, MSG_NOSIGNAL | (zero_copy ? MSG_ZEROCOPY : 0));
+        if (result >= 0) {
+            send.written += std::size_t(result);
+            if (zero_copy) {
+                send.last_id = m_zero_copy_next_id++;
+                send.has_id = true;
+            }
+        } else if (errno == ENOBUFS && zero_copy) {
+            // Limit of memory pinned by the socket is reached, the rest of data is copied
+            zero_copy = false;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            status = uv_translate_sys_error(errno);
+            break;
+        }
+    }
+
+    const std::size_t prev_queued_bytes = send.queued_bytes;
+    std::size_t queued_bytes = 0;
+
+    if (status < 0) {
+        LOG_ERROR(m_loop, m_parent, "Error:", uv_strerror(status));
+        auto end_send_callback = std::move(send.end_send_callback);
+        if (send.has_id) {
+            // Part of data may still be referenced by kernel, buffer is released on completion
+            send.written = send.size;
+            send.queued_bytes = 0;
+            send.end_send_reported = true;
+        } else {
+            m_zero_copy_sends.pop_back();
+        }
+        m_zero_copy_writing = false;
+        defer_end_send(std::move(end_send_callback), status);
+    } else if (send.written == send.size) {
+        send.queued_bytes = 0;
+        m_zero_copy_writing = false;
+    } else {
+        queued_bytes = send.size - send.written;
+        send.queued_bytes = queued_bytes;
+    }
+
+    update_zero_copy_poll();
+
+    if (!m_zero_copy_writing) {
+        complete_zero_copy_sends();
+        release_held_sends();
+    }
+
+    // Watermark callbacks are called last because connection may be closed from them
+    if (queued_bytes > prev_queued_bytes) {
+        add_queued_write_bytes(queued_bytes - prev_queued_bytes);
+    } else if (queued_bytes < prev_queued_bytes) {
+        remove_queued_write_bytes(prev_queued_bytes - queued_bytes);
+    }
+#endif
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::read_zero_copy_completions() {
+    bool copied = false;
+    const bool received = read_zero_copy_completions(m_zero_copy_poll->fd, m_zero_copy_completed_end, copied);
+    if (copied) {
+        LOG_TRACE(m_loop, m_parent, "Data of zero-copy send was copied by kernel");
+    }
+    return received;
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::read_zero_copy_completions(int fd, std::uint32_t& completed_end, bool& copied) {
+    bool received = false;
+#ifdef TARM_IO_PLATFORM_LINUX
+    while (true) {
+        char control[128];
+        ::msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const ssize_t result = ::recvmsg(fd, &message, MSG_ERRQUEUE);
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            const bool is_ip_error = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                                     (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!is_ip_error) {
+                continue;
+            }
+
+            ::sock_extended_err error;
+            std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+            if (error.ee_errno != 0 || error.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+
+            // Completion is a range of counters [ee_info, ee_data], TCP completes sends in order
+            const std::uint32_t end = error.ee_data + 1;
+            if (std::int32_t(end - completed_end) > 0) {
+                completed_end = end;
+            }
+            received = true;
+
+            if (error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                copied = true;
+            }
+        }
+    }
+#endif
+    return received;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::complete_zero_copy_sends() {
+    while (!m_zero_copy_sends.empty()) {
+        auto& send = m_zero_copy_sends.front();
+        if (send.written != send.size) {
+            break;
+        }
+
+        if (send.has_id && std::int32_t(m_zero_copy_completed_end - send.last_id) <= 0) {
+            break;
+        }
+
+        const bool end_send_reported = send.end_send_reported;
+        auto end_send_callback = std::move(send.end_send_callback);
+        m_zero_copy_sends.pop_front();
+        if (!end_send_reported) {
+            defer_end_send(std::move(end_send_callback), 0);
+        }
+    }
+
+    update_zero_copy_poll();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::cancel_zero_copy_sends(bool connection_reset) {
+    if (m_zero_copy_poll && !m_zero_copy_sends.empty()) {
+        read_zero_copy_completions();
+    }
+
+    m_zero_copy_send = false;
+    m_zero_copy_writing = false;
+
+    ZeroCopyRelease* release = nullptr;
+    std::size_t queued_bytes = 0;
+    while (!m_zero_copy_sends.empty()) {
+        auto& send = m_zero_copy_sends.front();
+        // Data passed to the socket is reported as sent, like for regular sends
+        const int status = send.written == send.size ? 0 : UV_ECANCELED;
+        queued_bytes += send.queued_bytes;
+
+        if (!send.end_send_reported) {
+            defer_end_send(std::move(send.end_send_callback), status);
+        }
+
+        const bool in_kernel = send.has_id && std::int32_t(m_zero_copy_completed_end - send.last_id) <= 0;
+        if (in_kernel && !connection_reset && m_zero_copy_poll) {
+            if (release == nullptr) {
+                release = new ZeroCopyRelease;
+                release->completed_end = m_zero_copy_completed_end;
+            }
+            send.end_send_callback = nullptr;
+            release->sends.push_back(std::move(send));
+        }
+
+        m_zero_copy_sends.pop_front();
+    }
+
+    if (m_zero_copy_poll) {
+        if (release) {
+            release->poll = m_zero_copy_poll;
+            release->poll->data = release;
+#ifdef TARM_IO_PLATFORM_LINUX
+            // Socket is not closed by kernel while poll holds its duplicate, so shutdown is made explicitly
+            ::shutdown(release->poll->fd, SHUT_WR);
+#endif
+            const int poll_status = uv_poll_start(release->poll, UV_PRIORITIZED, on_zero_copy_release_poll);
+            if (poll_status < 0) {
+                release_zero_copy_buffers(release);
+            }
+        } else {
+            uv_close(reinterpret_cast<uv_handle_t*>(m_zero_copy_poll), on_socket_poll_close);
+        }
+        m_zero_copy_poll = nullptr;
+    }
+
+    if (queued_bytes) {
+        remove_queued_write_bytes(queued_bytes);
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::release_zero_copy_buffers(ZeroCopyRelease* release) {
+    uv_close(reinterpret_cast<uv_handle_t*>(release->poll), on_socket_poll_close);
+    delete release;
+}
+
+template<typename ParentType, typename ImplType>
+int TcpClientImplBase<ParentType, ImplType>::update_zero_copy_poll() {
+    if (m_zero_copy_poll == nullptr) {
+        return 0;
+    }
+
+    if (!m_zero_copy_writing && m_zero_copy_sends.empty()) {
+        return uv_poll_stop(m_zero_copy_poll);
+    }
+
+    // Completions are signaled as POLLERR, libuv passes it to callback only if prioritized events are requested
+    return uv_poll_start(m_zero_copy_poll,
+                         UV_PRIORITIZED | (m_zero_copy_writing ? UV_WRITABLE : 0),
+                         on_zero_copy_poll);
+}
+
 template<typename ParentType, typename ImplType>
 std::size_t TcpClientImplBase<ParentType, ImplType>::pending_write_requests() const {
     return m_pending_write_requests;
 }
 
+template<typename ParentType, typename ImplType>
+std::size_t TcpClientImplBase<ParentType, ImplType>::pending_send_bytes() const {
+    return m_queued_write_bytes;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_send_watermarks(std::size_t high_watermark, std::size_t low_watermark) {
+    assert(low_watermark < high_watermark || high_watermark == 0);
+
+    m_send_high_watermark = high_watermark;
+    m_send_low_watermark = low_watermark;
+    // Callbacks are not called on watermarks change, only on change of pending bytes
+    m_send_high_watermark_reached = high_watermark != 0 && m_queued_write_bytes >= high_watermark;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_high_watermark_callback(const typename ParentType::SendWatermarkCallback& callback) {
+    m_high_watermark_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_drain_callback(const typename ParentType::SendWatermarkCallback& callback) {
+    m_drain_callback = callback;
+}
+
 template<typename ParentType, typename ImplType>
 bool TcpClientImplBase<ParentType, ImplType>::is_open() const {
     return m_is_open;
@@ -214,6 +1339,27 @@ bool TcpClientImplBase<ParentType, ImplType>::is_delay_send() const {
     return m_delay_send;
 }
 
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::cork_send(bool enabled) {
+    if (!enabled) {
+        flush();
+    }
+
+    m_cork_send = enabled;
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::is_cork_send() const {
+    return m_cork_send;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::flush() {
+    if (m_send_queue) {
+        m_send_queue->flush();
+    }
+}
+
 template<typename ParentType, typename ImplType>
 void TcpClientImplBase<ParentType, ImplType>::on_read_error(const Error& error) {
     LOG_DEBUG(m_loop, m_parent, "Connection end", endpoint(), "reason:", error);
@@ -229,6 +1375,90 @@ void TcpClientImplBase<ParentType, ImplType>::on_read_error(const Error& error)
     }
 }
 
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::set_read_buffer_callback(const typename ParentType::ReadBufferCallback& callback) {
+    m_read_buffer_callback = callback;
+}
+
+template<typename ParentType, typename ImplType>
+std::shared_ptr<char> TcpClientImplBase<ParentType, ImplType>::received_data_buffer(const uv_buf_t* buf) const {
+    if (m_read_buf_supplied_by_user) {
+        // Aliasing constructor with empty owner, pointer is not deleted
+        return std::shared_ptr<char>(std::shared_ptr<char>(), buf->base);
+    }
+
+    return m_read_buf;
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::on_no_read_buffer(ssize_t nread) {
+    if (nread != UV_ENOBUFS || !m_read_buf_supplied_by_user) {
+        return false;
+    }
+
+    LOG_TRACE(m_loop, m_parent, "No read buffer supplied, pausing read");
+    pause_read();
+    return true;
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::release_shared_read_buffer() {
+    if (m_read_buf_shared) {
+        m_read_buf.reset();
+        m_read_buf_shared = false;
+    }
+}
+
+template<typename ParentType, typename ImplType>
+template<typename T>
+auto TcpClientImplBase<ParentType, ImplType>::new_write_request() -> WriteRequest<T>* {
+    static_assert(sizeof(WriteRequest<T>) <= sizeof(WriteRequestBlock), "Write request does not fit in a block");
+
+    WriteRequestBlock* block = nullptr;
+    if (m_write_requests_cache.empty()) {
+        block = new WriteRequestBlock;
+    } else {
+        block = m_write_requests_cache.back();
+        m_write_requests_cache.pop_back();
+    }
+
+    return new (block) WriteRequest<T>;
+}
+
+template<typename ParentType, typename ImplType>
+template<typename T>
+void TcpClientImplBase<ParentType, ImplType>::delete_write_request(WriteRequest<T>* request) {
+    request->~WriteRequest<T>();
+
+    auto block = reinterpret_cast<WriteRequestBlock*>(request);
+    if (m_write_requests_cache.size() < MAX_CACHED_WRITE_REQUESTS) {
+        m_write_requests_cache.push_back(block);
+    } else {
+        delete block;
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::pause_read() {
+    if (m_read_paused) {
+        return;
+    }
+
+    m_read_paused = true;
+
+    if (is_open()) {
+        const Error stop_error = uv_read_stop(reinterpret_cast<uv_stream_t*>(m_tcp_stream));
+        if (stop_error) {
+            LOG_ERROR(m_loop, m_parent, "Error:", stop_error.string());
+        }
+    }
+}
+
+template<typename ParentType, typename ImplType>
+bool TcpClientImplBase<ParentType, ImplType>::is_read_paused() const {
+    return m_read_paused;
+}
+
 template<typename ParentType, typename ImplType>
 Error TcpClientImplBase<ParentType, ImplType>::get_socket_error() const {
     int value = 0;
@@ -246,35 +1476,143 @@ template<typename T>
 void TcpClientImplBase<ParentType, ImplType>::after_write(uv_write_t* req, int uv_status) {
     auto& this_ = *reinterpret_cast<ImplType*>(req->data);
 
-    assert(this_.m_pending_write_requests >= 1);
-    --this_.m_pending_write_requests;
+    assert(this_.m_queued_write_requests >= 1);
+    --this_.m_queued_write_requests;
 
     auto request = reinterpret_cast<WriteRequest<T>*>(req);
-    std::unique_ptr<WriteRequest<T>> guard(request);
 
     Error error(uv_status);
     if (error) {
         LOG_ERROR(this_.m_loop, this_.m_parent, "Error:", uv_strerror(uv_status));
     }
 
-    if (request->end_send_callback) {
-        request->end_send_callback(*this_.m_parent, error);
+    // Request is released before the callback, so memory could be reused by sends from the callback
+    auto end_send_callback = std::move(request->end_send_callback);
+    const auto queued_bytes = request->queued_bytes;
+    this_.delete_write_request(request);
+
+    if (this_.has_deferred_end_sends()) {
+        this_.defer_end_send(std::move(end_send_callback), uv_status);
+    } else {
+        assert(this_.m_pending_write_requests >= 1);
+        --this_.m_pending_write_requests;
+
+        if (end_send_callback) {
+            end_send_callback(*this_.m_parent, error);
+        }
+    }
+
+    // Drain is reported after end send callback, data sent from that callback is counted
+    this_.remove_queued_write_bytes(queued_bytes);
+
+    // File is sent after all sends which were made before it
+    if (this_.m_file_send && !this_.m_file_send->started && this_.m_queued_write_requests == 0) {
+        this_.start_file_send();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::on_file_send_writable(uv_poll_t* handle, int status, int events) {
+    auto& this_ = *reinterpret_cast<ImplType*>(handle->data);
+
+    uv_poll_stop(handle);
+
+    if (status < 0) {
+        this_.finish_file_send(status);
+        return;
+    }
+
+    this_.continue_file_send();
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::on_zero_copy_poll(uv_poll_t* handle, int status, int events) {
+    auto& this_ = *reinterpret_cast<ImplType*>(handle->data);
+
+    // POLLERR together with writable event is reported by libuv as UV_EBADF and poll is stopped,
+    // this is expected because completions are delivered via socket error queue.
+    const bool received = this_.read_zero_copy_completions();
+    if (received) {
+        this_.complete_zero_copy_sends();
+    }
+
+    if (status < 0 && !received && !this_.m_zero_copy_writing) {
+        // Socket error, it is reported by reads and writes of the connection
+        uv_poll_stop(handle);
+        return;
+    }
+
+    this_.update_zero_copy_poll();
+
+    if (this_.m_zero_copy_writing) {
+        this_.continue_zero_copy_write();
     }
 }
 
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::on_zero_copy_release_poll(uv_poll_t* handle, int status, int events) {
+    auto release = reinterpret_cast<ZeroCopyRelease*>(handle->data);
+    auto poll = reinterpret_cast<SocketPoll*>(handle);
+
+    bool copied = false;
+    const bool received = read_zero_copy_completions(poll->fd, release->completed_end, copied);
+    while (!release->sends.empty() &&
+           std::int32_t(release->completed_end - release->sends.front().last_id) > 0) {
+        release->sends.pop_front();
+    }
+
+    bool socket_failed = status < 0 && !received;
+#ifdef TARM_IO_PLATFORM_LINUX
+    if (!received && !socket_failed) {
+        // Hang up is reported as prioritized event, kernel does not transmit data of a failed socket anymore
+        int socket_error = 0;
+        ::socklen_t length = sizeof(socket_error);
+        socket_failed = ::getsockopt(poll->fd, SOL_SOCKET, SO_ERROR, &socket_error, &length) != 0 || socket_error != 0;
+    }
+#endif
+
+    if (release->sends.empty() || socket_failed) {
+        release_zero_copy_buffers(release);
+    } else if (status < 0) {
+        // Poll is stopped by libuv on POLLERR
+        if (uv_poll_start(handle, UV_PRIORITIZED, on_zero_copy_release_poll) < 0) {
+            release_zero_copy_buffers(release);
+        }
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void TcpClientImplBase<ParentType, ImplType>::on_socket_poll_close(uv_handle_t* handle) {
+    auto poll = reinterpret_cast<SocketPoll*>(handle);
+#ifdef TARM_IO_PLATFORM_LINUX
+    ::close(poll->fd);
+#endif
+    delete poll;
+}
+
 template<typename ParentType, typename ImplType>
 void TcpClientImplBase<ParentType, ImplType>::alloc_read_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
     auto& this_ = *reinterpret_cast<ImplType*>(handle->data);
 
-    if (this_.m_read_buf == nullptr) {
-        io::detail::default_alloc_buffer(handle, suggested_size, buf);
+    this_.m_read_buf_supplied_by_user = this_.m_read_buffer_callback != nullptr;
+    if (this_.m_read_buf_supplied_by_user) {
+        const ReadBuffer user_buf = this_.m_read_buffer_callback(*this_.m_parent, suggested_size);
+        // Empty buffer is reported by libuv to read callback as UV_ENOBUFS
+        buf->base = user_buf.data;
+        buf->len = static_cast<decltype(uv_buf_t::len)>(user_buf.size);
+        return;
+    }
 
-        this_.m_read_buf.reset(buf->base, std::default_delete<char[]>());
-        this_.m_read_buf_size = buf->len;
-    } else {
-        buf->base =  this_.m_read_buf.get();
-        buf->len = static_cast<decltype(uv_buf_t::len)>(this_.m_read_buf_size);
+    if (this_.m_read_buf == nullptr) {
+        this_.m_read_buf_shared = this_.m_loop->is_shared_read_buffer();
+        this_.m_read_buf = this_.m_read_buf_shared ?
+                           io::detail::EventLoopAccess::acquire_shared_read_buffer(*this_.m_loop, suggested_size) :
+                           this_.m_loop->buffer_pool().acquire(suggested_size);
+        this_.m_read_buf_size = suggested_size;
     }
+
+    buf->base = this_.m_read_buf.get();
+    buf->len = static_cast<decltype(uv_buf_t::len)>(this_.m_read_buf_size); // This cast is OK because suggested size is not more than 64 kB
 }
 
 } // namespace detail
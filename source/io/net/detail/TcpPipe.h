@@ -0,0 +1,31 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "net/PipeConnections.h"
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+enum class TcpPipeMode {
+    // splice(2) on Linux, relay through a buffer otherwise
+    DEFAULT,
+    // Relay through a buffer from the pool of the loop on all platforms
+    RELAY
+};
+
+// Same as net::pipe_connections, but with explicitly selected transfer mode. Allows to test relay mode on Linux.
+TARM_IO_DLL_PUBLIC Error pipe_connections(TcpConnectedClient& first,
+                                          TcpClient& second,
+                                          const PipeEndCallback& end_callback,
+                                          TcpPipeMode mode);
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
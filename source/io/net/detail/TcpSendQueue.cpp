@@ -0,0 +1,98 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "TcpSendQueue.h"
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+TcpSendQueue::TcpSendQueue(EventLoop& loop, uv_stream_t& stream) :
+    m_loop(&loop),
+    m_stream(&stream) {
+}
+
+TcpSendQueue::~TcpSendQueue() {
+    cancel();
+}
+
+std::size_t TcpSendQueue::size() const {
+    return m_sends.size();
+}
+
+void TcpSendQueue::push(uv_write_t* request, const uv_buf_t* bufs, unsigned int nbufs, uv_write_cb callback) {
+    request->handle = m_stream;
+    m_bufs.insert(m_bufs.end(), bufs, bufs + nbufs);
+    m_sends.push_back({request, callback});
+    schedule_flush();
+}
+
+void TcpSendQueue::schedule_flush() {
+    if (m_flush_scheduled) {
+        return;
+    }
+
+    m_flush_scheduled = true;
+
+    // Queue may be destroyed together with its owner before the callback is executed
+    std::weak_ptr<TcpSendQueue> weak_this = shared_from_this();
+    m_loop->schedule_callback([weak_this](EventLoop&) {
+        auto this_ = weak_this.lock();
+        if (this_) {
+            this_->m_flush_scheduled = false;
+            this_->flush();
+        }
+    });
+}
+
+void TcpSendQueue::flush() {
+    if (m_sends.empty()) {
+        return;
+    }
+
+    auto batch = new BatchWriteRequest;
+    batch->bufs.swap(m_bufs);
+    batch->sends.swap(m_sends);
+
+    int status = UV_ECANCELED;
+    if (!uv_is_closing(reinterpret_cast<uv_handle_t*>(m_stream))) {
+        status = uv_write(batch,
+                          m_stream,
+                          batch->bufs.data(),
+                          static_cast<unsigned int>(batch->bufs.size()),
+                          on_write);
+    }
+
+    if (status < 0) {
+        on_write(batch, status);
+    }
+}
+
+void TcpSendQueue::cancel() {
+    while (!m_sends.empty()) {
+        std::vector<Send> sends;
+        sends.swap(m_sends);
+        m_bufs.clear();
+        for (auto& send : sends) {
+            send.callback(send.request, UV_ECANCELED);
+        }
+    }
+}
+
+////////////////////////////////////////////// static //////////////////////////////////////////////
+
+void TcpSendQueue::on_write(uv_write_t* req, int status) {
+    // Batch does not refer to the queue, so it is safe to complete it after the queue is destroyed
+    std::unique_ptr<BatchWriteRequest> batch(static_cast<BatchWriteRequest*>(req));
+    for (auto& send : batch->sends) {
+        send.callback(send.request, status);
+    }
+}
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,72 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoop.h"
+
+#include <uv.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+// Collects sends made to a TCP stream during a loop cycle and passes them to libuv as a single vectored write.
+// Queue is flushed automatically at the end of the loop cycle (see EventLoop::schedule_callback) or explicitly.
+// Send requests are regular libuv requests, each of them is completed with its own callback in order of sending.
+class TcpSendQueue : public std::enable_shared_from_this<TcpSendQueue> {
+public:
+    TARM_IO_FORBID_COPY(TcpSendQueue);
+    TARM_IO_FORBID_MOVE(TcpSendQueue);
+
+    TcpSendQueue(EventLoop& loop, uv_stream_t& stream);
+    ~TcpSendQueue();
+
+    std::size_t size() const;
+
+    // Request and buffers should remain valid until callback is called.
+    void push(uv_write_t* request, const uv_buf_t* bufs, unsigned int nbufs, uv_write_cb callback);
+
+    // Passes all queued sends to libuv. On error callbacks are called immediately.
+    void flush();
+
+    // Completes all queued sends with UV_ECANCELED status.
+    void cancel();
+
+private:
+    struct Send {
+        uv_write_t* request;
+        uv_write_cb callback;
+    };
+
+    // Single libuv request which carries buffers of all sends of one flush
+    struct BatchWriteRequest : public uv_write_t {
+        std::vector<uv_buf_t> bufs;
+        std::vector<Send> sends;
+    };
+
+    static void on_write(uv_write_t* req, int status);
+
+    void schedule_flush();
+
+    EventLoop* m_loop = nullptr;
+    uv_stream_t* m_stream = nullptr;
+
+    std::vector<uv_buf_t> m_bufs;
+    std::vector<Send> m_sends;
+
+    bool m_flush_scheduled = false;
+};
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -26,6 +26,9 @@ struct TlsContext {
     ::EVP_PKEY* private_key = nullptr;
     ::SSL_CTX* ssl_ctx = nullptr;
     TlsVersionRange tls_version_range = DEFAULT_TLS_VERSION_RANGE;
+    bool handshake_offload = false;
+    bool kernel_tls = false;
+    bool release_idle_buffers = false;
 };
 
 } // namespace detail
@@ -7,6 +7,7 @@
 
 #include "RefCounted.h"
 #include "detail/RawBufferGetter.h"
+#include "detail/UniqueFunction.h"
 
 #include "UdpImplBase.h"
 
@@ -34,7 +35,7 @@ protected:
     template<typename T>
     struct SendRequest : public uv_udp_send_t {
         uv_buf_t uv_buf;
-        typename ParentType::EndSendCallback end_send_callback;
+        io::detail::UniqueFunction<void(ParentType&, const Error&)> end_send_callback;
         T buf;
     };
 
@@ -96,6 +97,18 @@ void UdpClientImplBase<ParentType, ImplType>::send_data_impl(T buffer, std::uint
     // const_cast is a workaround for lack of constness support in uv_buf_t
     req->uv_buf = uv_buf_init(const_cast<char*>(io::detail::raw_buffer_get(req->buf)), size);
 
+    auto send_queue = static_cast<ImplType*>(this)->send_queue();
+    if (send_queue) {
+        send_queue->push(req,
+                         &req->uv_buf,
+                         reinterpret_cast<const sockaddr*>(UdpImplBase<ParentType, ImplType>::m_raw_endpoint),
+                         on_send<T>);
+        if (m_ref_counted) {
+            m_ref_counted->ref();
+        }
+        return;
+    }
+
     int uv_status = uv_udp_send(req,
                                 UdpImplBase<ParentType, ImplType>::m_udp_handle.get(),
                                 &req->uv_buf,
@@ -103,6 +116,7 @@ void UdpClientImplBase<ParentType, ImplType>::send_data_impl(T buffer, std::uint
                                 reinterpret_cast<const sockaddr*>(UdpImplBase<ParentType, ImplType>::m_raw_endpoint),
                                 on_send<T>);
     if (uv_status < 0) {
+        delete req;
         if (callback) {
             callback(*UdpImplBase<ParentType, ImplType>::m_parent, Error(uv_status));
         }
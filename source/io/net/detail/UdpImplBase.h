@@ -14,11 +14,18 @@
 #include "Logger.h"
 
 #include "detail/Common.h"
+#include "UdpReceiveBatch.h"
+#include "UdpSendQueue.h"
 
+#include <cstddef>
 #include <cstring>
 #include <limits>
 #include <memory>
 
+#ifdef TARM_IO_HAS_UV_UDP_IO_WATCHER
+    #include <poll.h>
+#endif
+
 namespace tarm {
 namespace io {
 namespace net {
@@ -30,7 +37,9 @@ public:
     UdpImplBase(EventLoop& loop, ParentType& parent);
     UdpImplBase(EventLoop& loop, ParentType& parent, uv_udp_t* udp_handle);
 
-    Error ensure_handle_inited();
+    // If address_family is not AF_UNSPEC, socket is created immediately, so options which should be applied
+    // before bind could be set.
+    Error ensure_handle_inited(int address_family = AF_UNSPEC);
     bool is_open() const;
 
     void set_last_packet_time(std::uint64_t time);
@@ -44,12 +53,32 @@ public:
 
     const Endpoint& endpoint() const;
 
+    Error set_receive_batch(std::size_t datagrams_count, std::size_t max_datagram_size);
+
+    Error set_send_batch(std::size_t datagrams_count);
+    void flush();
+
+    // Returns nullptr if batched send is disabled
+    UdpSendQueue* send_queue();
 
 protected:
     Error check_buffer_size_value(std::size_t size) const;
     void reset_udp_handle_state();
 
+    // Starts receiving. If receive batch is set and supported, datagrams are read with recvmmsg and passed to
+    // ImplType::on_datagrams_received, otherwise recv_callback is called for each datagram.
+    Error start_receive_impl(uv_udp_recv_cb recv_callback);
+    void receive_batches();
+
+    // Returns read buffer back to the pool if user did not keep a reference to it,
+    // otherwise it will be returned when user releases it and new one is taken on next read.
+    void release_read_buffer(long prev_use_count);
+
     // statics
+    static void alloc_read_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+#ifdef TARM_IO_HAS_UV_UDP_IO_WATCHER
+    static void on_batch_io(uv_loop_t* loop, uv__io_t* watcher, unsigned int events);
+#endif
     static void on_close_with_removal(uv_handle_t* handle);
     static void on_close(uv_handle_t* handle);
 
@@ -61,9 +90,25 @@ protected:
     Endpoint m_destination_endpoint;
     const void* m_raw_endpoint = nullptr;
 
+    std::shared_ptr<char> m_read_buf;
+    std::size_t m_read_buf_size = 0;
+
+    std::unique_ptr<UdpReceiveBatch> m_receive_batch;
+    std::shared_ptr<UdpSendQueue> m_send_queue;
+
 private:
+    // Limits number of system calls per one poll event to prevent loop starvation
+    static const std::size_t RECEIVE_BATCHES_PER_EVENT = 4;
+
+#ifdef TARM_IO_HAS_UV_UDP_IO_WATCHER
+    // Original libuv's handler of socket events which is replaced to receive datagrams in batches
+    uv__io_cb m_uv_udp_io_callback = nullptr;
+#endif
+
     std::uint64_t m_last_packet_time_ns = 0;
     bool m_udp_handle_inited = false;
+    // Callbacks of received batch are in progress
+    bool m_receiving_batch = false;
 };
 
 ///////////////////////////////////////// implementation ///////////////////////////////////////////
@@ -92,12 +137,12 @@ UdpImplBase<ParentType, ImplType>::UdpImplBase(EventLoop& loop, ParentType& pare
 }
 
 template<typename ParentType, typename ImplType>
-Error UdpImplBase<ParentType, ImplType>::ensure_handle_inited() {
+Error UdpImplBase<ParentType, ImplType>::ensure_handle_inited(int address_family) {
     if (m_udp_handle_inited) {
         return Error(0);
     }
 
-    const Error init_error = uv_udp_init(m_uv_loop, m_udp_handle.get());
+    const Error init_error = uv_udp_init_ex(m_uv_loop, m_udp_handle.get(), static_cast<unsigned int>(address_family));
     if (init_error) {
         LOG_ERROR(m_loop, this->m_parent, init_error);
         return init_error;
@@ -115,6 +160,150 @@ void UdpImplBase<ParentType, ImplType>::reset_udp_handle_state() {
     m_udp_handle_inited = false;
 }
 
+template<typename ParentType, typename ImplType>
+void UdpImplBase<ParentType, ImplType>::release_read_buffer(long prev_use_count) {
+    if (prev_use_count != m_read_buf.use_count()) { // user made a copy
+        m_read_buf.reset();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+Error UdpImplBase<ParentType, ImplType>::set_receive_batch(std::size_t datagrams_count, std::size_t max_datagram_size) {
+    if (datagrams_count == 0 || max_datagram_size == 0) {
+        return StatusCode::INVALID_ARGUMENT;
+    }
+
+    // Batch and its buffers are in use while receiving
+    if (m_receiving_batch || (m_udp_handle_inited && m_udp_handle->recv_cb != nullptr)) {
+        return StatusCode::OPERATION_ALREADY_IN_PROGRESS;
+    }
+
+    if (datagrams_count == 1 || !UdpReceiveBatch::is_supported()) {
+        m_receive_batch.reset();
+        return Error(0);
+    }
+
+    m_receive_batch.reset(new UdpReceiveBatch(datagrams_count, max_datagram_size));
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+Error UdpImplBase<ParentType, ImplType>::set_send_batch(std::size_t datagrams_count) {
+    if (datagrams_count == 0) {
+        return StatusCode::INVALID_ARGUMENT;
+    }
+
+    if (datagrams_count == 1 || !UdpSendQueue::is_supported()) {
+        flush();
+        m_send_queue.reset();
+        return Error(0);
+    }
+
+    if (m_send_queue) {
+        m_send_queue->set_datagrams_per_call(datagrams_count);
+    } else {
+        m_send_queue.reset(new UdpSendQueue(*m_loop, *m_udp_handle, datagrams_count));
+    }
+
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+void UdpImplBase<ParentType, ImplType>::flush() {
+    if (m_send_queue) {
+        m_send_queue->flush();
+    }
+}
+
+template<typename ParentType, typename ImplType>
+UdpSendQueue* UdpImplBase<ParentType, ImplType>::send_queue() {
+    return m_send_queue.get();
+}
+
+template<typename ParentType, typename ImplType>
+Error UdpImplBase<ParentType, ImplType>::start_receive_impl(uv_udp_recv_cb recv_callback) {
+    const Error receive_start_error = uv_udp_recv_start(m_udp_handle.get(), alloc_read_buffer, recv_callback);
+    if (receive_start_error) {
+        return receive_start_error;
+    }
+
+#ifdef TARM_IO_HAS_UV_UDP_IO_WATCHER
+    // libuv 1.30 has no support of recvmmsg, so readable events of the socket are intercepted here.
+    // Other events (sending) are still processed by libuv.
+    if (m_receive_batch && m_udp_handle->io_watcher.cb != on_batch_io) {
+        m_uv_udp_io_callback = m_udp_handle->io_watcher.cb;
+        m_udp_handle->io_watcher.cb = on_batch_io;
+    }
+#endif
+
+    return Error(0);
+}
+
+template<typename ParentType, typename ImplType>
+void UdpImplBase<ParentType, ImplType>::receive_batches() {
+    for (std::size_t i = 0; i < RECEIVE_BATCHES_PER_EVENT; ++i) {
+        // Receiving may be stopped or handle closed from callbacks
+        if (!is_open() || m_udp_handle->recv_cb == nullptr) {
+            return;
+        }
+
+        const std::size_t buffer_size = m_receive_batch->buffer_size();
+        if (m_read_buf == nullptr || m_read_buf_size < buffer_size) {
+            m_read_buf = m_loop->buffer_pool().acquire(buffer_size);
+            m_read_buf_size = buffer_size;
+        }
+
+        uv_os_fd_t fd = -1;
+        uv_fileno(reinterpret_cast<uv_handle_t*>(m_udp_handle.get()), &fd);
+
+        const int count = m_receive_batch->receive(fd, m_read_buf.get());
+        if (count == 0) {
+            return;
+        }
+
+        const auto prev_use_count = m_read_buf.use_count();
+        m_receiving_batch = true;
+        static_cast<ImplType*>(this)->on_datagrams_received(*m_receive_batch, count);
+        m_receiving_batch = false;
+        release_read_buffer(prev_use_count);
+
+        if (count < static_cast<int>(m_receive_batch->datagrams_count())) {
+            return;
+        }
+    }
+}
+
+template<typename ParentType, typename ImplType>
+void UdpImplBase<ParentType, ImplType>::alloc_read_buffer(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) {
+    auto& this_ = *reinterpret_cast<ImplType*>(handle->data);
+
+    if (this_.m_read_buf == nullptr || this_.m_read_buf_size < suggested_size) {
+        this_.m_read_buf = this_.m_loop->buffer_pool().acquire(suggested_size);
+        this_.m_read_buf_size = suggested_size;
+    }
+
+    buf->base = this_.m_read_buf.get();
+    buf->len = static_cast<decltype(uv_buf_t::len)>(this_.m_read_buf_size); // This cast is OK because suggested size is not more than 64 kB
+}
+
+#ifdef TARM_IO_HAS_UV_UDP_IO_WATCHER
+template<typename ParentType, typename ImplType>
+void UdpImplBase<ParentType, ImplType>::on_batch_io(uv_loop_t* loop, uv__io_t* watcher, unsigned int events) {
+    auto handle = reinterpret_cast<uv_udp_t*>(reinterpret_cast<char*>(watcher) - offsetof(uv_udp_t, io_watcher));
+    auto& this_ = *reinterpret_cast<ImplType*>(handle->data);
+    const auto uv_udp_io_callback = this_.m_uv_udp_io_callback;
+
+    if (events & POLLIN) {
+        this_.receive_batches();
+        events &= ~static_cast<unsigned int>(POLLIN);
+    }
+
+    if (events) {
+        uv_udp_io_callback(loop, watcher, events);
+    }
+}
+#endif
+
 template<typename ParentType, typename ImplType>
 void UdpImplBase<ParentType, ImplType>::on_close_with_removal(uv_handle_t* handle) {
     auto& this_ = *reinterpret_cast<ImplType*>(handle->data);
@@ -0,0 +1,160 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "UdpReceiveBatch.h"
+
+#include "detail/LibuvCompatibility.h"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <assert.h>
+
+#ifdef TARM_IO_HAS_UV_UDP_IO_WATCHER
+    #include <sys/socket.h>
+#endif
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+#ifdef TARM_IO_HAS_UV_UDP_IO_WATCHER
+
+struct UdpReceiveBatch::Impl {
+    Impl(std::size_t datagrams_count, std::size_t max_datagram_size) :
+        max_datagram_size(max_datagram_size),
+        headers(datagrams_count),
+        iovecs(datagrams_count),
+        addresses(datagrams_count) {
+        for (std::size_t i = 0; i < datagrams_count; ++i) {
+            std::memset(&headers[i], 0, sizeof(headers[i]));
+            headers[i].msg_hdr.msg_name = &addresses[i];
+            headers[i].msg_hdr.msg_iov = &iovecs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+            iovecs[i].iov_len = max_datagram_size;
+        }
+    }
+
+    std::size_t max_datagram_size;
+    std::vector<::mmsghdr> headers;
+    std::vector<::iovec> iovecs;
+    std::vector<::sockaddr_storage> addresses;
+};
+
+UdpReceiveBatch::UdpReceiveBatch(std::size_t datagrams_count, std::size_t max_datagram_size) :
+    m_impl(new Impl(datagrams_count, max_datagram_size)) {
+}
+
+bool UdpReceiveBatch::is_supported() {
+    return true;
+}
+
+std::size_t UdpReceiveBatch::datagrams_count() const {
+    return m_impl->headers.size();
+}
+
+std::size_t UdpReceiveBatch::max_datagram_size() const {
+    return m_impl->max_datagram_size;
+}
+
+int UdpReceiveBatch::receive(uv_os_fd_t fd, char* buffer) {
+    auto& headers = m_impl->headers;
+
+    for (std::size_t i = 0; i < headers.size(); ++i) {
+        m_impl->iovecs[i].iov_base = buffer + i * m_impl->max_datagram_size;
+        headers[i].msg_hdr.msg_namelen = sizeof(::sockaddr_storage);
+        headers[i].msg_hdr.msg_flags = 0;
+        headers[i].msg_len = 0;
+    }
+
+    int result = 0;
+    do {
+        result = ::recvmmsg(fd, headers.data(), static_cast<unsigned int>(headers.size()), 0, nullptr);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+
+        return uv_translate_sys_error(errno);
+    }
+
+    return result;
+}
+
+std::size_t UdpReceiveBatch::datagram_size(std::size_t index) const {
+    assert(index < m_impl->headers.size());
+    return m_impl->headers[index].msg_len;
+}
+
+bool UdpReceiveBatch::is_truncated(std::size_t index) const {
+    assert(index < m_impl->headers.size());
+    return m_impl->headers[index].msg_hdr.msg_flags & MSG_TRUNC;
+}
+
+const struct sockaddr* UdpReceiveBatch::address(std::size_t index) const {
+    assert(index < m_impl->headers.size());
+    if (m_impl->headers[index].msg_hdr.msg_namelen == 0) {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const struct sockaddr*>(&m_impl->addresses[index]);
+}
+
+#else
+
+struct UdpReceiveBatch::Impl {
+    std::size_t datagrams_count;
+    std::size_t max_datagram_size;
+};
+
+UdpReceiveBatch::UdpReceiveBatch(std::size_t datagrams_count, std::size_t max_datagram_size) :
+    m_impl(new Impl{datagrams_count, max_datagram_size}) {
+}
+
+bool UdpReceiveBatch::is_supported() {
+    return false;
+}
+
+std::size_t UdpReceiveBatch::datagrams_count() const {
+    return m_impl->datagrams_count;
+}
+
+std::size_t UdpReceiveBatch::max_datagram_size() const {
+    return m_impl->max_datagram_size;
+}
+
+int UdpReceiveBatch::receive(uv_os_fd_t, char*) {
+    return UV_ENOSYS;
+}
+
+std::size_t UdpReceiveBatch::datagram_size(std::size_t) const {
+    return 0;
+}
+
+bool UdpReceiveBatch::is_truncated(std::size_t) const {
+    return false;
+}
+
+const struct sockaddr* UdpReceiveBatch::address(std::size_t) const {
+    return nullptr;
+}
+
+#endif
+
+UdpReceiveBatch::~UdpReceiveBatch() {
+}
+
+std::size_t UdpReceiveBatch::buffer_size() const {
+    return datagrams_count() * max_datagram_size();
+}
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
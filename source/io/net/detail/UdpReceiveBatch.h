@@ -0,0 +1,53 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+
+#include <uv.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+// Receives multiple datagrams with a single system call (recvmmsg) into one contiguous buffer,
+// datagram with index i is placed at offset i * max_datagram_size.
+class UdpReceiveBatch {
+public:
+    TARM_IO_FORBID_COPY(UdpReceiveBatch);
+    TARM_IO_FORBID_MOVE(UdpReceiveBatch);
+
+    UdpReceiveBatch(std::size_t datagrams_count, std::size_t max_datagram_size);
+    ~UdpReceiveBatch();
+
+    // Returns false if batched receive is not available on the current platform.
+    static bool is_supported();
+
+    std::size_t datagrams_count() const;
+    std::size_t max_datagram_size() const;
+    std::size_t buffer_size() const;
+
+    // Returns number of received datagrams, 0 if there is no data or negative libuv error code.
+    int receive(uv_os_fd_t fd, char* buffer);
+
+    // Accessors for datagrams of the last receive call
+    std::size_t datagram_size(std::size_t index) const;
+    bool is_truncated(std::size_t index) const;
+    const struct sockaddr* address(std::size_t index) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,215 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "UdpSendQueue.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <assert.h>
+
+#ifdef TARM_IO_PLATFORM_LINUX
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+#endif
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+#ifdef TARM_IO_PLATFORM_LINUX
+
+struct UdpSendQueue::Impl {
+    std::vector<::mmsghdr> headers;
+};
+
+#else
+
+struct UdpSendQueue::Impl {
+};
+
+#endif
+
+UdpSendQueue::UdpSendQueue(EventLoop& loop, uv_udp_t& handle, std::size_t datagrams_per_call) :
+    m_loop(&loop),
+    m_handle(&handle),
+    m_impl(new Impl) {
+    set_datagrams_per_call(datagrams_per_call);
+}
+
+UdpSendQueue::~UdpSendQueue() {
+    cancel();
+}
+
+bool UdpSendQueue::is_supported() {
+#ifdef TARM_IO_PLATFORM_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::size_t UdpSendQueue::datagrams_per_call() const {
+#ifdef TARM_IO_PLATFORM_LINUX
+    return m_impl->headers.size();
+#else
+    return 1;
+#endif
+}
+
+void UdpSendQueue::set_datagrams_per_call(std::size_t datagrams_per_call) {
+    assert(datagrams_per_call > 0);
+#ifdef TARM_IO_PLATFORM_LINUX
+    m_impl->headers.resize(datagrams_per_call);
+#endif
+}
+
+std::size_t UdpSendQueue::size() const {
+    return m_queue.size();
+}
+
+void UdpSendQueue::push(uv_udp_send_t* request, const uv_buf_t* buf, const struct sockaddr* address, uv_udp_send_cb callback) {
+    request->handle = m_handle;
+    m_queue.push_back({request, buf, address, callback, 0});
+    schedule_flush();
+}
+
+void UdpSendQueue::schedule_flush() {
+    if (m_flush_scheduled) {
+        return;
+    }
+
+    m_flush_scheduled = true;
+
+    // Queue may be destroyed together with its owner before the callback is executed
+    std::weak_ptr<UdpSendQueue> weak_this = shared_from_this();
+    m_loop->schedule_callback([weak_this](EventLoop&) {
+        auto this_ = weak_this.lock();
+        if (this_) {
+            this_->m_flush_scheduled = false;
+            this_->flush();
+        }
+    });
+}
+
+void UdpSendQueue::flush() {
+    if (m_flushing || m_queue.empty()) {
+        return;
+    }
+
+    m_flushing = true;
+    m_sending.swap(m_queue);
+
+    if (uv_is_closing(reinterpret_cast<uv_handle_t*>(m_handle))) {
+        for (auto& datagram : m_sending) {
+            datagram.status = UV_ECANCELED;
+        }
+    } else {
+        send_datagrams();
+    }
+
+    // Callbacks are called when all datagrams are sent because they may close the handle or send more data
+    for (auto& datagram : m_sending) {
+        if (datagram.status != STATUS_PASSED_TO_LIBUV) {
+            datagram.callback(datagram.request, datagram.status);
+        }
+    }
+
+    m_sending.clear();
+    m_flushing = false;
+
+    if (!m_queue.empty()) {
+        schedule_flush();
+    }
+}
+
+void UdpSendQueue::cancel() {
+    while (!m_queue.empty()) {
+        std::vector<Datagram> datagrams;
+        datagrams.swap(m_queue);
+        for (auto& datagram : datagrams) {
+            datagram.callback(datagram.request, UV_ECANCELED);
+        }
+    }
+}
+
+void UdpSendQueue::send_with_libuv(Datagram& datagram) {
+    const int status = uv_udp_send(datagram.request, m_handle, datagram.buf, 1, datagram.address, datagram.callback);
+    datagram.status = status < 0 ? status : STATUS_PASSED_TO_LIBUV;
+}
+
+#ifdef TARM_IO_PLATFORM_LINUX
+
+void UdpSendQueue::send_datagrams() {
+    uv_os_fd_t fd = -1;
+    const int fileno_status = uv_fileno(reinterpret_cast<uv_handle_t*>(m_handle), &fd);
+
+    // If libuv still has pending datagrams from previous flushes, they should be sent first to preserve order
+    const bool send_with_sendmmsg = fileno_status == 0 && m_handle->send_queue_count == 0;
+
+    auto& headers = m_impl->headers;
+    std::size_t index = 0;
+
+    while (send_with_sendmmsg && index < m_sending.size()) {
+        const std::size_t count = (std::min)(m_sending.size() - index, headers.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& datagram = m_sending[index + i];
+            auto& header = headers[i].msg_hdr;
+            std::memset(&headers[i], 0, sizeof(headers[i]));
+            // Address is null for connected sockets.
+            // const_cast is a workaround for lack of constness in msghdr, data is not modified.
+            if (datagram.address) {
+                header.msg_name = const_cast<struct sockaddr*>(datagram.address);
+                header.msg_namelen = datagram.address->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6)
+                                                                              : sizeof(struct sockaddr_in);
+            }
+            // uv_buf_t is ABI compatible with iovec on Unix, libuv relies on this too
+            header.msg_iov = reinterpret_cast<struct iovec*>(const_cast<uv_buf_t*>(datagram.buf));
+            header.msg_iovlen = 1;
+        }
+
+        int result = 0;
+        do {
+            result = ::sendmmsg(fd, headers.data(), static_cast<unsigned int>(count), 0);
+        } while (result == -1 && errno == EINTR);
+
+        if (result > 0) {
+            for (std::size_t i = 0; i < std::size_t(result); ++i) {
+                m_sending[index + i].status = 0;
+            }
+            index += std::size_t(result);
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+
+        // Error is related to the first datagram, the rest ones are tried again
+        m_sending[index].status = uv_translate_sys_error(errno);
+        ++index;
+    }
+
+    for (; index < m_sending.size(); ++index) {
+        send_with_libuv(m_sending[index]);
+    }
+}
+
+#else
+
+void UdpSendQueue::send_datagrams() {
+    for (auto& datagram : m_sending) {
+        send_with_libuv(datagram);
+    }
+}
+
+#endif
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
@@ -0,0 +1,85 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "CommonMacros.h"
+#include "EventLoop.h"
+
+#include <uv.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace tarm {
+namespace io {
+namespace net {
+namespace detail {
+
+// Collects datagrams sent during a loop cycle and sends them with as few system calls as possible (sendmmsg).
+// Queue is flushed automatically at the end of the loop cycle (see EventLoop::schedule_callback) or explicitly.
+// Send requests are regular libuv requests, on completion their callbacks are called the same way as libuv does.
+// If socket buffer is full, remaining datagrams are passed to libuv which sends them when socket becomes writable.
+class UdpSendQueue : public std::enable_shared_from_this<UdpSendQueue> {
+public:
+    TARM_IO_FORBID_COPY(UdpSendQueue);
+    TARM_IO_FORBID_MOVE(UdpSendQueue);
+
+    UdpSendQueue(EventLoop& loop, uv_udp_t& handle, std::size_t datagrams_per_call);
+    ~UdpSendQueue();
+
+    // Returns false if batched send is not available on the current platform.
+    static bool is_supported();
+
+    std::size_t datagrams_per_call() const;
+    void set_datagrams_per_call(std::size_t datagrams_per_call);
+
+    std::size_t size() const;
+
+    // Request, buffer and address should remain valid until callback is called.
+    // Address is nullptr for connected sockets.
+    void push(uv_udp_send_t* request, const uv_buf_t* buf, const struct sockaddr* address, uv_udp_send_cb callback);
+
+    // Sends all queued datagrams and calls callbacks of completed ones.
+    // Datagrams queued from those callbacks are sent by next flush.
+    void flush();
+
+    // Completes all queued datagrams with UV_ECANCELED status.
+    void cancel();
+
+private:
+    struct Datagram {
+        uv_udp_send_t* request;
+        const uv_buf_t* buf;
+        const struct sockaddr* address;
+        uv_udp_send_cb callback;
+        int status;
+    };
+
+    // Status of datagrams which are handed over to libuv, their callbacks are called by libuv
+    static const int STATUS_PASSED_TO_LIBUV = 1;
+
+    void send_datagrams();
+    void send_with_libuv(Datagram& datagram);
+    void schedule_flush();
+
+    EventLoop* m_loop = nullptr;
+    uv_udp_t* m_handle = nullptr;
+
+    std::vector<Datagram> m_queue;
+    std::vector<Datagram> m_sending;
+
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+
+    bool m_flush_scheduled = false;
+    bool m_flushing = false;
+};
+
+} // namespace detail
+} // namespace net
+} // namespace io
+} // namespace tarm
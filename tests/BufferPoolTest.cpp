@@ -0,0 +1,177 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "UTCommon.h"
+
+#include "BufferPool.h"
+
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct BufferPoolTest : public testing::Test,
+                        public LogRedirector {
+};
+
+TEST_F(BufferPoolTest, default_state) {
+    io::BufferPool pool;
+    EXPECT_EQ(io::BufferPool::DEFAULT_SIZE_CLASSES, pool.size_classes());
+    EXPECT_EQ(io::BufferPool::DEFAULT_MAX_FREE_BUFFERS_PER_CLASS, pool.max_free_buffers_per_class());
+    EXPECT_EQ(0, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, buffer_is_reused) {
+    io::BufferPool pool;
+
+    auto buf_1 = pool.acquire(1000);
+    ASSERT_TRUE(buf_1);
+    std::memset(buf_1.get(), 'a', 1000);
+    const char* const raw_ptr = buf_1.get();
+    EXPECT_EQ(0, pool.free_buffers_count());
+
+    buf_1.reset();
+    EXPECT_EQ(1, pool.free_buffers_count());
+
+    auto buf_2 = pool.acquire(1000);
+    EXPECT_EQ(raw_ptr, buf_2.get());
+    EXPECT_EQ(0, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, buffer_is_returned_when_last_reference_dropped) {
+    io::BufferPool pool;
+
+    auto buf = pool.acquire(100);
+    std::shared_ptr<const char> copy_1 = buf;
+    std::shared_ptr<const char> copy_2 = copy_1;
+
+    buf.reset();
+    copy_1.reset();
+    EXPECT_EQ(0, pool.free_buffers_count());
+
+    copy_2.reset();
+    EXPECT_EQ(1, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, size_classes) {
+    io::BufferPool pool;
+    pool.set_size_classes({1024, 0, 64, 256, 64});
+    EXPECT_EQ(std::vector<std::size_t>({64, 256, 1024}), pool.size_classes());
+
+    // 100 bytes are rounded up to 256 class, so buffer is reused for requests up to 256
+    auto buf_1 = pool.acquire(100);
+    const char* const raw_ptr_1 = buf_1.get();
+    buf_1.reset();
+
+    auto buf_2 = pool.acquire(10);
+    EXPECT_NE(raw_ptr_1, buf_2.get());
+    auto buf_3 = pool.acquire(256);
+    EXPECT_EQ(raw_ptr_1, buf_3.get());
+    buf_2.reset();
+    buf_3.reset();
+    EXPECT_EQ(2, pool.free_buffers_count());
+
+    // Changing classes releases free buffers
+    pool.set_size_classes({128});
+    EXPECT_EQ(0, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, buffer_does_not_match_changed_classes) {
+    io::BufferPool pool;
+    pool.set_size_classes({64});
+
+    auto buf = pool.acquire(64);
+    pool.set_size_classes({128});
+    buf.reset();
+    EXPECT_EQ(0, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, size_bigger_than_max_class) {
+    io::BufferPool pool;
+    pool.set_size_classes({64});
+
+    auto buf = pool.acquire(1024 * 1024);
+    ASSERT_TRUE(buf);
+    std::memset(buf.get(), 'a', 1024 * 1024);
+    buf.reset();
+
+    EXPECT_EQ(0, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, max_free_buffers_per_class) {
+    io::BufferPool pool;
+    pool.set_size_classes({64, 128});
+    pool.set_max_free_buffers_per_class(2);
+    EXPECT_EQ(2, pool.max_free_buffers_per_class());
+
+    std::vector<std::shared_ptr<char>> buffers;
+    for (std::size_t i = 0; i < 4; ++i) {
+        buffers.push_back(pool.acquire(64));
+        buffers.push_back(pool.acquire(128));
+    }
+    buffers.clear();
+    EXPECT_EQ(4, pool.free_buffers_count());
+
+    pool.set_max_free_buffers_per_class(1);
+    EXPECT_EQ(2, pool.free_buffers_count());
+
+    pool.set_max_free_buffers_per_class(0);
+    EXPECT_EQ(0, pool.free_buffers_count());
+    buffers.push_back(pool.acquire(64));
+    buffers.clear();
+    EXPECT_EQ(0, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, buffer_outlives_pool) {
+    std::shared_ptr<char> buf;
+
+    {
+        io::BufferPool pool;
+        buf = pool.acquire(100);
+        auto free_buf = pool.acquire(100);
+    }
+
+    std::memset(buf.get(), 'a', 100);
+    buf.reset();
+}
+
+TEST_F(BufferPoolTest, release_from_other_thread) {
+    const std::size_t BUFFERS_COUNT = 16;
+
+    io::BufferPool pool;
+
+    std::vector<std::shared_ptr<char>> buffers;
+    for (std::size_t i = 0; i < BUFFERS_COUNT; ++i) {
+        buffers.push_back(pool.acquire(100));
+    }
+
+    std::thread thread([&buffers]() {
+        buffers.clear();
+    });
+    thread.join();
+
+    EXPECT_EQ(BUFFERS_COUNT, pool.free_buffers_count());
+}
+
+TEST_F(BufferPoolTest, no_allocations_after_warm_up) {
+    const std::size_t BUFFERS_COUNT = 8;
+
+    io::BufferPool pool;
+
+    std::vector<std::shared_ptr<char>> buffers;
+    buffers.reserve(BUFFERS_COUNT);
+
+    for (std::size_t i = 0; i < BUFFERS_COUNT; ++i) {
+        buffers.push_back(pool.acquire(64 * 1024));
+    }
+    buffers.clear();
+
+    const auto allocations_before = allocations_count();
+    for (std::size_t i = 0; i < BUFFERS_COUNT; ++i) {
+        buffers.push_back(pool.acquire(64 * 1024));
+    }
+    buffers.clear();
+    EXPECT_EQ(0, allocations_count() - allocations_before);
+}
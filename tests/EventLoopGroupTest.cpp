@@ -0,0 +1,74 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "UTCommon.h"
+
+#include "EventLoopGroup.h"
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+struct EventLoopGroupTest : public testing::Test,
+                            public LogRedirector {
+};
+
+TEST_F(EventLoopGroupTest, constructor) {
+    io::EventLoopGroup group_1(3);
+    EXPECT_EQ(3, group_1.size());
+
+    io::EventLoopGroup group_2;
+    EXPECT_GE(group_2.size(), 1);
+}
+
+TEST_F(EventLoopGroupTest, run_without_work) {
+    io::EventLoopGroup group(4);
+    ASSERT_EQ(io::StatusCode::OK, group.run());
+}
+
+TEST_F(EventLoopGroupTest, loops_are_different) {
+    io::EventLoopGroup group(3);
+    EXPECT_NE(&group.loop(0), &group.loop(1));
+    EXPECT_NE(&group.loop(1), &group.loop(2));
+    EXPECT_NE(&group.loop(0), &group.loop(2));
+}
+
+TEST_F(EventLoopGroupTest, execute_on_each_loop_thread) {
+    io::EventLoopGroup group(4);
+
+    std::mutex mutex;
+    std::set<std::thread::id> thread_ids;
+    std::set<io::EventLoop*> loops;
+
+    group.execute_on_each_loop_thread([&](io::EventLoop& loop) {
+        std::lock_guard<std::mutex> guard(mutex);
+        thread_ids.insert(std::this_thread::get_id());
+        loops.insert(&loop);
+    });
+
+    ASSERT_EQ(io::StatusCode::OK, group.run());
+
+    EXPECT_EQ(4, thread_ids.size());
+    EXPECT_EQ(1, thread_ids.count(std::this_thread::get_id())); // First loop is executed on the calling thread
+    EXPECT_EQ(4, loops.size());
+}
+
+TEST_F(EventLoopGroupTest, execute_on_each_loop_thread_from_other_thread) {
+    io::EventLoopGroup group(2);
+
+    for (std::size_t i = 0; i < group.size(); ++i) {
+        group.loop(i).start_block_loop_from_exit();
+    }
+
+    std::thread thread([&group]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        group.execute_on_each_loop_thread([](io::EventLoop& loop) {
+            loop.stop_block_loop_from_exit();
+        });
+    });
+
+    ASSERT_EQ(io::StatusCode::OK, group.run());
+    thread.join();
+}
@@ -7,9 +7,11 @@
 
 #include "EventLoop.h"
 #include "ScopeExitGuard.h"
+#include "Timer.h"
 
 #include <atomic>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -465,6 +467,68 @@ TEST_F(EventLoopTest, execute_on_loop_thread_from_other_thread) {
     EXPECT_TRUE(execute_on_loop_thread_called);
 }
 
+TEST_F(EventLoopTest, execute_on_loop_thread_bulk) {
+    io::EventLoop loop;
+
+    std::vector<int> order;
+
+    std::vector<io::EventLoop::WorkCallback> callbacks;
+    for (int i = 0; i < 5; ++i) {
+        callbacks.push_back([&order, i](io::EventLoop&) {
+            order.push_back(i);
+        });
+    }
+
+    loop.execute_on_loop_thread([&order](io::EventLoop&) {
+        order.push_back(-1);
+    });
+    loop.execute_on_loop_thread(std::move(callbacks));
+    loop.execute_on_loop_thread(std::vector<io::EventLoop::WorkCallback>());
+
+    EXPECT_TRUE(order.empty());
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+    EXPECT_EQ(std::vector<int>({-1, 0, 1, 2, 3, 4}), order);
+}
+
+TEST_F(EventLoopTest, execute_on_loop_thread_from_many_threads) {
+    io::EventLoop loop;
+
+    const std::size_t THREADS_COUNT = 4;
+    const std::size_t CALLBACKS_PER_THREAD = 10000;
+
+    std::size_t counter = 0;
+    std::vector<std::size_t> last_value_per_thread(THREADS_COUNT, 0);
+    bool order_is_preserved = true;
+
+    loop.start_block_loop_from_exit(); // need to hold loop running
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < THREADS_COUNT; ++i) {
+        threads.emplace_back([&, i]() {
+            for (std::size_t j = 1; j <= CALLBACKS_PER_THREAD; ++j) {
+                loop.execute_on_loop_thread([&, i, j](io::EventLoop& loop) {
+                    order_is_preserved = order_is_preserved && last_value_per_thread[i] + 1 == j;
+                    last_value_per_thread[i] = j;
+
+                    if (++counter == THREADS_COUNT * CALLBACKS_PER_THREAD) {
+                        loop.stop_block_loop_from_exit();
+                    }
+                });
+            }
+        });
+    }
+
+    io::ScopeExitGuard scope_guard([&threads](){
+        for (auto& t : threads) {
+            t.join();
+        }
+    });
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+    EXPECT_EQ(THREADS_COUNT * CALLBACKS_PER_THREAD, counter);
+    EXPECT_TRUE(order_is_preserved);
+}
+
 TEST_F(EventLoopTest, run_loop_several_times) {
     io::EventLoop loop;
 
@@ -637,6 +701,40 @@ TEST_F(EventLoopTest, schedule_multiple_callbacks_sequential) {
     EXPECT_EQ(1, callback_counter_3);
 }
 
+TEST_F(EventLoopTest, schedule_callback_from_io_callback_is_executed_before_next_loop_iteration) {
+    io::EventLoop loop;
+
+    std::vector<std::string> calls_order;
+
+    loop.start_block_loop_from_exit();
+
+    std::thread thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        loop.execute_on_loop_thread([&](io::EventLoop&) {
+            // Timer with zero timeout fires at the beginning of the next loop iteration
+            auto timer = new io::Timer(loop);
+            timer->start(0, [&](io::Timer& timer) {
+                calls_order.push_back("timer");
+                timer.schedule_removal();
+            });
+
+            loop.schedule_callback([&](io::EventLoop&) {
+                calls_order.push_back("callback");
+            });
+
+            loop.stop_block_loop_from_exit();
+        });
+    });
+
+    EXPECT_EQ(io::StatusCode::OK, loop.run());
+    thread.join();
+
+    ASSERT_EQ(2, calls_order.size());
+    EXPECT_EQ("callback", calls_order[0]);
+    EXPECT_EQ("timer", calls_order[1]);
+}
+
 TEST_F(EventLoopTest, create_loop_in_one_thread_and_run_in_another) {
     io::EventLoop loop;
 
@@ -0,0 +1,130 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "UTCommon.h"
+
+#include "detail/MpscQueue.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Node : public io::detail::MpscQueueNode {
+    Node(std::size_t v = 0) :
+        value(v) {
+    }
+
+    std::size_t value;
+};
+
+} // namespace
+
+struct MpscQueueTest : public testing::Test,
+                       public LogRedirector {
+};
+
+TEST_F(MpscQueueTest, default_state) {
+    io::detail::MpscQueue queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.pop());
+}
+
+TEST_F(MpscQueueTest, push_pop_single_thread) {
+    io::detail::MpscQueue queue;
+
+    std::vector<Node> nodes(5);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].value = i;
+    }
+
+    for (auto& node : nodes) {
+        queue.push(&node);
+    }
+    EXPECT_FALSE(queue.empty());
+
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        auto node = static_cast<Node*>(queue.pop());
+        ASSERT_NE(nullptr, node);
+        EXPECT_EQ(i, node->value);
+    }
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.pop());
+
+    // Queue is reusable after it was drained
+    queue.push(&nodes[3]);
+    EXPECT_FALSE(queue.empty());
+    EXPECT_EQ(&nodes[3], queue.pop());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MpscQueueTest, push_chain) {
+    io::detail::MpscQueue queue;
+
+    Node n0(0);
+    Node n1(1);
+    Node n2(2);
+    Node n3(3);
+
+    queue.push(&n0);
+
+    n1.next = &n2;
+    n2.next = &n3;
+    queue.push_chain(&n1, &n3);
+
+    EXPECT_EQ(&n0, queue.pop());
+    EXPECT_EQ(&n1, queue.pop());
+    EXPECT_EQ(&n2, queue.pop());
+    EXPECT_EQ(&n3, queue.pop());
+    EXPECT_EQ(nullptr, queue.pop());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MpscQueueTest, multiple_producers) {
+    io::detail::MpscQueue queue;
+
+    const std::size_t PRODUCERS_COUNT = 4;
+    const std::size_t NODES_PER_PRODUCER = 50000;
+
+    std::vector<Node> nodes(PRODUCERS_COUNT * NODES_PER_PRODUCER);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].value = i;
+    }
+
+    std::vector<std::thread> producers;
+    for (std::size_t i = 0; i < PRODUCERS_COUNT; ++i) {
+        producers.emplace_back([&queue, &nodes, i]() {
+            for (std::size_t j = 0; j < NODES_PER_PRODUCER; ++j) {
+                queue.push(&nodes[i * NODES_PER_PRODUCER + j]);
+            }
+        });
+    }
+
+    // Items of each producer should be received in order
+    std::vector<std::size_t> next_expected(PRODUCERS_COUNT, 0);
+    std::size_t popped_count = 0;
+    bool order_is_preserved = true;
+    while (popped_count < PRODUCERS_COUNT * NODES_PER_PRODUCER) {
+        auto node = static_cast<Node*>(queue.pop());
+        if (node == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto producer = node->value / NODES_PER_PRODUCER;
+        order_is_preserved = order_is_preserved && node->value % NODES_PER_PRODUCER == next_expected[producer];
+        ++next_expected[producer];
+        ++popped_count;
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    EXPECT_TRUE(order_is_preserved);
+    EXPECT_EQ(nullptr, queue.pop());
+    EXPECT_TRUE(queue.empty());
+}
@@ -109,3 +109,43 @@ TEST_F(RemovableTest, change_callback_after_schedule_removal) {
     EXPECT_EQ(0, callback_1_counter);
     EXPECT_EQ(1, callback_2_counter);
 }
+
+TEST_F(RemovableTest, schedule_removal_of_many_objects) {
+    io::EventLoop loop;
+
+    const std::size_t OBJECTS_COUNT = 10000;
+
+    std::unique_ptr<bool[]> disposed(new bool[OBJECTS_COUNT]);
+    for (std::size_t i = 0; i < OBJECTS_COUNT; ++i) {
+        disposed[i] = false;
+        auto removable = new TestRemovable(loop, disposed[i]);
+        removable->schedule_removal();
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    for (std::size_t i = 0; i < OBJECTS_COUNT; ++i) {
+        ASSERT_TRUE(disposed[i]) << "i=" << i;
+    }
+}
+
+TEST_F(RemovableTest, schedule_removal_from_removal_callback) {
+    io::EventLoop loop;
+
+    bool disposed_1 = false;
+    bool disposed_2 = false;
+
+    auto removable_1 = new TestRemovable(loop, disposed_1);
+    auto removable_2 = new TestRemovable(loop, disposed_2);
+
+    removable_1->set_on_schedule_removal([&](const io::Removable&) {
+        EXPECT_FALSE(disposed_1);
+        removable_2->schedule_removal();
+    });
+    removable_1->schedule_removal();
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_TRUE(disposed_1);
+    EXPECT_TRUE(disposed_2);
+}
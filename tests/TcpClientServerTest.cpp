@@ -5,16 +5,29 @@
 
 #include "UTCommon.h"
 
+#include "fs/File.h"
 #include "net/Tcp.h"
+#include "net/detail/TcpPipe.h"
+#include "ByteSwap.h"
 #include "ScopeExitGuard.h"
 #include "Timer.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <thread>
 #include <vector>
 
+#ifndef TARM_IO_PLATFORM_WINDOWS
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
 struct TcpClientServerTest : public testing::Test,
                              public LogRedirector {
 
@@ -118,6 +131,185 @@ TEST_F(TcpClientServerTest, server_address_in_use) {
     ASSERT_EQ(io::StatusCode::OK, loop.run());
 }
 
+TEST_F(TcpClientServerTest, server_reuse_port) {
+    TARM_IO_TEST_SKIP_ON_WINDOWS();
+
+    io::EventLoop loop;
+
+    auto server_1 = new io::net::TcpServer(loop);
+    EXPECT_FALSE(server_1->is_reuse_port());
+    server_1->set_reuse_port(true);
+    EXPECT_TRUE(server_1->is_reuse_port());
+    auto listen_error_1 = server_1->listen({m_default_addr, m_default_port}, nullptr, nullptr, nullptr);
+    EXPECT_FALSE(listen_error_1) << listen_error_1;
+
+    auto server_2 = new io::net::TcpServer(loop);
+    server_2->set_reuse_port(true);
+    auto listen_error_2 = server_2->listen({m_default_addr, m_default_port}, nullptr, nullptr, nullptr);
+    EXPECT_FALSE(listen_error_2) << listen_error_2;
+
+    // Both servers should set option
+    auto server_3 = new io::net::TcpServer(loop);
+    auto listen_error_3 = server_3->listen({m_default_addr, m_default_port}, nullptr, nullptr, nullptr);
+    EXPECT_EQ(io::StatusCode::ADDRESS_ALREADY_IN_USE, listen_error_3.code());
+
+    server_1->schedule_removal();
+    server_2->schedule_removal();
+    server_3->schedule_removal();
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+}
+
+TEST_F(TcpClientServerTest, server_group_echo) {
+    TARM_IO_TEST_SKIP_ON_WINDOWS();
+
+    const std::size_t LOOPS_COUNT = 2;
+    const std::size_t CLIENTS_COUNT = 32;
+    const std::string message = "Hello!";
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::mutex mutex;
+    std::set<std::thread::id> server_thread_ids;
+    std::size_t server_connections_count = 0;
+
+    io::net::TcpServerGroup server(group);
+    auto listen_error = server.listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            std::lock_guard<std::mutex> guard(mutex);
+            ++server_connections_count;
+        },
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                server_thread_ids.insert(std::this_thread::get_id());
+            }
+            client.send_data(std::string(data.buf.get(), data.size));
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+    EXPECT_EQ(LOOPS_COUNT, server.size());
+    EXPECT_EQ(m_default_port, server.endpoint().port());
+
+    io::Error group_run_error;
+    std::thread group_thread([&]() {
+        group_run_error = group.run();
+    });
+
+    io::EventLoop client_loop;
+    std::size_t echo_received_count = 0;
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::TcpClient(client_loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data(message);
+            },
+            [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                EXPECT_EQ(message, std::string(data.buf.get(), data.size));
+                client.schedule_removal();
+
+                if (++echo_received_count == CLIENTS_COUNT) {
+                    server.schedule_removal();
+                }
+            }
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, client_loop.run());
+    group_thread.join();
+
+    EXPECT_FALSE(group_run_error) << group_run_error;
+    EXPECT_EQ(CLIENTS_COUNT, echo_received_count);
+    EXPECT_EQ(CLIENTS_COUNT, server_connections_count);
+    // Connections should be distributed between loops
+    EXPECT_EQ(LOOPS_COUNT, server_thread_ids.size());
+    EXPECT_EQ(0, server_thread_ids.count(std::this_thread::get_id()));
+}
+
+TEST_F(TcpClientServerTest, server_group_listen_on_port_0) {
+    TARM_IO_TEST_SKIP_ON_WINDOWS();
+
+    const std::size_t LOOPS_COUNT = 2;
+    const std::size_t CLIENTS_COUNT = 32;
+    const std::string message = "Hello!";
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::mutex mutex;
+    std::set<std::thread::id> server_thread_ids;
+
+    io::net::TcpServerGroup server(group);
+    auto listen_error = server.listen({m_default_addr, 0},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                server_thread_ids.insert(std::this_thread::get_id());
+            }
+            client.send_data(std::string(data.buf.get(), data.size));
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+    ASSERT_EQ(LOOPS_COUNT, server.size());
+
+    // All servers share the port assigned by the system
+    const auto port = server.endpoint().port();
+    EXPECT_NE(0, port);
+    for (std::size_t i = 0; i < LOOPS_COUNT; ++i) {
+        EXPECT_EQ(port, server.server(i).endpoint().port());
+    }
+
+    io::Error group_run_error;
+    std::thread group_thread([&]() {
+        group_run_error = group.run();
+    });
+
+    io::EventLoop client_loop;
+    std::size_t echo_received_count = 0;
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::TcpClient(client_loop);
+        client->connect({m_default_addr, port},
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                if (error) {
+                    client.schedule_removal();
+                    if (++echo_received_count == CLIENTS_COUNT) {
+                        server.schedule_removal();
+                    }
+                    return;
+                }
+                client.send_data(message);
+            },
+            [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                EXPECT_EQ(message, std::string(data.buf.get(), data.size));
+                client.schedule_removal();
+
+                if (++echo_received_count == CLIENTS_COUNT) {
+                    server.schedule_removal();
+                }
+            }
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, client_loop.run());
+    group_thread.join();
+
+    EXPECT_FALSE(group_run_error) << group_run_error;
+    EXPECT_EQ(CLIENTS_COUNT, echo_received_count);
+    // Connections should be distributed between loops
+    EXPECT_EQ(LOOPS_COUNT, server_thread_ids.size());
+}
+
 TEST_F(TcpClientServerTest, client_connect_to_invalid_address) {
     io::EventLoop loop;
 
@@ -257,6 +449,125 @@ TEST_F(TcpClientServerTest, client_send_data_via_unique_ptr) {
     EXPECT_EQ(MESSAGES_COUNT * str.size(), total_bytes_received);
 }
 
+TEST_F(TcpClientServerTest, client_send_data_via_buffer_list) {
+    const std::string header = "HEADER:";
+    const std::string body = "body of the message";
+    const std::string footer = ":FOOTER";
+    const std::string expected = header + body + footer + header;
+
+    io::EventLoop loop;
+
+    std::string received_message;
+    std::size_t client_on_send_count = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_message.append(data.buf.get(), data.size);
+            if (received_message.size() == expected.size()) {
+                server->schedule_removal();
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            std::shared_ptr<char> shared_body(new char[body.size()], std::default_delete<char[]>());
+            std::memcpy(shared_body.get(), body.c_str(), body.size());
+            std::unique_ptr<char[]> unique_footer(new char[footer.size()]);
+            std::memcpy(unique_footer.get(), footer.c_str(), footer.size());
+
+            std::vector<io::SendBuffer> buffers;
+            buffers.emplace_back(std::string(header));
+            buffers.emplace_back(shared_body, static_cast<std::uint32_t>(body.size()));
+            buffers.emplace_back(std::move(unique_footer), static_cast<std::uint32_t>(footer.size()));
+            buffers.emplace_back(header.c_str(), static_cast<std::uint32_t>(header.size()));
+
+            client.send_data(std::move(buffers),
+                [&](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    EXPECT_EQ(0, client.pending_send_requesets());
+                    ++client_on_send_count;
+                    client.schedule_removal();
+                }
+            );
+            EXPECT_EQ(1, client.pending_send_requesets());
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(1, client_on_send_count);
+    EXPECT_EQ(expected, received_message);
+}
+
+TEST_F(TcpClientServerTest, client_send_data_via_long_buffer_list) {
+    // More buffers than a single sendmsg/writev accepts (IOV_MAX is 1024 on Linux)
+    const std::size_t BUFFERS_COUNT = 5000;
+
+    std::string expected;
+    for (std::size_t i = 0; i < BUFFERS_COUNT; ++i) {
+        expected.push_back(static_cast<char>(i % 251));
+    }
+
+    io::EventLoop loop;
+
+    std::string received_message;
+    std::size_t client_on_send_count = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_message.append(data.buf.get(), data.size);
+            if (received_message.size() == expected.size()) {
+                server->schedule_removal();
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            std::vector<io::SendBuffer> buffers;
+            for (std::size_t i = 0; i < BUFFERS_COUNT; ++i) {
+                buffers.emplace_back(expected.c_str() + i, 1);
+            }
+
+            client.send_data(std::move(buffers),
+                [&](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    ++client_on_send_count;
+                    client.schedule_removal();
+                    if (error) {
+                        server->schedule_removal();
+                    }
+                }
+            );
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(1, client_on_send_count);
+    EXPECT_EQ(expected.size(), received_message.size());
+    EXPECT_TRUE(expected == received_message);
+}
+
 TEST_F(TcpClientServerTest, 2_clients_send_data_to_server) {
     io::EventLoop loop;
 
@@ -350,82 +661,1262 @@ TEST_F(TcpClientServerTest, client_and_server_in_threads) {
         EXPECT_TRUE(receive_called);
     });
 
-    std::thread client_thread([this, &message, &send_called](){
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::thread client_thread([this, &message, &send_called](){
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        io::EventLoop loop;
+        auto client = new io::net::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port}, [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            client.send_data(message, [&](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error);
+                send_called = true;
+                client.schedule_removal();
+            });
+        },
+        nullptr);
+
+        EXPECT_EQ(io::StatusCode::OK, loop.run());
+        EXPECT_TRUE(send_called);
+    });
+
+    io::ScopeExitGuard guard([&server_thread, &client_thread](){
+        client_thread.join();
+        server_thread.join();
+    });
+}
+
+TEST_F(TcpClientServerTest, send_data_from_char_buffer) {
+    io::EventLoop loop;
+
+    char client_message[] = "Hello from client!";
+    char server_message[] = "Hello from server!";
+
+    std::size_t on_server_receive_count = 0;
+    std::size_t on_client_receive_count = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            ++on_server_receive_count;
+
+            client.send_data(server_message, sizeof(server_message),
+                [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    server->schedule_removal();
+                }
+            );
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            client.send_data(client_message, sizeof(client_message),
+                [&](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    ++on_client_receive_count;
+                    client.schedule_removal();
+                }
+            );
+        },
+        nullptr
+    );
+
+    EXPECT_EQ(0, on_server_receive_count);
+    EXPECT_EQ(0, on_client_receive_count);
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(1, on_server_receive_count);
+    EXPECT_EQ(1, on_client_receive_count);
+}
+
+TEST_F(TcpClientServerTest, send_data_does_not_allocate) {
+    // Memory of write requests is reused, so in a steady state sending of data with
+    // a typical callback should not allocate.
+    io::EventLoop loop;
+
+    const char message[] = "Hello from client!";
+    static const std::size_t BURST_SIZE = 10;
+
+    struct State {
+        std::size_t end_send_counter = 0;
+        std::size_t measured_sends_counter = 0;
+        std::size_t allocations_during_send = 0;
+        std::size_t server_received_bytes = 0;
+    } state;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            state.server_received_bytes += data.size;
+            if (state.server_received_bytes == 2 * BURST_SIZE * sizeof(message)) {
+                server->schedule_removal();
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    // First burst fills cache of requests, allocations are measured for the second one
+    std::function<void(io::net::TcpClient&, bool)> send_burst =
+        [&](io::net::TcpClient& client, bool measure) {
+            for (std::size_t i = 0; i < BURST_SIZE; ++i) {
+                const auto allocations_before = allocations_count();
+
+                client.send_data(message, sizeof(message),
+                    [&state, &send_burst](io::net::TcpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        ++state.end_send_counter;
+                        if (state.end_send_counter == BURST_SIZE) {
+                            send_burst(client, true);
+                        } else if (state.end_send_counter == 2 * BURST_SIZE) {
+                            client.schedule_removal();
+                        }
+                    }
+                );
+
+                if (measure) {
+                    state.allocations_during_send += allocations_count() - allocations_before;
+                    ++state.measured_sends_counter;
+                }
+            }
+        };
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            send_burst(client, false);
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(2 * BURST_SIZE, state.end_send_counter);
+    EXPECT_EQ(BURST_SIZE, state.measured_sends_counter);
+    EXPECT_EQ(0, state.allocations_during_send);
+    EXPECT_EQ(2 * BURST_SIZE * sizeof(message), state.server_received_bytes);
+}
+
+TEST_F(TcpClientServerTest, end_send_callbacks_are_not_called_from_send_data) {
+    // Small sends are written immediately when nothing is queued, but end send callbacks
+    // are still called later, in order of sending.
+    io::EventLoop loop;
+
+    const char message[] = "Hello from client!";
+    static const std::size_t SENDS_COUNT = 5;
+
+    std::vector<std::size_t> end_send_order;
+    bool inside_send_data = false;
+    std::size_t server_received_bytes = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            server_received_bytes += data.size;
+            if (server_received_bytes == SENDS_COUNT * sizeof(message)) {
+                server->schedule_removal();
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (std::size_t i = 0; i < SENDS_COUNT; ++i) {
+                inside_send_data = true;
+                client.send_data(message, sizeof(message),
+                    [&, i](io::net::TcpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        EXPECT_FALSE(inside_send_data);
+                        end_send_order.push_back(i);
+                        if (end_send_order.size() == SENDS_COUNT) {
+                            client.schedule_removal();
+                        }
+                    }
+                );
+                inside_send_data = false;
+                EXPECT_EQ(i + 1, client.pending_send_requesets());
+            }
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    ASSERT_EQ(SENDS_COUNT, end_send_order.size());
+    for (std::size_t i = 0; i < SENDS_COUNT; ++i) {
+        EXPECT_EQ(i, end_send_order[i]);
+    }
+    EXPECT_EQ(SENDS_COUNT * sizeof(message), server_received_bytes);
+}
+
+TEST_F(TcpClientServerTest, client_pause_and_resume_read) {
+    io::EventLoop loop;
+
+    const std::string message = "Hello world!";
+
+    std::string received_message;
+    bool resumed = false;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(message);
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TcpClient(loop);
+    EXPECT_FALSE(client->is_read_paused());
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.pause_read();
+            EXPECT_TRUE(client.is_read_paused());
+
+            (new io::Timer(loop))->start(100, [&](io::Timer& timer) {
+                EXPECT_TRUE(received_message.empty());
+                resumed = true;
+                client.resume_read();
+                EXPECT_FALSE(client.is_read_paused());
+                timer.schedule_removal();
+            });
+        },
+        [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_TRUE(resumed);
+            received_message.append(data.buf.get(), data.size);
+            if (received_message.size() == message.size()) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_TRUE(resumed);
+    EXPECT_EQ(message, received_message);
+}
+
+TEST_F(TcpClientServerTest, server_pause_read_in_new_connection_callback) {
+    io::EventLoop loop;
+
+    const std::string message = "Hello world!";
+
+    std::string received_message;
+    bool resumed = false;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.pause_read();
+
+            (new io::Timer(loop))->start(100, [&](io::Timer& timer) {
+                EXPECT_TRUE(received_message.empty());
+                resumed = true;
+                client.resume_read();
+                timer.schedule_removal();
+            });
+        },
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_TRUE(resumed);
+            received_message.append(data.buf.get(), data.size);
+            if (received_message.size() == message.size()) {
+                server->schedule_removal();
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(message, [](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.schedule_removal();
+            });
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_TRUE(resumed);
+    EXPECT_EQ(message, received_message);
+}
+
+TEST_F(TcpClientServerTest, proxy_pause_read_on_backpressure) {
+    // Producer -> server (upstream) -> forwarding client (downstream) -> slow consumer server.
+    // Consumer does not read for some time, so reading of upstream connection should be paused.
+    const std::size_t CHUNK_SIZE = 64 * 1024;
+    const std::size_t TOTAL_SIZE = 64 * 1024 * 1024;
+    const std::uint16_t CONSUMER_PORT = m_default_port + 1;
+
+    io::EventLoop loop;
+
+    std::shared_ptr<const char> chunk(new char[CHUNK_SIZE](), std::default_delete<const char[]>());
+
+    std::size_t consumed_size = 0;
+    bool upstream_was_paused = false;
+    std::size_t max_pending_send_bytes = 0;
+
+    auto consumer_server = new io::net::TcpServer(loop);
+    auto listen_error = consumer_server->listen({m_default_addr, CONSUMER_PORT},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.pause_read();
+
+            (new io::Timer(loop))->start(200, [&](io::Timer& timer) {
+                client.resume_read();
+                timer.schedule_removal();
+            });
+        },
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            consumed_size += data.size;
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto downstream = new io::net::TcpClient(loop);
+
+    auto proxy_server = new io::net::TcpServer(loop);
+    listen_error = proxy_server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& upstream, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            io::net::pause_read_on_backpressure(upstream, *downstream, 1024 * 1024, 256 * 1024);
+        },
+        [&](io::net::TcpConnectedClient& upstream, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            downstream->copy_and_send_data(data.buf.get(), static_cast<std::uint32_t>(data.size));
+            max_pending_send_bytes = std::max(max_pending_send_bytes, downstream->pending_send_bytes());
+            upstream_was_paused = upstream_was_paused || upstream.is_read_paused();
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto producer = new io::net::TcpClient(loop);
+
+    downstream->connect({m_default_addr, CONSUMER_PORT},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            producer->connect({m_default_addr, m_default_port},
+                [&](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    for (std::size_t i = 0; i < TOTAL_SIZE / CHUNK_SIZE; ++i) {
+                        client.send_data(chunk, CHUNK_SIZE);
+                    }
+                },
+                nullptr
+            );
+        },
+        nullptr
+    );
+
+    auto timer = new io::Timer(loop);
+    timer->start(100, 100, [&](io::Timer& timer) {
+        if (consumed_size == TOTAL_SIZE) {
+            timer.schedule_removal();
+            producer->schedule_removal();
+            downstream->schedule_removal();
+            proxy_server->schedule_removal();
+            consumer_server->schedule_removal();
+        }
+    });
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(TOTAL_SIZE, consumed_size);
+    EXPECT_TRUE(upstream_was_paused);
+    // Each read of upstream is at most 64Kb
+    EXPECT_LT(max_pending_send_bytes, 1024 * 1024 + 64 * 1024);
+}
+
+TEST_F(TcpClientServerTest, shared_read_buffer) {
+    const std::size_t CLIENTS_COUNT = 4;
+
+    io::EventLoop loop;
+    EXPECT_FALSE(loop.is_shared_read_buffer());
+    loop.set_shared_read_buffer(true);
+    EXPECT_TRUE(loop.is_shared_read_buffer());
+
+    std::vector<io::DataChunk> retained_chunks;
+    std::set<const char*> not_retained_buffers;
+    std::size_t received_counter = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            ASSERT_EQ(1, data.size);
+
+            // First received chunk is kept by user, others are not
+            if (retained_chunks.empty()) {
+                retained_chunks.push_back(data);
+            } else {
+                not_retained_buffers.insert(data.buf.get());
+            }
+
+            if (++received_counter == CLIENTS_COUNT) {
+                server->schedule_removal();
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [i](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data(std::to_string(i), [](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    client.schedule_removal();
+                });
+            },
+            nullptr
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(CLIENTS_COUNT, received_counter);
+    ASSERT_EQ(1, retained_chunks.size());
+    // Retained buffer is not overwritten by reads of other connections
+    const char retained_value = retained_chunks[0].buf.get()[0];
+    EXPECT_TRUE(retained_value >= '0' && retained_value < char('0' + CLIENTS_COUNT));
+    ASSERT_EQ(1, not_retained_buffers.size());
+    EXPECT_NE(retained_chunks[0].buf.get(), *not_retained_buffers.begin());
+}
+
+TEST_F(TcpClientServerTest, client_read_into_user_buffer) {
+    const std::size_t BUFFER_SIZE = 100;
+    const std::size_t MESSAGE_SIZE = 1000;
+
+    io::EventLoop loop;
+
+    std::string message(MESSAGE_SIZE, 0);
+    for (std::size_t i = 0; i < MESSAGE_SIZE; ++i) {
+        message[i] = static_cast<char>('a' + i % 26);
+    }
+
+    char user_buffer[BUFFER_SIZE];
+    std::size_t buffer_filled = 0;
+    std::size_t paused_counter = 0;
+    std::string received_message;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(message);
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TcpClient(loop);
+    client->set_read_buffer_callback([&](io::net::TcpClient& client, std::size_t suggested_size) -> io::ReadBuffer {
+        if (buffer_filled == BUFFER_SIZE) {
+            ++paused_counter;
+            return {};
+        }
+
+        return {user_buffer + buffer_filled, BUFFER_SIZE - buffer_filled};
+    });
+
+    auto timer = new io::Timer(loop);
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            // Consumer of the buffer
+            timer->start(10, 10, [&](io::Timer& timer) {
+                received_message.append(user_buffer, buffer_filled);
+                buffer_filled = 0;
+                client.resume_read();
+
+                if (received_message.size() == MESSAGE_SIZE) {
+                    timer.schedule_removal();
+                    client.schedule_removal();
+                    server->schedule_removal();
+                }
+            });
+        },
+        [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            // Data is placed directly into user buffer
+            EXPECT_EQ(user_buffer + buffer_filled, data.buf.get());
+            EXPECT_LE(buffer_filled + data.size, BUFFER_SIZE);
+            buffer_filled += data.size;
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_GT(paused_counter, 0);
+    EXPECT_EQ(message, received_message);
+}
+
+TEST_F(TcpClientServerTest, server_send_file) {
+#ifndef TARM_IO_PLATFORM_LINUX
+    TARM_IO_TEST_SKIP();
+#endif
+
+    const std::size_t FILE_SIZE = 4 * 1024 * 1024 + 17;
+    const std::size_t FILE_OFFSET = 100;
+    const std::string header = "header";
+    const std::string trailer = "trailer";
+
+    std::string file_content(FILE_SIZE, 0);
+    for (std::size_t i = 0; i < FILE_SIZE; ++i) {
+        file_content[i] = static_cast<char>(i % 251);
+    }
+
+    const auto file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ofile.write(file_content.data(), file_content.size());
+    }
+
+    const std::string expected_message = header + file_content.substr(FILE_OFFSET) + trailer;
+
+    io::EventLoop loop;
+
+    std::vector<std::string> end_sends;
+    std::vector<std::uint64_t> progress;
+    std::string received_message;
+
+    auto file = new io::fs::File(loop);
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            file->open(file_path, [&](io::fs::File& file, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+
+                client.send_data(header, [&](io::net::TcpConnectedClient&, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    end_sends.push_back("header");
+                });
+                client.send_file(file, FILE_OFFSET, FILE_SIZE - FILE_OFFSET,
+                    [&](io::net::TcpConnectedClient&, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        end_sends.push_back("file");
+                    },
+                    [&](io::net::TcpConnectedClient&, std::uint64_t bytes_sent) {
+                        progress.push_back(bytes_sent);
+                    }
+                );
+                // Held until the file is sent
+                client.send_data(trailer, [&](io::net::TcpConnectedClient&, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    end_sends.push_back("trailer");
+                });
+                EXPECT_EQ(3, client.pending_send_requesets());
+                EXPECT_EQ(trailer.size(), client.pending_send_bytes());
+            });
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        },
+        [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_message.append(data.buf.get(), data.size);
+            if (received_message.size() == expected_message.size()) {
+                client.schedule_removal();
+                server->schedule_removal();
+                file->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_TRUE(received_message == expected_message);
+    EXPECT_EQ(std::vector<std::string>({"header", "file", "trailer"}), end_sends);
+    ASSERT_FALSE(progress.empty());
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+    EXPECT_EQ(FILE_SIZE - FILE_OFFSET, progress.back());
+}
+
+TEST_F(TcpClientServerTest, client_send_file_and_close) {
+#ifndef TARM_IO_PLATFORM_LINUX
+    TARM_IO_TEST_SKIP();
+#endif
+
+    // Server does not read, so file send can not be completed and is canceled by close
+    const std::size_t FILE_SIZE = 64 * 1024 * 1024;
+
+    const auto file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ofile.seekp(FILE_SIZE - 1);
+        ofile.put('!');
+    }
+
+    io::EventLoop loop;
+
+    bool file_send_canceled = false;
+    bool data_send_failed = false;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.pause_read();
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto file = new io::fs::File(loop);
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            file->open(file_path, [&](io::fs::File& file, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+
+                client.send_file(file, 0, FILE_SIZE,
+                    [&](io::net::TcpClient&, const io::Error& error) {
+                        EXPECT_EQ(io::StatusCode::OPERATION_CANCELED, error.code());
+                        file_send_canceled = true;
+                        file.schedule_removal();
+                        server->schedule_removal();
+                    }
+                );
+                client.send_data("!", [&](io::net::TcpClient&, const io::Error& error) {
+                    EXPECT_EQ(io::StatusCode::NOT_CONNECTED, error.code());
+                    EXPECT_TRUE(file_send_canceled);
+                    data_send_failed = true;
+                });
+
+                (new io::Timer(loop))->start(100, [&](io::Timer& timer) {
+                    EXPECT_FALSE(file_send_canceled);
+                    client.schedule_removal();
+                    timer.schedule_removal();
+                });
+            });
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_TRUE(file_send_canceled);
+    EXPECT_TRUE(data_send_failed);
+}
+
+#ifndef TARM_IO_PLATFORM_WINDOWS
+TEST_F(TcpClientServerTest, client_send_file_and_reconnect_on_peer_close) {
+#ifndef TARM_IO_PLATFORM_LINUX
+    TARM_IO_TEST_SKIP();
+#endif
+
+    // Peer does not read the first connection and half-closes it during file send. Client reconnects from close
+    // callback, rest of the file should not be sent to the new connection.
+    const std::size_t FILE_SIZE = 64 * 1024 * 1024;
+    const std::string message = "hello";
+
+    const auto file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ofile.seekp(FILE_SIZE - 1);
+        ofile.put('!');
+    }
+
+    // Server with half-close support, TcpConnectedClient closes connection on shutdown
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_NE(-1, listen_fd);
+    const int reuse = 1;
+    ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    ::sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = io::host_to_network(std::uint32_t(INADDR_LOOPBACK));
+    address.sin_port = io::host_to_network(m_default_port);
+    ASSERT_EQ(0, ::bind(listen_fd, reinterpret_cast<const ::sockaddr*>(&address), sizeof(address)));
+    ASSERT_EQ(0, ::listen(listen_fd, 2));
+
+    std::string second_connection_data;
+    std::thread server_thread([&]() {
+        const int first_fd = ::accept(listen_fd, nullptr, nullptr);
+        ASSERT_NE(-1, first_fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(0, ::shutdown(first_fd, SHUT_WR));
+
+        const int second_fd = ::accept(listen_fd, nullptr, nullptr);
+        ASSERT_NE(-1, second_fd);
+
+        ::timeval timeout{10, 0};
+        ::setsockopt(second_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::vector<char> buffer(64 * 1024);
+        ssize_t size = 0;
+        while ((size = ::recv(second_fd, buffer.data(), buffer.size(), 0)) > 0) {
+            second_connection_data.append(buffer.data(), std::size_t(size));
+        }
+        EXPECT_EQ(0, size);
+
+        ::close(second_fd);
+        ::close(first_fd);
+    });
+
+    io::EventLoop loop;
+
+    bool file_send_canceled = false;
+    std::size_t reconnect_count = 0;
+    std::size_t message_send_count = 0;
+
+    auto file = new io::fs::File(loop);
+    auto client = new io::net::TcpClient(loop);
+
+    std::function<void(io::net::TcpClient&, const io::Error&)> on_close =
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            if (reconnect_count++) {
+                return;
+            }
+
+            client.connect({m_default_addr, m_default_port},
+                [&](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    client.send_data(message, [&](io::net::TcpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        ++message_send_count;
+                        client.schedule_removal();
+                    });
+                },
+                nullptr,
+                on_close
+            );
+        };
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            file->open(file_path, [&](io::fs::File& file, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+
+                client.send_file(file, 0, FILE_SIZE,
+                    [&](io::net::TcpClient&, const io::Error& error) {
+                        EXPECT_EQ(io::StatusCode::OPERATION_CANCELED, error.code());
+                        file_send_canceled = true;
+                        file.schedule_removal();
+                    }
+                );
+            });
+        },
+        nullptr,
+        on_close
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+    server_thread.join();
+    ::close(listen_fd);
+
+    EXPECT_TRUE(file_send_canceled);
+    EXPECT_EQ(1, message_send_count);
+    EXPECT_EQ(message, second_connection_data);
+}
+#endif // TARM_IO_PLATFORM_WINDOWS
+
+TEST_F(TcpClientServerTest, client_zero_copy_send) {
+#ifndef TARM_IO_PLATFORM_LINUX
+    TARM_IO_TEST_SKIP();
+#endif
+
+    const std::size_t BUFFERS_COUNT = 8;
+    const std::size_t BUFFER_SIZE = 1024 * 1024;
+    const std::string small_message = "small";
+
+    io::EventLoop loop;
+
+    std::vector<std::shared_ptr<const char>> buffers;
+    std::string expected_message;
+    for (std::size_t i = 0; i < BUFFERS_COUNT; ++i) {
+        std::shared_ptr<char> buffer(new char[BUFFER_SIZE], std::default_delete<char[]>());
+        std::fill(buffer.get(), buffer.get() + BUFFER_SIZE, static_cast<char>('a' + i));
+        expected_message.append(buffer.get(), BUFFER_SIZE);
+        buffers.push_back(buffer);
+    }
+    expected_message += small_message;
+
+    std::string received_message;
+    std::vector<std::size_t> completed_buffers;
+    bool small_message_sent = false;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_message.append(data.buf.get(), data.size);
+        },
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            server->schedule_removal();
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TcpClient(loop);
+    EXPECT_EQ(io::StatusCode::NOT_CONNECTED, client->zero_copy_send(true).code());
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            const auto zero_copy_error = client.zero_copy_send(true, BUFFER_SIZE);
+            ASSERT_FALSE(zero_copy_error) << zero_copy_error;
+            EXPECT_TRUE(client.is_zero_copy_send());
+
+            for (std::size_t i = 0; i < BUFFERS_COUNT; ++i) {
+                client.send_data(buffers[i], BUFFER_SIZE, [&, i](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    completed_buffers.push_back(i);
+                    if (completed_buffers.size() == BUFFERS_COUNT && small_message_sent) {
+                        client.schedule_removal();
+                    }
+                });
+            }
+            // Below the threshold, copied as usual
+            client.send_data(small_message, [&](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                small_message_sent = true;
+                if (completed_buffers.size() == BUFFERS_COUNT) {
+                    client.schedule_removal();
+                }
+            });
+            EXPECT_EQ(BUFFERS_COUNT + 1, client.pending_send_requesets());
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_TRUE(small_message_sent);
+    ASSERT_EQ(BUFFERS_COUNT, completed_buffers.size());
+    EXPECT_TRUE(std::is_sorted(completed_buffers.begin(), completed_buffers.end()));
+    EXPECT_TRUE(received_message == expected_message);
+    // Buffers are released by the library
+    for (const auto& buffer : buffers) {
+        EXPECT_EQ(1, buffer.use_count());
+    }
+}
+
+TEST_F(TcpClientServerTest, client_zero_copy_send_and_close) {
+#ifndef TARM_IO_PLATFORM_LINUX
+    TARM_IO_TEST_SKIP();
+#endif
+
+    const std::size_t BUFFER_SIZE = 8 * 1024 * 1024;
+
+    io::EventLoop loop;
+
+    std::size_t buffer_release_count = 0;
+    // Released memory is overwritten, so it is noticed if kernel still transmits from it
+    std::shared_ptr<const char> buffer(new char[BUFFER_SIZE], [&](const char* data) {
+        std::fill(const_cast<char*>(data), const_cast<char*>(data) + BUFFER_SIZE, 0);
+        delete[] data;
+        ++buffer_release_count;
+    });
+    for (std::size_t i = 0; i < BUFFER_SIZE; ++i) {
+        const_cast<char*>(buffer.get())[i] = static_cast<char>(i % 251 + 1);
+    }
+
+    std::string received_message;
+    std::size_t server_on_close_count = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_message.append(data.buf.get(), data.size);
+        },
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            ++server_on_close_count;
+            server->schedule_removal();
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::size_t send_callback_count = 0;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            const auto zero_copy_error = client.zero_copy_send(true);
+            ASSERT_FALSE(zero_copy_error) << zero_copy_error;
+
+            client.send_data(std::move(buffer), BUFFER_SIZE, [&](io::net::TcpClient& client, const io::Error& error) {
+                ++send_callback_count;
+            });
+            client.schedule_removal();
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(1, send_callback_count);
+    EXPECT_EQ(1, server_on_close_count);
+    EXPECT_EQ(1, buffer_release_count);
+
+    // Only part of data is passed to the socket before close, it is received intact
+    ASSERT_GT(received_message.size(), 0);
+    ASSERT_LE(received_message.size(), BUFFER_SIZE);
+    std::size_t mismatch_count = 0;
+    for (std::size_t i = 0; i < received_message.size(); ++i) {
+        if (received_message[i] != static_cast<char>(i % 251 + 1)) {
+            ++mismatch_count;
+        }
+    }
+    EXPECT_EQ(0, mismatch_count);
+}
+
+TEST_F(TcpClientServerTest, pipe_connections) {
+    // Client <-> proxy server <-> echo server, message is larger than socket buffers, so backpressure is involved
+    const std::size_t MESSAGE_SIZE = 8 * 1024 * 1024;
+    const std::uint16_t echo_port = m_default_port + 1;
+
+    std::string message(MESSAGE_SIZE, 0);
+    for (std::size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<char>(i % 251);
+    }
+
+    for (auto mode : {io::net::detail::TcpPipeMode::DEFAULT, io::net::detail::TcpPipeMode::RELAY}) {
+        io::EventLoop loop;
+
+        std::size_t echo_server_received_size = 0;
+        std::size_t echo_server_close_count = 0;
+
+        auto echo_server = new io::net::TcpServer(loop);
+        auto listen_error = echo_server->listen({m_default_addr, echo_port},
+            nullptr,
+            [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                echo_server_received_size += data.size;
+                client.send_data(data.buf, static_cast<std::uint32_t>(data.size));
+            },
+            [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                ++echo_server_close_count;
+                echo_server->schedule_removal();
+            }
+        );
+        ASSERT_FALSE(listen_error) << listen_error;
+
+        std::size_t proxy_received_size = 0;
+        std::size_t pipe_end_count = 0;
+        io::Error pipe_end_error = io::StatusCode::UNDEFINED;
+
+        auto proxy_server = new io::net::TcpServer(loop);
+        listen_error = proxy_server->listen({m_default_addr, m_default_port},
+            [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                // Nothing is read until the pipe is established
+                client.pause_read();
+
+                auto upstream = new io::net::TcpClient(loop);
+                EXPECT_EQ(io::StatusCode::NOT_CONNECTED, io::net::pipe_connections(client, *upstream).code());
+
+                upstream->connect({m_default_addr, echo_port},
+                    [&](io::net::TcpClient& upstream, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        const auto pipe_error = io::net::detail::pipe_connections(client, upstream,
+                            [&](const io::Error& error) {
+                                ++pipe_end_count;
+                                pipe_end_error = error;
+                                client.close();
+                                upstream.schedule_removal();
+                                proxy_server->schedule_removal();
+                            },
+                            mode
+                        );
+                        EXPECT_FALSE(pipe_error) << pipe_error;
+                    },
+                    [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+                        proxy_received_size += data.size;
+                    }
+                );
+            },
+            [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+                proxy_received_size += data.size;
+            },
+            nullptr
+        );
+        ASSERT_FALSE(listen_error) << listen_error;
+
+        std::string received_message;
+
+        auto client = new io::net::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data(message);
+            },
+            [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                received_message.append(data.buf.get(), data.size);
+                if (received_message.size() == MESSAGE_SIZE) {
+                    // Closing is forwarded through the pipe in both directions
+                    client.schedule_removal();
+                }
+            }
+        );
+
+        ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+        EXPECT_EQ(MESSAGE_SIZE, echo_server_received_size);
+        EXPECT_TRUE(received_message == message);
+        EXPECT_EQ(0, proxy_received_size);
+        EXPECT_EQ(1, echo_server_close_count);
+        EXPECT_EQ(1, pipe_end_count);
+        EXPECT_FALSE(pipe_end_error) << pipe_end_error;
+    }
+}
+
+#ifndef TARM_IO_PLATFORM_WINDOWS
+TEST_F(TcpClientServerTest, pipe_connections_half_close) {
+    // Client sends request and shuts down its write side, reply of upstream is still delivered through the pipe
+    const std::size_t REPLY_SIZE = 4 * 1024 * 1024;
+    const std::uint16_t upstream_port = m_default_port + 1;
+    const std::string request = "request";
+
+    std::string reply(REPLY_SIZE, 0);
+    for (std::size_t i = 0; i < reply.size(); ++i) {
+        reply[i] = static_cast<char>(i % 251);
+    }
+
+    for (auto mode : {io::net::detail::TcpPipeMode::DEFAULT, io::net::detail::TcpPipeMode::RELAY}) {
+        io::EventLoop loop;
+
+        std::string upstream_received;
+        std::size_t upstream_send_count = 0;
+
+        auto timer = new io::Timer(loop);
+        auto upstream_server = new io::net::TcpServer(loop);
+        auto listen_error = upstream_server->listen({m_default_addr, upstream_port},
+            nullptr,
+            [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                upstream_received.append(data.buf.get(), data.size);
+                if (upstream_received.size() < request.size()) {
+                    return;
+                }
+
+                // Reply is delayed, so it goes through the pipe after FIN of the client.
+                // Reading is paused to not close connection on FIN.
+                client.pause_read();
+                timer->start(100, [&](io::Timer& timer) {
+                    client.send_data(reply, [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        ++upstream_send_count;
+                        timer.schedule_removal();
+                        upstream_server->schedule_removal();
+                    });
+                });
+            },
+            nullptr
+        );
+        ASSERT_FALSE(listen_error) << listen_error;
+
+        std::size_t pipe_end_count = 0;
+        io::Error pipe_end_error = io::StatusCode::UNDEFINED;
+
+        auto proxy_server = new io::net::TcpServer(loop);
+        listen_error = proxy_server->listen({m_default_addr, m_default_port},
+            [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.pause_read();
+
+                auto upstream = new io::net::TcpClient(loop);
+                upstream->connect({m_default_addr, upstream_port},
+                    [&](io::net::TcpClient& upstream, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        const auto pipe_error = io::net::detail::pipe_connections(client, upstream,
+                            [&](const io::Error& error) {
+                                ++pipe_end_count;
+                                pipe_end_error = error;
+                                client.close();
+                                upstream.schedule_removal();
+                                proxy_server->schedule_removal();
+                            },
+                            mode
+                        );
+                        EXPECT_FALSE(pipe_error) << pipe_error;
+                    },
+                    nullptr
+                );
+            },
+            nullptr,
+            nullptr
+        );
+        ASSERT_FALSE(listen_error) << listen_error;
+
+        // Client with half-close support, TcpClient closes connection on shutdown
+        std::string client_received;
+        std::thread client_thread([&]() {
+            const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            ASSERT_NE(-1, fd);
+
+            ::timeval timeout{10, 0};
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+            ::sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = io::host_to_network(std::uint32_t(INADDR_LOOPBACK));
+            address.sin_port = io::host_to_network(m_default_port);
+            EXPECT_EQ(0, ::connect(fd, reinterpret_cast<const ::sockaddr*>(&address), sizeof(address)));
 
-        io::EventLoop loop;
-        auto client = new io::net::TcpClient(loop);
-        client->connect({m_default_addr, m_default_port}, [&](io::net::TcpClient& client, const io::Error& error) {
-            EXPECT_FALSE(error);
+            EXPECT_EQ(ssize_t(request.size()), ::send(fd, request.data(), request.size(), 0));
+            EXPECT_EQ(0, ::shutdown(fd, SHUT_WR));
 
-            client.send_data(message, [&](io::net::TcpClient& client, const io::Error& error) {
-                EXPECT_FALSE(error);
-                send_called = true;
-                client.schedule_removal();
-            });
-        },
-        nullptr);
+            std::vector<char> buffer(64 * 1024);
+            ssize_t size = 0;
+            while ((size = ::recv(fd, buffer.data(), buffer.size(), 0)) > 0) {
+                client_received.append(buffer.data(), std::size_t(size));
+            }
+            EXPECT_EQ(0, size);
 
-        EXPECT_EQ(io::StatusCode::OK, loop.run());
-        EXPECT_TRUE(send_called);
-    });
+            ::close(fd);
+        });
 
-    io::ScopeExitGuard guard([&server_thread, &client_thread](){
+        ASSERT_EQ(io::StatusCode::OK, loop.run());
         client_thread.join();
-        server_thread.join();
-    });
+
+        EXPECT_EQ(request, upstream_received);
+        EXPECT_EQ(1, upstream_send_count);
+        EXPECT_EQ(reply.size(), client_received.size());
+        EXPECT_TRUE(reply == client_received);
+        EXPECT_EQ(1, pipe_end_count);
+        EXPECT_FALSE(pipe_end_error) << pipe_end_error;
+    }
 }
+#endif // TARM_IO_PLATFORM_WINDOWS
 
-TEST_F(TcpClientServerTest, send_data_from_char_buffer) {
-    io::EventLoop loop;
+TEST_F(TcpClientServerTest, pipe_connections_end_on_close) {
+    const std::uint16_t upstream_port = m_default_port + 1;
 
-    char client_message[] = "Hello from client!";
-    char server_message[] = "Hello from server!";
+    for (auto mode : {io::net::detail::TcpPipeMode::DEFAULT, io::net::detail::TcpPipeMode::RELAY}) {
+        io::EventLoop loop;
 
-    std::size_t on_server_receive_count = 0;
-    std::size_t on_client_receive_count = 0;
+        std::size_t upstream_server_close_count = 0;
 
-    auto server = new io::net::TcpServer(loop);
-    auto listen_error = server->listen({"0.0.0.0", m_default_port},
-        nullptr,
-        [&](io::net::TcpConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
-            EXPECT_FALSE(error) << error;
-            ++on_server_receive_count;
+        auto upstream_server = new io::net::TcpServer(loop);
+        auto listen_error = upstream_server->listen({m_default_addr, upstream_port},
+            nullptr,
+            nullptr,
+            [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                ++upstream_server_close_count;
+                upstream_server->schedule_removal();
+            }
+        );
+        ASSERT_FALSE(listen_error) << listen_error;
 
-            client.send_data(server_message, sizeof(server_message),
-                [&](io::net::TcpConnectedClient& client, const io::Error& error) {
-                    EXPECT_FALSE(error) << error;
-                    server->schedule_removal();
-                }
-            );
-        },
-        nullptr
-    );
-    ASSERT_FALSE(listen_error);
+        std::size_t pipe_end_count = 0;
+        io::Error pipe_end_error = io::StatusCode::UNDEFINED;
 
-    auto client = new io::net::TcpClient(loop);
-    client->connect({m_default_addr, m_default_port},
-        [&](io::net::TcpClient& client, const io::Error& error) {
-            EXPECT_FALSE(error) << error;
+        auto proxy_server = new io::net::TcpServer(loop);
+        listen_error = proxy_server->listen({m_default_addr, m_default_port},
+            [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.pause_read();
 
-            client.send_data(client_message, sizeof(client_message),
-                [&](io::net::TcpClient& client, const io::Error& error) {
-                    EXPECT_FALSE(error) << error;
-                    ++on_client_receive_count;
-                    client.schedule_removal();
-                }
-            );
-        },
-        nullptr
-    );
+                auto upstream = new io::net::TcpClient(loop);
+                upstream->connect({m_default_addr, upstream_port},
+                    [&](io::net::TcpClient& upstream, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        const auto pipe_error = io::net::detail::pipe_connections(client, upstream,
+                            [&](const io::Error& error) {
+                                ++pipe_end_count;
+                                pipe_end_error = error;
+                                EXPECT_FALSE(client.is_open());
+                                EXPECT_TRUE(upstream.is_open());
+                                upstream.schedule_removal();
+                                proxy_server->schedule_removal();
+                            },
+                            mode
+                        );
+                        ASSERT_FALSE(pipe_error) << pipe_error;
+                        // Closing of one connection by user ends the pipe and closes the other one
+                        client.close();
+                    },
+                    nullptr
+                );
+            },
+            nullptr,
+            nullptr
+        );
+        ASSERT_FALSE(listen_error) << listen_error;
 
-    EXPECT_EQ(0, on_server_receive_count);
-    EXPECT_EQ(0, on_client_receive_count);
+        std::size_t client_close_count = 0;
 
-    ASSERT_EQ(io::StatusCode::OK, loop.run());
+        auto client = new io::net::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+            },
+            nullptr,
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                ++client_close_count;
+                client.schedule_removal();
+            }
+        );
 
-    EXPECT_EQ(1, on_server_receive_count);
-    EXPECT_EQ(1, on_client_receive_count);
+        ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+        EXPECT_EQ(1, client_close_count);
+        EXPECT_EQ(1, upstream_server_close_count);
+        EXPECT_EQ(1, pipe_end_count);
+        EXPECT_EQ(io::StatusCode::OPERATION_CANCELED, pipe_end_error.code());
+    }
 }
 
 TEST_F(TcpClientServerTest, server_sends_data_first) {
@@ -601,6 +2092,52 @@ TEST_F(TcpClientServerTest, null_send_buf) {
     EXPECT_EQ(1, client_on_send_count);
 }
 
+TEST_F(TcpClientServerTest, send_buffer_list_with_empty_buffer) {
+    io::EventLoop loop;
+
+    std::size_t client_on_send_count = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({"0.0.0.0", m_default_port},
+        nullptr,
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            client.send_data(std::vector<io::SendBuffer>(),
+                [&](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+                    ++client_on_send_count;
+                }
+            );
+
+            std::vector<io::SendBuffer> buffers;
+            buffers.emplace_back(std::string("data"));
+            buffers.emplace_back(std::shared_ptr<const char>(), 1);
+            client.send_data(std::move(buffers),
+                [&](io::net::TcpClient& client, const io::Error& error) {
+                    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, error.code());
+                    ++client_on_send_count;
+                    EXPECT_EQ(0, client.pending_send_requesets());
+                    client.schedule_removal();
+                    server->schedule_removal();
+                }
+            );
+        },
+        nullptr
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(2, client_on_send_count);
+}
+
 TEST_F(TcpClientServerTest, server_shutdown_callback) {
     io::EventLoop loop;
 
@@ -1674,6 +3211,199 @@ TEST_F(TcpClientServerTest, pending_write_requests) {
     EXPECT_EQ(1, client_close_call_count);
 }
 
+TEST_F(TcpClientServerTest, server_cork_send) {
+    const std::size_t MESSAGES_COUNT = 100;
+
+    io::EventLoop loop;
+
+    std::vector<std::size_t> send_callbacks_order;
+    std::string expected_message;
+    for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+        expected_message += std::to_string(i) + ";";
+    }
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            EXPECT_FALSE(client.is_cork_send());
+            client.cork_send(true);
+            EXPECT_TRUE(client.is_cork_send());
+
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                client.send_data(std::to_string(i) + ";",
+                    [&, i](io::net::TcpConnectedClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        send_callbacks_order.push_back(i);
+                        EXPECT_EQ(MESSAGES_COUNT - send_callbacks_order.size(), client.pending_send_requesets());
+                    }
+                );
+            }
+            EXPECT_EQ(MESSAGES_COUNT, client.pending_send_requesets());
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::string received_message;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        },
+        [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_message.append(data.buf.get(), data.size);
+            if (received_message.size() == expected_message.size()) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(expected_message, received_message);
+    ASSERT_EQ(MESSAGES_COUNT, send_callbacks_order.size());
+    for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+        EXPECT_EQ(i, send_callbacks_order[i]);
+    }
+}
+
+TEST_F(TcpClientServerTest, server_cork_send_then_shutdown) {
+    io::EventLoop loop;
+
+    std::size_t server_on_send_count = 0;
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            client.cork_send(true);
+            for (const auto& message : {"Hello", " ", "world!"}) {
+                client.send_data(message, [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    ++server_on_send_count;
+                });
+            }
+            // Corked data is written before connection is shut down
+            client.shutdown();
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::string received_message;
+    std::size_t client_on_close_count = 0;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        },
+        [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_message.append(data.buf.get(), data.size);
+        },
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            ++client_on_close_count;
+            client.schedule_removal();
+            server->schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(3, server_on_send_count);
+    EXPECT_EQ(1, client_on_close_count);
+    EXPECT_EQ("Hello world!", received_message);
+}
+
+TEST_F(TcpClientServerTest, server_send_watermarks) {
+    // Server produces data as fast as possible, stops on high watermark and continues on drain
+    const std::size_t CHUNK_SIZE = 64 * 1024;
+    const std::size_t TOTAL_SIZE = 64 * 1024 * 1024;
+    const std::size_t HIGH_WATERMARK = 1024 * 1024;
+    const std::size_t LOW_WATERMARK = 256 * 1024;
+
+    io::EventLoop loop;
+
+    std::shared_ptr<const char> chunk(new char[CHUNK_SIZE](), std::default_delete<const char[]>());
+
+    std::size_t sent_size = 0;
+    std::size_t max_pending_send_bytes = 0;
+    std::size_t high_watermark_counter = 0;
+    std::size_t drain_counter = 0;
+    bool paused = false;
+
+    std::function<void(io::net::TcpConnectedClient&)> produce = [&](io::net::TcpConnectedClient& client) {
+        while (!paused && sent_size < TOTAL_SIZE) {
+            client.send_data(chunk, CHUNK_SIZE);
+            sent_size += CHUNK_SIZE;
+            max_pending_send_bytes = std::max(max_pending_send_bytes, client.pending_send_bytes());
+        }
+    };
+
+    auto server = new io::net::TcpServer(loop);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TcpConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            EXPECT_EQ(0, client.pending_send_bytes());
+            client.set_send_watermarks(HIGH_WATERMARK, LOW_WATERMARK);
+            client.set_high_watermark_callback([&](io::net::TcpConnectedClient& client) {
+                EXPECT_FALSE(paused);
+                EXPECT_GE(client.pending_send_bytes(), HIGH_WATERMARK);
+                ++high_watermark_counter;
+                paused = true;
+            });
+            client.set_drain_callback([&](io::net::TcpConnectedClient& client) {
+                EXPECT_TRUE(paused);
+                EXPECT_LE(client.pending_send_bytes(), LOW_WATERMARK);
+                ++drain_counter;
+                paused = false;
+                produce(client);
+            });
+
+            produce(client);
+        },
+        nullptr,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::size_t received_size = 0;
+
+    auto client = new io::net::TcpClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TcpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        },
+        [&](io::net::TcpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_size += data.size;
+            if (received_size == TOTAL_SIZE) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(TOTAL_SIZE, received_size);
+    EXPECT_GE(high_watermark_counter, 1);
+    EXPECT_LE(drain_counter, high_watermark_counter);
+    EXPECT_GE(drain_counter, high_watermark_counter - 1);
+    EXPECT_LT(max_pending_send_bytes, HIGH_WATERMARK + CHUNK_SIZE);
+}
+
 TEST_F(TcpClientServerTest, client_shutdown_in_connect) {
     io::EventLoop loop;
 
@@ -5,12 +5,34 @@
 
 #include "UTCommon.h"
 
+#include "net/Tcp.h"
 #include "net/Tls.h"
+#include "net/detail/OpenSslKernelTls.h"
+#include "fs/File.h"
 #include "fs/Path.h"
+#include "ByteSwap.h"
+#include "Timer.h"
 
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
 #include <thread>
 #include <vector>
 
+#ifndef TARM_IO_PLATFORM_WINDOWS
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+#ifdef TARM_IO_HAS_KERNEL_TLS
+    #include <linux/tls.h>
+#endif
+
 struct TlsClientServerTest : public testing::Test,
                              public LogRedirector {
 
@@ -22,6 +44,164 @@ protected:
 
     const io::fs::Path m_cert_path = m_test_path / "certificate.pem";
     const io::fs::Path m_key_path = m_test_path / "key.pem";
+
+    using ExchangeCallback = std::function<void(const io::net::TlsSession&, bool)>;
+
+    // Connects with offered session, exchanges a message and closes connection
+    void connect_and_exchange(io::EventLoop& loop,
+                              const io::net::TlsSession& session,
+                              io::net::TlsVersionRange version_range,
+                              const ExchangeCallback& callback) {
+        auto client = new io::net::TlsClient(loop, version_range);
+        client->set_session(session);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data("hello");
+            },
+            [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.close();
+            },
+            [callback](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                const auto session = client.session();
+                const bool resumed = client.is_session_resumed();
+                client.schedule_removal();
+                callback(session, resumed);
+            }
+        );
+    }
+
+    // Kernel TLS could be requested only if platform and OpenSSL version support it
+    bool kernel_tls_is_supported() {
+        io::EventLoop loop;
+        auto client = new io::net::TlsClient(loop);
+        const auto error = client->set_kernel_tls(true);
+        client->schedule_removal();
+        EXPECT_EQ(io::StatusCode::OK, loop.run());
+        return error.code() != io::StatusCode::FUNCTION_NOT_IMPLEMENTED;
+    }
+
+#ifdef TARM_IO_HAS_KERNEL_TLS
+    // Moves all pending data from one memory BIO to another and returns it
+    std::vector<char> move_bio_data(::BIO* from, ::BIO* to) {
+        std::vector<char> data(BIO_ctrl_pending(from));
+        if (!data.empty()) {
+            EXPECT_EQ(int(data.size()), BIO_read(from, data.data(), int(data.size())));
+            EXPECT_EQ(int(data.size()), BIO_write(to, data.data(), int(data.size())));
+        }
+        return data;
+    }
+
+    template<typename CryptoInfo>
+    void parse_crypto_info(const std::vector<unsigned char>& crypto_info_data,
+                           std::vector<unsigned char>& key,
+                           std::vector<unsigned char>& salt,
+                           std::vector<unsigned char>& iv,
+                           std::vector<unsigned char>& rec_seq) {
+        CryptoInfo info;
+        ASSERT_EQ(sizeof(info), crypto_info_data.size());
+        std::memcpy(&info, crypto_info_data.data(), sizeof(info));
+        key.assign(info.key, info.key + sizeof(info.key));
+        salt.assign(info.salt, info.salt + sizeof(info.salt));
+        iv.assign(info.iv, info.iv + sizeof(info.iv));
+        rec_seq.assign(info.rec_seq, info.rec_seq + sizeof(info.rec_seq));
+    }
+
+    // Encrypts application data record the same way as the kernel does with keys from TLS_TX socket option
+    std::vector<unsigned char> encrypt_kernel_tls_record(const std::vector<unsigned char>& crypto_info_data,
+                                                         const std::string& plaintext) {
+        const std::size_t TAG_SIZE = 16;
+        const std::size_t NONCE_SIZE = 12;
+
+        ::tls_crypto_info info;
+        std::memcpy(&info, crypto_info_data.data(), sizeof(info));
+        const bool is_tls_1_2 = info.version == TLS_1_2_VERSION;
+
+        const ::EVP_CIPHER* cipher = nullptr;
+        std::vector<unsigned char> key;
+        std::vector<unsigned char> salt;
+        std::vector<unsigned char> iv;
+        std::vector<unsigned char> rec_seq;
+
+        switch (info.cipher_type) {
+            case TLS_CIPHER_AES_GCM_128:
+                cipher = EVP_aes_128_gcm();
+                parse_crypto_info<::tls12_crypto_info_aes_gcm_128>(crypto_info_data, key, salt, iv, rec_seq);
+                break;
+#ifdef TLS_CIPHER_AES_GCM_256
+            case TLS_CIPHER_AES_GCM_256:
+                cipher = EVP_aes_256_gcm();
+                parse_crypto_info<::tls12_crypto_info_aes_gcm_256>(crypto_info_data, key, salt, iv, rec_seq);
+                break;
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+            case TLS_CIPHER_CHACHA20_POLY1305:
+                cipher = EVP_chacha20_poly1305();
+                parse_crypto_info<::tls12_crypto_info_chacha20_poly1305>(crypto_info_data, key, salt, iv, rec_seq);
+                break;
+#endif
+            default:
+                ADD_FAILURE() << "Unexpected cipher type: " << info.cipher_type;
+                return {};
+        }
+
+        // TLS 1.2 with AES-GCM sends explicit part of the nonce in the record, in other cases
+        // the whole nonce is implicit and is combined with the record sequence number.
+        const bool explicit_nonce = is_tls_1_2 && !salt.empty();
+        std::vector<unsigned char> nonce(salt);
+        nonce.insert(nonce.end(), iv.begin(), iv.end());
+        EXPECT_EQ(NONCE_SIZE, nonce.size());
+        if (!explicit_nonce) {
+            for (std::size_t i = 0; i < rec_seq.size(); ++i) {
+                nonce[NONCE_SIZE - rec_seq.size() + i] ^= rec_seq[i];
+            }
+        }
+
+        std::vector<unsigned char> inner_plaintext(plaintext.begin(), plaintext.end());
+        if (!is_tls_1_2) {
+            inner_plaintext.push_back(SSL3_RT_APPLICATION_DATA);
+        }
+
+        const std::size_t record_size = (explicit_nonce ? iv.size() : 0) + inner_plaintext.size() + TAG_SIZE;
+        std::vector<unsigned char> record = {
+            SSL3_RT_APPLICATION_DATA, 0x03, 0x03,
+            static_cast<unsigned char>(record_size >> 8), static_cast<unsigned char>(record_size)
+        };
+
+        std::vector<unsigned char> aad;
+        if (is_tls_1_2) {
+            aad = rec_seq;
+            aad.insert(aad.end(), {
+                SSL3_RT_APPLICATION_DATA, 0x03, 0x03,
+                static_cast<unsigned char>(plaintext.size() >> 8), static_cast<unsigned char>(plaintext.size())
+            });
+        } else {
+            aad = record;
+        }
+
+        if (explicit_nonce) {
+            record.insert(record.end(), iv.begin(), iv.end());
+        }
+
+        std::vector<unsigned char> ciphertext(inner_plaintext.size() + TAG_SIZE);
+        int size = 0;
+        int final_size = 0;
+        std::unique_ptr<::EVP_CIPHER_CTX, decltype(&::EVP_CIPHER_CTX_free)> ctx(EVP_CIPHER_CTX_new(), &::EVP_CIPHER_CTX_free);
+        EXPECT_EQ(1, EVP_EncryptInit_ex(ctx.get(), cipher, nullptr, nullptr, nullptr));
+        EXPECT_EQ(1, EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_SET_IVLEN, int(NONCE_SIZE), nullptr));
+        EXPECT_EQ(1, EVP_EncryptInit_ex(ctx.get(), nullptr, nullptr, key.data(), nonce.data()));
+        EXPECT_EQ(1, EVP_EncryptUpdate(ctx.get(), nullptr, &size, aad.data(), int(aad.size())));
+        EXPECT_EQ(1, EVP_EncryptUpdate(ctx.get(), ciphertext.data(), &size, inner_plaintext.data(), int(inner_plaintext.size())));
+        EXPECT_EQ(1, EVP_EncryptFinal_ex(ctx.get(), ciphertext.data() + size, &final_size));
+        EXPECT_EQ(inner_plaintext.size(), std::size_t(size + final_size));
+        EXPECT_EQ(1, EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_GET_TAG, int(TAG_SIZE), ciphertext.data() + inner_plaintext.size()));
+
+        record.insert(record.end(), ciphertext.begin(), ciphertext.end());
+        return record;
+    }
+#endif
 };
 /*
 TEST_F(TlsClientServerTest,  constructor) {
@@ -496,6 +676,260 @@ TEST_F(TlsClientServerTest, server_send_data_to_client) {
     EXPECT_EQ(0, server_on_receive_callback_count);
 }
 
+TEST_F(TlsClientServerTest, server_send_buffer_list_to_client) {
+    const std::string header = "HEADER:";
+    const std::string body = "body of the message";
+    const std::string expected = header + body + header;
+
+    std::size_t server_on_send_callback_count = 0;
+    std::string received_message;
+
+    io::EventLoop loop;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+
+            std::unique_ptr<char[]> unique_body(new char[body.size()]);
+            std::memcpy(unique_body.get(), body.c_str(), body.size());
+
+            std::vector<io::SendBuffer> buffers;
+            buffers.emplace_back(std::string(header));
+            buffers.emplace_back(std::move(unique_body), static_cast<std::uint32_t>(body.size()));
+            buffers.emplace_back(header.c_str(), static_cast<std::uint32_t>(header.size()));
+
+            client.send_data(std::move(buffers),
+                [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error);
+                    ++server_on_send_callback_count;
+                    server->shutdown([](io::net::TlsServer& server, const io::Error& error) {server.schedule_removal();});
+                }
+            );
+        },
+        nullptr);
+    ASSERT_FALSE(listen_error);
+
+    auto client = new io::net::TlsClient(loop);
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TlsClient& client, const io::Error& error) {
+            EXPECT_FALSE(error);
+        },
+        [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error);
+            received_message.append(data.buf.get(), data.size);
+            if (received_message.size() == expected.size()) {
+                client.schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(1, server_on_send_callback_count);
+    EXPECT_EQ(expected, received_message);
+}
+
+TEST_F(TlsClientServerTest, client_send_watermarks) {
+    // Watermarks are set before connection and applied to encrypted data
+    const std::size_t CHUNK_SIZE = 16 * 1024;
+    const std::size_t TOTAL_SIZE = 16 * 1024 * 1024;
+    const std::size_t HIGH_WATERMARK = 512 * 1024;
+    const std::size_t LOW_WATERMARK = 128 * 1024;
+
+    io::EventLoop loop;
+
+    std::shared_ptr<const char> chunk(new char[CHUNK_SIZE](), std::default_delete<const char[]>());
+
+    std::size_t sent_size = 0;
+    std::size_t high_watermark_counter = 0;
+    std::size_t drain_counter = 0;
+    bool paused = false;
+
+    std::function<void(io::net::TlsClient&)> produce = [&](io::net::TlsClient& client) {
+        while (!paused && sent_size < TOTAL_SIZE) {
+            client.send_data(chunk, CHUNK_SIZE);
+            sent_size += CHUNK_SIZE;
+        }
+    };
+
+    std::size_t received_size = 0;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        },
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_size += data.size;
+            if (received_size == TOTAL_SIZE) {
+                client.close();
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TlsClient(loop);
+    EXPECT_EQ(0, client->pending_send_bytes());
+    client->set_send_watermarks(HIGH_WATERMARK, LOW_WATERMARK);
+    client->set_high_watermark_callback([&](io::net::TlsClient& client) {
+        EXPECT_FALSE(paused);
+        EXPECT_GE(client.pending_send_bytes(), HIGH_WATERMARK);
+        ++high_watermark_counter;
+        paused = true;
+    });
+    client->set_drain_callback([&](io::net::TlsClient& client) {
+        EXPECT_TRUE(paused);
+        EXPECT_LE(client.pending_send_bytes(), LOW_WATERMARK);
+        ++drain_counter;
+        paused = false;
+        produce(client);
+    });
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TlsClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            produce(client);
+        },
+        nullptr,
+        [&](io::net::TlsClient& client, const io::Error& error) {
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(TOTAL_SIZE, received_size);
+    EXPECT_GE(high_watermark_counter, 1);
+    EXPECT_EQ(high_watermark_counter, drain_counter);
+}
+
+TEST_F(TlsClientServerTest, client_pause_read_with_buffered_data) {
+    // Messages are sent at once, so most of them are received in one TCP chunk and still buffered
+    // in OpenSSL when reading is paused from the receive callback.
+    const std::vector<std::string> messages = {"a", "bc", "def", "ghij", "klmno"};
+
+    io::EventLoop loop;
+
+    std::vector<std::string> received_messages;
+    bool resumed = false;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (const auto& message : messages) {
+                client.send_data(message);
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TlsClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TlsClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        },
+        [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_FALSE(client.is_read_paused());
+            received_messages.emplace_back(data.buf.get(), data.size);
+
+            if (received_messages.size() == 1) {
+                client.pause_read();
+                EXPECT_TRUE(client.is_read_paused());
+
+                (new io::Timer(loop))->start(100, [&](io::Timer& timer) {
+                    EXPECT_EQ(1, received_messages.size());
+                    resumed = true;
+                    client.resume_read();
+                    timer.schedule_removal();
+                });
+            } else {
+                EXPECT_TRUE(resumed);
+            }
+
+            if (received_messages.size() == messages.size()) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_TRUE(resumed);
+    EXPECT_EQ(messages, received_messages);
+}
+
+TEST_F(TlsClientServerTest, client_pause_read_with_large_buffered_data) {
+    // Received records which are not decrypted yet when reading is paused should be kept till resume
+    const std::size_t MESSAGE_SIZE = 100 * 1024;
+    const std::size_t MESSAGES_COUNT = 8;
+
+    std::string expected_data;
+    for (std::size_t i = 0; i < MESSAGE_SIZE * MESSAGES_COUNT; ++i) {
+        expected_data.push_back(static_cast<char>(i % 251));
+    }
+
+    io::EventLoop loop;
+
+    std::string received_data;
+    std::size_t pauses_count = 0;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                client.send_data(expected_data.substr(i * MESSAGE_SIZE, MESSAGE_SIZE));
+            }
+        },
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TlsClient(loop);
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TlsClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        },
+        [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_FALSE(client.is_read_paused());
+            EXPECT_EQ(received_data.size(), data.offset);
+            received_data.append(data.buf.get(), data.size);
+
+            if (received_data.size() == expected_data.size()) {
+                client.schedule_removal();
+                server->schedule_removal();
+                return;
+            }
+
+            // Pause in the middle of each message
+            if (received_data.size() / (MESSAGE_SIZE / 2) > pauses_count) {
+                ++pauses_count;
+                client.pause_read();
+                (new io::Timer(loop))->start(10, [&](io::Timer& timer) {
+                    client.resume_read();
+                    timer.schedule_removal();
+                });
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_LT(0, pauses_count);
+    EXPECT_EQ(expected_data.size(), received_data.size());
+    EXPECT_TRUE(expected_data == received_data);
+}
+
 TEST_F(TlsClientServerTest, server_send_simultaneous_multiple_chunks_to_client) {
     const std::vector<std::string> messages = {
         "a",
@@ -1382,6 +1816,849 @@ TEST_F(TlsClientServerTest, server_works_with_multiple_clients) {
     }
 }
 
+TEST_F(TlsClientServerTest, session_resumption_from_cache) {
+    io::EventLoop loop;
+
+    std::vector<bool> server_resumed;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    EXPECT_FALSE(server->set_session_tickets(false));
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            server_resumed.push_back(client.is_session_resumed());
+        },
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(data.buf, data.size);
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    std::vector<bool> client_resumed;
+
+    connect_and_exchange(loop, io::net::TlsSession(), io::net::DEFAULT_TLS_VERSION_RANGE,
+        [&](const io::net::TlsSession& session, bool resumed) {
+            EXPECT_FALSE(session.is_empty());
+            client_resumed.push_back(resumed);
+            connect_and_exchange(loop, session, io::net::DEFAULT_TLS_VERSION_RANGE,
+                [&](const io::net::TlsSession& session, bool resumed) {
+                    client_resumed.push_back(resumed);
+                    server->schedule_removal();
+                }
+            );
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(std::vector<bool>({false, true}), client_resumed);
+    EXPECT_EQ(std::vector<bool>({false, true}), server_resumed);
+}
+
+TEST_F(TlsClientServerTest, session_resumption_with_tickets) {
+    io::EventLoop loop;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    EXPECT_FALSE(server->set_session_cache(0, 60 * 1000));
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(data.buf, data.size);
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    std::vector<bool> client_resumed;
+
+    // Session of resumed connection is renewed and may be resumed again
+    connect_and_exchange(loop, io::net::TlsSession(), io::net::DEFAULT_TLS_VERSION_RANGE,
+        [&](const io::net::TlsSession& session, bool resumed) {
+            client_resumed.push_back(resumed);
+            connect_and_exchange(loop, session, io::net::DEFAULT_TLS_VERSION_RANGE,
+                [&](const io::net::TlsSession& session, bool resumed) {
+                    EXPECT_FALSE(session.is_empty());
+                    client_resumed.push_back(resumed);
+                    connect_and_exchange(loop, session, io::net::DEFAULT_TLS_VERSION_RANGE,
+                        [&](const io::net::TlsSession& session, bool resumed) {
+                            client_resumed.push_back(resumed);
+                            server->schedule_removal();
+                        }
+                    );
+                }
+            );
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(std::vector<bool>({false, true, true}), client_resumed);
+}
+
+TEST_F(TlsClientServerTest, session_resumption_tls_1_2) {
+    if (io::net::min_supported_tls_version() > io::net::TlsVersion::V1_2 ||
+        io::net::max_supported_tls_version() < io::net::TlsVersion::V1_2) {
+        TARM_IO_TEST_SKIP();
+    }
+
+    const io::net::TlsVersionRange version_range{io::net::TlsVersion::V1_2, io::net::TlsVersion::V1_2};
+
+    for (bool tickets : {false, true}) {
+        io::EventLoop loop;
+
+        auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+        EXPECT_FALSE(server->set_session_tickets(tickets));
+        if (tickets) {
+            EXPECT_FALSE(server->set_session_cache(0, 60 * 1000));
+        }
+        auto listen_error = server->listen({m_default_addr, m_default_port},
+            nullptr,
+            [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                EXPECT_EQ(io::net::TlsVersion::V1_2, client.negotiated_tls_version());
+                client.send_data(data.buf, data.size);
+            }
+        );
+        ASSERT_FALSE(listen_error);
+
+        std::vector<bool> client_resumed;
+
+        connect_and_exchange(loop, io::net::TlsSession(), version_range,
+            [&](const io::net::TlsSession& session, bool resumed) {
+                EXPECT_FALSE(session.is_empty());
+                client_resumed.push_back(resumed);
+                connect_and_exchange(loop, session, version_range,
+                    [&](const io::net::TlsSession& session, bool resumed) {
+                        client_resumed.push_back(resumed);
+                        server->schedule_removal();
+                    }
+                );
+            }
+        );
+
+        ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+        EXPECT_EQ(std::vector<bool>({false, true}), client_resumed) << "tickets: " << tickets;
+    }
+}
+
+TEST_F(TlsClientServerTest, session_resumption_disabled) {
+    io::EventLoop loop;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(data.buf, data.size);
+        }
+    );
+    ASSERT_FALSE(listen_error);
+    // Could be changed after listen
+    EXPECT_FALSE(server->set_session_cache(0, 60 * 1000));
+    EXPECT_FALSE(server->set_session_tickets(false));
+
+    std::vector<bool> client_resumed;
+
+    connect_and_exchange(loop, io::net::TlsSession(), io::net::DEFAULT_TLS_VERSION_RANGE,
+        [&](const io::net::TlsSession& session, bool resumed) {
+            client_resumed.push_back(resumed);
+            connect_and_exchange(loop, session, io::net::DEFAULT_TLS_VERSION_RANGE,
+                [&](const io::net::TlsSession& session, bool resumed) {
+                    client_resumed.push_back(resumed);
+                    server->schedule_removal();
+                }
+            );
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(std::vector<bool>({false, false}), client_resumed);
+}
+
+#ifndef TARM_IO_PLATFORM_WINDOWS
+TEST_F(TlsClientServerTest, server_replies_close_notify) {
+    const std::string message = "hello";
+
+    io::EventLoop loop;
+
+    std::size_t server_on_close_count = 0;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(data.buf, data.size);
+        },
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            ++server_on_close_count;
+            server->schedule_removal();
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    // OpenSSL client waits for close_notify in reply to its own
+    int shutdown_result = -1;
+    std::string client_received;
+    std::thread client_thread([&]() {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_NE(-1, fd);
+
+        ::timeval timeout{10, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        ::sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = io::host_to_network(std::uint32_t(INADDR_LOOPBACK));
+        address.sin_port = io::host_to_network(m_default_port);
+        EXPECT_EQ(0, ::connect(fd, reinterpret_cast<const ::sockaddr*>(&address), sizeof(address)));
+
+        ::SSL_CTX* ctx = ::SSL_CTX_new(::TLS_client_method());
+        ::SSL* ssl = ::SSL_new(ctx);
+        ::SSL_set_fd(ssl, fd);
+
+        EXPECT_EQ(1, ::SSL_connect(ssl));
+        EXPECT_EQ(int(message.size()), ::SSL_write(ssl, message.data(), int(message.size())));
+
+        char buffer[64];
+        const int read_size = ::SSL_read(ssl, buffer, sizeof(buffer));
+        if (read_size > 0) {
+            client_received.assign(buffer, std::size_t(read_size));
+        }
+
+        EXPECT_EQ(0, ::SSL_shutdown(ssl)); // close_notify is sent
+        shutdown_result = ::SSL_shutdown(ssl); // close_notify is received
+
+        ::SSL_free(ssl);
+        ::SSL_CTX_free(ctx);
+        ::close(fd);
+    });
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+    client_thread.join();
+
+    EXPECT_EQ(message, client_received);
+    EXPECT_EQ(1, shutdown_result);
+    EXPECT_EQ(1, server_on_close_count);
+}
+#endif // TARM_IO_PLATFORM_WINDOWS
+
+TEST_F(TlsClientServerTest, session_ticket_key_rotation) {
+    io::EventLoop loop;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    EXPECT_FALSE(server->set_session_cache(0, 60 * 1000));
+    EXPECT_FALSE(server->set_session_tickets(true, 300));
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(data.buf, data.size);
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    std::vector<bool> client_resumed;
+
+    // Ticket of the previous key is accepted, ticket which is older than 2 rotation intervals is not
+    auto timer = new io::Timer(loop);
+    connect_and_exchange(loop, io::net::TlsSession(), io::net::DEFAULT_TLS_VERSION_RANGE,
+        [&](const io::net::TlsSession& first_session, bool resumed) {
+            client_resumed.push_back(resumed);
+            timer->start(400, [&, first_session](io::Timer&) {
+                connect_and_exchange(loop, first_session, io::net::DEFAULT_TLS_VERSION_RANGE,
+                    [&, first_session](const io::net::TlsSession&, bool resumed) {
+                        client_resumed.push_back(resumed);
+                        timer->start(800, [&, first_session](io::Timer&) {
+                            connect_and_exchange(loop, first_session, io::net::DEFAULT_TLS_VERSION_RANGE,
+                                [&](const io::net::TlsSession&, bool resumed) {
+                                    client_resumed.push_back(resumed);
+                                    timer->schedule_removal();
+                                    server->schedule_removal();
+                                }
+                            );
+                        });
+                    }
+                );
+            });
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(std::vector<bool>({false, true, false}), client_resumed);
+}
+
+TEST_F(TlsClientServerTest, handshake_offload) {
+    const std::size_t CLIENTS_COUNT = 10;
+    const std::size_t BUF_SIZE = 64 * 1024;
+
+    io::EventLoop loop;
+
+    std::size_t server_on_connect_callback_count = 0;
+    std::size_t client_on_close_callback_count = 0;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    EXPECT_FALSE(server->set_handshake_offload(true));
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            ++server_on_connect_callback_count;
+        },
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(data.buf, data.size);
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    std::shared_ptr<char> buffer(new char[BUF_SIZE], std::default_delete<char[]>());
+    for (std::size_t i = 0; i < BUF_SIZE; ++i) {
+        buffer.get()[i] = static_cast<char>(i % 251);
+    }
+
+    // Clients are connected simultaneously, so data of one is received while handshake of another is performed
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::TlsClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data(buffer, BUF_SIZE);
+            },
+            [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                for (std::size_t i = 0; i < data.size; ++i) {
+                    ASSERT_EQ(buffer.get()[i + data.offset], data.buf.get()[i]) << "i: " << i;
+                }
+
+                if (data.offset + data.size == BUF_SIZE) {
+                    client.close();
+                }
+            },
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.schedule_removal();
+                if (++client_on_close_callback_count == CLIENTS_COUNT) {
+                    server->schedule_removal();
+                }
+            }
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(CLIENTS_COUNT, server_on_connect_callback_count);
+    EXPECT_EQ(CLIENTS_COUNT, client_on_close_callback_count);
+}
+
+TEST_F(TlsClientServerTest, handshake_offload_session_resumption) {
+    io::EventLoop loop;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    EXPECT_FALSE(server->set_handshake_offload(true));
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data(data.buf, data.size);
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    std::vector<bool> client_resumed;
+
+    connect_and_exchange(loop, io::net::TlsSession(), io::net::DEFAULT_TLS_VERSION_RANGE,
+        [&](const io::net::TlsSession& session, bool resumed) {
+            client_resumed.push_back(resumed);
+            connect_and_exchange(loop, session, io::net::DEFAULT_TLS_VERSION_RANGE,
+                [&](const io::net::TlsSession& session, bool resumed) {
+                    client_resumed.push_back(resumed);
+                    server->schedule_removal();
+                }
+            );
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(std::vector<bool>({false, true}), client_resumed);
+}
+
+TEST_F(TlsClientServerTest, handshake_offload_client_disconnects_during_handshake) {
+    const std::size_t CLIENTS_COUNT = 10;
+
+    io::EventLoop loop;
+
+    std::size_t server_on_connect_callback_count = 0;
+    std::size_t client_on_close_callback_count = 0;
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    EXPECT_FALSE(server->set_handshake_offload(true));
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+            // Handshake fails, if it is completed before the connection is closed
+            EXPECT_TRUE(error);
+            ++server_on_connect_callback_count;
+        },
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            ADD_FAILURE() << "Data should not be received";
+        }
+    );
+    ASSERT_FALSE(listen_error);
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::TcpClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data("GET / HTTP/1.1\r\n\r\n",
+                    [](io::net::TcpClient& client, const io::Error& error) {
+                        client.close();
+                    }
+                );
+            },
+            nullptr,
+            [&](io::net::TcpClient& client, const io::Error& error) {
+                client.schedule_removal();
+                if (++client_on_close_callback_count == CLIENTS_COUNT) {
+                    server->schedule_removal();
+                }
+            }
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(CLIENTS_COUNT, client_on_close_callback_count);
+    EXPECT_GE(CLIENTS_COUNT, server_on_connect_callback_count);
+}
+
+TEST_F(TlsClientServerTest, kernel_tls_data_exchange) {
+    if (!kernel_tls_is_supported()) {
+        TARM_IO_TEST_SKIP();
+    }
+
+    const std::size_t BUF_SIZE = 256 * 1024;
+
+    std::shared_ptr<char> buffer(new char[BUF_SIZE], std::default_delete<char[]>());
+    for (std::size_t i = 0; i < BUF_SIZE; ++i) {
+        buffer.get()[i] = static_cast<char>(i % 251);
+    }
+
+    // Kernel TLS may be not available (for example 'tls' module is not loaded), in that case data is
+    // encrypted by OpenSSL and connection should work the same way.
+    for (auto version : {io::net::TlsVersion::V1_2, io::net::TlsVersion::V1_3}) {
+        io::EventLoop loop;
+
+        std::size_t server_received_size = 0;
+        std::size_t client_received_size = 0;
+        bool server_kernel_tls = false;
+        bool client_kernel_tls = false;
+        std::size_t client_on_close_callback_count = 0;
+
+        auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path, {version, version});
+        EXPECT_FALSE(server->set_kernel_tls(true));
+        auto listen_error = server->listen({m_default_addr, m_default_port},
+            [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                server_kernel_tls = client.is_kernel_tls_active();
+            },
+            [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                for (std::size_t i = 0; i < data.size; ++i) {
+                    ASSERT_EQ(buffer.get()[i + data.offset], data.buf.get()[i]) << "i: " << i;
+                }
+                server_received_size += data.size;
+                client.send_data(data.buf, data.size);
+            }
+        );
+        ASSERT_FALSE(listen_error);
+
+        auto client = new io::net::TlsClient(loop, {version, version});
+        EXPECT_FALSE(client->set_kernel_tls(true));
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                EXPECT_EQ(version, client.negotiated_tls_version());
+                client_kernel_tls = client.is_kernel_tls_active();
+                client.send_data(buffer, BUF_SIZE);
+            },
+            [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                for (std::size_t i = 0; i < data.size; ++i) {
+                    ASSERT_EQ(buffer.get()[i + data.offset], data.buf.get()[i]) << "i: " << i;
+                }
+                client_received_size += data.size;
+                if (client_received_size == BUF_SIZE) {
+                    client.close();
+                }
+            },
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                ++client_on_close_callback_count;
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        );
+
+        ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+        EXPECT_EQ(BUF_SIZE, server_received_size);
+        EXPECT_EQ(BUF_SIZE, client_received_size);
+        EXPECT_EQ(1, client_on_close_callback_count);
+        EXPECT_EQ(server_kernel_tls, client_kernel_tls);
+    }
+}
+
+#ifdef TARM_IO_HAS_KERNEL_TLS
+TEST_F(TlsClientServerTest, kernel_tls_crypto_info_is_accepted_by_openssl_peer) {
+    // Keys which would be installed into the socket are checked without the kernel: record encrypted with them
+    // should be decrypted by OpenSSL on the other side of the connection.
+    struct CipherCase {
+        int version;
+        const char* cipher;
+    };
+
+    const std::vector<CipherCase> cases = {
+        {TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256"},
+#ifdef TLS_CIPHER_AES_GCM_256
+        {TLS1_2_VERSION, "ECDHE-RSA-AES256-GCM-SHA384"},
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        {TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305"},
+#endif
+#ifdef TLS_1_3_VERSION
+        {TLS1_3_VERSION, "TLS_AES_128_GCM_SHA256"},
+    #ifdef TLS_CIPHER_AES_GCM_256
+        {TLS1_3_VERSION, "TLS_AES_256_GCM_SHA384"},
+    #endif
+    #ifdef TLS_CIPHER_CHACHA20_POLY1305
+        {TLS1_3_VERSION, "TLS_CHACHA20_POLY1305_SHA256"},
+    #endif
+#endif
+    };
+
+    for (const auto& cipher_case : cases) {
+        SCOPED_TRACE(cipher_case.cipher);
+
+        std::unique_ptr<::SSL_CTX, decltype(&::SSL_CTX_free)> server_ctx(SSL_CTX_new(TLS_server_method()), &::SSL_CTX_free);
+        std::unique_ptr<::SSL_CTX, decltype(&::SSL_CTX_free)> client_ctx(SSL_CTX_new(TLS_client_method()), &::SSL_CTX_free);
+        ASSERT_TRUE(server_ctx);
+        ASSERT_TRUE(client_ctx);
+
+        ASSERT_EQ(1, SSL_CTX_use_certificate_file(server_ctx.get(), m_cert_path.string().c_str(), SSL_FILETYPE_PEM));
+        ASSERT_EQ(1, SSL_CTX_use_PrivateKey_file(server_ctx.get(), m_key_path.string().c_str(), SSL_FILETYPE_PEM));
+
+        for (auto ctx : {server_ctx.get(), client_ctx.get()}) {
+            ASSERT_EQ(1, SSL_CTX_set_min_proto_version(ctx, cipher_case.version));
+            ASSERT_EQ(1, SSL_CTX_set_max_proto_version(ctx, cipher_case.version));
+            io::net::detail::kernel_tls_init_context(ctx);
+        }
+
+        if (cipher_case.version == TLS1_2_VERSION) {
+            ASSERT_EQ(1, SSL_CTX_set_cipher_list(client_ctx.get(), cipher_case.cipher));
+        } else {
+            ASSERT_EQ(1, SSL_CTX_set_ciphersuites(client_ctx.get(), cipher_case.cipher));
+        }
+
+        std::unique_ptr<::SSL, decltype(&::SSL_free)> server(SSL_new(server_ctx.get()), &::SSL_free);
+        std::unique_ptr<::SSL, decltype(&::SSL_free)> client(SSL_new(client_ctx.get()), &::SSL_free);
+        ASSERT_TRUE(server);
+        ASSERT_TRUE(client);
+        ASSERT_FALSE(io::net::detail::kernel_tls_init_ssl(server.get()));
+        ASSERT_FALSE(io::net::detail::kernel_tls_init_ssl(client.get()));
+
+        ::BIO* server_read_bio = BIO_new(BIO_s_mem());
+        ::BIO* server_write_bio = BIO_new(BIO_s_mem());
+        ::BIO* client_read_bio = BIO_new(BIO_s_mem());
+        ::BIO* client_write_bio = BIO_new(BIO_s_mem());
+        SSL_set_bio(server.get(), server_read_bio, server_write_bio);
+        SSL_set_bio(client.get(), client_read_bio, client_write_bio);
+        SSL_set_accept_state(server.get());
+        SSL_set_connect_state(client.get());
+
+        bool handshake_done = false;
+        for (std::size_t i = 0; i < 10 && !handshake_done; ++i) {
+            const int client_result = SSL_do_handshake(client.get());
+            move_bio_data(client_write_bio, server_read_bio);
+            const int server_result = SSL_do_handshake(server.get());
+            handshake_done = client_result == 1 && server_result == 1;
+            if (!handshake_done) {
+                move_bio_data(server_write_bio, client_read_bio);
+            }
+        }
+        ASSERT_TRUE(handshake_done);
+        ASSERT_EQ(cipher_case.version, SSL_version(server.get()));
+        ASSERT_STREQ(cipher_case.cipher, SSL_CIPHER_get_name(SSL_get_current_cipher(server.get())));
+
+        // Data left after the handshake (TLS 1.3 session tickets) is sent to the client before keys are installed
+        const auto client_pending = move_bio_data(client_write_bio, server_read_bio);
+        const auto server_pending = move_bio_data(server_write_bio, client_read_bio);
+        const auto client_sequence_number =
+            io::net::detail::kernel_tls_tx_sequence_number(client.get(), client_pending.data(), client_pending.size());
+        const auto server_sequence_number =
+            io::net::detail::kernel_tls_tx_sequence_number(server.get(), server_pending.data(), server_pending.size());
+
+        struct Direction {
+            ::SSL* sender;
+            std::uint64_t sequence_number;
+            ::SSL* receiver;
+            ::BIO* receiver_read_bio;
+            std::string message;
+        };
+
+        for (const auto& direction : {Direction{client.get(), client_sequence_number, server.get(), server_read_bio, "from client"},
+                                      Direction{server.get(), server_sequence_number, client.get(), client_read_bio, "from server"}}) {
+            SCOPED_TRACE(direction.message);
+
+            std::vector<unsigned char> crypto_info;
+            ASSERT_FALSE(io::net::detail::kernel_tls_crypto_info(direction.sender, direction.sequence_number, crypto_info));
+
+            const auto record = encrypt_kernel_tls_record(crypto_info, direction.message);
+            ASSERT_FALSE(record.empty());
+            ASSERT_EQ(int(record.size()), BIO_write(direction.receiver_read_bio, record.data(), int(record.size())));
+
+            char buf[64];
+            const int read_size = SSL_read(direction.receiver, buf, sizeof(buf));
+            ASSERT_EQ(int(direction.message.size()), read_size) << SSL_get_error(direction.receiver, read_size);
+            EXPECT_EQ(direction.message, std::string(buf, read_size));
+        }
+    }
+}
+#endif
+
+TEST_F(TlsClientServerTest, release_idle_buffers_data_exchange) {
+    const std::size_t BUF_SIZE = 256 * 1024;
+    const std::size_t ROUNDS_COUNT = 3;
+
+    std::shared_ptr<char> buffer(new char[BUF_SIZE], std::default_delete<char[]>());
+    for (std::size_t i = 0; i < BUF_SIZE; ++i) {
+        buffer.get()[i] = static_cast<char>(i % 251);
+    }
+
+    for (auto version : {io::net::TlsVersion::V1_2, io::net::TlsVersion::V1_3}) {
+        io::EventLoop loop;
+        loop.set_shared_read_buffer(true);
+
+        std::size_t server_received_size = 0;
+        std::size_t client_received_size = 0;
+        std::size_t rounds_count = 0;
+        std::size_t client_on_close_callback_count = 0;
+
+        auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path, {version, version});
+        server->set_release_idle_buffers(true);
+        auto listen_error = server->listen({m_default_addr, m_default_port},
+            [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+            },
+            [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                for (std::size_t i = 0; i < data.size; ++i) {
+                    ASSERT_EQ(buffer.get()[(i + data.offset) % BUF_SIZE], data.buf.get()[i]) << "i: " << i;
+                }
+                server_received_size += data.size;
+                client.send_data(data.buf, data.size);
+            }
+        );
+        ASSERT_FALSE(listen_error);
+
+        auto client = new io::net::TlsClient(loop, {version, version});
+        client->set_release_idle_buffers(true);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data(buffer, BUF_SIZE);
+            },
+            [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                for (std::size_t i = 0; i < data.size; ++i) {
+                    ASSERT_EQ(buffer.get()[(i + data.offset) % BUF_SIZE], data.buf.get()[i]) << "i: " << i;
+                }
+                client_received_size += data.size;
+                if (client_received_size != BUF_SIZE * (rounds_count + 1)) {
+                    return;
+                }
+
+                // Next round starts after connection became idle and all buffers were released
+                if (++rounds_count < ROUNDS_COUNT) {
+                    loop.schedule_callback([&](io::EventLoop&) {
+                        client.send_data(buffer, BUF_SIZE);
+                    });
+                } else {
+                    client.close();
+                }
+            },
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                ++client_on_close_callback_count;
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        );
+
+        ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+        EXPECT_EQ(BUF_SIZE * ROUNDS_COUNT, server_received_size);
+        EXPECT_EQ(BUF_SIZE * ROUNDS_COUNT, client_received_size);
+        EXPECT_EQ(ROUNDS_COUNT, rounds_count);
+        EXPECT_EQ(1, client_on_close_callback_count);
+    }
+}
+
+TEST_F(TlsClientServerTest, server_send_file) {
+    const std::size_t FILE_SIZE = 1024 * 1024 + 17;
+    const std::size_t FILE_OFFSET = 100;
+    const std::string header = "header";
+    const std::string trailer = "trailer";
+
+    std::string file_content(FILE_SIZE, 0);
+    for (std::size_t i = 0; i < FILE_SIZE; ++i) {
+        file_content[i] = static_cast<char>(i % 251);
+    }
+
+    const auto file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ofile.write(file_content.data(), file_content.size());
+    }
+
+    const std::string expected_message = header + file_content.substr(FILE_OFFSET) + trailer;
+
+    // Both with and without kernel TLS
+    for (bool kernel_tls : {false, true}) {
+        if (kernel_tls && !kernel_tls_is_supported()) {
+            break;
+        }
+
+        io::EventLoop loop;
+
+        std::vector<std::string> end_sends;
+        std::vector<std::uint64_t> progress;
+        std::string received_message;
+
+        auto file = new io::fs::File(loop);
+
+        auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+        EXPECT_FALSE(server->set_kernel_tls(kernel_tls));
+        auto listen_error = server->listen({m_default_addr, m_default_port},
+            [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+
+                file->open(file_path, [&](io::fs::File& file, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+
+                    client.send_data(header, [&](io::net::TlsConnectedClient&, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        end_sends.push_back("header");
+                    });
+                    client.send_file(file, FILE_OFFSET, FILE_SIZE - FILE_OFFSET,
+                        [&](io::net::TlsConnectedClient& client, const io::Error& error) {
+                            EXPECT_FALSE(error) << error;
+                            end_sends.push_back("file");
+                            client.send_data(trailer, [&](io::net::TlsConnectedClient&, const io::Error& error) {
+                                EXPECT_FALSE(error) << error;
+                                end_sends.push_back("trailer");
+                            });
+                        },
+                        [&](io::net::TlsConnectedClient&, std::uint64_t bytes_sent) {
+                            progress.push_back(bytes_sent);
+                        }
+                    );
+                });
+            },
+            nullptr
+        );
+        ASSERT_FALSE(listen_error) << listen_error;
+
+        auto client = new io::net::TlsClient(loop);
+        client->connect({m_default_addr, m_default_port},
+            [&](io::net::TlsClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+            },
+            [&](io::net::TlsClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                received_message.append(data.buf.get(), data.size);
+                if (received_message.size() == expected_message.size()) {
+                    client.schedule_removal();
+                    server->schedule_removal();
+                    file->schedule_removal();
+                }
+            }
+        );
+
+        ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+        EXPECT_TRUE(received_message == expected_message);
+        EXPECT_EQ(std::vector<std::string>({"header", "file", "trailer"}), end_sends);
+        ASSERT_FALSE(progress.empty());
+        EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+        EXPECT_EQ(FILE_SIZE - FILE_OFFSET, progress.back());
+    }
+}
+
+TEST_F(TlsClientServerTest, client_send_file_errors) {
+    const auto file_path = create_temp_test_directory() + "/send_file";
+    {
+        std::ofstream ofile(file_path, std::ios::binary);
+        ofile << "0123456789";
+    }
+
+    io::EventLoop loop;
+
+    std::vector<io::Error> errors;
+
+    auto file = new io::fs::File(loop);
+
+    auto server = new io::net::TlsServer(loop, m_cert_path, m_key_path);
+    auto listen_error = server->listen({m_default_addr, m_default_port},
+        nullptr,
+        [&](io::net::TlsConnectedClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    auto client = new io::net::TlsClient(loop);
+
+    client->send_file(*file, 0, 10, [&](io::net::TlsClient&, const io::Error& error) {
+        errors.push_back(error);
+    });
+
+    client->connect({m_default_addr, m_default_port},
+        [&](io::net::TlsClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+
+            // Not opened file
+            client.send_file(*file, 0, 10, [&](io::net::TlsClient&, const io::Error& error) {
+                errors.push_back(error);
+            });
+
+            file->open(file_path, [&](io::fs::File& file, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+
+                // File is shorter than requested
+                client.send_file(file, 5, 10, [&](io::net::TlsClient& client, const io::Error& error) {
+                    errors.push_back(error);
+                    client.schedule_removal();
+                    server->schedule_removal();
+                    file.schedule_removal();
+                });
+            });
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    ASSERT_EQ(3, errors.size());
+    EXPECT_EQ(io::StatusCode::NOT_CONNECTED, errors[0].code());
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, errors[1].code());
+    EXPECT_EQ(io::StatusCode::END_OF_FILE, errors[2].code());
+}
+
 // TODO: connect as TCP and send invalid data on various stages
 
 // TODO: SSL_renegotiate test
@@ -7,9 +7,52 @@
 
 #include <boost/filesystem.hpp>
 
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <string>
 
+namespace {
+
+std::atomic<std::size_t> g_allocations_counter(0);
+
+} // namespace
+
+// Replacing global allocation functions to be able to check that some code paths do not allocate.
+void* operator new(std::size_t size) {
+    ++g_allocations_counter;
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+std::size_t allocations_count() {
+    return g_allocations_counter;
+}
+
 std::string create_temp_test_directory() {
     auto path = boost::filesystem::temp_directory_path();
     path /= "uv_cpp";
@@ -34,6 +34,10 @@ boost::filesystem::path exe_path();
 std::string current_test_suite_name();
 std::string current_test_case_name();
 
+// Number of heap allocations made by the process so far. Note: on Windows allocations made inside
+// the library DLL are not counted.
+std::size_t allocations_count();
+
 // std::chrono pretty printers for GTest
 namespace std {
 
@@ -5,14 +5,19 @@
 
 #include "UTCommon.h"
 
+#include "detail/LibuvCompatibility.h"
 #include "net/Udp.h"
 #include "ScopeExitGuard.h"
 #include "Timer.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <mutex>
 #include <numeric>
+#include <set>
 #include <unordered_map>
 #include <thread>
+#include <vector>
 
 struct UdpClientServerTest : public testing::Test,
                              public LogRedirector {
@@ -81,6 +86,198 @@ TEST_F(UdpClientServerTest, server_address_in_use) {
     ASSERT_EQ(io::StatusCode::OK, loop.run());
 }
 
+TEST_F(UdpClientServerTest, server_reuse_port) {
+    TARM_IO_TEST_SKIP_ON_WINDOWS();
+
+    io::EventLoop loop;
+
+    auto server_1 = new io::net::UdpServer(loop);
+    EXPECT_FALSE(server_1->is_reuse_port());
+    server_1->set_reuse_port(true);
+    EXPECT_TRUE(server_1->is_reuse_port());
+    auto listen_error_1 = server_1->start_receive({m_default_addr, m_default_port}, nullptr);
+    EXPECT_FALSE(listen_error_1) << listen_error_1;
+
+    auto server_2 = new io::net::UdpServer(loop);
+    server_2->set_reuse_port(true);
+    auto listen_error_2 = server_2->start_receive({m_default_addr, m_default_port}, nullptr);
+    EXPECT_FALSE(listen_error_2) << listen_error_2;
+
+    // Both servers should set option
+    auto server_3 = new io::net::UdpServer(loop);
+    auto listen_error_3 = server_3->start_receive({m_default_addr, m_default_port}, nullptr);
+    EXPECT_EQ(io::StatusCode::ADDRESS_ALREADY_IN_USE, listen_error_3.code());
+
+    server_1->schedule_removal();
+    server_2->schedule_removal();
+    server_3->schedule_removal();
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+}
+
+TEST_F(UdpClientServerTest, server_group_peers_affinity) {
+    TARM_IO_TEST_SKIP_ON_WINDOWS();
+
+    const std::size_t LOOPS_COUNT = 2;
+    const std::size_t CLIENTS_COUNT = 32;
+    const std::size_t MESSAGES_PER_CLIENT = 3;
+    const std::string message = "Hello!";
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::mutex mutex;
+    std::unordered_map<std::uint16_t, std::thread::id> peer_thread_ids;
+    std::set<std::thread::id> server_thread_ids;
+    std::size_t server_new_peers_count = 0;
+    std::size_t server_data_receive_count = 0;
+    bool same_thread_for_peer = true;
+
+    io::net::UdpServerGroup server(group);
+    auto listen_error = server.start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            std::lock_guard<std::mutex> guard(mutex);
+            ++server_new_peers_count;
+            peer_thread_ids[peer.endpoint().port()] = std::this_thread::get_id();
+        },
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_EQ(message, std::string(data.buf.get(), data.size));
+
+            std::lock_guard<std::mutex> guard(mutex);
+            server_thread_ids.insert(std::this_thread::get_id());
+            same_thread_for_peer &= peer_thread_ids[peer.endpoint().port()] == std::this_thread::get_id();
+
+            if (++server_data_receive_count == CLIENTS_COUNT * MESSAGES_PER_CLIENT) {
+                server.schedule_removal();
+            }
+        },
+        10000,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+    EXPECT_EQ(LOOPS_COUNT, server.size());
+    EXPECT_EQ(m_default_port, server.endpoint().port());
+
+    io::Error group_run_error;
+    std::thread group_thread([&]() {
+        group_run_error = group.run();
+    });
+
+    io::EventLoop client_loop;
+    std::vector<io::net::UdpClient*> clients;
+    std::size_t client_send_count = 0;
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::UdpClient(client_loop);
+        clients.push_back(client);
+        client->set_destination({m_default_addr, m_default_port},
+            [&](io::net::UdpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                for (std::size_t j = 0; j < MESSAGES_PER_CLIENT; ++j) {
+                    client.send_data(message,
+                        [&](io::net::UdpClient& client, const io::Error& error) {
+                            EXPECT_FALSE(error) << error;
+                            // Clients are removed all together, so ports are not reused by other clients
+                            if (++client_send_count == CLIENTS_COUNT * MESSAGES_PER_CLIENT) {
+                                for (auto c : clients) {
+                                    c->schedule_removal();
+                                }
+                            }
+                        }
+                    );
+                }
+            }
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, client_loop.run());
+    group_thread.join();
+
+    EXPECT_FALSE(group_run_error) << group_run_error;
+    EXPECT_EQ(CLIENTS_COUNT * MESSAGES_PER_CLIENT, server_data_receive_count);
+    // Each peer is tracked only by one loop.
+    // Note: clients bind with SO_REUSEADDR, so sometimes 2 clients could get the same port and look like 1 peer.
+    EXPECT_EQ(peer_thread_ids.size(), server_new_peers_count);
+    EXPECT_TRUE(same_thread_for_peer);
+    // Peers should be distributed between loops
+    EXPECT_EQ(LOOPS_COUNT, server_thread_ids.size());
+}
+
+TEST_F(UdpClientServerTest, server_group_start_receive_on_port_0) {
+    TARM_IO_TEST_SKIP_ON_WINDOWS();
+
+    const std::size_t LOOPS_COUNT = 2;
+    const std::size_t CLIENTS_COUNT = 32;
+    const std::string message = "Hello!";
+
+    io::EventLoopGroup group(LOOPS_COUNT);
+
+    std::mutex mutex;
+    std::set<std::thread::id> server_thread_ids;
+    std::size_t server_data_receive_count = 0;
+
+    io::net::UdpServerGroup server(group);
+    auto listen_error = server.start_receive({m_default_addr, 0},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_EQ(message, std::string(data.buf.get(), data.size));
+
+            std::lock_guard<std::mutex> guard(mutex);
+            server_thread_ids.insert(std::this_thread::get_id());
+            if (++server_data_receive_count == CLIENTS_COUNT) {
+                server.schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+    ASSERT_EQ(LOOPS_COUNT, server.size());
+
+    // All servers share the port assigned by the system
+    const auto port = server.endpoint().port();
+    EXPECT_NE(0, port);
+    for (std::size_t i = 0; i < LOOPS_COUNT; ++i) {
+        EXPECT_EQ(port, server.server(i).endpoint().port());
+    }
+
+    io::Error group_run_error;
+    std::thread group_thread([&]() {
+        group_run_error = group.run();
+    });
+
+    io::EventLoop client_loop;
+    std::vector<io::net::UdpClient*> clients;
+    std::size_t client_send_count = 0;
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::UdpClient(client_loop);
+        clients.push_back(client);
+        client->set_destination({m_default_addr, port},
+            [&](io::net::UdpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data(message,
+                    [&](io::net::UdpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        if (++client_send_count == CLIENTS_COUNT) {
+                            for (auto c : clients) {
+                                c->schedule_removal();
+                            }
+                        }
+                    }
+                );
+            }
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, client_loop.run());
+    group_thread.join();
+
+    EXPECT_FALSE(group_run_error) << group_run_error;
+    EXPECT_EQ(CLIENTS_COUNT, server_data_receive_count);
+    // Peers should be distributed between loops
+    EXPECT_EQ(LOOPS_COUNT, server_thread_ids.size());
+}
+
 TEST_F(UdpClientServerTest, server_invalid_address) {
     io::EventLoop loop;
 
@@ -532,6 +729,593 @@ TEST_F(UdpClientServerTest, peer_identity_with_preservation_on_server) {
     ASSERT_EQ(2, server_receive_counter);
 }
 
+TEST_F(UdpClientServerTest, server_receive_buffer_reuse) {
+    io::EventLoop loop;
+
+    const std::vector<std::string> messages = {"message_1", "message_2", "message_3"};
+
+    std::vector<const char*> received_buffers;
+    io::DataChunk kept_chunk;
+
+    auto server = new io::net::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_buffers.push_back(data.buf.get());
+            if (received_buffers.size() == 2) {
+                kept_chunk = data;
+            }
+
+            if (received_buffers.size() == messages.size()) {
+                server->schedule_removal();
+            }
+        },
+        1000,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::function<void(io::net::UdpClient&, std::size_t)> send_message =
+        [&](io::net::UdpClient& client, std::size_t index) {
+            client.send_data(messages[index],
+                [&, index](io::net::UdpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    if (index + 1 < messages.size()) {
+                        send_message(client, index + 1);
+                    } else {
+                        client.schedule_removal();
+                    }
+                }
+            );
+        };
+
+    auto client = new io::net::UdpClient(loop);
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            send_message(client, 0);
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    ASSERT_EQ(messages.size(), received_buffers.size());
+    // Buffer is reused if user does not keep it
+    EXPECT_EQ(received_buffers[0], received_buffers[1]);
+    // Kept buffer is not overwritten by next packets
+    EXPECT_NE(received_buffers[1], received_buffers[2]);
+    EXPECT_EQ(messages[1], std::string(kept_chunk.buf.get(), kept_chunk.size));
+
+    // Buffer returns to the pool when last reference is dropped
+    const auto free_buffers_count = loop.buffer_pool().free_buffers_count();
+    kept_chunk = io::DataChunk();
+    EXPECT_EQ(free_buffers_count + 1, loop.buffer_pool().free_buffers_count());
+}
+
+TEST_F(UdpClientServerTest, server_receive_does_not_allocate) {
+    io::EventLoop loop;
+
+    static const std::size_t BURST_SIZE = 10;
+    const std::string message = "Hello!";
+
+    std::size_t server_receive_counter = 0;
+    std::size_t allocations_on_burst_start = 0;
+    std::size_t allocations_on_burst_end = 0;
+
+    auto server = new io::net::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            ++server_receive_counter;
+
+            // First burst is used for warm up
+            if (server_receive_counter == BURST_SIZE + 1) {
+                allocations_on_burst_start = allocations_count();
+            } else if (server_receive_counter == 2 * BURST_SIZE) {
+                allocations_on_burst_end = allocations_count();
+                server->schedule_removal();
+            }
+        },
+        1000,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::size_t client_send_counter = 0;
+
+    auto client = new io::net::UdpClient(loop);
+    auto send_burst = [&](io::net::UdpClient& client) {
+        for (std::size_t i = 0; i < BURST_SIZE; ++i) {
+            client.send_data(message.c_str(), static_cast<std::uint32_t>(message.size()),
+                [&](io::net::UdpClient& client, const io::Error& error) {
+                    EXPECT_FALSE(error) << error;
+                    ++client_send_counter;
+                }
+            );
+        }
+    };
+
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            send_burst(client);
+        }
+    );
+
+    // Second burst is sent when the first one is received
+    bool second_burst_sent = false;
+    auto timer = new io::Timer(loop);
+    timer->start(10, 10, [&](io::Timer& timer) {
+        if (server_receive_counter == BURST_SIZE && !second_burst_sent) {
+            second_burst_sent = true;
+            send_burst(*client);
+        } else if (server_receive_counter == 2 * BURST_SIZE) {
+            timer.schedule_removal();
+            client->schedule_removal();
+        }
+    });
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(2 * BURST_SIZE, server_receive_counter);
+    EXPECT_EQ(2 * BURST_SIZE, client_send_counter);
+    EXPECT_EQ(allocations_on_burst_start, allocations_on_burst_end);
+}
+
+TEST_F(UdpClientServerTest, server_receive_batch) {
+    io::EventLoop loop;
+
+    static const std::size_t MESSAGES_COUNT = 20;
+    static const std::size_t BATCH_SIZE = 8;
+
+    std::vector<std::string> received_messages;
+    std::vector<std::string> received_batch_messages;
+    std::size_t batch_callback_counter = 0;
+    std::size_t max_batch_size = 0;
+
+    auto server = new io::net::UdpServer(loop);
+    auto batch_error = server->set_receive_batch(BATCH_SIZE, 64,
+        [&](io::net::UdpServer& server, const io::net::UdpDatagram* datagrams, std::size_t count, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_LE(count, BATCH_SIZE);
+            ++batch_callback_counter;
+            max_batch_size = std::max(max_batch_size, count);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                EXPECT_NE(0, datagrams[i].peer_id.port);
+                received_batch_messages.emplace_back(datagrams[i].data.buf.get(), datagrams[i].data.size);
+            }
+
+            if (received_batch_messages.size() == MESSAGES_COUNT) {
+                server.schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(batch_error) << batch_error;
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_messages.emplace_back(data.buf.get(), data.size);
+        },
+        1000,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::size_t client_send_counter = 0;
+
+    auto client = new io::net::UdpClient(loop);
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                client.send_data("message_" + std::to_string(i),
+                    [&](io::net::UdpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        if (++client_send_counter == MESSAGES_COUNT) {
+                            client.schedule_removal();
+                        }
+                    }
+                );
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(MESSAGES_COUNT, client_send_counter);
+    ASSERT_EQ(MESSAGES_COUNT, received_messages.size());
+    EXPECT_EQ(received_messages, received_batch_messages);
+    for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+        EXPECT_EQ("message_" + std::to_string(i), received_messages[i]);
+    }
+
+#if defined(TARM_IO_HAS_UV_UDP_IO_WATCHER)
+    EXPECT_GT(max_batch_size, 1u);
+    EXPECT_LT(batch_callback_counter, MESSAGES_COUNT);
+#else
+    EXPECT_EQ(MESSAGES_COUNT, batch_callback_counter);
+#endif
+}
+
+TEST_F(UdpClientServerTest, server_set_receive_batch_from_receive_callback) {
+    io::EventLoop loop;
+
+    static const std::size_t MESSAGES_COUNT = 20;
+
+    std::vector<std::string> received_messages;
+    std::vector<std::string> received_batch_messages;
+
+    auto server = new io::net::UdpServer(loop);
+    auto batch_error = server->set_receive_batch(8, 64,
+        [&](io::net::UdpServer& server, const io::net::UdpDatagram* datagrams, std::size_t count, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_EQ(io::StatusCode::OPERATION_ALREADY_IN_PROGRESS, server.set_receive_batch(16, 128).code());
+
+            for (std::size_t i = 0; i < count; ++i) {
+                received_batch_messages.emplace_back(datagrams[i].data.buf.get(), datagrams[i].data.size);
+            }
+
+            if (received_batch_messages.size() == MESSAGES_COUNT) {
+                server.schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(batch_error) << batch_error;
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            // Batch is in use, so it can not be disabled or resized
+            EXPECT_EQ(io::StatusCode::OPERATION_ALREADY_IN_PROGRESS, peer.server().set_receive_batch(1, 64).code());
+            EXPECT_EQ(io::StatusCode::OPERATION_ALREADY_IN_PROGRESS, peer.server().set_receive_batch(2, 8).code());
+            received_messages.emplace_back(data.buf.get(), data.size);
+        },
+        1000,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+    EXPECT_EQ(io::StatusCode::OPERATION_ALREADY_IN_PROGRESS, server->set_receive_batch(1, 64).code());
+
+    std::size_t client_send_counter = 0;
+
+    auto client = new io::net::UdpClient(loop);
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                client.send_data("message_" + std::to_string(i),
+                    [&](io::net::UdpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        if (++client_send_counter == MESSAGES_COUNT) {
+                            client.schedule_removal();
+                        }
+                    }
+                );
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    ASSERT_EQ(MESSAGES_COUNT, received_messages.size());
+    EXPECT_EQ(received_messages, received_batch_messages);
+    for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+        EXPECT_EQ("message_" + std::to_string(i), received_messages[i]);
+    }
+}
+
+TEST_F(UdpClientServerTest, server_receive_batch_drops_long_datagrams) {
+#if !defined(TARM_IO_HAS_UV_UDP_IO_WATCHER)
+    TARM_IO_TEST_SKIP();
+#endif
+
+    io::EventLoop loop;
+
+    const std::vector<std::string> messages = {"short", "this message is too long", "end"};
+
+    std::vector<std::string> received_messages;
+
+    auto server = new io::net::UdpServer(loop);
+    auto batch_error = server->set_receive_batch(4, 8);
+    ASSERT_FALSE(batch_error) << batch_error;
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_messages.emplace_back(data.buf.get(), data.size);
+            if (received_messages.back() == "end") {
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::size_t client_send_counter = 0;
+
+    auto client = new io::net::UdpClient(loop);
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (auto& message : messages) {
+                client.send_data(message,
+                    [&](io::net::UdpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        if (++client_send_counter == messages.size()) {
+                            client.schedule_removal();
+                        }
+                    }
+                );
+            }
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    ASSERT_EQ(2, received_messages.size());
+    EXPECT_EQ(messages[0], received_messages[0]);
+    EXPECT_EQ(messages[2], received_messages[1]);
+}
+
+TEST_F(UdpClientServerTest, server_set_receive_batch_invalid_args) {
+    io::EventLoop loop;
+
+    auto server = new io::net::UdpServer(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, server->set_receive_batch(0, 100));
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, server->set_receive_batch(10, 0));
+    EXPECT_FALSE(server->set_receive_batch(1, 100));
+    EXPECT_FALSE(server->set_receive_batch(16, 100));
+    server->schedule_removal();
+
+    auto client = new io::net::UdpClient(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, client->set_receive_batch(0, 100));
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, client->set_receive_batch(10, 0));
+    EXPECT_FALSE(client->set_receive_batch(16, 100));
+    client->schedule_removal();
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+}
+
+TEST_F(UdpClientServerTest, client_receive_batch) {
+    io::EventLoop loop;
+
+    static const std::size_t MESSAGES_COUNT = 10;
+
+    auto server = new io::net::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            peer.send_data(std::string(data.buf.get(), data.size));
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::vector<std::string> received_messages;
+    std::vector<std::string> received_batch_messages;
+
+    auto client = new io::net::UdpClient(loop);
+    auto batch_error = client->set_receive_batch(4, 64,
+        [&](io::net::UdpClient& client, const io::net::UdpDatagram* datagrams, std::size_t count, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            EXPECT_LE(count, 4u);
+            for (std::size_t i = 0; i < count; ++i) {
+                received_batch_messages.emplace_back(datagrams[i].data.buf.get(), datagrams[i].data.size);
+            }
+
+            if (received_batch_messages.size() == MESSAGES_COUNT) {
+                client.schedule_removal();
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(batch_error) << batch_error;
+
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                client.send_data("message_" + std::to_string(i));
+            }
+        },
+        [&](io::net::UdpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_messages.emplace_back(data.buf.get(), data.size);
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    ASSERT_EQ(MESSAGES_COUNT, received_messages.size());
+    EXPECT_EQ(received_messages, received_batch_messages);
+    for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+        EXPECT_EQ("message_" + std::to_string(i), received_messages[i]);
+    }
+}
+
+TEST_F(UdpClientServerTest, server_send_batch) {
+    io::EventLoop loop;
+
+    static const std::size_t CLIENTS_COUNT = 3;
+    static const std::size_t MESSAGES_COUNT = 20;
+
+    std::size_t server_send_counter = 0;
+
+    auto server = new io::net::UdpServer(loop);
+    auto batch_error = server->set_send_batch(8);
+    ASSERT_FALSE(batch_error) << batch_error;
+
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+                peer.send_data("message_" + std::to_string(i),
+                    [&](io::net::UdpPeer& peer, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        ++server_send_counter;
+                    }
+                );
+            }
+        },
+        1000,
+        nullptr
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::vector<std::vector<std::string>> client_messages(CLIENTS_COUNT);
+    std::size_t clients_done = 0;
+
+    for (std::size_t i = 0; i < CLIENTS_COUNT; ++i) {
+        auto client = new io::net::UdpClient(loop);
+        client->set_destination({m_default_addr, m_default_port},
+            [&](io::net::UdpClient& client, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client.send_data("hello");
+            },
+            [&, i](io::net::UdpClient& client, const io::DataChunk& data, const io::Error& error) {
+                EXPECT_FALSE(error) << error;
+                client_messages[i].emplace_back(data.buf.get(), data.size);
+                if (client_messages[i].size() == MESSAGES_COUNT) {
+                    client.schedule_removal();
+                    if (++clients_done == CLIENTS_COUNT) {
+                        server->schedule_removal();
+                    }
+                }
+            }
+        );
+    }
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(CLIENTS_COUNT * MESSAGES_COUNT, server_send_counter);
+    for (auto& messages : client_messages) {
+        ASSERT_EQ(MESSAGES_COUNT, messages.size());
+        for (std::size_t i = 0; i < MESSAGES_COUNT; ++i) {
+            EXPECT_EQ("message_" + std::to_string(i), messages[i]);
+        }
+    }
+}
+
+TEST_F(UdpClientServerTest, client_send_batch_flush) {
+    io::EventLoop loop;
+
+    const std::vector<std::string> messages = {"a", "bb", "ccc", "dddd"};
+
+    std::vector<std::string> received_messages;
+
+    auto server = new io::net::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_messages.emplace_back(data.buf.get(), data.size);
+            if (received_messages.size() == messages.size()) {
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::size_t client_send_counter = 0;
+    std::size_t send_counter_after_flush = 0;
+
+    auto client = new io::net::UdpClient(loop);
+    auto batch_error = client->set_send_batch(16);
+    ASSERT_FALSE(batch_error) << batch_error;
+
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (auto& message : messages) {
+                client.send_data(message,
+                    [&](io::net::UdpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        ++client_send_counter;
+                    }
+                );
+            }
+
+            EXPECT_EQ(0, client_send_counter);
+            client.flush();
+            send_counter_after_flush = client_send_counter;
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(messages.size(), client_send_counter);
+#if defined(TARM_IO_PLATFORM_LINUX)
+    EXPECT_EQ(messages.size(), send_counter_after_flush);
+#endif
+    EXPECT_EQ(messages, received_messages);
+}
+
+TEST_F(UdpClientServerTest, client_send_batch_then_schedule_removal) {
+    io::EventLoop loop;
+
+    const std::vector<std::string> messages = {"message_1", "message_2", "message_3"};
+
+    std::vector<std::string> received_messages;
+
+    auto server = new io::net::UdpServer(loop);
+    auto listen_error = server->start_receive({m_default_addr, m_default_port},
+        [&](io::net::UdpPeer& peer, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            received_messages.emplace_back(data.buf.get(), data.size);
+            if (received_messages.size() == messages.size()) {
+                server->schedule_removal();
+            }
+        }
+    );
+    ASSERT_FALSE(listen_error) << listen_error;
+
+    std::size_t client_send_counter = 0;
+
+    auto client = new io::net::UdpClient(loop);
+    auto batch_error = client->set_send_batch(16);
+    ASSERT_FALSE(batch_error) << batch_error;
+
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            for (auto& message : messages) {
+                client.send_data(message,
+                    [&](io::net::UdpClient& client, const io::Error& error) {
+                        EXPECT_FALSE(error) << error;
+                        ++client_send_counter;
+                    }
+                );
+            }
+
+            // Queued datagrams are sent before close
+            client.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(messages.size(), client_send_counter);
+    EXPECT_EQ(messages, received_messages);
+}
+
+TEST_F(UdpClientServerTest, set_send_batch_invalid_args) {
+    io::EventLoop loop;
+
+    auto server = new io::net::UdpServer(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, server->set_send_batch(0));
+    EXPECT_FALSE(server->set_send_batch(1));
+    EXPECT_FALSE(server->set_send_batch(32));
+    server->schedule_removal();
+
+    auto client = new io::net::UdpClient(loop);
+    EXPECT_EQ(io::StatusCode::INVALID_ARGUMENT, client->set_send_batch(0));
+    EXPECT_FALSE(client->set_send_batch(32));
+    EXPECT_FALSE(client->set_send_batch(1));
+    client->schedule_removal();
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+}
+
 TEST_F(UdpClientServerTest, on_new_peer_callback) {
     io::EventLoop loop;
 
@@ -1302,6 +2086,41 @@ TEST_F(UdpClientServerTest, client_receive_data_only_from_its_target) {
     EXPECT_EQ(0, receive_callback_call_count);
 }
 
+TEST_F(UdpClientServerTest, client_receives_connection_refused_from_closed_port) {
+#if !defined(TARM_IO_PLATFORM_LINUX)
+    TARM_IO_TEST_SKIP();
+#endif
+
+    io::EventLoop loop;
+
+    std::size_t receive_errors_count = 0;
+
+    // Client socket is connected to destination, so ICMP "port unreachable" is reported to it
+    auto client = new io::net::UdpClient(loop);
+    client->set_destination({m_default_addr, m_default_port},
+        [&](io::net::UdpClient& client, const io::Error& error) {
+            EXPECT_FALSE(error) << error;
+            client.send_data("Is anybody here?");
+        },
+        [&](io::net::UdpClient& client, const io::DataChunk& data, const io::Error& error) {
+            EXPECT_EQ(io::StatusCode::CONNECTION_REFUSED, error);
+            ++receive_errors_count;
+        }
+    );
+
+    auto timer = new io::Timer(loop);
+    timer->start(200,
+        [&](io::Timer& timer) {
+            client->schedule_removal();
+            timer.schedule_removal();
+        }
+    );
+
+    ASSERT_EQ(io::StatusCode::OK, loop.run());
+
+    EXPECT_EQ(1, receive_errors_count);
+}
+
 TEST_F(UdpClientServerTest, send_larger_than_ethernet_mtu) {
     io::EventLoop loop;
 
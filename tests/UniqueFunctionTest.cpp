@@ -0,0 +1,178 @@
+/*----------------------------------------------------------------------------------------------
+ *  Copyright (c) 2020 - present Alexander Voitenko
+ *  Licensed under the MIT License. See License.txt in the project root for license information.
+ *----------------------------------------------------------------------------------------------*/
+
+#include "UTCommon.h"
+
+#include "detail/UniqueFunction.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+struct UniqueFunctionTest : public testing::Test,
+                            public LogRedirector {
+};
+
+namespace {
+
+int plus_one(int value) {
+    return value + 1;
+}
+
+} // namespace
+
+TEST_F(UniqueFunctionTest, default_constructor) {
+    io::detail::UniqueFunction<void()> f;
+    EXPECT_FALSE(f);
+
+    io::detail::UniqueFunction<void()> f_null(nullptr);
+    EXPECT_FALSE(f_null);
+}
+
+TEST_F(UniqueFunctionTest, empty_std_function_and_function_pointer) {
+    io::detail::UniqueFunction<int(int)> f_1 = std::function<int(int)>();
+    EXPECT_FALSE(f_1);
+
+    int (*function_ptr)(int) = nullptr;
+    io::detail::UniqueFunction<int(int)> f_2 = function_ptr;
+    EXPECT_FALSE(f_2);
+
+    function_ptr = &plus_one;
+    io::detail::UniqueFunction<int(int)> f_3 = function_ptr;
+    ASSERT_TRUE(f_3);
+    EXPECT_EQ(2, f_3(1));
+}
+
+TEST_F(UniqueFunctionTest, lambda) {
+    int counter = 0;
+    io::detail::UniqueFunction<void(int)> f = [&counter](int value) {
+        counter += value;
+    };
+    ASSERT_TRUE(f);
+
+    f(2);
+    f(3);
+    EXPECT_EQ(5, counter);
+
+    f = nullptr;
+    EXPECT_FALSE(f);
+}
+
+TEST_F(UniqueFunctionTest, from_std_function) {
+    std::function<int(int)> std_function = [](int value) {
+        return value * 2;
+    };
+
+    io::detail::UniqueFunction<int(int)> f = std_function;
+    ASSERT_TRUE(f);
+    EXPECT_EQ(4, f(2));
+    EXPECT_TRUE(std_function);
+}
+
+TEST_F(UniqueFunctionTest, move_only_callable) {
+    std::unique_ptr<int> ptr(new int(10));
+    auto raw_ptr = ptr.get();
+
+    struct Callable {
+        std::unique_ptr<int> ptr;
+
+        int operator()(int value) const {
+            return *ptr + value;
+        }
+    };
+
+    io::detail::UniqueFunction<int(int)> f_1 = Callable{std::move(ptr)};
+    EXPECT_EQ(11, f_1(1));
+
+    io::detail::UniqueFunction<int(int)> f_2 = std::move(f_1);
+    EXPECT_FALSE(f_1);
+    ASSERT_TRUE(f_2);
+    EXPECT_EQ(12, f_2(2));
+
+    io::detail::UniqueFunction<int(int)> f_3;
+    f_3 = std::move(f_2);
+    EXPECT_FALSE(f_2);
+    ASSERT_TRUE(f_3);
+    EXPECT_EQ(13, f_3(3));
+
+    struct Inspector {
+        int* expected;
+        bool operator()(int* actual) const {
+            return expected == actual;
+        }
+    };
+    EXPECT_TRUE(io::detail::UniqueFunction<bool(int*)>(Inspector{raw_ptr})(raw_ptr));
+}
+
+TEST_F(UniqueFunctionTest, small_callable_does_not_allocate) {
+    int a = 0;
+    int b = 0;
+    int c = 0;
+    std::function<void()> std_function = [&a]() {
+        ++a;
+    };
+
+    const auto allocations_before = allocations_count();
+    {
+        io::detail::UniqueFunction<void()> f_1 = [&a, &b, &c]() {
+            ++a;
+            ++b;
+            ++c;
+        };
+        io::detail::UniqueFunction<void()> f_2 = std_function;
+        io::detail::UniqueFunction<void()> f_3 = std::move(f_1);
+        f_2();
+        f_3();
+    }
+    EXPECT_EQ(allocations_before, allocations_count());
+
+    EXPECT_EQ(2, a);
+    EXPECT_EQ(1, b);
+    EXPECT_EQ(1, c);
+}
+
+TEST_F(UniqueFunctionTest, large_callable) {
+    std::array<int, 64> values;
+    values.fill(1);
+
+    std::size_t destructor_calls = 0;
+    struct Large {
+        std::array<int, 64> values;
+        std::size_t* destructor_calls;
+
+        ~Large() {
+            ++(*destructor_calls);
+        }
+
+        int operator()() const {
+            int sum = 0;
+            for (auto v : values) {
+                sum += v;
+            }
+            return sum;
+        }
+    };
+
+    {
+        io::detail::UniqueFunction<int()> f_1 = Large{values, &destructor_calls};
+        destructor_calls = 0; // Temporary object is destroyed
+        EXPECT_EQ(64, f_1());
+
+        io::detail::UniqueFunction<int()> f_2 = std::move(f_1);
+        EXPECT_EQ(0, destructor_calls); // Moved by pointer
+        EXPECT_EQ(64, f_2());
+    }
+    EXPECT_EQ(1, destructor_calls);
+}
+
+TEST_F(UniqueFunctionTest, destructor_is_called) {
+    auto ptr = std::make_shared<int>(0);
+    {
+        io::detail::UniqueFunction<void()> f = [ptr]() {
+        };
+        EXPECT_EQ(2, ptr.use_count());
+    }
+    EXPECT_EQ(1, ptr.use_count());
+}